@@ -60,6 +60,7 @@ typedef enum {
   SYSTEM_CAN_MESSAGE_MOTOR_AMP_HR = 39,
   SYSTEM_CAN_MESSAGE_ODOMETER = 40,
   SYSTEM_CAN_MESSAGE_CRUISE_CONTROL_COMMAND = 41,
+  SYSTEM_CAN_MESSAGE_BATTERY_SOC = 42,
   SYSTEM_CAN_MESSAGE_AUX_DCDC_VC = 43,
   SYSTEM_CAN_MESSAGE_DCDC_TEMPS = 44,
   SYSTEM_CAN_MESSAGE_CHARGER_INFO = 47,
@@ -77,5 +78,5 @@ typedef enum {
   SYSTEM_CAN_MESSAGE_SOLAR_DATA = 59,
   SYSTEM_CAN_MESSAGE_SOLAR_FAULT = 60,
   SYSTEM_CAN_MESSAGE_BABYDRIVER = 63,
-  NUM_SYSTEM_CAN_MESSAGES = 53
+  NUM_SYSTEM_CAN_MESSAGES = 54
 } SystemCanMessage;
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "can_msg.h"
+#include "can_msg_defs.h"
+
+#define CAN_MSG_TABLE_MAX_FIELDS 8
+
+// A field of a message, as packed by CAN_PACK_*: |width| little-endian bytes at |offset|.
+typedef struct CanMsgFieldDef {
+  const char *name;
+  uint8_t offset;
+  uint8_t width;
+} CanMsgFieldDef;
+
+typedef struct CanMsgDef {
+  const char *name;  // NULL if the message ID is unused
+  SystemCanDevice source;
+  uint8_t dlc;
+  uint8_t num_fields;
+  CanMsgFieldDef fields[CAN_MSG_TABLE_MAX_FIELDS];
+} CanMsgDef;
+
+// Returns the definition of |msg_id|, or NULL if it isn't a system CAN message.
+const CanMsgDef *can_msg_table_get(CanMessageId msg_id);
+
+// Returns the ID of the message named |name| (e.g. "BATTERY_VT"), or CAN_MSG_INVALID_ID.
+CanMessageId can_msg_table_find(const char *name);
+
+// Returns the name of |device|, or NULL if it isn't a system CAN device.
+const char *can_msg_table_device_name(uint16_t device);
+
+// Extracts |field| from a message's data bytes.
+uint64_t can_msg_table_get_field(const CanMsgFieldDef *field, const uint8_t *data);
@@ -299,6 +299,14 @@
     status;                                              \
   })
 
+#define CAN_TRANSMIT_BATTERY_SOC(soc_u32, energy_u32)    \
+  ({                                                     \
+    CanMessage msg = { 0 };                              \
+    CAN_PACK_BATTERY_SOC(&msg, (soc_u32), (energy_u32)); \
+    StatusCode status = can_transmit(&msg, NULL);        \
+    status;                                              \
+  })
+
 #define CAN_TRANSMIT_AUX_DCDC_VC(aux_voltage_u16, aux_current_u16, dcdc_voltage_u16,     \
                                  dcdc_current_u16)                                       \
   ({                                                                                     \
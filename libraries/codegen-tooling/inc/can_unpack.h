@@ -146,6 +146,9 @@
                      CAN_UNPACK_IMPL_EMPTY, CAN_UNPACK_IMPL_EMPTY, CAN_UNPACK_IMPL_EMPTY,          \
                      CAN_UNPACK_IMPL_EMPTY, CAN_UNPACK_IMPL_EMPTY)
 
+#define CAN_UNPACK_BATTERY_SOC(msg_ptr, soc_u32_ptr, energy_u32_ptr) \
+  can_unpack_impl_u32((msg_ptr), 8, (soc_u32_ptr), (energy_u32_ptr))
+
 #define CAN_UNPACK_AUX_DCDC_VC(msg_ptr, aux_voltage_u16_ptr, aux_current_u16_ptr, \
                                dcdc_voltage_u16_ptr, dcdc_current_u16_ptr)        \
   can_unpack_impl_u16((msg_ptr), 8, (aux_voltage_u16_ptr), (aux_current_u16_ptr), \
@@ -7,6 +7,9 @@
 
 # The code in this library is autogenerated and pulled from GitHub
 # https://github.com/uw-midsun/codegen-tooling
+# Messages defined here ahead of a release are listed in can_messages_local.json and generated
+# into the headers by make/codegen_local.py, which also renders the CAN message table from
+# templates/. `make update_codegen` runs it after fetching.
 
 $(T)_DEPS := ms-common
 
@@ -0,0 +1,558 @@
+#include "can_msg_table.h"
+
+#include <string.h>
+
+static const char *s_device_names[CAN_MSG_MAX_DEVICES] = {
+  [SYSTEM_CAN_DEVICE_RESERVED] = "RESERVED",
+  [SYSTEM_CAN_DEVICE_BMS_CARRIER] = "BMS_CARRIER",
+  [SYSTEM_CAN_DEVICE_CENTRE_CONSOLE] = "CENTRE_CONSOLE",
+  [SYSTEM_CAN_DEVICE_POWER_DISTRIBUTION_REAR] = "POWER_DISTRIBUTION_REAR",
+  [SYSTEM_CAN_DEVICE_POWER_DISTRIBUTION_FRONT] = "POWER_DISTRIBUTION_FRONT",
+  [SYSTEM_CAN_DEVICE_MOTOR_CONTROLLER] = "MOTOR_CONTROLLER",
+  [SYSTEM_CAN_DEVICE_PEDAL] = "PEDAL",
+  [SYSTEM_CAN_DEVICE_STEERING] = "STEERING",
+  [SYSTEM_CAN_DEVICE_SOLAR] = "SOLAR",
+  [SYSTEM_CAN_DEVICE_CHARGER] = "CHARGER",
+  [SYSTEM_CAN_DEVICE_IMU] = "IMU",
+  [SYSTEM_CAN_DEVICE_POWER_SELECTION] = "POWER_SELECTION",
+  [SYSTEM_CAN_DEVICE_BABYDRIVER] = "BABYDRIVER",
+};
+
+static const CanMsgDef s_msg_defs[CAN_MSG_MAX_IDS] = {
+  [SYSTEM_CAN_MESSAGE_BPS_HEARTBEAT] = {
+    .name = "BPS_HEARTBEAT",
+    .source = SYSTEM_CAN_DEVICE_BMS_CARRIER,
+    .dlc = 1,
+    .num_fields = 1,
+    .fields = {
+      { "status", 0, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_SET_RELAY_STATES] = {
+    .name = "SET_RELAY_STATES",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 4,
+    .num_fields = 2,
+    .fields = {
+      { "relay_mask", 0, 2 },
+      { "relay_state", 2, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_POWERTRAIN_HEARTBEAT] = {
+    .name = "POWERTRAIN_HEARTBEAT",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 0,
+    .num_fields = 0,
+  },
+  [SYSTEM_CAN_MESSAGE_GET_AUX_STATUS] = {
+    .name = "GET_AUX_STATUS",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 2,
+    .num_fields = 2,
+    .fields = {
+      { "aux_bat_ov_flag", 0, 1 },
+      { "aux_bat_ut_flag", 1, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_FAULT_SEQUENCE] = {
+    .name = "FAULT_SEQUENCE",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 2,
+    .num_fields = 1,
+    .fields = {
+      { "sequence", 0, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_POWER_ON_MAIN_SEQUENCE] = {
+    .name = "POWER_ON_MAIN_SEQUENCE",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 2,
+    .num_fields = 1,
+    .fields = {
+      { "sequence", 0, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_POWER_OFF_SEQUENCE] = {
+    .name = "POWER_OFF_SEQUENCE",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 2,
+    .num_fields = 1,
+    .fields = {
+      { "sequence", 0, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_POWER_ON_AUX_SEQUENCE] = {
+    .name = "POWER_ON_AUX_SEQUENCE",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 2,
+    .num_fields = 1,
+    .fields = {
+      { "sequence", 0, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_DRIVE_OUTPUT] = {
+    .name = "DRIVE_OUTPUT",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 2,
+    .num_fields = 1,
+    .fields = {
+      { "drive_output", 0, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_SET_EBRAKE_STATE] = {
+    .name = "SET_EBRAKE_STATE",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 1,
+    .num_fields = 1,
+    .fields = {
+      { "ebrake_state", 0, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_OVUV_DCDC_AUX] = {
+    .name = "OVUV_DCDC_AUX",
+    .source = SYSTEM_CAN_DEVICE_POWER_DISTRIBUTION_REAR,
+    .dlc = 4,
+    .num_fields = 4,
+    .fields = {
+      { "dcdc_ov_flag", 0, 1 },
+      { "dcdc_uv_flag", 1, 1 },
+      { "aux_bat_ov_flag", 2, 1 },
+      { "aux_bat_uv_flag", 3, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_MC_ERROR_LIMITS] = {
+    .name = "MC_ERROR_LIMITS",
+    .source = SYSTEM_CAN_DEVICE_MOTOR_CONTROLLER,
+    .dlc = 4,
+    .num_fields = 2,
+    .fields = {
+      { "error_id", 0, 2 },
+      { "limits", 2, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_PEDAL_OUTPUT] = {
+    .name = "PEDAL_OUTPUT",
+    .source = SYSTEM_CAN_DEVICE_PEDAL,
+    .dlc = 8,
+    .num_fields = 2,
+    .fields = {
+      { "throttle_output", 0, 4 },
+      { "brake_output", 4, 4 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_CRUISE_TARGET] = {
+    .name = "CRUISE_TARGET",
+    .source = SYSTEM_CAN_DEVICE_STEERING,
+    .dlc = 1,
+    .num_fields = 1,
+    .fields = {
+      { "target_speed", 0, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_BRAKE] = {
+    .name = "BRAKE",
+    .source = SYSTEM_CAN_DEVICE_PEDAL,
+    .dlc = 2,
+    .num_fields = 1,
+    .fields = {
+      { "brake_state", 0, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_FRONT_POWER] = {
+    .name = "FRONT_POWER",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 2,
+    .num_fields = 1,
+    .fields = {
+      { "power_bitset", 0, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_DRIVE_STATE] = {
+    .name = "DRIVE_STATE",
+    .source = SYSTEM_CAN_DEVICE_MOTOR_CONTROLLER,
+    .dlc = 2,
+    .num_fields = 1,
+    .fields = {
+      { "drive_state", 0, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_LIGHTS_SYNC] = {
+    .name = "LIGHTS_SYNC",
+    .source = SYSTEM_CAN_DEVICE_POWER_DISTRIBUTION_REAR,
+    .dlc = 0,
+    .num_fields = 0,
+  },
+  [SYSTEM_CAN_MESSAGE_LIGHTS] = {
+    .name = "LIGHTS",
+    .source = SYSTEM_CAN_DEVICE_STEERING,
+    .dlc = 2,
+    .num_fields = 2,
+    .fields = {
+      { "lights_id", 0, 1 },
+      { "state", 1, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_HORN] = {
+    .name = "HORN",
+    .source = SYSTEM_CAN_DEVICE_STEERING,
+    .dlc = 1,
+    .num_fields = 1,
+    .fields = {
+      { "state", 0, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_GET_CHARGER_CONNECTION_STATE] = {
+    .name = "GET_CHARGER_CONNECTION_STATE",
+    .source = SYSTEM_CAN_DEVICE_CHARGER,
+    .dlc = 1,
+    .num_fields = 1,
+    .fields = {
+      { "is_connected", 0, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_SET_CHARGER_RELAY] = {
+    .name = "SET_CHARGER_RELAY",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 1,
+    .num_fields = 1,
+    .fields = {
+      { "state", 0, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_BEGIN_PRECHARGE] = {
+    .name = "BEGIN_PRECHARGE",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 0,
+    .num_fields = 0,
+  },
+  [SYSTEM_CAN_MESSAGE_PRECHARGE_COMPLETED] = {
+    .name = "PRECHARGE_COMPLETED",
+    .source = SYSTEM_CAN_DEVICE_MOTOR_CONTROLLER,
+    .dlc = 0,
+    .num_fields = 0,
+  },
+  [SYSTEM_CAN_MESSAGE_HAZARD] = {
+    .name = "HAZARD",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 1,
+    .num_fields = 1,
+    .fields = {
+      { "state", 0, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_DISCHARGE_PRECHARGE] = {
+    .name = "DISCHARGE_PRECHARGE",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 0,
+    .num_fields = 0,
+  },
+  [SYSTEM_CAN_MESSAGE_BATTERY_VT] = {
+    .name = "BATTERY_VT",
+    .source = SYSTEM_CAN_DEVICE_BMS_CARRIER,
+    .dlc = 6,
+    .num_fields = 3,
+    .fields = {
+      { "module_id", 0, 2 },
+      { "voltage", 2, 2 },
+      { "temperature", 4, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_BATTERY_AGGREGATE_VC] = {
+    .name = "BATTERY_AGGREGATE_VC",
+    .source = SYSTEM_CAN_DEVICE_BMS_CARRIER,
+    .dlc = 8,
+    .num_fields = 2,
+    .fields = {
+      { "voltage", 0, 4 },
+      { "current", 4, 4 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_STATE_TRANSITION_FAULT] = {
+    .name = "STATE_TRANSITION_FAULT",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 4,
+    .num_fields = 2,
+    .fields = {
+      { "state_machine", 0, 2 },
+      { "fault_reason", 2, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_MOTOR_CONTROLLER_VC] = {
+    .name = "MOTOR_CONTROLLER_VC",
+    .source = SYSTEM_CAN_DEVICE_MOTOR_CONTROLLER,
+    .dlc = 8,
+    .num_fields = 4,
+    .fields = {
+      { "mc_voltage_1", 0, 2 },
+      { "mc_current_1", 2, 2 },
+      { "mc_voltage_2", 4, 2 },
+      { "mc_current_2", 6, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_MOTOR_VELOCITY] = {
+    .name = "MOTOR_VELOCITY",
+    .source = SYSTEM_CAN_DEVICE_MOTOR_CONTROLLER,
+    .dlc = 4,
+    .num_fields = 2,
+    .fields = {
+      { "vehicle_velocity_left", 0, 2 },
+      { "vehicle_velocity_right", 2, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_MOTOR_DEBUG] = {
+    .name = "MOTOR_DEBUG",
+    .source = SYSTEM_CAN_DEVICE_MOTOR_CONTROLLER,
+    .dlc = 8,
+    .num_fields = 1,
+    .fields = {
+      { "data", 0, 8 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_MOTOR_TEMPS] = {
+    .name = "MOTOR_TEMPS",
+    .source = SYSTEM_CAN_DEVICE_MOTOR_CONTROLLER,
+    .dlc = 8,
+    .num_fields = 2,
+    .fields = {
+      { "motor_temp_l", 0, 4 },
+      { "motor_temp_r", 4, 4 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_MOTOR_AMP_HR] = {
+    .name = "MOTOR_AMP_HR",
+    .source = SYSTEM_CAN_DEVICE_MOTOR_CONTROLLER,
+    .dlc = 8,
+    .num_fields = 2,
+    .fields = {
+      { "motor_amp_hr_l", 0, 4 },
+      { "motor_amp_hr_r", 4, 4 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_ODOMETER] = {
+    .name = "ODOMETER",
+    .source = SYSTEM_CAN_DEVICE_MOTOR_CONTROLLER,
+    .dlc = 4,
+    .num_fields = 1,
+    .fields = {
+      { "odometer_val", 0, 4 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_CRUISE_CONTROL_COMMAND] = {
+    .name = "CRUISE_CONTROL_COMMAND",
+    .source = SYSTEM_CAN_DEVICE_STEERING,
+    .dlc = 1,
+    .num_fields = 1,
+    .fields = {
+      { "command", 0, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_BATTERY_SOC] = {
+    .name = "BATTERY_SOC",
+    .source = SYSTEM_CAN_DEVICE_BMS_CARRIER,
+    .dlc = 8,
+    .num_fields = 2,
+    .fields = {
+      { "soc", 0, 4 },
+      { "energy", 4, 4 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_AUX_DCDC_VC] = {
+    .name = "AUX_DCDC_VC",
+    .source = SYSTEM_CAN_DEVICE_POWER_DISTRIBUTION_REAR,
+    .dlc = 8,
+    .num_fields = 4,
+    .fields = {
+      { "aux_voltage", 0, 2 },
+      { "aux_current", 2, 2 },
+      { "dcdc_voltage", 4, 2 },
+      { "dcdc_current", 6, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_DCDC_TEMPS] = {
+    .name = "DCDC_TEMPS",
+    .source = SYSTEM_CAN_DEVICE_POWER_DISTRIBUTION_REAR,
+    .dlc = 4,
+    .num_fields = 2,
+    .fields = {
+      { "temp_1", 0, 2 },
+      { "temp_2", 2, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_CHARGER_INFO] = {
+    .name = "CHARGER_INFO",
+    .source = SYSTEM_CAN_DEVICE_CHARGER,
+    .dlc = 6,
+    .num_fields = 3,
+    .fields = {
+      { "current", 0, 2 },
+      { "voltage", 2, 2 },
+      { "status_bitset", 4, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_REQUEST_TO_CHARGE] = {
+    .name = "REQUEST_TO_CHARGE",
+    .source = SYSTEM_CAN_DEVICE_CHARGER,
+    .dlc = 0,
+    .num_fields = 0,
+  },
+  [SYSTEM_CAN_MESSAGE_ALLOW_CHARGING] = {
+    .name = "ALLOW_CHARGING",
+    .source = SYSTEM_CAN_DEVICE_CENTRE_CONSOLE,
+    .dlc = 0,
+    .num_fields = 0,
+  },
+  [SYSTEM_CAN_MESSAGE_CHARGER_CONNECTED_STATE] = {
+    .name = "CHARGER_CONNECTED_STATE",
+    .source = SYSTEM_CAN_DEVICE_CHARGER,
+    .dlc = 1,
+    .num_fields = 1,
+    .fields = {
+      { "is_connected", 0, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_LINEAR_ACCELERATION] = {
+    .name = "LINEAR_ACCELERATION",
+    .source = SYSTEM_CAN_DEVICE_IMU,
+    .dlc = 0,
+    .num_fields = 0,
+  },
+  [SYSTEM_CAN_MESSAGE_ANGULAR_ROTATION] = {
+    .name = "ANGULAR_ROTATION",
+    .source = SYSTEM_CAN_DEVICE_IMU,
+    .dlc = 0,
+    .num_fields = 0,
+  },
+  [SYSTEM_CAN_MESSAGE_CHARGER_FAULT] = {
+    .name = "CHARGER_FAULT",
+    .source = SYSTEM_CAN_DEVICE_CHARGER,
+    .dlc = 1,
+    .num_fields = 1,
+    .fields = {
+      { "fault", 0, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_FRONT_CURRENT_MEASUREMENT] = {
+    .name = "FRONT_CURRENT_MEASUREMENT",
+    .source = SYSTEM_CAN_DEVICE_POWER_DISTRIBUTION_FRONT,
+    .dlc = 4,
+    .num_fields = 2,
+    .fields = {
+      { "current_id", 0, 2 },
+      { "current", 2, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_REAR_CURRENT_MEASUREMENT] = {
+    .name = "REAR_CURRENT_MEASUREMENT",
+    .source = SYSTEM_CAN_DEVICE_POWER_DISTRIBUTION_REAR,
+    .dlc = 4,
+    .num_fields = 2,
+    .fields = {
+      { "current_id", 0, 2 },
+      { "current", 2, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_AUX_BATTERY_STATUS] = {
+    .name = "AUX_BATTERY_STATUS",
+    .source = SYSTEM_CAN_DEVICE_POWER_SELECTION,
+    .dlc = 6,
+    .num_fields = 3,
+    .fields = {
+      { "aux_battery_volt", 0, 2 },
+      { "aux_battery_temp", 2, 2 },
+      { "dcdc_status", 4, 2 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_BATTERY_FAN_STATE] = {
+    .name = "BATTERY_FAN_STATE",
+    .source = SYSTEM_CAN_DEVICE_BMS_CARRIER,
+    .dlc = 8,
+    .num_fields = 8,
+    .fields = {
+      { "fan_1", 0, 1 },
+      { "fan_2", 1, 1 },
+      { "fan_3", 2, 1 },
+      { "fan_4", 3, 1 },
+      { "fan_5", 4, 1 },
+      { "fan_6", 5, 1 },
+      { "fan_7", 6, 1 },
+      { "fan_8", 7, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_BATTERY_RELAY_STATE] = {
+    .name = "BATTERY_RELAY_STATE",
+    .source = SYSTEM_CAN_DEVICE_BMS_CARRIER,
+    .dlc = 2,
+    .num_fields = 2,
+    .fields = {
+      { "hv", 0, 1 },
+      { "gnd", 1, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_SOLAR_DATA] = {
+    .name = "SOLAR_DATA",
+    .source = SYSTEM_CAN_DEVICE_SOLAR,
+    .dlc = 8,
+    .num_fields = 2,
+    .fields = {
+      { "data_point_type", 0, 4 },
+      { "data_value", 4, 4 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_SOLAR_FAULT] = {
+    .name = "SOLAR_FAULT",
+    .source = SYSTEM_CAN_DEVICE_SOLAR,
+    .dlc = 2,
+    .num_fields = 2,
+    .fields = {
+      { "fault", 0, 1 },
+      { "fault_data", 1, 1 },
+    },
+  },
+  [SYSTEM_CAN_MESSAGE_BABYDRIVER] = {
+    .name = "BABYDRIVER",
+    .source = SYSTEM_CAN_DEVICE_BABYDRIVER,
+    .dlc = 8,
+    .num_fields = 8,
+    .fields = {
+      { "id", 0, 1 },
+      { "data0", 1, 1 },
+      { "data1", 2, 1 },
+      { "data2", 3, 1 },
+      { "data3", 4, 1 },
+      { "data4", 5, 1 },
+      { "data5", 6, 1 },
+      { "data6", 7, 1 },
+    },
+  },
+};
+
+const CanMsgDef *can_msg_table_get(CanMessageId msg_id) {
+  if (msg_id >= CAN_MSG_MAX_IDS || s_msg_defs[msg_id].name == NULL) {
+    return NULL;
+  }
+  return &s_msg_defs[msg_id];
+}
+
+CanMessageId can_msg_table_find(const char *name) {
+  for (CanMessageId msg_id = 0; msg_id < CAN_MSG_MAX_IDS; msg_id++) {
+    if (s_msg_defs[msg_id].name != NULL && strcmp(s_msg_defs[msg_id].name, name) == 0) {
+      return msg_id;
+    }
+  }
+  return CAN_MSG_INVALID_ID;
+}
+
+const char *can_msg_table_device_name(uint16_t device) {
+  if (device >= CAN_MSG_MAX_DEVICES) {
+    return NULL;
+  }
+  return s_device_names[device];
+}
+
+uint64_t can_msg_table_get_field(const CanMsgFieldDef *field, const uint8_t *data) {
+  uint64_t value = 0;
+  for (uint8_t i = 0; i < field->width; i++) {
+    value |= (uint64_t)data[field->offset + i] << (8 * i);
+  }
+  return value;
+}
@@ -0,0 +1,54 @@
+#pragma once
+// Q-format fixed-point arithmetic
+//
+// A fixed-point value is an int32_t with |frac_bits| fractional bits: Qm.n with n = frac_bits, so
+// Q16.16 stores 1.5 as 0x18000. The STM32F0's Cortex-M0 has no FPU, so these stand in for
+// soft-float math on hot paths.
+//
+// Every operation computes in 64 bits and saturates at the int32_t limits instead of wrapping.
+// Results are rounded to nearest (halves away from zero) unless noted otherwise.
+// |frac_bits| can be at most FIXED_MAX_FRAC_BITS.
+#include <stdint.h>
+
+#define FIXED_Q16_FRAC_BITS 16
+#define FIXED_MAX_FRAC_BITS 30
+
+#define FIXED_ONE(frac_bits) ((int32_t)1 << (frac_bits))
+
+// Clamp a 64-bit intermediate to the int32_t range.
+int32_t fixed_saturate(int64_t value);
+
+int32_t fixed_from_int(int32_t value, uint8_t frac_bits);
+
+// Rounds to the nearest integer.
+int32_t fixed_to_int(int32_t value, uint8_t frac_bits);
+
+// Rounds toward zero, like a float to integer cast.
+int32_t fixed_trunc(int32_t value, uint8_t frac_bits);
+
+// The operands can have different formats: the result has the fractional bits of a * b less
+// |frac_bits|, e.g. Q24 times Q16 with 24 gives Q16.
+int32_t fixed_mul(int32_t a, int32_t b, uint8_t frac_bits);
+
+// Dividing by zero saturates with the sign of |a|.
+int32_t fixed_div(int32_t a, int32_t b, uint8_t frac_bits);
+
+// a + (b - a) * t, where |t| has |frac_bits| fractional bits and isn't limited to [0, 1].
+int32_t fixed_lerp(int32_t a, int32_t b, int32_t t, uint8_t frac_bits);
+
+// value * num / den without intermediate overflow, for scaling by a rational constant.
+// A zero |den| saturates with the sign of value * num.
+int32_t fixed_scale(int32_t value, int32_t num, int32_t den);
+
+// Linearly maps |value| from [in_lo, in_hi] to [out_lo, out_hi]. Values outside of the input range
+// are extrapolated, not clamped. |value - in_lo| and |out_hi - out_lo| must not both be 2^31 or
+// more.
+int32_t fixed_map(int32_t value, int32_t in_lo, int32_t in_hi, int32_t out_lo, int32_t out_hi);
+
+// As fixed_map, but the offset into the output range rounds toward zero like integer division.
+int32_t fixed_map_trunc(int32_t value, int32_t in_lo, int32_t in_hi, int32_t out_lo,
+                        int32_t out_hi);
+
+// Converts the bits of an IEEE 754 single, e.g. a float received over CAN, without any float math.
+// Rounds toward zero like a cast. NaN converts to 0.
+int32_t fixed_from_float_bits(uint32_t bits, uint8_t frac_bits);
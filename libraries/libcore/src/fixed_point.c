@@ -0,0 +1,123 @@
+#include "fixed_point.h"
+
+#include <stdbool.h>
+
+#define FIXED_FLOAT_EXP_BIAS 127
+#define FIXED_FLOAT_MANTISSA_BITS 23
+#define FIXED_FLOAT_EXP_MASK 0xFF
+
+// num / den rounded to nearest, halves away from zero
+static int64_t prv_div_round(int64_t num, int64_t den) {
+  if (den < 0) {
+    num = -num;
+    den = -den;
+  }
+  return (num + ((num < 0) ? -den / 2 : den / 2)) / den;
+}
+
+// value / 2^bits rounded to nearest, halves away from zero, without a 64-bit division
+static int64_t prv_shift_round(int64_t value, uint8_t bits) {
+  if (bits == 0) {
+    return value;
+  }
+  int64_t half = (int64_t)1 << (bits - 1);
+  return (value < 0) ? -((half - value) >> bits) : ((value + half) >> bits);
+}
+
+static int32_t prv_saturate_sign(bool negative) {
+  return negative ? INT32_MIN : INT32_MAX;
+}
+
+int32_t fixed_saturate(int64_t value) {
+  if (value > INT32_MAX) {
+    return INT32_MAX;
+  } else if (value < INT32_MIN) {
+    return INT32_MIN;
+  }
+  return (int32_t)value;
+}
+
+int32_t fixed_from_int(int32_t value, uint8_t frac_bits) {
+  return fixed_saturate((int64_t)value * FIXED_ONE(frac_bits));
+}
+
+int32_t fixed_to_int(int32_t value, uint8_t frac_bits) {
+  return (int32_t)prv_shift_round(value, frac_bits);
+}
+
+int32_t fixed_trunc(int32_t value, uint8_t frac_bits) {
+  return value / FIXED_ONE(frac_bits);
+}
+
+int32_t fixed_mul(int32_t a, int32_t b, uint8_t frac_bits) {
+  return fixed_saturate(prv_shift_round((int64_t)a * b, frac_bits));
+}
+
+int32_t fixed_div(int32_t a, int32_t b, uint8_t frac_bits) {
+  if (b == 0) {
+    return prv_saturate_sign(a < 0);
+  }
+  return fixed_saturate(prv_div_round((int64_t)a * FIXED_ONE(frac_bits), b));
+}
+
+int32_t fixed_lerp(int32_t a, int32_t b, int32_t t, uint8_t frac_bits) {
+  int64_t delta = prv_shift_round(((int64_t)b - a) * t, frac_bits);
+  return fixed_saturate(a + delta);
+}
+
+int32_t fixed_scale(int32_t value, int32_t num, int32_t den) {
+  int64_t product = (int64_t)value * num;
+  if (den == 0) {
+    return prv_saturate_sign(product < 0);
+  }
+  return fixed_saturate(prv_div_round(product, den));
+}
+
+static int32_t prv_map(int32_t value, int32_t in_lo, int32_t in_hi, int32_t out_lo, int32_t out_hi,
+                       bool round) {
+  int64_t in_range = (int64_t)in_hi - in_lo;
+  int64_t product = ((int64_t)value - in_lo) * ((int64_t)out_hi - out_lo);
+  if (in_range == 0) {
+    return prv_saturate_sign(product < 0);
+  }
+  return fixed_saturate(out_lo + (round ? prv_div_round(product, in_range) : product / in_range));
+}
+
+int32_t fixed_map(int32_t value, int32_t in_lo, int32_t in_hi, int32_t out_lo, int32_t out_hi) {
+  return prv_map(value, in_lo, in_hi, out_lo, out_hi, true);
+}
+
+int32_t fixed_map_trunc(int32_t value, int32_t in_lo, int32_t in_hi, int32_t out_lo,
+                        int32_t out_hi) {
+  return prv_map(value, in_lo, in_hi, out_lo, out_hi, false);
+}
+
+int32_t fixed_from_float_bits(uint32_t bits, uint8_t frac_bits) {
+  bool negative = (bits >> 31) != 0;
+  int32_t exp = (int32_t)((bits >> FIXED_FLOAT_MANTISSA_BITS) & FIXED_FLOAT_EXP_MASK);
+  uint32_t mantissa = bits & ((1u << FIXED_FLOAT_MANTISSA_BITS) - 1);
+
+  if (exp == FIXED_FLOAT_EXP_MASK) {
+    // Infinity saturates, NaN has no sensible value
+    return (mantissa != 0) ? 0 : prv_saturate_sign(negative);
+  } else if (exp == 0) {
+    // Zero and denormals, which are far below any useful resolution
+    return 0;
+  }
+
+  // value = 1.mantissa * 2^(exp - bias), so shift the integer mantissa into place
+  uint32_t significand = mantissa | (1u << FIXED_FLOAT_MANTISSA_BITS);
+  int32_t shift = exp - FIXED_FLOAT_EXP_BIAS - FIXED_FLOAT_MANTISSA_BITS + frac_bits;
+  int64_t magnitude = 0;
+  if (shift >= 0) {
+    // The significand has 24 bits, so anything shifted past bit 31 saturates anyway
+    if (shift > 31 - FIXED_FLOAT_MANTISSA_BITS) {
+      return prv_saturate_sign(negative);
+    }
+    magnitude = (int64_t)significand << shift;
+  } else if (shift > -32) {
+    magnitude = significand >> -shift;
+  }
+
+  return fixed_saturate(negative ? -magnitude : magnitude);
+}
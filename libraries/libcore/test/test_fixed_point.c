@@ -0,0 +1,125 @@
+#include "fixed_point.h"
+
+#include <string.h>
+
+#include "misc.h"
+#include "unity.h"
+
+#define TEST_Q FIXED_Q16_FRAC_BITS
+
+// Largest error allowed against the double result, in units of the last fractional bit
+#define TEST_FIXED_POINT_TOLERANCE 1
+
+static const double s_values[] = { 0.0, 1.0, -1.0, 0.5, -0.5, 3.14159, -2.71828, 123.456, -987.654,
+                                   0.0001, 12345.678 };
+
+static int32_t prv_to_fixed(double value) {
+  double scaled = value * FIXED_ONE(TEST_Q);
+  return (int32_t)(scaled + ((scaled < 0) ? -0.5 : 0.5));
+}
+
+static uint32_t prv_float_bits(float value) {
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+void setup_test(void) {}
+
+void teardown_test(void) {}
+
+void test_fixed_point_int_conversion(void) {
+  TEST_ASSERT_EQUAL(0x30000, fixed_from_int(3, TEST_Q));
+  TEST_ASSERT_EQUAL(-0x30000, fixed_from_int(-3, TEST_Q));
+  TEST_ASSERT_EQUAL(INT32_MAX, fixed_from_int(40000, TEST_Q));
+  TEST_ASSERT_EQUAL(INT32_MIN, fixed_from_int(-40000, TEST_Q));
+
+  // 2.5 and -2.5 round away from zero, truncation goes toward it
+  TEST_ASSERT_EQUAL(3, fixed_to_int(0x28000, TEST_Q));
+  TEST_ASSERT_EQUAL(-3, fixed_to_int(-0x28000, TEST_Q));
+  TEST_ASSERT_EQUAL(2, fixed_to_int(0x27FFF, TEST_Q));
+  TEST_ASSERT_EQUAL(2, fixed_trunc(0x2FFFF, TEST_Q));
+  TEST_ASSERT_EQUAL(-2, fixed_trunc(-0x2FFFF, TEST_Q));
+}
+
+void test_fixed_point_mul_div(void) {
+  for (size_t i = 0; i < SIZEOF_ARRAY(s_values); i++) {
+    for (size_t j = 0; j < SIZEOF_ARRAY(s_values); j++) {
+      int32_t a = prv_to_fixed(s_values[i]);
+      int32_t b = prv_to_fixed(s_values[j]);
+      double fa = (double)a / FIXED_ONE(TEST_Q);
+      double fb = (double)b / FIXED_ONE(TEST_Q);
+
+      double product = fa * fb;
+      if (product < 32767.0 && product > -32768.0) {
+        TEST_ASSERT_INT32_WITHIN(TEST_FIXED_POINT_TOLERANCE, prv_to_fixed(product),
+                                 fixed_mul(a, b, TEST_Q));
+      }
+      if (b != 0 && fa / fb < 32767.0 && fa / fb > -32768.0) {
+        TEST_ASSERT_INT32_WITHIN(TEST_FIXED_POINT_TOLERANCE, prv_to_fixed(fa / fb),
+                                 fixed_div(a, b, TEST_Q));
+      }
+    }
+  }
+}
+
+void test_fixed_point_saturation(void) {
+  int32_t big = fixed_from_int(30000, TEST_Q);
+  TEST_ASSERT_EQUAL(INT32_MAX, fixed_mul(big, big, TEST_Q));
+  TEST_ASSERT_EQUAL(INT32_MIN, fixed_mul(big, -big, TEST_Q));
+  TEST_ASSERT_EQUAL(INT32_MAX, fixed_div(big, FIXED_ONE(TEST_Q) / 1000, TEST_Q));
+
+  TEST_ASSERT_EQUAL(INT32_MAX, fixed_div(1, 0, TEST_Q));
+  TEST_ASSERT_EQUAL(INT32_MIN, fixed_div(-1, 0, TEST_Q));
+  TEST_ASSERT_EQUAL(INT32_MAX, fixed_scale(1, 1, 0));
+  TEST_ASSERT_EQUAL(INT32_MIN, fixed_scale(INT32_MAX, INT32_MAX, -1));
+  TEST_ASSERT_EQUAL(INT32_MAX, fixed_saturate((int64_t)INT32_MAX + 1));
+}
+
+void test_fixed_point_lerp_scale_map(void) {
+  int32_t a = fixed_from_int(10, TEST_Q);
+  int32_t b = fixed_from_int(20, TEST_Q);
+  TEST_ASSERT_EQUAL(a, fixed_lerp(a, b, 0, TEST_Q));
+  TEST_ASSERT_EQUAL(b, fixed_lerp(a, b, FIXED_ONE(TEST_Q), TEST_Q));
+  TEST_ASSERT_EQUAL(fixed_from_int(15, TEST_Q), fixed_lerp(a, b, FIXED_ONE(TEST_Q) / 2, TEST_Q));
+  TEST_ASSERT_EQUAL(fixed_from_int(25, TEST_Q),
+                    fixed_lerp(a, b, FIXED_ONE(TEST_Q) * 3 / 2, TEST_Q));
+
+  // 2.5V full scale on a 20-bit signed converter, as the ADS1259 does it
+  TEST_ASSERT_EQUAL(2500000, fixed_scale((1 << 19) - 1, 2500000, (1 << 19) - 1));
+  TEST_ASSERT_EQUAL(5, fixed_scale(1, 2500000, (1 << 19) - 1));
+  TEST_ASSERT_EQUAL(-1250000, fixed_scale(-(1 << 18), 2500000, 1 << 19));
+
+  TEST_ASSERT_EQUAL(50, fixed_map(150, 100, 200, 0, 100));
+  TEST_ASSERT_EQUAL(-50, fixed_map(50, 100, 200, 0, 100));
+  TEST_ASSERT_EQUAL(75, fixed_map(25, 0, 100, 100, 0));
+  // 1/3 rounds down, 2/3 rounds up
+  TEST_ASSERT_EQUAL(33, fixed_map(1, 0, 3, 0, 100));
+  TEST_ASSERT_EQUAL(67, fixed_map(2, 0, 3, 0, 100));
+
+  // Truncation rounds toward zero on both sides of the input range
+  TEST_ASSERT_EQUAL(66, fixed_map_trunc(2, 0, 3, 0, 100));
+  TEST_ASSERT_EQUAL(-66, fixed_map_trunc(-2, 0, 3, 0, 100));
+  TEST_ASSERT_EQUAL(34, fixed_map_trunc(2, 0, 3, 100, 0));
+  TEST_ASSERT_EQUAL(50, fixed_map_trunc(150, 100, 200, 0, 100));
+}
+
+// Decoding float bits should match a float cast exactly, since both truncate.
+void test_fixed_point_from_float_bits(void) {
+  for (size_t i = 0; i < SIZEOF_ARRAY(s_values); i++) {
+    float value = (float)s_values[i];
+    int32_t expected = (int32_t)(value * FIXED_ONE(TEST_Q));
+    TEST_ASSERT_EQUAL(expected, fixed_from_float_bits(prv_float_bits(value), TEST_Q));
+    TEST_ASSERT_EQUAL((int32_t)value, fixed_from_float_bits(prv_float_bits(value), 0));
+  }
+
+  TEST_ASSERT_EQUAL(INT32_MAX, fixed_from_float_bits(prv_float_bits(40000.0f), TEST_Q));
+  TEST_ASSERT_EQUAL(INT32_MIN, fixed_from_float_bits(prv_float_bits(-40000.0f), TEST_Q));
+  TEST_ASSERT_EQUAL(INT32_MIN, fixed_from_float_bits(prv_float_bits(-32768.0f), TEST_Q));
+  TEST_ASSERT_EQUAL(0, fixed_from_float_bits(prv_float_bits(1e-10f), TEST_Q));
+  TEST_ASSERT_EQUAL(0, fixed_from_float_bits(prv_float_bits(-0.0f), TEST_Q));
+  // Infinity and NaN
+  TEST_ASSERT_EQUAL(INT32_MAX, fixed_from_float_bits(0x7F800000, TEST_Q));
+  TEST_ASSERT_EQUAL(INT32_MIN, fixed_from_float_bits(0xFF800000, TEST_Q));
+  TEST_ASSERT_EQUAL(0, fixed_from_float_bits(0x7FC00000, TEST_Q));
+}
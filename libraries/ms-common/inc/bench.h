@@ -0,0 +1,47 @@
+#pragma once
+// Micro-benchmark harness
+//
+// Benchmarks live next to unit tests as <test dir>/bench_*.c and are built into Unity runners
+// whose cases are the functions starting with "bench". They get setup_test and teardown_test like
+// unit tests do. Run them with `make bench [PL] [PR|LI]`.
+//
+// Each case times an operation with BENCH_RUN, which reports one machine-readable line:
+//   BENCH,<file>,<case>,<ops per sample>,<samples>,<min>,<median>,<p99>,<unit>
+// where the statistics are per operation. `make bench` collects these lines into a CSV file that
+// can be diffed between commits.
+//
+// Times are in TSC ticks on x86 (nanoseconds if there's no TSC) and core clock cycles on STM32.
+// Keep |ops_per_sample| small enough that a sample takes well under 300ms on STM32, where the
+// cycle counter is the 24-bit SysTick.
+#include <stdint.h>
+
+#include "unity.h"
+
+// Number of timed samples per benchmark, after one untimed warmup sample
+#define BENCH_NUM_SAMPLES 256
+
+// Times |ops_per_sample| calls to |op| per sample.
+typedef void (*BenchOp)(void *context);
+
+#define BENCH_RUN(op, context, ops_per_sample) \
+  bench_run(Unity.TestFile, Unity.CurrentTestName, (op), (context), (ops_per_sample))
+
+typedef struct BenchResult {
+  uint32_t min;
+  uint32_t median;
+  uint32_t p99;
+} BenchResult;
+
+// Run and report a benchmark. Prefer BENCH_RUN, which names it after the current Unity case.
+BenchResult bench_run(const char *file, const char *name, BenchOp op, void *context,
+                      uint32_t ops_per_sample);
+
+// Platform-specific clock used to time samples.
+void bench_clock_init(void);
+
+uint32_t bench_clock_now(void);
+
+// Ticks from |start| to |end|, accounting for the counter's direction and width.
+uint32_t bench_clock_elapsed(uint32_t start, uint32_t end);
+
+const char *bench_clock_unit(void);
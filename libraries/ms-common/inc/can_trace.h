@@ -0,0 +1,117 @@
+#pragma once
+// Binary CAN trace format
+//
+// A trace is a fixed-size header followed by fixed-size records, one per CAN frame, in
+// non-decreasing timestamp order. Records are grouped into chunks of CAN_TRACE_CHUNK_RECORDS. When
+// a trace is closed cleanly, an index holding the first timestamp of every chunk is appended,
+// followed by a footer. A trace that was cut short (or streamed) has no index, and readers rebuild
+// it from the records.
+//
+//   | CanTraceHeader | CanTraceRecord * n | uint64_t chunk index * num chunks | CanTraceFooter |
+//
+// Everything is little-endian and naturally aligned so a trace can be mmapped and used in place.
+//
+// The writer works with any stdio stream. Reading and replaying traces is only built on x86.
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "status.h"
+
+#define CAN_TRACE_MAGIC 0x5443534D  // "MSCT"
+#define CAN_TRACE_FOOTER_MAGIC 0x4943534D  // "MSCI"
+#define CAN_TRACE_VERSION 1
+
+#define CAN_TRACE_CHUNK_RECORDS 256
+
+// Set in |CanTraceRecord.raw_id| for 29-bit IDs, matching SocketCAN's CAN_EFF_FLAG
+#define CAN_TRACE_ID_EXTENDED_FLAG 0x80000000
+#define CAN_TRACE_ID_EXTENDED_MASK 0x1FFFFFFF
+#define CAN_TRACE_ID_STANDARD_MASK 0x7FF
+
+// |CanTraceRecord.flags|
+#define CAN_TRACE_FLAG_TX (1 << 0)  // transmitted by the recording node rather than received
+
+typedef struct CanTraceHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_size;
+  uint32_t chunk_records;
+  uint32_t reserved;
+} CanTraceHeader;
+
+typedef struct CanTraceRecord {
+  uint64_t timestamp_us;
+  uint32_t raw_id;
+  uint8_t dlc;
+  uint8_t flags;
+  uint8_t reserved[2];
+  uint8_t data[8];
+} CanTraceRecord;
+
+typedef struct CanTraceFooter {
+  uint32_t magic;
+  uint32_t num_chunks;
+  uint64_t num_records;
+} CanTraceFooter;
+
+typedef struct CanTraceWriter {
+  FILE *stream;
+  uint64_t num_records;
+  // Caller-provided chunk index, or NULL to write an unindexed trace
+  uint64_t *chunk_index;
+  size_t max_chunks;
+} CanTraceWriter;
+
+typedef struct CanTraceReader {
+  const uint8_t *map;
+  size_t map_size;
+  const CanTraceRecord *records;
+  size_t num_records;
+  const uint64_t *chunk_index;
+  size_t num_chunks;
+  // Set if the index had to be rebuilt and must be freed on close
+  uint64_t *owned_index;
+} CanTraceReader;
+
+typedef struct CanTraceReplaySettings {
+  // Playback speed in percent of the original: 200 replays twice as fast. 0 replays with no delay.
+  uint32_t speed_percent;
+  // Whether to replay frames the recording node transmitted itself
+  bool include_tx;
+} CanTraceReplaySettings;
+
+// Fill in |record| for a frame. |data| may be NULL if |dlc| is 0.
+void can_trace_record_init(CanTraceRecord *record, uint64_t timestamp_us, uint32_t id,
+                           bool extended, const uint8_t *data, size_t dlc, uint8_t flags);
+
+// Unpack the CAN ID from |record|.
+void can_trace_record_get_id(const CanTraceRecord *record, uint32_t *id, bool *extended);
+
+// Start a trace on |stream| by writing the header. If |chunk_index| is not NULL, it must hold
+// |max_chunks| entries and the index is written on close as long as the trace fits.
+StatusCode can_trace_writer_init(CanTraceWriter *writer, FILE *stream, uint64_t *chunk_index,
+                                 size_t max_chunks);
+
+// Append a record. Timestamps must not decrease. The stream is flushed after every chunk.
+StatusCode can_trace_writer_append(CanTraceWriter *writer, const CanTraceRecord *record);
+
+// Write the index and footer (if there's an index) and flush. The stream is left open.
+StatusCode can_trace_writer_close(CanTraceWriter *writer);
+
+// Returns the index of the first record with a timestamp at or after |timestamp_us|, or
+// |num_records| if there is none. |chunk_index| holds the first timestamp of every chunk.
+size_t can_trace_find(const CanTraceRecord *records, size_t num_records,
+                      const uint64_t *chunk_index, size_t num_chunks, uint64_t timestamp_us);
+
+// Map the trace at |path| read-only. x86 only.
+StatusCode can_trace_reader_open(CanTraceReader *reader, const char *path);
+
+// Returns the index of the first record at or after |timestamp_us|.
+size_t can_trace_reader_seek(const CanTraceReader *reader, uint64_t timestamp_us);
+
+void can_trace_reader_close(CanTraceReader *reader);
+
+// Write every record of |reader| to the x86 CAN interface with the original relative timing,
+// scaled by |settings->speed_percent|. Blocks until the trace is done. x86 only.
+StatusCode can_trace_replay(const CanTraceReader *reader, const CanTraceReplaySettings *settings);
@@ -0,0 +1,69 @@
+#pragma once
+// Event queue instrumentation
+//
+// Build with DEFINE="EVENT_QUEUE_STATS" to have the event queue record:
+// - the high-water mark of each priority's FIFO
+// - how many times each event ID was dropped because its FIFO was full
+// - a log2 histogram of how long events wait between being raised and processed, measured with
+//   the soft timer clock (soft timers must be initialized for latencies to be meaningful)
+//
+// Without EVENT_QUEUE_STATS the event queue doesn't call into this module and its sources compile
+// to nothing, so EVENT_QUEUE_SIZE can be sized from a debug build without costing anything in a
+// normal one. The functions below only exist in builds with EVENT_QUEUE_STATS.
+//
+// The stats can be logged to the console with event_queue_stats_dump(), or sent over CAN a few
+// frames at a time with event_queue_stats_transmit().
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "can_msg.h"
+#include "event_queue.h"
+#include "status.h"
+
+// Drops of event IDs at or above this are counted together in the last counter
+#ifndef EVENT_QUEUE_STATS_MAX_EVENT_IDS
+#define EVENT_QUEUE_STATS_MAX_EVENT_IDS 64
+#endif
+
+// Bucket i counts latencies in [2^(i-1), 2^i) us, with bucket 0 for < 1us. The last bucket also
+// holds everything longer.
+#define EVENT_QUEUE_STATS_LATENCY_BUCKETS 20
+
+typedef struct EventQueueStats {
+  uint16_t high_water[NUM_EVENT_PRIORITIES];
+  uint32_t dropped[EVENT_QUEUE_STATS_MAX_EVENT_IDS];
+  uint32_t latency_us_log2[EVENT_QUEUE_STATS_LATENCY_BUCKETS];
+} EventQueueStats;
+
+// Kinds of entries sent by event_queue_stats_transmit()
+typedef enum {
+  EVENT_QUEUE_STATS_ENTRY_HIGH_WATER = 0,  // key: priority
+  EVENT_QUEUE_STATS_ENTRY_DROPPED,         // key: event ID
+  EVENT_QUEUE_STATS_ENTRY_LATENCY,         // key: histogram bucket
+  NUM_EVENT_QUEUE_STATS_ENTRIES,
+} EventQueueStatsEntry;
+
+// Clears all stats. Called by event_queue_init().
+void event_queue_stats_reset(void);
+
+// Returns the current stats. They keep updating while events are raised and processed.
+const EventQueueStats *event_queue_stats_get(void);
+
+// Hooks for the event queue. |depth| is the FIFO's size after the event was added.
+void event_queue_stats_record_raise(EventPriority priority, EventId id, size_t depth, bool dropped);
+
+void event_queue_stats_record_latency(uint32_t latency_us);
+
+// Returns the histogram bucket a latency falls into.
+size_t event_queue_stats_latency_bucket(uint32_t latency_us);
+
+// Logs every non-zero stat.
+void event_queue_stats_dump(void);
+
+// Sends non-zero stats as |msg_id| from |source_id|, one entry per 8-byte frame:
+//   byte 0: EventQueueStatsEntry, byte 1: reserved, bytes 2-3: key, bytes 4-7: value
+// |cursor| tracks progress and must start at 0. Stops early with STATUS_CODE_RESOURCE_EXHAUSTED if
+// the TX queue fills up, in which case call it again later to continue. Returns OK and resets
+// |cursor| once everything has been sent.
+StatusCode event_queue_stats_transmit(uint16_t source_id, CanMessageId msg_id, size_t *cursor);
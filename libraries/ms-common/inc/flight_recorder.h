@@ -0,0 +1,106 @@
+#pragma once
+// Flight recorder
+//
+// Keeps a ring of the most recent events, CAN frames and faults in RAM that isn't cleared on reset,
+// so we can see what led up to a fault after the fact. Recording is cheap enough to leave on in
+// production: one timestamp read and one 8-byte store per entry.
+//
+// When a board faults, it freezes the ring with flight_recorder_freeze(), which stops recording so
+// the lead-up to the fault is preserved. Hard faults freeze the ring automatically. On the next
+// boot, flight_recorder_init() saves a frozen ring to FLIGHT_RECORDER_FLASH_PAGE and starts
+// recording again. Use the flight_recorder_decode project to print a saved ring.
+//
+// On STM32, the ring lives in the .noinit section, so it survives resets but not power loss.
+// On x86, set MIDSUN_X86_FLIGHT_RECORDER_FILE to back the ring with a file that survives the
+// process exiting. Crashing signals (SIGSEGV etc.) count as hard faults.
+//
+// Entries recorded from interrupts can race with entries recorded in the main loop, in which case
+// one of them may be lost. We accept that rather than paying for a critical section per entry.
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "flash.h"
+#include "status.h"
+
+// Must be a power of 2
+#ifndef FLIGHT_RECORDER_NUM_ENTRIES
+#define FLIGHT_RECORDER_NUM_ENTRIES 64
+#endif
+
+#define FLIGHT_RECORDER_FLASH_PAGE (NUM_FLASH_PAGES - 3)
+
+#define FLIGHT_RECORDER_MAGIC 0x5246534D  // "MSFR"
+#define FLIGHT_RECORDER_FROZEN 0x5A5A5A5A
+
+// Fault code used for hard faults - the argument is the faulting PC
+#define FLIGHT_RECORDER_FAULT_HARD_FAULT 0xFFFF
+
+typedef enum {
+  FLIGHT_RECORDER_ENTRY_NONE = 0,
+  FLIGHT_RECORDER_ENTRY_EVENT,   // value: event ID, arg: priority
+  FLIGHT_RECORDER_ENTRY_CAN_RX,  // value: raw CAN ID, arg: DLC
+  FLIGHT_RECORDER_ENTRY_CAN_TX,  // value: raw CAN ID, arg: DLC
+  FLIGHT_RECORDER_ENTRY_FAULT,   // value: fault code, arg: low byte of the fault argument
+  FLIGHT_RECORDER_ENTRY_USER,    // board-specific
+  NUM_FLIGHT_RECORDER_ENTRIES,
+} FlightRecorderEntryType;
+
+typedef struct FlightRecorderEntry {
+  uint32_t timestamp_us;
+  uint16_t value;
+  uint8_t type;
+  uint8_t arg;
+} FlightRecorderEntry;
+
+typedef struct FlightRecorderFault {
+  uint16_t code;
+  uint16_t reserved;
+  uint32_t arg;
+} FlightRecorderFault;
+
+// Both the live ring and its saved copy
+typedef struct FlightRecorderRing {
+  uint32_t magic;
+  // Set to FLIGHT_RECORDER_FROZEN once frozen
+  uint32_t frozen;
+  // Number of entries ever recorded - the next entry goes at head % FLIGHT_RECORDER_NUM_ENTRIES
+  uint32_t head;
+  // CRC32 of everything after this field. Only used for saved rings.
+  uint32_t crc;
+  FlightRecorderFault fault;
+  FlightRecorderEntry entries[FLIGHT_RECORDER_NUM_ENTRIES];
+} FlightRecorderRing;
+
+// Saves the ring if it was frozen before the last reset, then starts recording into a fresh ring.
+// Flash must be initialized first.
+StatusCode flight_recorder_init(void);
+
+// Record an entry. Does nothing before flight_recorder_init() or once the ring is frozen.
+void flight_recorder_record(FlightRecorderEntryType type, uint8_t arg, uint16_t value);
+
+// Record a fault and stop recording. Only the first fault is kept. Safe to call from interrupts.
+void flight_recorder_freeze(uint16_t code, uint32_t arg);
+
+bool flight_recorder_is_frozen(void);
+
+// Save the ring to flash if it's frozen. Called by flight_recorder_init(), but a board that keeps
+// running after a fault can call this from its main loop to avoid losing the ring to power loss.
+// Don't call this from interrupts.
+StatusCode flight_recorder_persist(void);
+
+// Read the ring saved in flash. Returns STATUS_CODE_UNINITIALIZED if no valid ring was saved.
+StatusCode flight_recorder_load(FlightRecorderRing *ring);
+
+// Check a saved ring read from |data|, e.g. a raw dump of FLIGHT_RECORDER_FLASH_PAGE, and copy it
+// into |ring|. Returns STATUS_CODE_UNINITIALIZED if it isn't a valid ring.
+StatusCode flight_recorder_decode(const uint8_t *data, size_t len, FlightRecorderRing *ring);
+
+// Returns the number of valid entries in |ring|.
+size_t flight_recorder_num_entries(const FlightRecorderRing *ring);
+
+// Returns the |i|th oldest valid entry in |ring|.
+const FlightRecorderEntry *flight_recorder_get_entry(const FlightRecorderRing *ring, size_t i);
+
+// Platform-specific: returns the RAM that survives resets to record into.
+FlightRecorderRing *flight_recorder_ring_init(void);
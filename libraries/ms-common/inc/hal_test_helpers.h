@@ -4,7 +4,22 @@
 
 #include <stdint.h>
 
+#include "status.h"
+#include "uart_mcu.h"
+
 // For testing soft_timer.h:
 // TEST ONLY FUNCTION TO SET TIMER COUNTER FOR SOFT TIMERS UNSAFE TO CALL
 // OUTSIDE A TEST.
 void _test_soft_timer_set_counter(uint32_t counter_value);
+
+// For quantifying bus traffic in tests:
+// Running count of output pin writes through gpio_set_state/gpio_toggle_state and of SPI
+// transactions (CS assertions). Only tracked on x86, always 0 on STM32. Compare two readings.
+uint32_t _test_gpio_get_num_writes(void);
+uint32_t _test_spi_get_num_transactions(void);
+
+// For testing UART on x86:
+// Uses |fd| (e.g. one end of a socketpair) for the port instead of a pty, starting
+// from the next uart_init(). Passing both ends of a socketpair to two ports wires
+// them back to back. Unimplemented on STM32.
+StatusCode _test_uart_connect(UartPort uart, int fd);
@@ -0,0 +1,79 @@
+#pragma once
+// Indexed minimum priority queue
+//
+// A 4-ary min-heap where each pushed entry gets a handle, so queued entries can be removed or have
+// their priority changed in O(log n) instead of searching for them or leaving tombstones. A 4-ary
+// heap is half as deep as a binary one, and a node's children sit next to each other since the
+// heap only holds priorities and handles. Data and heap positions live in a separate array of
+// entries indexed by handle.
+//
+// Handles stay valid while their entry is queued, and are reused once it's popped or removed.
+// Unlike pqueue, every node can be used.
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "misc.h"
+#include "status.h"
+
+#define PQUEUE_INDEXED_ARITY 4
+#define PQUEUE_INDEXED_MAX_NODES UINT16_MAX
+#define PQUEUE_INDEXED_INVALID_HANDLE UINT16_MAX
+
+typedef uint16_t PQueueHandle;
+
+typedef struct PQueueIndexedNode {
+  uint16_t prio;
+  PQueueHandle handle;
+} PQueueIndexedNode;
+
+typedef struct PQueueIndexedEntry {
+  void *data;
+  // Position of the entry's node in the heap, or PQUEUE_INDEXED_MAX_NODES if it isn't queued
+  uint16_t heap_index;
+} PQueueIndexedEntry;
+
+typedef struct PQueueIndexed {
+  // Nodes past the end of the heap hold the free handles
+  PQueueIndexedNode *nodes;
+  PQueueIndexedEntry *entries;
+  size_t max_nodes;
+  size_t size;
+} PQueueIndexed;
+
+// Initialize and clear a queue given local node and entry arrays of the same size.
+#define pqueue_indexed_init(queue, nodes, entries)                                 \
+  pqueue_indexed_init_verbose((queue), (nodes), (entries), SIZEOF_ARRAY(nodes), \
+                              SIZEOF_ARRAY(entries))
+
+StatusCode pqueue_indexed_init_verbose(PQueueIndexed *queue, PQueueIndexedNode *nodes,
+                                       PQueueIndexedEntry *entries, size_t num_nodes,
+                                       size_t num_entries);
+
+// Push a node with the specified priority and data onto the queue. If |handle| isn't NULL, it's
+// set to the handle of the new entry.
+StatusCode pqueue_indexed_push(PQueueIndexed *queue, void *data, uint16_t prio,
+                               PQueueHandle *handle);
+
+// Pop the minimum node from the queue and return its data.
+void *pqueue_indexed_pop(PQueueIndexed *queue);
+
+// Peek at the minimum node in the queue, returning its data. If |prio| isn't NULL, it's set to the
+// node's priority.
+void *pqueue_indexed_peek(PQueueIndexed *queue, uint16_t *prio);
+
+// Remove a queued entry.
+StatusCode pqueue_indexed_remove(PQueueIndexed *queue, PQueueHandle handle);
+
+// Change the priority of a queued entry, moving it up or down as needed.
+StatusCode pqueue_indexed_update(PQueueIndexed *queue, PQueueHandle handle, uint16_t prio);
+
+bool pqueue_indexed_is_queued(PQueueIndexed *queue, PQueueHandle handle);
+
+// Replace the contents of the queue with |num_elems| entries in O(n), rather than O(n log n) from
+// pushing them one at a time. If |handles| isn't NULL, it's filled with the handle of each entry.
+StatusCode pqueue_indexed_heapify(PQueueIndexed *queue, void *const *data, const uint16_t *prios,
+                                  size_t num_elems, PQueueHandle *handles);
+
+// Returns the number of nodes currently in the queue.
+size_t pqueue_indexed_size(PQueueIndexed *queue);
@@ -0,0 +1,114 @@
+#pragma once
+// Slab allocator
+//
+// Like the object pool, a slab hands out fixed-size nodes from a statically allocated buffer, and
+// slab_get_node()/slab_free_node() behave the same as objpool_get_node()/objpool_free_node():
+// nodes are reset and passed through the init function when they're freed. Slabs differ in that:
+// - They hold up to SLAB_MAX_NODES nodes. Free nodes are tracked in a bitset of 32-bit words with
+//   a summary word marking the words with free nodes, so allocating is two count-trailing-zeros.
+// - Several slabs of different node sizes can be grouped into a SlabAllocator, which serves each
+//   allocation from the smallest size class with a free node.
+// - They keep usage statistics, including the high-water mark, for sizing them.
+// - Built with DEFINE="SLAB_CANARIES", each node is followed by a canary word that's checked
+//   whenever the node is allocated or freed, to catch writes past the end of a node.
+//
+// Storage is declared with SLAB_STORAGE:
+//   static SLAB_STORAGE(TestObject, 100) s_storage;
+//   slab_init(&s_slab, &s_storage, TestObject, prv_init_node, NULL);
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "misc.h"
+#include "status.h"
+
+#define SLAB_BITSET_WORD_BITS 32
+// Limited by the summary word
+#define SLAB_MAX_NODES (SLAB_BITSET_WORD_BITS * SLAB_BITSET_WORD_BITS)
+
+#ifdef SLAB_CANARIES
+#define SLAB_CANARY 0xC0DEFEEDu
+#define SLAB_CANARY_SIZE sizeof(uint32_t)
+// Keep nodes aligned after the canary
+#define SLAB_NODE_ALIGN 8
+#define SLAB_NODE_STRIDE(node_size) \
+  (((node_size) + SLAB_CANARY_SIZE + SLAB_NODE_ALIGN - 1) / SLAB_NODE_ALIGN * SLAB_NODE_ALIGN)
+#else
+#define SLAB_NODE_STRIDE(node_size) (node_size)
+#endif
+
+#define SLAB_BITSET_WORDS(num_nodes) \
+  (((num_nodes) + SLAB_BITSET_WORD_BITS - 1) / SLAB_BITSET_WORD_BITS)
+
+// Declares the storage for a slab of |num_nodes| |type| nodes
+#define SLAB_STORAGE(type, num_nodes)                                                         \
+  struct {                                                                                    \
+    uint8_t buffer[SLAB_NODE_STRIDE(sizeof(type)) * (num_nodes)] __attribute__((aligned(8))); \
+    uint32_t free_bitset[SLAB_BITSET_WORDS(num_nodes)];                                       \
+  }
+
+// Function to initialize nodes with
+typedef void (*SlabNodeInitFn)(void *node, void *context);
+
+typedef struct SlabStats {
+  uint16_t in_use;
+  uint16_t high_water;
+  // Allocations that found the slab full
+  uint32_t failed;
+  // Canaries found overwritten, always 0 without SLAB_CANARIES
+  uint32_t corrupted;
+} SlabStats;
+
+typedef struct Slab {
+  uint8_t *nodes;
+  void *context;
+  SlabNodeInitFn init_node;
+  size_t num_nodes;
+  size_t node_size;
+  size_t stride;
+  uint32_t *free_bitset;
+  // Bit i is set if word i of the bitset has a free node
+  uint32_t free_summary;
+  SlabStats stats;
+} Slab;
+
+typedef struct SlabAllocator {
+  Slab *classes;
+  size_t num_classes;
+} SlabAllocator;
+
+// Initializes a slab of |type| nodes in storage declared with SLAB_STORAGE
+#define slab_init(slab, storage, type, init_fn, context)                                          \
+  slab_init_verbose((slab), (storage)->buffer, sizeof((storage)->buffer), (storage)->free_bitset, \
+                    SIZEOF_ARRAY((storage)->free_bitset), sizeof(type), (init_fn), (context))
+
+// Initializes a slab of |node_size| nodes in |buffer|, which should be aligned for them and
+// SLAB_NODE_STRIDE(node_size) bytes per node. |free_bitset| must have a bit for each node. The
+// specified context is provided for node initialization.
+StatusCode slab_init_verbose(Slab *slab, void *buffer, size_t buffer_size, uint32_t *free_bitset,
+                             size_t bitset_words, size_t node_size, SlabNodeInitFn init_node,
+                             void *context);
+
+// Returns the pointer to a node from the slab, or NULL if it's full.
+void *slab_get_node(Slab *slab);
+
+// Releases the specified node. Returns STATUS_CODE_INTERNAL_ERROR if its canary was overwritten,
+// after releasing it anyway.
+StatusCode slab_free_node(Slab *slab, void *node);
+
+// Checks the canaries of every node, returning STATUS_CODE_INTERNAL_ERROR if any were overwritten.
+StatusCode slab_check_canaries(Slab *slab);
+
+const SlabStats *slab_get_stats(const Slab *slab);
+
+// Groups initialized slabs into size classes. |classes| must be sorted by increasing node size.
+#define slab_allocator_init(allocator, classes) \
+  slab_allocator_init_verbose((allocator), (classes), SIZEOF_ARRAY(classes))
+
+StatusCode slab_allocator_init_verbose(SlabAllocator *allocator, Slab *classes, size_t num_classes);
+
+// Returns a node of at least |size| bytes from the smallest class with a free one, or NULL.
+void *slab_alloc(SlabAllocator *allocator, size_t size);
+
+// Releases a node from any of the allocator's classes.
+StatusCode slab_free(SlabAllocator *allocator, void *node);
@@ -46,3 +46,7 @@ bool soft_timer_inuse(void);
 // expired and is no longer in use, or if timer_id is invalid. Note that since timer ids are re-used
 // this could return false values once the timer has expired or if it is cancelled.
 uint32_t soft_timer_remaining_time(SoftTimerId timer_id);
+
+// Returns the current value of the free-running microsecond clock backing the soft timers.
+// Wraps around every ~71 minutes, so only differences between two readings are meaningful.
+uint32_t soft_timer_get_current_time(void);
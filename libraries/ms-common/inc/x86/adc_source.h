@@ -0,0 +1,56 @@
+#pragma once
+// Signal sources for the x86 ADC
+// Each channel is sampled from its own source instead of returning a fixed reading, so
+// filters and converters can be exercised with representative signals. Sources are
+// external to the ADC, so they're kept across adc_init().
+//
+// Conversions are sampled on a fixed clock: a channel's nth conversion since its source
+// was set sees the signal at n * sample period, whether it came from the continuous
+// scan or adc_read_raw(). In continuous mode, all enabled channels are scanned once per
+// sample period.
+//
+// Sources can also be set over the "cmd" x86 socket with raw 12-bit values:
+//   adc <channel> const <value>
+//   adc <channel> sine <offset> <amplitude> <period_us>
+//   adc <channel> ramp <start> <span> <period_us>
+//   adc <channel> noise <mean> <amplitude>
+//   adc <channel> replay <file>
+//   adc rate <sample_period_us>
+#include <stdint.h>
+
+#include "adc.h"
+#include "status.h"
+
+// Every channel starts as a constant at this raw reading
+#define ADC_SOURCE_DEFAULT_RAW 2500
+#define ADC_SOURCE_DEFAULT_SAMPLE_PERIOD_US 50000
+#define ADC_SOURCE_MAX_RAW 4095
+
+typedef enum {
+  ADC_SOURCE_CONSTANT = 0,
+  // offset + amplitude * sin(2 * pi * t / period)
+  ADC_SOURCE_SINE,
+  // Sawtooth from offset up to offset + amplitude, once per period
+  ADC_SOURCE_RAMP,
+  // Uniformly distributed within offset +/- amplitude. Repeatable between runs.
+  ADC_SOURCE_NOISE,
+  // One value per conversion from |replay_file|, looping at the end
+  ADC_SOURCE_REPLAY,
+  NUM_ADC_SOURCE_TYPES,
+} AdcSourceType;
+
+typedef struct AdcSource {
+  AdcSourceType type;
+  uint16_t offset;
+  uint16_t amplitude;
+  uint32_t period_us;
+  // Files ending in .csv hold one value per line, where lines that don't start with a
+  // number (i.e. headers) are skipped. Anything else is read as native uint16_t values.
+  const char *replay_file;
+} AdcSource;
+
+// Readings outside of the 12-bit range are clamped. Replay files are loaded right away.
+StatusCode adc_source_set(AdcChannel adc_channel, const AdcSource *source);
+
+// Sets the time between conversions of a channel. Takes effect from the next scan.
+StatusCode adc_source_set_sample_period(uint32_t sample_period_us);
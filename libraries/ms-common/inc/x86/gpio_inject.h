@@ -0,0 +1,39 @@
+#pragma once
+// Drives GPIO inputs from outside the program on x86
+// Injected levels are what gpio_get_state() returns for input pins, and changing one
+// fires the pin's gpio_it interrupt through the normal x86 interrupt path if the edge
+// matches the one it was registered with.
+//
+// Inputs can also be driven over the "cmd" x86 socket, with ports as letters or numbers:
+//   gpio <port> <pin> <0|1>                Set the input level
+//   gpio <port> <pin> <rising|falling>     Generate an edge without changing the level
+//   gpio replay <file>                     Replay a trace (see gpio_inject_replay())
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gpio.h"
+#include "interrupt_def.h"
+#include "status.h"
+
+// Registers the socket commands. Called by gpio_init().
+void gpio_inject_init(void);
+
+// Sets the input level of the pin, firing its interrupt on a matching edge.
+StatusCode gpio_inject_set_state(const GpioAddress *address, GpioState state);
+
+// Fires the pin's interrupt if |edge| matches the registered edge, e.g. for glitches
+// too short to show up as a level change. Masked interrupts ignore edges.
+StatusCode gpio_inject_edge(const GpioAddress *address, InterruptEdge edge);
+
+// Returns the CLOCK_MONOTONIC time of the last edge that fired the pin's interrupt,
+// to measure latency from the edge to whatever it causes.
+StatusCode gpio_inject_get_edge_time(const GpioAddress *address, uint64_t *time_ns);
+
+// Replays a trace of input levels on a background thread. Each line of the trace is
+// "<time_us> <port> <pin> <0|1>", where times are relative to the start of the replay
+// and must not decrease. Empty lines and lines starting with # are skipped.
+// Only one trace can be replayed at a time.
+StatusCode gpio_inject_replay(const char *path);
+
+// Whether a trace is still being replayed.
+bool gpio_inject_replaying(void);
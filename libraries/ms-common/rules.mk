@@ -1,5 +1,5 @@
 # Defines $(T)_SRC, $(T)_INC, $(T)_DEPS, and $(T)_CFLAGS for the build makefile.
-# Tests can be excluded by defining $(T)_EXCLUDE_TESTS.
+# Tests can be excluded by defining $(T)_EXCLUDE_TESTS, and benchmarks by $(T)_EXCLUDE_BENCHES.
 # Pre-defined:
 # $(T)_SRC_ROOT: $(T)_DIR/src
 # $(T)_INC_DIRS: $(T)_DIR/inc{/$(PLATFORM)}
@@ -9,4 +9,11 @@ $(T)_DEPS := $(PLATFORM_LIB) libcore
 
 ifeq (x86,$(PLATFORM))
 $(T)_EXCLUDE_TESTS := pwm pwm_input
+else
+# Traces can only be read back on x86, the UART tests need its sockets, ADC sources and GPIO
+# injection only exist there, and bus traffic is only counted there
+$(T)_EXCLUDE_TESTS := can_trace uart adc_source gpio_inject bus_traffic
+$(T)_EXCLUDE_BENCHES := x86_interrupt uart
 endif
+
+$(T)_test_event_queue_stats_MOCKS := can_transmit
@@ -0,0 +1,56 @@
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t s_samples[BENCH_NUM_SAMPLES];
+
+static uint32_t prv_time_sample(BenchOp op, void *context, uint32_t ops_per_sample) {
+  const uint32_t start = bench_clock_now();
+  for (uint32_t i = 0; i < ops_per_sample; i++) {
+    op(context);
+  }
+  return bench_clock_elapsed(start, bench_clock_now());
+}
+
+static void prv_sort(uint32_t *samples, size_t len) {
+  // Insertion sort - the samples are few and often nearly sorted, and this avoids pulling in qsort
+  for (size_t i = 1; i < len; i++) {
+    const uint32_t sample = samples[i];
+    size_t j = i;
+    while (j > 0 && samples[j - 1] > sample) {
+      samples[j] = samples[j - 1];
+      j--;
+    }
+    samples[j] = sample;
+  }
+}
+
+BenchResult bench_run(const char *file, const char *name, BenchOp op, void *context,
+                      uint32_t ops_per_sample) {
+  if (ops_per_sample == 0) {
+    ops_per_sample = 1;
+  }
+  bench_clock_init();
+
+  // Warm up caches and branch predictors before timing anything
+  prv_time_sample(op, context, ops_per_sample);
+  for (size_t i = 0; i < BENCH_NUM_SAMPLES; i++) {
+    s_samples[i] = prv_time_sample(op, context, ops_per_sample);
+  }
+  prv_sort(s_samples, BENCH_NUM_SAMPLES);
+
+  const BenchResult result = {
+    .min = s_samples[0] / ops_per_sample,
+    .median = s_samples[BENCH_NUM_SAMPLES / 2] / ops_per_sample,
+    .p99 = s_samples[BENCH_NUM_SAMPLES * 99 / 100] / ops_per_sample,
+  };
+
+  // Only report the file's name so results from different checkouts line up
+  const char *basename = strrchr(file, '/');
+  basename = (basename == NULL) ? file : basename + 1;
+  printf("BENCH,%s,%s,%u,%u,%u,%u,%u,%s\n", basename, name, (unsigned)ops_per_sample,
+         (unsigned)BENCH_NUM_SAMPLES, (unsigned)result.min, (unsigned)result.median,
+         (unsigned)result.p99, bench_clock_unit());
+  return result;
+}
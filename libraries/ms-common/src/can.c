@@ -18,6 +18,7 @@
 #include <string.h>
 #include "can_fsm.h"
 #include "can_hw.h"
+#include "flight_recorder.h"
 #include "log.h"
 #include "soft_timer.h"
 
@@ -132,7 +133,12 @@ StatusCode can_transmit(const CanMessage *msg, const CanAckRequest *ack_request)
   // postponed until the main event loop.
   event_raise(s_can_storage->tx_event, 1);
 
-  return can_fifo_push(&s_can_storage->tx_fifo, msg);
+  status_ok_or_return(can_fifo_push(&s_can_storage->tx_fifo, msg));
+
+  CanId id = { .source_id = msg->source_id, .type = msg->type, .msg_id = msg->msg_id };
+  flight_recorder_record(FLIGHT_RECORDER_ENTRY_CAN_TX, (uint8_t)msg->dlc, id.raw);
+
+  return STATUS_CODE_OK;
 }
 
 bool can_process_event(const Event *e) {
@@ -171,6 +177,7 @@ void prv_rx_handler(void *context) {
       continue;
     }
     CAN_MSG_SET_RAW_ID(&rx_msg, rx_id);
+    flight_recorder_record(FLIGHT_RECORDER_ENTRY_CAN_RX, (uint8_t)rx_msg.dlc, (uint16_t)rx_id);
 
     StatusCode result = can_fifo_push(&can_storage->rx_fifo, &rx_msg);
     // TODO(ELEC-251): add error handling for FSMs
@@ -0,0 +1,114 @@
+#include "can_trace.h"
+
+#include <string.h>
+
+void can_trace_record_init(CanTraceRecord *record, uint64_t timestamp_us, uint32_t id,
+                           bool extended, const uint8_t *data, size_t dlc, uint8_t flags) {
+  memset(record, 0, sizeof(*record));
+  record->timestamp_us = timestamp_us;
+  record->raw_id = extended ? ((id & CAN_TRACE_ID_EXTENDED_MASK) | CAN_TRACE_ID_EXTENDED_FLAG)
+                            : (id & CAN_TRACE_ID_STANDARD_MASK);
+  record->dlc = (uint8_t)((dlc > sizeof(record->data)) ? sizeof(record->data) : dlc);
+  record->flags = flags;
+  if (data != NULL) {
+    memcpy(record->data, data, record->dlc);
+  }
+}
+
+void can_trace_record_get_id(const CanTraceRecord *record, uint32_t *id, bool *extended) {
+  *extended = (record->raw_id & CAN_TRACE_ID_EXTENDED_FLAG) != 0;
+  *id = record->raw_id & (*extended ? CAN_TRACE_ID_EXTENDED_MASK : CAN_TRACE_ID_STANDARD_MASK);
+}
+
+StatusCode can_trace_writer_init(CanTraceWriter *writer, FILE *stream, uint64_t *chunk_index,
+                                 size_t max_chunks) {
+  if (writer == NULL || stream == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  writer->stream = stream;
+  writer->num_records = 0;
+  writer->chunk_index = chunk_index;
+  writer->max_chunks = (chunk_index == NULL) ? 0 : max_chunks;
+
+  const CanTraceHeader header = {
+    .magic = CAN_TRACE_MAGIC,
+    .version = CAN_TRACE_VERSION,
+    .record_size = sizeof(CanTraceRecord),
+    .chunk_records = CAN_TRACE_CHUNK_RECORDS,
+  };
+  if (fwrite(&header, sizeof(header), 1, stream) != 1) {
+    return status_msg(STATUS_CODE_INTERNAL_ERROR, "CAN trace: failed to write header");
+  }
+  return STATUS_CODE_OK;
+}
+
+StatusCode can_trace_writer_append(CanTraceWriter *writer, const CanTraceRecord *record) {
+  const uint64_t chunk = writer->num_records / CAN_TRACE_CHUNK_RECORDS;
+  const bool chunk_start = (writer->num_records % CAN_TRACE_CHUNK_RECORDS) == 0;
+  if (chunk_start && chunk < writer->max_chunks) {
+    writer->chunk_index[chunk] = record->timestamp_us;
+  }
+
+  if (fwrite(record, sizeof(*record), 1, writer->stream) != 1) {
+    return status_msg(STATUS_CODE_INTERNAL_ERROR, "CAN trace: failed to write record");
+  }
+  writer->num_records++;
+
+  // Bound how much is lost if the recorder dies without closing the trace
+  if (writer->num_records % CAN_TRACE_CHUNK_RECORDS == 0) {
+    fflush(writer->stream);
+  }
+  return STATUS_CODE_OK;
+}
+
+StatusCode can_trace_writer_close(CanTraceWriter *writer) {
+  const uint64_t num_chunks =
+      (writer->num_records + CAN_TRACE_CHUNK_RECORDS - 1) / CAN_TRACE_CHUNK_RECORDS;
+
+  // Without a complete index, leave the trace unindexed and let the reader rebuild it
+  if (writer->chunk_index != NULL && num_chunks <= writer->max_chunks) {
+    const CanTraceFooter footer = {
+      .magic = CAN_TRACE_FOOTER_MAGIC,
+      .num_chunks = (uint32_t)num_chunks,
+      .num_records = writer->num_records,
+    };
+    if (fwrite(writer->chunk_index, sizeof(uint64_t), (size_t)num_chunks, writer->stream) !=
+            num_chunks ||
+        fwrite(&footer, sizeof(footer), 1, writer->stream) != 1) {
+      return status_msg(STATUS_CODE_INTERNAL_ERROR, "CAN trace: failed to write index");
+    }
+  }
+
+  fflush(writer->stream);
+  return STATUS_CODE_OK;
+}
+
+size_t can_trace_find(const CanTraceRecord *records, size_t num_records,
+                      const uint64_t *chunk_index, size_t num_chunks, uint64_t timestamp_us) {
+  // Find the last chunk starting before the timestamp - everything before it is too early
+  size_t lo = 0;
+  size_t hi = num_chunks;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (chunk_index[mid] < timestamp_us) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  // Then binary search the records within that chunk
+  size_t first = (lo == 0) ? 0 : (lo - 1) * CAN_TRACE_CHUNK_RECORDS;
+  size_t last = (lo * CAN_TRACE_CHUNK_RECORDS < num_records) ? lo * CAN_TRACE_CHUNK_RECORDS
+                                                             : num_records;
+  while (first < last) {
+    size_t mid = first + (last - first) / 2;
+    if (records[mid].timestamp_us < timestamp_us) {
+      first = mid + 1;
+    } else {
+      last = mid;
+    }
+  }
+  return first;
+}
@@ -3,13 +3,22 @@
 #include <stdbool.h>
 #include <string.h>
 
+#include "critical_section.h"
 #include "event_queue.h"
+#include "event_queue_stats.h"
 #include "fifo.h"
+#include "flight_recorder.h"
+#include "soft_timer.h"
 #include "status.h"
 
 typedef struct EventQueue {
   Fifo fifos[NUM_EVENT_PRIORITIES];
   Event event_nodes[NUM_EVENT_PRIORITIES][EVENT_QUEUE_SIZE];
+#ifdef EVENT_QUEUE_STATS
+  // When each queued event was raised, kept in lockstep with |fifos|
+  Fifo raise_time_fifos[NUM_EVENT_PRIORITIES];
+  uint32_t raise_times_us[NUM_EVENT_PRIORITIES][EVENT_QUEUE_SIZE];
+#endif
 } EventQueue;
 
 static EventQueue s_queue;
@@ -17,9 +26,45 @@ static EventQueue s_queue;
 void event_queue_init(void) {
   for (size_t i = 0; i < NUM_EVENT_PRIORITIES; i++) {
     fifo_init(&s_queue.fifos[i], s_queue.event_nodes[i]);
+#ifdef EVENT_QUEUE_STATS
+    fifo_init(&s_queue.raise_time_fifos[i], s_queue.raise_times_us[i]);
+#endif
   }
+#ifdef EVENT_QUEUE_STATS
+  event_queue_stats_reset();
+#endif
 }
 
+#ifdef EVENT_QUEUE_STATS
+static StatusCode prv_push(EventPriority priority, Event *e) {
+  // Events are raised from interrupts, so keep the timestamps in sync with the events
+  bool disabled = critical_section_start();
+  StatusCode status = fifo_push(&s_queue.fifos[priority], e);
+  if (status == STATUS_CODE_OK) {
+    uint32_t now_us = soft_timer_get_current_time();
+    fifo_push(&s_queue.raise_time_fifos[priority], &now_us);
+  }
+  event_queue_stats_record_raise(priority, e->id, fifo_size(&s_queue.fifos[priority]),
+                                 status != STATUS_CODE_OK);
+  critical_section_end(disabled);
+  return status;
+}
+
+static StatusCode prv_pop(size_t priority, Event *e) {
+  bool disabled = critical_section_start();
+  uint32_t raised_us = 0;
+  fifo_pop(&s_queue.raise_time_fifos[priority], &raised_us);
+  StatusCode status = fifo_pop(&s_queue.fifos[priority], e);
+  critical_section_end(disabled);
+
+  event_queue_stats_record_latency(soft_timer_get_current_time() - raised_us);
+  return status;
+}
+#else
+#define prv_push(priority, e) fifo_push(&s_queue.fifos[(priority)], (e))
+#define prv_pop(priority, e) fifo_pop(&s_queue.fifos[(priority)], (e))
+#endif
+
 StatusCode event_raise_priority(EventPriority priority, EventId id, uint16_t data) {
   if (priority >= NUM_EVENT_PRIORITIES) {
     return status_code(STATUS_CODE_INVALID_ARGS);
@@ -29,13 +74,15 @@ StatusCode event_raise_priority(EventPriority priority, EventId id, uint16_t dat
     .data = data,  //
   };
 
-  return fifo_push(&s_queue.fifos[priority], &e);
+  return prv_push(priority, &e);
 }
 
 StatusCode event_process(Event *e) {
   for (size_t i = 0; i < NUM_EVENT_PRIORITIES; i++) {
     if (s_queue.fifos[i].num_elems > 0) {
-      return fifo_pop(&s_queue.fifos[i], e);
+      StatusCode status = prv_pop(i, e);
+      flight_recorder_record(FLIGHT_RECORDER_ENTRY_EVENT, (uint8_t)i, e->id);
+      return status;
     }
   }
   return status_code(STATUS_CODE_EMPTY);
@@ -0,0 +1,67 @@
+#include "event_queue_stats.h"
+
+#include <string.h>
+
+#include "log.h"
+
+// Only built with EVENT_QUEUE_STATS so normal builds don't pay for |s_stats|
+#ifdef EVENT_QUEUE_STATS
+
+static EventQueueStats s_stats;
+
+void event_queue_stats_reset(void) {
+  memset(&s_stats, 0, sizeof(s_stats));
+}
+
+const EventQueueStats *event_queue_stats_get(void) {
+  return &s_stats;
+}
+
+void event_queue_stats_record_raise(EventPriority priority, EventId id, size_t depth,
+                                    bool dropped) {
+  if (dropped) {
+    size_t counter = (id < EVENT_QUEUE_STATS_MAX_EVENT_IDS) ? id
+                                                            : EVENT_QUEUE_STATS_MAX_EVENT_IDS - 1;
+    s_stats.dropped[counter]++;
+  } else if (depth > s_stats.high_water[priority]) {
+    s_stats.high_water[priority] = (uint16_t)depth;
+  }
+}
+
+size_t event_queue_stats_latency_bucket(uint32_t latency_us) {
+  if (latency_us == 0) {
+    return 0;
+  }
+  // Bucket i holds [2^(i-1), 2^i), i.e. the number of significant bits
+  size_t bucket = 32 - (size_t)__builtin_clz(latency_us);
+  return (bucket < EVENT_QUEUE_STATS_LATENCY_BUCKETS) ? bucket
+                                                      : EVENT_QUEUE_STATS_LATENCY_BUCKETS - 1;
+}
+
+void event_queue_stats_record_latency(uint32_t latency_us) {
+  s_stats.latency_us_log2[event_queue_stats_latency_bucket(latency_us)]++;
+}
+
+void event_queue_stats_dump(void) {
+  LOG_DEBUG("Event queue stats (EVENT_QUEUE_SIZE %d):\n", EVENT_QUEUE_SIZE);
+  for (size_t i = 0; i < NUM_EVENT_PRIORITIES; i++) {
+    LOG_DEBUG("  priority %d high-water: %d\n", (int)i, s_stats.high_water[i]);
+  }
+  for (size_t i = 0; i < EVENT_QUEUE_STATS_MAX_EVENT_IDS; i++) {
+    if (s_stats.dropped[i] != 0) {
+      LOG_DEBUG("  event %d dropped: %u\n", (int)i, (unsigned)s_stats.dropped[i]);
+    }
+  }
+  for (size_t i = 0; i < EVENT_QUEUE_STATS_LATENCY_BUCKETS; i++) {
+    if (s_stats.latency_us_log2[i] == 0) {
+      continue;
+    }
+    if (i == EVENT_QUEUE_STATS_LATENCY_BUCKETS - 1) {
+      LOG_DEBUG("  latency >= %uus: %u\n", 1u << (i - 1), (unsigned)s_stats.latency_us_log2[i]);
+    } else {
+      LOG_DEBUG("  latency < %uus: %u\n", 1u << i, (unsigned)s_stats.latency_us_log2[i]);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,63 @@
+// Kept apart from the rest of the stats so boards without CAN don't link it in
+#include "can.h"
+#include "event_queue_stats.h"
+
+#ifdef EVENT_QUEUE_STATS
+
+#define EVENT_QUEUE_STATS_NUM_ENTRIES \
+  (NUM_EVENT_PRIORITIES + EVENT_QUEUE_STATS_MAX_EVENT_IDS + EVENT_QUEUE_STATS_LATENCY_BUCKETS)
+
+// Returns the |index|th stat in transmit order, or 0 if it's out of range.
+static uint32_t prv_get_entry(size_t index, EventQueueStatsEntry *entry, uint16_t *key) {
+  const EventQueueStats *stats = event_queue_stats_get();
+  if (index < NUM_EVENT_PRIORITIES) {
+    *entry = EVENT_QUEUE_STATS_ENTRY_HIGH_WATER;
+    *key = (uint16_t)index;
+    return stats->high_water[index];
+  }
+  index -= NUM_EVENT_PRIORITIES;
+  if (index < EVENT_QUEUE_STATS_MAX_EVENT_IDS) {
+    *entry = EVENT_QUEUE_STATS_ENTRY_DROPPED;
+    *key = (uint16_t)index;
+    return stats->dropped[index];
+  }
+  index -= EVENT_QUEUE_STATS_MAX_EVENT_IDS;
+  if (index < EVENT_QUEUE_STATS_LATENCY_BUCKETS) {
+    *entry = EVENT_QUEUE_STATS_ENTRY_LATENCY;
+    *key = (uint16_t)index;
+    return stats->latency_us_log2[index];
+  }
+  return 0;
+}
+
+StatusCode event_queue_stats_transmit(uint16_t source_id, CanMessageId msg_id, size_t *cursor) {
+  if (cursor == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  for (; *cursor < EVENT_QUEUE_STATS_NUM_ENTRIES; (*cursor)++) {
+    EventQueueStatsEntry entry = NUM_EVENT_QUEUE_STATS_ENTRIES;
+    uint16_t key = 0;
+    uint32_t value = prv_get_entry(*cursor, &entry, &key);
+    if (value == 0) {
+      continue;
+    }
+
+    CanMessage msg = {
+      .source_id = source_id,
+      .msg_id = msg_id,
+      .type = CAN_MSG_TYPE_DATA,
+      .dlc = 8,
+    };
+    msg.data_u8[0] = (uint8_t)entry;
+    msg.data_u16[1] = key;
+    msg.data_u32[1] = value;
+    // Leave the cursor on this entry so it's retried next time
+    status_ok_or_return(can_transmit(&msg, NULL));
+  }
+
+  *cursor = 0;
+  return STATUS_CODE_OK;
+}
+
+#endif
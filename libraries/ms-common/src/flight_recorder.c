@@ -0,0 +1,138 @@
+#include "flight_recorder.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "crc32.h"
+#include "log.h"
+#include "misc.h"
+#include "soft_timer.h"
+
+#define FLIGHT_RECORDER_INDEX_MASK (FLIGHT_RECORDER_NUM_ENTRIES - 1)
+
+static_assert((FLIGHT_RECORDER_NUM_ENTRIES & FLIGHT_RECORDER_INDEX_MASK) == 0,
+              "FLIGHT_RECORDER_NUM_ENTRIES must be a power of 2");
+static_assert(sizeof(FlightRecorderRing) % FLASH_WRITE_BYTES == 0,
+              "Flight recorder ring must be a whole number of flash writes");
+
+// The CRC covers everything after |crc|
+#define FLIGHT_RECORDER_CRC_OFFSET (offsetof(FlightRecorderRing, crc) + sizeof(uint32_t))
+
+static FlightRecorderRing *s_ring;
+// Whether the frozen ring has been saved since boot
+static bool s_persisted;
+
+static uint32_t prv_crc(const FlightRecorderRing *ring) {
+  return crc32_arr((const uint8_t *)ring + FLIGHT_RECORDER_CRC_OFFSET,
+                   sizeof(*ring) - FLIGHT_RECORDER_CRC_OFFSET);
+}
+
+static StatusCode prv_save(FlightRecorderRing *ring) {
+  ring->crc = prv_crc(ring);
+  status_ok_or_return(flash_erase(FLIGHT_RECORDER_FLASH_PAGE));
+  return flash_write(FLASH_PAGE_TO_ADDR(FLIGHT_RECORDER_FLASH_PAGE), (uint8_t *)ring,
+                     sizeof(*ring));
+}
+
+StatusCode flight_recorder_init(void) {
+  status_ok_or_return(crc32_init());
+
+  // Stop recording while we look at the ring
+  s_ring = NULL;
+  s_persisted = false;
+  FlightRecorderRing *ring = flight_recorder_ring_init();
+  if (ring == NULL) {
+    return status_msg(STATUS_CODE_INTERNAL_ERROR, "Flight recorder: no ring");
+  }
+
+  // After a power cycle the ring is garbage, which the magic catches
+  if (ring->magic == FLIGHT_RECORDER_MAGIC && ring->frozen == FLIGHT_RECORDER_FROZEN) {
+    LOG_DEBUG("Flight recorder: saving ring frozen by fault 0x%x\n", ring->fault.code);
+    status_ok_or_return(prv_save(ring));
+  }
+
+  memset(ring, 0, sizeof(*ring));
+  ring->magic = FLIGHT_RECORDER_MAGIC;
+  s_ring = ring;
+  return STATUS_CODE_OK;
+}
+
+void flight_recorder_record(FlightRecorderEntryType type, uint8_t arg, uint16_t value) {
+  FlightRecorderRing *ring = s_ring;
+  if (ring == NULL || ring->frozen != 0) {
+    return;
+  }
+
+  FlightRecorderEntry *entry = &ring->entries[ring->head++ & FLIGHT_RECORDER_INDEX_MASK];
+  entry->timestamp_us = soft_timer_get_current_time();
+  entry->value = value;
+  entry->type = (uint8_t)type;
+  entry->arg = arg;
+}
+
+void flight_recorder_freeze(uint16_t code, uint32_t arg) {
+  FlightRecorderRing *ring = s_ring;
+  if (ring == NULL || ring->frozen != 0) {
+    return;
+  }
+
+  flight_recorder_record(FLIGHT_RECORDER_ENTRY_FAULT, (uint8_t)arg, code);
+  ring->fault.code = code;
+  ring->fault.arg = arg;
+  ring->frozen = FLIGHT_RECORDER_FROZEN;
+}
+
+bool flight_recorder_is_frozen(void) {
+  return s_ring != NULL && s_ring->frozen == FLIGHT_RECORDER_FROZEN;
+}
+
+StatusCode flight_recorder_persist(void) {
+  // The ring can't change once it's frozen, so it only needs to be saved once
+  if (!flight_recorder_is_frozen() || s_persisted) {
+    return STATUS_CODE_OK;
+  }
+
+  status_ok_or_return(prv_save(s_ring));
+  s_persisted = true;
+  return STATUS_CODE_OK;
+}
+
+static StatusCode prv_validate(const FlightRecorderRing *ring) {
+  if (ring->magic != FLIGHT_RECORDER_MAGIC || ring->frozen != FLIGHT_RECORDER_FROZEN ||
+      ring->crc != prv_crc(ring)) {
+    return status_code(STATUS_CODE_UNINITIALIZED);
+  }
+  return STATUS_CODE_OK;
+}
+
+StatusCode flight_recorder_load(FlightRecorderRing *ring) {
+  if (ring == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  status_ok_or_return(flash_read(FLASH_PAGE_TO_ADDR(FLIGHT_RECORDER_FLASH_PAGE), sizeof(*ring),
+                                 (uint8_t *)ring, sizeof(*ring)));
+  return prv_validate(ring);
+}
+
+StatusCode flight_recorder_decode(const uint8_t *data, size_t len, FlightRecorderRing *ring) {
+  if (data == NULL || ring == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  } else if (len < sizeof(*ring)) {
+    return status_code(STATUS_CODE_UNINITIALIZED);
+  }
+
+  memcpy(ring, data, sizeof(*ring));
+  return prv_validate(ring);
+}
+
+size_t flight_recorder_num_entries(const FlightRecorderRing *ring) {
+  return MIN(ring->head, (uint32_t)FLIGHT_RECORDER_NUM_ENTRIES);
+}
+
+const FlightRecorderEntry *flight_recorder_get_entry(const FlightRecorderRing *ring, size_t i) {
+  // The oldest entry is at head once the ring has wrapped, and at 0 before that
+  size_t oldest = ring->head - flight_recorder_num_entries(ring);
+  return &ring->entries[(oldest + i) & FLIGHT_RECORDER_INDEX_MASK];
+}
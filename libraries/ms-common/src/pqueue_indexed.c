@@ -0,0 +1,253 @@
+// Implements an indexed 4-ary min-heap.
+// The heap is 0-indexed: the children of node i are nodes 4i + 1 to 4i + 4. The handles of the
+// nodes past the end of the heap are the free handles, so pushing takes the handle at the end of
+// the heap and removing swaps the removed handle there.
+#include "pqueue_indexed.h"
+
+#include <string.h>
+
+#include "critical_section.h"
+
+#define PQUEUE_INDEXED_NOT_QUEUED PQUEUE_INDEXED_MAX_NODES
+
+#define PQUEUE_INDEXED_PARENT(index) (((index)-1) / PQUEUE_INDEXED_ARITY)
+#define PQUEUE_INDEXED_FIRST_CHILD(index) (PQUEUE_INDEXED_ARITY * (index) + 1)
+
+// Places |node| at |index|, keeping its entry's position in sync
+static void prv_set_node(PQueueIndexed *queue, size_t index, PQueueIndexedNode node) {
+  queue->nodes[index] = node;
+  queue->entries[node.handle].heap_index = (uint16_t)index;
+}
+
+// Moves |node| up from the hole at |index| until its parent is no larger
+static void prv_sift_up(PQueueIndexed *queue, size_t index, PQueueIndexedNode node) {
+  while (index != 0 && queue->nodes[PQUEUE_INDEXED_PARENT(index)].prio > node.prio) {
+    size_t parent = PQUEUE_INDEXED_PARENT(index);
+    prv_set_node(queue, index, queue->nodes[parent]);
+    index = parent;
+  }
+  prv_set_node(queue, index, node);
+}
+
+// Moves |node| down from the hole at |index| until none of its children are smaller
+static void prv_sift_down(PQueueIndexed *queue, size_t index, PQueueIndexedNode node) {
+  size_t child = PQUEUE_INDEXED_FIRST_CHILD(index);
+  while (child < queue->size) {
+    // Find the smallest child
+    size_t last_child = MIN(child + PQUEUE_INDEXED_ARITY, queue->size);
+    size_t min_child = child;
+    for (size_t i = child + 1; i < last_child; i++) {
+      if (queue->nodes[i].prio < queue->nodes[min_child].prio) {
+        min_child = i;
+      }
+    }
+
+    if (node.prio <= queue->nodes[min_child].prio) {
+      break;
+    }
+
+    // Node does not fit - move child up and go down a level
+    prv_set_node(queue, index, queue->nodes[min_child]);
+    index = min_child;
+    child = PQUEUE_INDEXED_FIRST_CHILD(index);
+  }
+  prv_set_node(queue, index, node);
+}
+
+// Takes the node at |index| out of the heap and fills its place from the end of the heap
+static void prv_remove_at(PQueueIndexed *queue, size_t index) {
+  PQueueIndexedNode removed = queue->nodes[index];
+  size_t last = --queue->size;
+
+  if (index != last) {
+    PQueueIndexedNode moved = queue->nodes[last];
+    if (moved.prio < removed.prio) {
+      prv_sift_up(queue, index, moved);
+    } else {
+      prv_sift_down(queue, index, moved);
+    }
+  }
+
+  // Free the removed handle
+  queue->nodes[last].handle = removed.handle;
+  queue->entries[removed.handle].data = NULL;
+  queue->entries[removed.handle].heap_index = PQUEUE_INDEXED_NOT_QUEUED;
+}
+
+static bool prv_is_queued(PQueueIndexed *queue, PQueueHandle handle) {
+  return handle < queue->max_nodes &&
+         queue->entries[handle].heap_index != PQUEUE_INDEXED_NOT_QUEUED;
+}
+
+// Clears the queue, with every handle free
+static void prv_reset(PQueueIndexed *queue) {
+  queue->size = 0;
+  for (size_t i = 0; i < queue->max_nodes; i++) {
+    queue->nodes[i].prio = 0;
+    queue->nodes[i].handle = (PQueueHandle)i;
+    queue->entries[i].data = NULL;
+    queue->entries[i].heap_index = PQUEUE_INDEXED_NOT_QUEUED;
+  }
+}
+
+StatusCode pqueue_indexed_init_verbose(PQueueIndexed *queue, PQueueIndexedNode *nodes,
+                                       PQueueIndexedEntry *entries, size_t num_nodes,
+                                       size_t num_entries) {
+  if (queue == NULL || nodes == NULL || entries == NULL || num_nodes != num_entries) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+  if (num_nodes > PQUEUE_INDEXED_MAX_NODES) {
+    return status_code(STATUS_CODE_OUT_OF_RANGE);
+  }
+
+  bool disabled = critical_section_start();
+  memset(queue, 0, sizeof(*queue));
+
+  queue->nodes = nodes;
+  queue->entries = entries;
+  queue->max_nodes = num_nodes;
+  prv_reset(queue);
+  critical_section_end(disabled);
+
+  return STATUS_CODE_OK;
+}
+
+StatusCode pqueue_indexed_push(PQueueIndexed *queue, void *data, uint16_t prio,
+                               PQueueHandle *handle) {
+  bool disabled = critical_section_start();
+
+  if (queue->size == queue->max_nodes) {
+    critical_section_end(disabled);
+
+    // Ran out of space.
+    return status_code(STATUS_CODE_RESOURCE_EXHAUSTED);
+  }
+
+  // Begin at new leaf, bubble up
+  PQueueIndexedNode node = { .prio = prio, .handle = queue->nodes[queue->size].handle };
+  queue->entries[node.handle].data = data;
+  prv_sift_up(queue, queue->size++, node);
+
+  if (handle != NULL) {
+    *handle = node.handle;
+  }
+
+  critical_section_end(disabled);
+
+  return STATUS_CODE_OK;
+}
+
+void *pqueue_indexed_pop(PQueueIndexed *queue) {
+  bool disabled = critical_section_start();
+
+  if (queue->size == 0) {
+    critical_section_end(disabled);
+    return NULL;
+  }
+
+  // Minimum element
+  void *data = queue->entries[queue->nodes[0].handle].data;
+  prv_remove_at(queue, 0);
+
+  critical_section_end(disabled);
+
+  return data;
+}
+
+void *pqueue_indexed_peek(PQueueIndexed *queue, uint16_t *prio) {
+  bool disabled = critical_section_start();
+
+  void *ret = NULL;
+  if (queue->size != 0) {
+    ret = queue->entries[queue->nodes[0].handle].data;
+    if (prio != NULL) {
+      *prio = queue->nodes[0].prio;
+    }
+  }
+
+  critical_section_end(disabled);
+
+  return ret;
+}
+
+StatusCode pqueue_indexed_remove(PQueueIndexed *queue, PQueueHandle handle) {
+  bool disabled = critical_section_start();
+
+  if (!prv_is_queued(queue, handle)) {
+    critical_section_end(disabled);
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  prv_remove_at(queue, queue->entries[handle].heap_index);
+
+  critical_section_end(disabled);
+
+  return STATUS_CODE_OK;
+}
+
+StatusCode pqueue_indexed_update(PQueueIndexed *queue, PQueueHandle handle, uint16_t prio) {
+  bool disabled = critical_section_start();
+
+  if (!prv_is_queued(queue, handle)) {
+    critical_section_end(disabled);
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  size_t index = queue->entries[handle].heap_index;
+  PQueueIndexedNode node = { .prio = prio, .handle = handle };
+  if (prio < queue->nodes[index].prio) {
+    prv_sift_up(queue, index, node);
+  } else {
+    prv_sift_down(queue, index, node);
+  }
+
+  critical_section_end(disabled);
+
+  return STATUS_CODE_OK;
+}
+
+bool pqueue_indexed_is_queued(PQueueIndexed *queue, PQueueHandle handle) {
+  bool disabled = critical_section_start();
+  bool queued = prv_is_queued(queue, handle);
+  critical_section_end(disabled);
+
+  return queued;
+}
+
+StatusCode pqueue_indexed_heapify(PQueueIndexed *queue, void *const *data, const uint16_t *prios,
+                                  size_t num_elems, PQueueHandle *handles) {
+  if (num_elems != 0 && (data == NULL || prios == NULL)) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  bool disabled = critical_section_start();
+
+  if (num_elems > queue->max_nodes) {
+    critical_section_end(disabled);
+    return status_code(STATUS_CODE_RESOURCE_EXHAUSTED);
+  }
+
+  prv_reset(queue);
+  for (size_t i = 0; i < num_elems; i++) {
+    queue->nodes[i].prio = prios[i];
+    queue->entries[i].data = data[i];
+    queue->entries[i].heap_index = (uint16_t)i;
+    if (handles != NULL) {
+      handles[i] = (PQueueHandle)i;
+    }
+  }
+  queue->size = num_elems;
+
+  // Sift down every parent, starting from the last one
+  for (size_t i = (num_elems + PQUEUE_INDEXED_ARITY - 2) / PQUEUE_INDEXED_ARITY; i > 0; i--) {
+    prv_sift_down(queue, i - 1, queue->nodes[i - 1]);
+  }
+
+  critical_section_end(disabled);
+
+  return STATUS_CODE_OK;
+}
+
+size_t pqueue_indexed_size(PQueueIndexed *queue) {
+  return queue->size;
+}
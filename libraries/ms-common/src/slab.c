@@ -0,0 +1,213 @@
+// A set bit marks a free node. The summary word lets allocation skip straight to a word with one.
+#include "slab.h"
+
+#include <string.h>
+
+#include "critical_section.h"
+
+#define SLAB_GET(slab, index) ((void *)((slab)->nodes + (index) * (slab)->stride))
+
+#define SLAB_NODE_IN_RANGE(slab, node)   \
+  ((slab)->nodes <= (uint8_t *)(node) && \
+   (uint8_t *)(node) < (slab)->nodes + (slab)->num_nodes * (slab)->stride)
+
+// Check in range and alignment
+#define SLAB_NODE_INVALID(slab, node)     \
+  (!SLAB_NODE_IN_RANGE((slab), (node)) || \
+   (size_t)((uint8_t *)(node) - (slab)->nodes) % (slab)->stride != 0)
+
+#define SLAB_GET_INDEX(slab, node) ((size_t)((uint8_t *)(node) - (slab)->nodes) / (slab)->stride)
+
+#define SLAB_WORD(index) ((index) / SLAB_BITSET_WORD_BITS)
+#define SLAB_BIT(index) ((uint32_t)1 << ((index) % SLAB_BITSET_WORD_BITS))
+
+#ifdef SLAB_CANARIES
+static void prv_set_canary(Slab *slab, size_t index) {
+  const uint32_t canary = SLAB_CANARY;
+  memcpy((uint8_t *)SLAB_GET(slab, index) + slab->node_size, &canary, sizeof(canary));
+}
+
+static bool prv_canary_ok(Slab *slab, size_t index) {
+  uint32_t canary = 0;
+  memcpy(&canary, (uint8_t *)SLAB_GET(slab, index) + slab->node_size, sizeof(canary));
+  if (canary != SLAB_CANARY) {
+    slab->stats.corrupted++;
+    return false;
+  }
+  return true;
+}
+#else
+static void prv_set_canary(Slab *slab, size_t index) {}
+
+static bool prv_canary_ok(Slab *slab, size_t index) {
+  return true;
+}
+#endif
+
+// Resets the node and marks it free
+static void prv_release(Slab *slab, size_t index) {
+  void *node = SLAB_GET(slab, index);
+  memset(node, 0, slab->node_size);
+  if (slab->init_node != NULL) {
+    slab->init_node(node, slab->context);
+  }
+  prv_set_canary(slab, index);
+
+  slab->free_bitset[SLAB_WORD(index)] |= SLAB_BIT(index);
+  slab->free_summary |= SLAB_BIT(SLAB_WORD(index));
+}
+
+StatusCode slab_init_verbose(Slab *slab, void *buffer, size_t buffer_size, uint32_t *free_bitset,
+                             size_t bitset_words, size_t node_size, SlabNodeInitFn init_node,
+                             void *context) {
+  if (slab == NULL || buffer == NULL || free_bitset == NULL || node_size == 0) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  size_t stride = SLAB_NODE_STRIDE(node_size);
+  size_t num_nodes = buffer_size / stride;
+  if (num_nodes > SLAB_MAX_NODES) {
+    return status_code(STATUS_CODE_OUT_OF_RANGE);
+  }
+  if (bitset_words < SLAB_BITSET_WORDS(num_nodes)) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  memset(slab, 0, sizeof(*slab));
+  memset(free_bitset, 0, bitset_words * sizeof(free_bitset[0]));
+
+  slab->nodes = buffer;
+  slab->context = context;
+  slab->init_node = init_node;
+  slab->num_nodes = num_nodes;
+  slab->node_size = node_size;
+  slab->stride = stride;
+  slab->free_bitset = free_bitset;
+
+  for (size_t i = 0; i < num_nodes; i++) {
+    prv_release(slab, i);
+  }
+
+  return STATUS_CODE_OK;
+}
+
+void *slab_get_node(Slab *slab) {
+  bool disabled = critical_section_start();
+
+  if (slab->free_summary == 0) {
+    slab->stats.failed++;
+    critical_section_end(disabled);
+    return NULL;
+  }
+
+  size_t word = (size_t)__builtin_ctz(slab->free_summary);
+  size_t index = word * SLAB_BITSET_WORD_BITS + (size_t)__builtin_ctz(slab->free_bitset[word]);
+
+  slab->free_bitset[word] &= ~SLAB_BIT(index);
+  if (slab->free_bitset[word] == 0) {
+    slab->free_summary &= ~SLAB_BIT(word);
+  }
+
+  slab->stats.in_use++;
+  if (slab->stats.in_use > slab->stats.high_water) {
+    slab->stats.high_water = slab->stats.in_use;
+  }
+
+  // Free nodes aren't written, so a bad canary here means the node before it overran
+  if (!prv_canary_ok(slab, index)) {
+    prv_set_canary(slab, index);
+  }
+
+  critical_section_end(disabled);
+
+  return SLAB_GET(slab, index);
+}
+
+StatusCode slab_free_node(Slab *slab, void *node) {
+  bool disabled = critical_section_start();
+
+  if (node == NULL || SLAB_NODE_INVALID(slab, node)) {
+    critical_section_end(disabled);
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  size_t index = SLAB_GET_INDEX(slab, node);
+  if (slab->free_bitset[SLAB_WORD(index)] & SLAB_BIT(index)) {
+    // Already free
+    critical_section_end(disabled);
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  bool canary_ok = prv_canary_ok(slab, index);
+  prv_release(slab, index);
+  slab->stats.in_use--;
+
+  critical_section_end(disabled);
+
+  if (!canary_ok) {
+    return status_code(STATUS_CODE_INTERNAL_ERROR);
+  }
+  return STATUS_CODE_OK;
+}
+
+StatusCode slab_check_canaries(Slab *slab) {
+  bool disabled = critical_section_start();
+
+  bool canaries_ok = true;
+  for (size_t i = 0; i < slab->num_nodes; i++) {
+    canaries_ok &= prv_canary_ok(slab, i);
+  }
+
+  critical_section_end(disabled);
+
+  if (!canaries_ok) {
+    return status_code(STATUS_CODE_INTERNAL_ERROR);
+  }
+  return STATUS_CODE_OK;
+}
+
+const SlabStats *slab_get_stats(const Slab *slab) {
+  return &slab->stats;
+}
+
+StatusCode slab_allocator_init_verbose(SlabAllocator *allocator, Slab *classes,
+                                       size_t num_classes) {
+  if (allocator == NULL || classes == NULL || num_classes == 0) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+  for (size_t i = 1; i < num_classes; i++) {
+    if (classes[i].node_size <= classes[i - 1].node_size) {
+      return status_code(STATUS_CODE_INVALID_ARGS);
+    }
+  }
+
+  allocator->classes = classes;
+  allocator->num_classes = num_classes;
+  return STATUS_CODE_OK;
+}
+
+void *slab_alloc(SlabAllocator *allocator, size_t size) {
+  for (size_t i = 0; i < allocator->num_classes; i++) {
+    Slab *slab = &allocator->classes[i];
+    if (slab->node_size < size) {
+      continue;
+    }
+
+    // Fall back to larger classes once this one is full
+    void *node = slab_get_node(slab);
+    if (node != NULL) {
+      return node;
+    }
+  }
+  return NULL;
+}
+
+StatusCode slab_free(SlabAllocator *allocator, void *node) {
+  for (size_t i = 0; i < allocator->num_classes; i++) {
+    Slab *slab = &allocator->classes[i];
+    if (SLAB_NODE_IN_RANGE(slab, node)) {
+      return slab_free_node(slab, node);
+    }
+  }
+  return status_code(STATUS_CODE_INVALID_ARGS);
+}
@@ -0,0 +1,26 @@
+#include "bench.h"
+
+#include "stm32f0xx.h"
+
+// The Cortex-M0 has no DWT cycle counter, so free-run SysTick at the core clock instead.
+#define BENCH_CLOCK_MASK SysTick_LOAD_RELOAD_Msk
+
+void bench_clock_init(void) {
+  SysTick->CTRL = 0;
+  SysTick->LOAD = BENCH_CLOCK_MASK;
+  SysTick->VAL = 0;
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+
+uint32_t bench_clock_now(void) {
+  return SysTick->VAL;
+}
+
+uint32_t bench_clock_elapsed(uint32_t start, uint32_t end) {
+  // SysTick counts down and wraps at 24 bits
+  return (start - end) & BENCH_CLOCK_MASK;
+}
+
+const char *bench_clock_unit(void) {
+  return "cycles";
+}
@@ -0,0 +1,15 @@
+#include "flight_recorder.h"
+
+#include "retarget.h"
+
+// Not cleared by the startup code, so a frozen ring survives until the next boot
+static FlightRecorderRing s_ring __attribute__((section(".noinit")));
+
+FlightRecorderRing *flight_recorder_ring_init(void) {
+  return &s_ring;
+}
+
+// Overrides the weak hook called by the hard fault handler
+void retarget_hard_fault_hook(uint32_t pc, uint32_t lr) {
+  flight_recorder_freeze(FLIGHT_RECORDER_FAULT_HARD_FAULT, pc);
+}
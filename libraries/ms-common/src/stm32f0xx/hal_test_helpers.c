@@ -8,3 +8,16 @@ void _test_soft_timer_set_counter(uint32_t counter_value) {
   TIM_SetCounter(TIM2, counter_value);
   return;
 }
+
+// These aren't tracked on hardware to keep the GPIO and SPI paths lean.
+uint32_t _test_gpio_get_num_writes(void) {
+  return 0;
+}
+
+uint32_t _test_spi_get_num_transactions(void) {
+  return 0;
+}
+
+StatusCode _test_uart_connect(UartPort uart, int fd) {
+  return status_code(STATUS_CODE_UNIMPLEMENTED);
+}
@@ -118,6 +118,10 @@ uint32_t soft_timer_remaining_time(SoftTimerId timer_id) {
   }
 }
 
+uint32_t soft_timer_get_current_time(void) {
+  return TIM_GetCounter(TIM2);
+}
+
 static void prv_init_periph(void) {
   RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
 
@@ -1,19 +1,26 @@
 #include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "log.h"
 
 #include "adc.h"
+#include "adc_source.h"
+#include "critical_section.h"
 #include "interrupt.h"
 #include "soft_timer.h"
+#include "x86_cmd.h"
 // x86 implementation very similar to STM32F0 implementation.
-// adc_read_raw should always return 4090.
+// Raw readings come from each channel's signal source (see adc_source.h).
 // Vdda locked at 3300 mV.
-// adc_read_converted should always return close to 2V
 // temperature reading always returns 293 kelvin.
 
-#define ADC_RETURNED_VOLTAGE_RAW 2500
-#define ADC_CONTINUOUS_CB_FREQ_MS 50
 #define ADC_TEMP_RETURN 293
 #define ADC_VDDA_RETURN 3300
+#define ADC_CMD "adc"
+// Quarter of a sine wave in Q15 - the rest of the cycle is mirrored from it
+#define ADC_SINE_QUARTER_STEPS 64
+#define ADC_SINE_STEPS (4 * ADC_SINE_QUARTER_STEPS)
 
 typedef struct AdcInterrupt {
   AdcCallback callback;
@@ -22,10 +29,238 @@ typedef struct AdcInterrupt {
   uint16_t reading;
 } AdcInterrupt;
 
+typedef struct AdcSourceData {
+  AdcSource source;
+  // Conversions since the source was set
+  uint32_t num_samples;
+  uint32_t noise_state;
+  uint16_t *replay;
+  size_t replay_len;
+} AdcSourceData;
+
 static AdcInterrupt s_adc_interrupts[NUM_ADC_CHANNELS];
 
 static bool s_active_channels[NUM_ADC_CHANNELS];
 
+static AdcSourceData s_sources[NUM_ADC_CHANNELS] = {
+  [0 ... NUM_ADC_CHANNELS - 1] = { .source = { .type = ADC_SOURCE_CONSTANT,
+                                               .offset = ADC_SOURCE_DEFAULT_RAW } },
+};
+static uint32_t s_sample_period_us = ADC_SOURCE_DEFAULT_SAMPLE_PERIOD_US;
+static SoftTimerId s_scan_timer = SOFT_TIMER_INVALID_TIMER;
+static bool s_continuous = false;
+static bool s_cmd_registered = false;
+
+static const int16_t s_sine_quarter[ADC_SINE_QUARTER_STEPS + 1] = {
+  0,     804,   1608,  2410,  3212,  4011,  4808,  5602,  6393,  7179,  7962,  8739,  9512,
+  10278, 11039, 11793, 12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530, 18204, 18868,
+  19519, 20159, 20787, 21403, 22005, 22594, 23170, 23731, 24279, 24811, 25329, 25832, 26319,
+  26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956, 30273, 30571, 30852, 31113,
+  31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757, 32767,
+};
+
+// sin(2 * pi * step / ADC_SINE_STEPS) in Q15
+static int32_t prv_sine(uint32_t step) {
+  uint32_t quarter_step = step % ADC_SINE_QUARTER_STEPS;
+  switch (step / ADC_SINE_QUARTER_STEPS) {
+    case 0:
+      return s_sine_quarter[quarter_step];
+    case 1:
+      return s_sine_quarter[ADC_SINE_QUARTER_STEPS - quarter_step];
+    case 2:
+      return -s_sine_quarter[quarter_step];
+    default:
+      return -s_sine_quarter[ADC_SINE_QUARTER_STEPS - quarter_step];
+  }
+}
+
+// xorshift32
+static uint32_t prv_noise(uint32_t *state) {
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+// Samples the channel's source once. Must be called within a critical section.
+static uint16_t prv_sample(AdcChannel adc_channel) {
+  AdcSourceData *data = &s_sources[adc_channel];
+  const AdcSource *source = &data->source;
+  uint64_t time_us = (uint64_t)data->num_samples * s_sample_period_us;
+  uint32_t sample = data->num_samples++;
+  int32_t value = source->offset;
+
+  switch (source->type) {
+    case ADC_SOURCE_SINE:
+      if (source->period_us != 0) {
+        uint32_t step = (uint32_t)(time_us % source->period_us * ADC_SINE_STEPS /
+                                   source->period_us);
+        value += source->amplitude * prv_sine(step) / 32768;
+      }
+      break;
+    case ADC_SOURCE_RAMP:
+      if (source->period_us != 0) {
+        value += (int32_t)(time_us % source->period_us * source->amplitude / source->period_us);
+      }
+      break;
+    case ADC_SOURCE_NOISE:
+      value += (int32_t)(prv_noise(&data->noise_state) % (2u * source->amplitude + 1)) -
+               source->amplitude;
+      break;
+    case ADC_SOURCE_REPLAY:
+      value = data->replay[sample % data->replay_len];
+      break;
+    default:
+      break;
+  }
+
+  if (value < 0) {
+    return 0;
+  }
+  return (value > ADC_SOURCE_MAX_RAW) ? ADC_SOURCE_MAX_RAW : (uint16_t)value;
+}
+
+static bool prv_is_csv(const char *path) {
+  size_t len = strlen(path);
+  return len >= 4 && strcmp(path + len - 4, ".csv") == 0;
+}
+
+// Reads the whole replay file into a buffer owned by the caller
+static StatusCode prv_load_replay(const char *path, uint16_t **values, size_t *num_values) {
+  FILE *file = fopen(path, prv_is_csv(path) ? "r" : "rb");
+  if (file == NULL) {
+    return status_msg(STATUS_CODE_INVALID_ARGS, "Could not open ADC replay file");
+  }
+
+  size_t capacity = 256;
+  size_t len = 0;
+  uint16_t *buf = malloc(capacity * sizeof(*buf));
+  while (buf != NULL) {
+    if (len == capacity) {
+      capacity *= 2;
+      uint16_t *bigger = realloc(buf, capacity * sizeof(*buf));
+      if (bigger == NULL) {
+        free(buf);
+        buf = NULL;
+        break;
+      }
+      buf = bigger;
+    }
+
+    if (prv_is_csv(path)) {
+      char line[64];
+      if (fgets(line, sizeof(line), file) == NULL) {
+        break;
+      } else if (line[0] >= '0' && line[0] <= '9') {
+        uint64_t value = strtoull(line, NULL, 10);
+        buf[len++] = (uint16_t)((value > ADC_SOURCE_MAX_RAW) ? ADC_SOURCE_MAX_RAW : value);
+      }
+    } else {
+      size_t num_read = fread(buf + len, sizeof(*buf), capacity - len, file);
+      if (num_read == 0) {
+        break;
+      }
+      len += num_read;
+    }
+  }
+  fclose(file);
+
+  if (buf == NULL) {
+    return status_code(STATUS_CODE_RESOURCE_EXHAUSTED);
+  } else if (len == 0) {
+    free(buf);
+    return status_msg(STATUS_CODE_INVALID_ARGS, "ADC replay file is empty");
+  }
+
+  for (size_t i = 0; i < len; i++) {
+    if (buf[i] > ADC_SOURCE_MAX_RAW) {
+      buf[i] = ADC_SOURCE_MAX_RAW;
+    }
+  }
+  *values = buf;
+  *num_values = len;
+  return STATUS_CODE_OK;
+}
+
+StatusCode adc_source_set(AdcChannel adc_channel, const AdcSource *source) {
+  if (adc_channel >= NUM_ADC_CHANNELS || source == NULL || source->type >= NUM_ADC_SOURCE_TYPES) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  uint16_t *replay = NULL;
+  size_t replay_len = 0;
+  if (source->type == ADC_SOURCE_REPLAY) {
+    if (source->replay_file == NULL) {
+      return status_code(STATUS_CODE_INVALID_ARGS);
+    }
+    status_ok_or_return(prv_load_replay(source->replay_file, &replay, &replay_len));
+  }
+
+  bool disabled = critical_section_start();
+  AdcSourceData *data = &s_sources[adc_channel];
+  uint16_t *old_replay = data->replay;
+  data->source = *source;
+  // The file has already been read
+  data->source.replay_file = NULL;
+  data->num_samples = 0;
+  data->noise_state = adc_channel + 1u;
+  data->replay = replay;
+  data->replay_len = replay_len;
+  critical_section_end(disabled);
+
+  free(old_replay);
+  return STATUS_CODE_OK;
+}
+
+StatusCode adc_source_set_sample_period(uint32_t sample_period_us) {
+  if (sample_period_us == 0) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+  s_sample_period_us = sample_period_us;
+  return STATUS_CODE_OK;
+}
+
+static void prv_cmd_handler(int client_fd, const char *cmd, const char *args[], size_t num_args,
+                            void *context) {
+  static const char *type_names[NUM_ADC_SOURCE_TYPES] = {
+    [ADC_SOURCE_CONSTANT] = "const",  //
+    [ADC_SOURCE_SINE] = "sine",       //
+    [ADC_SOURCE_RAMP] = "ramp",       //
+    [ADC_SOURCE_NOISE] = "noise",     //
+    [ADC_SOURCE_REPLAY] = "replay",   //
+  };
+
+  if (num_args == 2 && strcmp(args[0], "rate") == 0) {
+    adc_source_set_sample_period((uint32_t)strtoul(args[1], NULL, 10));
+    return;
+  } else if (num_args < 2) {
+    LOG_WARN("Usage: adc <channel> <source> [args...] or adc rate <sample_period_us>\n");
+    return;
+  }
+
+  AdcSource source = { .type = NUM_ADC_SOURCE_TYPES };
+  for (AdcSourceType i = 0; i < NUM_ADC_SOURCE_TYPES; i++) {
+    if (strcmp(args[1], type_names[i]) == 0) {
+      source.type = i;
+    }
+  }
+
+  if (source.type == ADC_SOURCE_REPLAY) {
+    source.replay_file = (num_args > 2) ? args[2] : NULL;
+  } else {
+    source.offset = (num_args > 2) ? (uint16_t)strtoul(args[2], NULL, 10) : 0;
+    source.amplitude = (num_args > 3) ? (uint16_t)strtoul(args[3], NULL, 10) : 0;
+    source.period_us = (num_args > 4) ? (uint32_t)strtoul(args[4], NULL, 10) : 0;
+  }
+
+  AdcChannel adc_channel = (AdcChannel)strtoul(args[0], NULL, 10);
+  if (!status_ok(adc_source_set(adc_channel, &source))) {
+    LOG_WARN("Invalid ADC source for channel %s\n", args[0]);
+  }
+}
+
 static uint16_t prv_get_temp(uint16_t reading) {
   return ADC_TEMP_RETURN;
 }
@@ -66,22 +301,46 @@ static GpioAddress prv_channel_to_gpio(uint8_t adc_channel) {
   return address;
 }
 
+static void prv_convert(AdcChannel adc_channel) {
+  bool disabled = critical_section_start();
+  s_adc_interrupts[adc_channel].reading = prv_sample(adc_channel);
+  critical_section_end(disabled);
+}
+
+// Mimics the EOC interrupt
+static void prv_run_callback(AdcChannel adc_channel) {
+  if (s_adc_interrupts[adc_channel].callback != NULL) {
+    s_adc_interrupts[adc_channel].callback(adc_channel, s_adc_interrupts[adc_channel].context);
+  } else if (s_adc_interrupts[adc_channel].pin_callback != NULL) {
+    s_adc_interrupts[adc_channel].pin_callback(prv_channel_to_gpio(adc_channel),
+                                               s_adc_interrupts[adc_channel].context);
+  }
+}
+
 static void prv_periodic_continous_cb(SoftTimerId id, void *context) {
   for (AdcChannel i = 0; i < NUM_ADC_CHANNELS; i++) {
-    if (s_adc_interrupts[i].callback != NULL) {
-      s_adc_interrupts[i].callback(i, s_adc_interrupts[i].context);
-    } else if (s_adc_interrupts[i].pin_callback != NULL) {
-      s_adc_interrupts[i].pin_callback(prv_channel_to_gpio(i), s_adc_interrupts[i].context);
+    if (s_active_channels[i]) {
+      prv_convert(i);
+      prv_run_callback(i);
     }
   }
-  soft_timer_start_millis(ADC_CONTINUOUS_CB_FREQ_MS, prv_periodic_continous_cb, NULL, NULL);
+  soft_timer_start(s_sample_period_us, prv_periodic_continous_cb, NULL, &s_scan_timer);
 }
 
 void adc_init(AdcMode adc_mode) {
   interrupt_init();
   soft_timer_init();
-  if (adc_mode == ADC_MODE_CONTINUOUS) {
-    soft_timer_start_millis(ADC_CONTINUOUS_CB_FREQ_MS, prv_periodic_continous_cb, NULL, NULL);
+  if (!s_cmd_registered) {
+    x86_cmd_register_handler(ADC_CMD, prv_cmd_handler, NULL);
+    s_cmd_registered = true;
+  }
+
+  // soft_timer_init() doesn't cancel timers
+  soft_timer_cancel(s_scan_timer);
+  s_scan_timer = SOFT_TIMER_INVALID_TIMER;
+  s_continuous = (adc_mode == ADC_MODE_CONTINUOUS);
+  if (s_continuous) {
+    soft_timer_start(s_sample_period_us, prv_periodic_continous_cb, NULL, &s_scan_timer);
   }
   for (size_t i = 0; i < NUM_ADC_CHANNELS; ++i) {
     prv_reset_channel(i);
@@ -134,17 +393,16 @@ StatusCode adc_register_callback(AdcChannel adc_channel, AdcCallback callback, v
 
 StatusCode adc_read_raw(AdcChannel adc_channel, uint16_t *reading) {
   status_ok_or_return(prv_check_channel_valid_and_enabled(adc_channel));
-  s_adc_interrupts[adc_channel].reading = ADC_RETURNED_VOLTAGE_RAW;
-  *reading = s_adc_interrupts[adc_channel].reading;
-
-  // this section mimics the IRQ handler
-  if (s_adc_interrupts[adc_channel].callback != NULL) {
-    s_adc_interrupts[adc_channel].callback(adc_channel, s_adc_interrupts[adc_channel].context);
-  } else if (s_adc_interrupts[adc_channel].pin_callback != NULL) {
-    s_adc_interrupts[adc_channel].pin_callback(prv_channel_to_gpio(adc_channel),
-                                               s_adc_interrupts[adc_channel].context);
+  // Like on STM32, continuous mode returns the last reading from the scan
+  if (s_continuous) {
+    *reading = s_adc_interrupts[adc_channel].reading;
+    return STATUS_CODE_OK;
   }
 
+  prv_convert(adc_channel);
+  *reading = s_adc_interrupts[adc_channel].reading;
+  prv_run_callback(adc_channel);
+
   return STATUS_CODE_OK;
 }
 
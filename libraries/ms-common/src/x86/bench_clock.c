@@ -0,0 +1,34 @@
+#include "bench.h"
+
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+
+void bench_clock_init(void) {}
+
+uint32_t bench_clock_now(void) {
+  return (uint32_t)__rdtsc();
+}
+
+const char *bench_clock_unit(void) {
+  return "tsc";
+}
+#else
+void bench_clock_init(void) {}
+
+uint32_t bench_clock_now(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)((uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec);
+}
+
+const char *bench_clock_unit(void) {
+  return "ns";
+}
+#endif
+
+uint32_t bench_clock_elapsed(uint32_t start, uint32_t end) {
+  // Both clocks count up, and unsigned subtraction handles the 32-bit wrap
+  return end - start;
+}
@@ -8,12 +8,15 @@
 #include <pthread.h>
 #include <semaphore.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
+#include "can_trace.h"
 #include "fifo.h"
 #include "interrupt_def.h"
 #include "log.h"
@@ -24,6 +27,10 @@
 #define CAN_HW_TX_FIFO_LEN 8
 // Check for thread exit once every 10ms
 #define CAN_HW_THREAD_EXIT_PERIOD_US 10000
+// If set, every frame sent or received is recorded to this file as a binary CAN trace
+#define CAN_HW_TRACE_USER_ENV "MIDSUN_X86_CAN_TRACE_FILE"
+// Enough to index ~1M frames, past which the trace is left for the reader to index
+#define CAN_HW_TRACE_MAX_CHUNKS 4096
 
 typedef struct CanHwEventHandler {
   CanHwEventHandlerCb callback;
@@ -52,6 +59,12 @@ static pthread_mutex_t s_keep_alive = PTHREAD_MUTEX_INITIALIZER;
 
 static CanHwSocketData s_socket_data = { .can_fd = -1 };
 
+// The trace is shared by the RX and TX threads
+static pthread_mutex_t s_trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static FILE *s_trace_fp = NULL;
+static CanTraceWriter s_trace_writer;
+static uint64_t s_trace_index[CAN_HW_TRACE_MAX_CHUNKS];
+
 static uint32_t prv_get_delay(CanHwBitrate bitrate) {
   const uint32_t delay_us[NUM_CAN_HW_BITRATES] = {
     1000,  // 125 kbps
@@ -63,6 +76,60 @@ static uint32_t prv_get_delay(CanHwBitrate bitrate) {
   return delay_us[bitrate];
 }
 
+static void prv_trace_close(void) {
+  pthread_mutex_lock(&s_trace_lock);
+  if (s_trace_fp != NULL) {
+    can_trace_writer_close(&s_trace_writer);
+    fclose(s_trace_fp);
+    s_trace_fp = NULL;
+  }
+  pthread_mutex_unlock(&s_trace_lock);
+}
+
+static void prv_trace_open(void) {
+  const char *trace_filename = getenv(CAN_HW_TRACE_USER_ENV);
+  if (trace_filename == NULL || s_trace_fp != NULL) {
+    return;
+  }
+
+  s_trace_fp = fopen(trace_filename, "wb");
+  if (s_trace_fp == NULL ||
+      can_trace_writer_init(&s_trace_writer, s_trace_fp, s_trace_index, CAN_HW_TRACE_MAX_CHUNKS) !=
+          STATUS_CODE_OK) {
+    LOG_WARN("CAN HW: Failed to open trace file %s\n", trace_filename);
+    if (s_trace_fp != NULL) {
+      fclose(s_trace_fp);
+      s_trace_fp = NULL;
+    }
+    return;
+  }
+
+  LOG_DEBUG("CAN HW: Tracing to %s\n", trace_filename);
+  atexit(prv_trace_close);
+}
+
+static void prv_trace_frame(const struct can_frame *frame, uint8_t flags) {
+  if (s_trace_fp == NULL) {
+    return;
+  }
+
+  // Use the monotonic clock so traces recorded by different processes line up
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const uint64_t timestamp_us = (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+
+  bool extended = !!(frame->can_id & CAN_EFF_FLAG);
+  CanTraceRecord record;
+  can_trace_record_init(&record, timestamp_us, frame->can_id, extended, frame->data,
+                        frame->can_dlc, flags);
+
+  pthread_mutex_lock(&s_trace_lock);
+  if (s_trace_fp != NULL) {
+    can_trace_writer_append(&s_trace_writer, &record);
+  }
+  pthread_mutex_unlock(&s_trace_lock);
+}
+
 static void *prv_rx_thread(void *arg) {
   x86_interrupt_pthread_init();
   LOG_DEBUG("CAN HW RX thread started\n");
@@ -83,6 +150,9 @@ static void *prv_rx_thread(void *arg) {
     if (FD_ISSET(s_socket_data.can_fd, &input_fds)) {
       int bytes =
           read(s_socket_data.can_fd, &s_socket_data.rx_frame, sizeof(s_socket_data.rx_frame));
+      if (bytes == (int)sizeof(s_socket_data.rx_frame)) {
+        prv_trace_frame(&s_socket_data.rx_frame, 0);
+      }
 
       if (s_socket_data.handlers[CAN_HW_EVENT_MSG_RX].callback != NULL) {
         s_socket_data.handlers[CAN_HW_EVENT_MSG_RX].callback(
@@ -112,6 +182,9 @@ static void *prv_tx_thread(void *arg) {
     sem_wait(&s_tx_sem);
     fifo_pop(&s_socket_data.tx_fifo, &frame);
     int bytes = write(s_socket_data.can_fd, &frame, sizeof(frame));
+    if (bytes == (int)sizeof(frame)) {
+      prv_trace_frame(&frame, CAN_TRACE_FLAG_TX);
+    }
 
     // Delay to simulate bus speed
     usleep(s_socket_data.delay_us);
@@ -189,6 +262,7 @@ StatusCode can_hw_init(const CanHwSettings *settings) {
   }
 
   LOG_DEBUG("CAN HW initialized on %s\n", CAN_HW_DEV_INTERFACE);
+  prv_trace_open();
 
   // 3 threads total: main, TX, RX
   pthread_barrier_init(&s_barrier, NULL, 3);
@@ -0,0 +1,196 @@
+#include "can_trace.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "log.h"
+
+#define CAN_TRACE_REPLAY_DEV_INTERFACE "vcan0"
+// How long to back off when the interface's TX queue is full
+#define CAN_TRACE_REPLAY_RETRY_US 100
+
+static bool prv_has_index(CanTraceReader *reader, size_t body_size) {
+  if (body_size < sizeof(CanTraceFooter)) {
+    return false;
+  }
+
+  CanTraceFooter footer;
+  memcpy(&footer, reader->map + reader->map_size - sizeof(footer), sizeof(footer));
+  const size_t index_size = (size_t)footer.num_chunks * sizeof(uint64_t);
+  const size_t num_chunks =
+      (size_t)((footer.num_records + CAN_TRACE_CHUNK_RECORDS - 1) / CAN_TRACE_CHUNK_RECORDS);
+  if (footer.magic != CAN_TRACE_FOOTER_MAGIC || footer.num_chunks != num_chunks ||
+      footer.num_records * sizeof(CanTraceRecord) + index_size + sizeof(footer) != body_size) {
+    return false;
+  }
+
+  reader->num_records = (size_t)footer.num_records;
+  reader->chunk_index = (const uint64_t *)(reader->map + sizeof(CanTraceHeader) +
+                                           reader->num_records * sizeof(CanTraceRecord));
+  reader->num_chunks = footer.num_chunks;
+  return true;
+}
+
+static StatusCode prv_rebuild_index(CanTraceReader *reader, size_t body_size) {
+  // Drop any partially written record at the end
+  reader->num_records = body_size / sizeof(CanTraceRecord);
+  reader->num_chunks =
+      (reader->num_records + CAN_TRACE_CHUNK_RECORDS - 1) / CAN_TRACE_CHUNK_RECORDS;
+  if (reader->num_chunks == 0) {
+    return STATUS_CODE_OK;
+  }
+
+  reader->owned_index = malloc(reader->num_chunks * sizeof(uint64_t));
+  if (reader->owned_index == NULL) {
+    return status_code(STATUS_CODE_RESOURCE_EXHAUSTED);
+  }
+  for (size_t chunk = 0; chunk < reader->num_chunks; chunk++) {
+    reader->owned_index[chunk] = reader->records[chunk * CAN_TRACE_CHUNK_RECORDS].timestamp_us;
+  }
+  reader->chunk_index = reader->owned_index;
+  return STATUS_CODE_OK;
+}
+
+StatusCode can_trace_reader_open(CanTraceReader *reader, const char *path) {
+  if (reader == NULL || path == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+  memset(reader, 0, sizeof(*reader));
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return status_msg(STATUS_CODE_UNREACHABLE, "CAN trace: failed to open trace");
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(CanTraceHeader)) {
+    close(fd);
+    return status_msg(STATUS_CODE_INVALID_ARGS, "CAN trace: not a trace");
+  }
+
+  reader->map_size = (size_t)st.st_size;
+  void *map = mmap(NULL, reader->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return status_msg(STATUS_CODE_INTERNAL_ERROR, "CAN trace: failed to map trace");
+  }
+  reader->map = map;
+
+  const CanTraceHeader *header = (const CanTraceHeader *)reader->map;
+  if (header->magic != CAN_TRACE_MAGIC || header->version != CAN_TRACE_VERSION ||
+      header->record_size != sizeof(CanTraceRecord) ||
+      header->chunk_records != CAN_TRACE_CHUNK_RECORDS) {
+    can_trace_reader_close(reader);
+    return status_msg(STATUS_CODE_INVALID_ARGS, "CAN trace: unsupported trace");
+  }
+
+  reader->records = (const CanTraceRecord *)(reader->map + sizeof(CanTraceHeader));
+  const size_t body_size = reader->map_size - sizeof(CanTraceHeader);
+  if (!prv_has_index(reader, body_size)) {
+    LOG_DEBUG("CAN trace: %s has no index, rebuilding\n", path);
+    StatusCode status = prv_rebuild_index(reader, body_size);
+    if (status != STATUS_CODE_OK) {
+      can_trace_reader_close(reader);
+      return status;
+    }
+  }
+
+  return STATUS_CODE_OK;
+}
+
+size_t can_trace_reader_seek(const CanTraceReader *reader, uint64_t timestamp_us) {
+  return can_trace_find(reader->records, reader->num_records, reader->chunk_index,
+                        reader->num_chunks, timestamp_us);
+}
+
+void can_trace_reader_close(CanTraceReader *reader) {
+  if (reader->map != NULL) {
+    munmap((void *)reader->map, reader->map_size);
+  }
+  free(reader->owned_index);
+  memset(reader, 0, sizeof(*reader));
+}
+
+static int prv_open_socket(void) {
+  int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+  if (fd < 0) {
+    return -1;
+  }
+
+  struct ifreq ifr = { 0 };
+  snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s", CAN_TRACE_REPLAY_DEV_INTERFACE);
+  if (ioctl(fd, SIOCGIFINDEX, &ifr) < 0) {
+    close(fd);
+    return -1;
+  }
+
+  struct sockaddr_can addr = {
+    .can_family = AF_CAN,
+    .can_ifindex = ifr.ifr_ifindex,
+  };
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static void prv_add_us(struct timespec *ts, uint64_t us) {
+  const uint64_t ns = (uint64_t)ts->tv_nsec + (us % 1000000) * 1000;
+  ts->tv_sec += (time_t)(us / 1000000 + ns / 1000000000);
+  ts->tv_nsec = (__typeof__(ts->tv_nsec))(ns % 1000000000);
+}
+
+StatusCode can_trace_replay(const CanTraceReader *reader, const CanTraceReplaySettings *settings) {
+  if (reader == NULL || settings == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  int fd = prv_open_socket();
+  if (fd < 0) {
+    return status_msg(STATUS_CODE_INTERNAL_ERROR, "CAN trace: failed to open CAN socket");
+  }
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  const uint64_t first_us = (reader->num_records > 0) ? reader->records[0].timestamp_us : 0;
+
+  for (size_t i = 0; i < reader->num_records; i++) {
+    const CanTraceRecord *record = &reader->records[i];
+    if (!settings->include_tx && (record->flags & CAN_TRACE_FLAG_TX)) {
+      continue;
+    }
+
+    // Sleep until the record's absolute deadline so timing errors don't accumulate
+    if (settings->speed_percent != 0) {
+      struct timespec deadline = start;
+      prv_add_us(&deadline, (record->timestamp_us - first_us) * 100 / settings->speed_percent);
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+        // interrupted by a signal - keep waiting for the same deadline
+      }
+    }
+
+    struct can_frame frame = { .can_id = record->raw_id, .can_dlc = record->dlc };
+    memcpy(frame.data, record->data, sizeof(frame.data));
+    while (write(fd, &frame, sizeof(frame)) < 0) {
+      if (errno != ENOBUFS && errno != EAGAIN) {
+        close(fd);
+        return status_msg(STATUS_CODE_INTERNAL_ERROR, "CAN trace: failed to write frame");
+      }
+      usleep(CAN_TRACE_REPLAY_RETRY_US);
+    }
+  }
+
+  close(fd);
+  return STATUS_CODE_OK;
+}
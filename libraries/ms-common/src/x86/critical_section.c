@@ -2,49 +2,63 @@
 
 #include <signal.h>
 #include <stdbool.h>
-#include <unistd.h>
+#include <stdint.h>
 
-#include <pthread.h>
-
-#include "interrupt_def.h"
 #include "x86_interrupt.h"
 
-static bool s_interrupts_disabled = false;
-static pthread_mutex_t s_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
-
-// WARNING: due to skipping the pthread_mutex lock in a signal_handler it is
-// possible that during a signal handler's critical section a data race occurs
-// due to another thread entering a critical section successfully during the
-// handler's execution. This is due to the signal handler not locking the mutex
-// however, this is to prevent deadlock. If this begins to be an issue we should
-// revisiting the mutex implementation here.
+// Interrupts only run on threads that don't block them, so masking them is
+// per-thread: each thread tracks its own nesting and only the outermost start
+// and end touch the signal mask.
+static __thread uint32_t s_depth = 0;
+// Whether the outermost start changed the signal mask, and what it was before
+static __thread bool s_masked = false;
+static __thread sigset_t s_prev_mask;
 
 bool critical_section_start(void) {
-  if (!x86_interrupt_in_handler()) {
-    pthread_mutex_lock(&s_mutex);
+  if (s_depth > 0) {
+    // Interrupts are already disabled
+    s_depth++;
+    return false;
+  }
+
+  // Skip the syscall if nothing could preempt us anyways. Otherwise interrupts
+  // still queue while masked like on an embedded device.
+  bool masked = !x86_interrupt_masked();
+  sigset_t prev_mask;
+  if (masked) {
+    x86_interrupt_mask(&prev_mask);
   }
-  if (!s_interrupts_disabled) {
-    // Update the signal mask to prevent interrupts from being executed on the
-    // signal handler thread. Note that they can still queue like on an embedded
-    // device.
-    x86_interrupt_mask();
-    s_interrupts_disabled = true;
-    // Interrupts got disabled.
-    return true;
+  // Keeps the CAN and socket threads out of the main thread's critical sections.
+  // It's always taken after masking so a handler can't preempt the thread holding it.
+  x86_interrupt_lock();
+
+  // Only touch the statics once interrupts are masked - a handler that preempts
+  // us before then runs its own outermost critical section
+  s_masked = masked;
+  if (masked) {
+    s_prev_mask = prev_mask;
   }
-  // Interrupts did not get disabled.
-  return false;
+  s_depth = 1;
+  return true;
 }
 
 void critical_section_end(bool disabled_in_scope) {
-  if (!x86_interrupt_in_handler()) {
-    pthread_mutex_unlock(&s_mutex);
+  if (s_depth == 0) {
+    return;
+  } else if (!disabled_in_scope) {
+    // The outermost critical section is only ended by the caller that started it
+    if (s_depth > 1) {
+      s_depth--;
+    }
+    return;
   }
-  if (s_interrupts_disabled && disabled_in_scope) {
-    // Clear the block mask for this process to allow signals to be processed.
-    // (They will queue when disabled).
-    s_interrupts_disabled = false;
-    x86_interrupt_unmask();
+
+  // Forcibly end all critical sections on this thread
+  s_depth = 0;
+  x86_interrupt_unlock();
+  if (s_masked) {
+    s_masked = false;
+    x86_interrupt_unmask(&s_prev_mask);
   }
 }
 
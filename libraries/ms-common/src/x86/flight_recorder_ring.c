@@ -0,0 +1,67 @@
+#include "flight_recorder.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "misc.h"
+
+#define FLIGHT_RECORDER_USER_ENV "MIDSUN_X86_FLIGHT_RECORDER_FILE"
+
+// Used if there's no file to back the ring - it won't survive the process exiting
+static FlightRecorderRing s_ring;
+static FlightRecorderRing *s_mapped_ring;
+
+static const int s_fault_signals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+
+static void prv_fault_handler(int signum, siginfo_t *info, void *ucontext) {
+  flight_recorder_freeze(FLIGHT_RECORDER_FAULT_HARD_FAULT, (uint32_t)(uintptr_t)info->si_addr);
+
+  // Crash as we would have without the handler
+  signal(signum, SIG_DFL);
+  raise(signum);
+}
+
+static FlightRecorderRing *prv_map_ring(const char *filename) {
+  int fd = open(filename, O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    return NULL;
+  }
+  // A new file reads as zeroes, which isn't a frozen ring
+  if (ftruncate(fd, sizeof(FlightRecorderRing)) < 0) {
+    close(fd);
+    return NULL;
+  }
+
+  void *map = mmap(NULL, sizeof(FlightRecorderRing), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  return (map == MAP_FAILED) ? NULL : map;
+}
+
+FlightRecorderRing *flight_recorder_ring_init(void) {
+  struct sigaction action = { .sa_sigaction = prv_fault_handler, .sa_flags = SA_SIGINFO };
+  sigemptyset(&action.sa_mask);
+  for (size_t i = 0; i < SIZEOF_ARRAY(s_fault_signals); i++) {
+    sigaction(s_fault_signals[i], &action, NULL);
+  }
+
+  const char *filename = getenv(FLIGHT_RECORDER_USER_ENV);
+  if (filename == NULL) {
+    return &s_ring;
+  }
+
+  // The mapping is shared with the file, so everything recorded lands in it even if we crash
+  if (s_mapped_ring == NULL) {
+    s_mapped_ring = prv_map_ring(filename);
+    if (s_mapped_ring == NULL) {
+      LOG_WARN("Flight recorder: could not map %s, recording to RAM\n", filename);
+      return &s_ring;
+    }
+    LOG_DEBUG("Using flight recorder file: %s\n", filename);
+  }
+  return s_mapped_ring;
+}
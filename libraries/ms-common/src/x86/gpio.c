@@ -3,16 +3,24 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "critical_section.h"
+#include "gpio_inject.h"
+#include "hal_test_helpers.h"
 #include "status.h"
 
 static GpioSettings s_pin_settings[GPIO_TOTAL_PINS];
 static uint8_t s_gpio_pin_input_value[GPIO_TOTAL_PINS];
 
+// Number of output writes, see |_test_gpio_get_num_writes|.
+static uint32_t s_num_writes = 0;
+
 static uint32_t prv_get_index(const GpioAddress *address) {
-  return address->port * (uint32_t)NUM_GPIO_PORTS + address->pin;
+  return address->port * (uint32_t)GPIO_PINS_PER_PORT + address->pin;
 }
 
 StatusCode gpio_init(void) {
+  gpio_inject_init();
+
   GpioSettings default_settings = {
     .direction = GPIO_DIR_IN,
     .state = GPIO_STATE_LOW,
@@ -44,6 +52,7 @@ StatusCode gpio_set_state(const GpioAddress *address, GpioState state) {
   }
 
   s_pin_settings[prv_get_index(address)].state = state;
+  s_num_writes++;
   return STATUS_CODE_OK;
 }
 
@@ -58,6 +67,7 @@ StatusCode gpio_toggle_state(const GpioAddress *address) {
   } else {
     s_pin_settings[index].state = GPIO_STATE_LOW;
   }
+  s_num_writes++;
   return STATUS_CODE_OK;
 }
 
@@ -76,3 +86,26 @@ StatusCode gpio_get_state(const GpioAddress *address, GpioState *state) {
   }
   return STATUS_CODE_OK;
 }
+
+StatusCode gpio_inject_set_state(const GpioAddress *address, GpioState state) {
+  if (address->port >= NUM_GPIO_PORTS || address->pin >= GPIO_PINS_PER_PORT ||
+      state >= NUM_GPIO_STATES) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  bool disabled = critical_section_start();
+  uint32_t index = prv_get_index(address);
+  bool changed = (s_gpio_pin_input_value[index] != state);
+  s_gpio_pin_input_value[index] = state;
+  critical_section_end(disabled);
+
+  if (changed) {
+    return gpio_inject_edge(address, (state == GPIO_STATE_HIGH) ? INTERRUPT_EDGE_RISING
+                                                                 : INTERRUPT_EDGE_FALLING);
+  }
+  return STATUS_CODE_OK;
+}
+
+uint32_t _test_gpio_get_num_writes(void) {
+  return s_num_writes;
+}
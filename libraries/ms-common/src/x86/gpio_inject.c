@@ -0,0 +1,198 @@
+// Socket commands and trace replay for gpio_inject.h
+// Traces are read up front, then replayed on a thread that sleeps until each entry's
+// absolute time so delays don't accumulate over long traces.
+#include "gpio_inject.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "log.h"
+#include "x86_cmd.h"
+#include "x86_interrupt.h"
+
+#define GPIO_INJECT_CMD "gpio"
+#define GPIO_INJECT_MAX_LINE_LEN 128
+
+typedef struct GpioInjectEntry {
+  uint64_t time_us;
+  GpioAddress address;
+  GpioState state;
+} GpioInjectEntry;
+
+typedef struct GpioInjectTrace {
+  GpioInjectEntry *entries;
+  size_t num_entries;
+} GpioInjectTrace;
+
+static bool s_cmd_registered = false;
+static bool s_replaying = false;
+
+// Accepts ports as letters (A, b) or numbers
+static bool prv_parse_port(const char *str, GpioPort *port) {
+  uint32_t value = 0;
+  if (isalpha((unsigned char)str[0])) {
+    value = (uint32_t)(toupper((unsigned char)str[0]) - 'A');
+  } else {
+    value = (uint32_t)strtoul(str, NULL, 10);
+  }
+  *port = (GpioPort)value;
+  return value < NUM_GPIO_PORTS;
+}
+
+static bool prv_parse_address(const char *port, const char *pin, GpioAddress *address) {
+  GpioPort parsed_port = NUM_GPIO_PORTS;
+  uint32_t parsed_pin = (uint32_t)strtoul(pin, NULL, 10);
+  if (!prv_parse_port(port, &parsed_port) || parsed_pin >= GPIO_PINS_PER_PORT) {
+    return false;
+  }
+  address->port = parsed_port;
+  address->pin = (uint8_t)parsed_pin;
+  return true;
+}
+
+static StatusCode prv_load_trace(const char *path, GpioInjectTrace *trace) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    return status_msg(STATUS_CODE_INVALID_ARGS, "Could not open GPIO trace");
+  }
+
+  size_t capacity = 64;
+  trace->entries = malloc(capacity * sizeof(*trace->entries));
+  trace->num_entries = 0;
+  StatusCode status = (trace->entries == NULL) ? status_code(STATUS_CODE_RESOURCE_EXHAUSTED)
+                                               : STATUS_CODE_OK;
+
+  char line[GPIO_INJECT_MAX_LINE_LEN];
+  uint64_t prev_time_us = 0;
+  while (status_ok(status) && fgets(line, sizeof(line), file) != NULL) {
+    char port[8] = { 0 };
+    char pin[8] = { 0 };
+    uint64_t time_us = 0;
+    uint32_t state = 0;
+    if (line[0] == '#' || line[0] == '\n') {
+      continue;
+    } else if (sscanf(line, "%" SCNu64 " %7s %7s %" SCNu32, &time_us, port, pin, &state) != 4 ||
+               time_us < prev_time_us || state >= NUM_GPIO_STATES) {
+      status = status_msg(STATUS_CODE_INVALID_ARGS, "Invalid GPIO trace entry");
+      break;
+    }
+
+    if (trace->num_entries == capacity) {
+      capacity *= 2;
+      GpioInjectEntry *bigger = realloc(trace->entries, capacity * sizeof(*trace->entries));
+      if (bigger == NULL) {
+        status = status_code(STATUS_CODE_RESOURCE_EXHAUSTED);
+        break;
+      }
+      trace->entries = bigger;
+    }
+
+    GpioInjectEntry *entry = &trace->entries[trace->num_entries];
+    if (!prv_parse_address(port, pin, &entry->address)) {
+      status = status_msg(STATUS_CODE_INVALID_ARGS, "Invalid GPIO trace address");
+      break;
+    }
+    entry->time_us = time_us;
+    entry->state = (GpioState)state;
+    prev_time_us = time_us;
+    trace->num_entries++;
+  }
+  fclose(file);
+
+  if (!status_ok(status)) {
+    free(trace->entries);
+    trace->entries = NULL;
+  }
+  return status;
+}
+
+static void *prv_replay_thread(void *arg) {
+  GpioInjectTrace *trace = arg;
+  x86_interrupt_pthread_init();
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < trace->num_entries; i++) {
+    const GpioInjectEntry *entry = &trace->entries[i];
+    uint64_t time_ns = (uint64_t)start.tv_nsec + entry->time_us * 1000;
+    struct timespec wake = {
+      .tv_sec = start.tv_sec + (time_t)(time_ns / 1000000000),
+      .tv_nsec = (int64_t)(time_ns % 1000000000),
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) == EINTR) {
+    }
+    gpio_inject_set_state(&entry->address, entry->state);
+  }
+
+  free(trace->entries);
+  free(trace);
+  __atomic_store_n(&s_replaying, false, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+StatusCode gpio_inject_replay(const char *path) {
+  if (path == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  } else if (__atomic_exchange_n(&s_replaying, true, __ATOMIC_ACQ_REL)) {
+    return status_msg(STATUS_CODE_RESOURCE_EXHAUSTED, "GPIO trace already replaying");
+  }
+
+  GpioInjectTrace *trace = malloc(sizeof(*trace));
+  StatusCode status = (trace == NULL) ? status_code(STATUS_CODE_RESOURCE_EXHAUSTED)
+                                      : prv_load_trace(path, trace);
+
+  pthread_t thread;
+  if (status_ok(status) && pthread_create(&thread, NULL, prv_replay_thread, trace) != 0) {
+    free(trace->entries);
+    status = status_msg(STATUS_CODE_INTERNAL_ERROR, "Failed to start GPIO trace replay");
+  }
+  if (!status_ok(status)) {
+    free(trace);
+    __atomic_store_n(&s_replaying, false, __ATOMIC_RELEASE);
+    return status;
+  }
+
+  pthread_detach(thread);
+  return STATUS_CODE_OK;
+}
+
+bool gpio_inject_replaying(void) {
+  return __atomic_load_n(&s_replaying, __ATOMIC_ACQUIRE);
+}
+
+static void prv_cmd_handler(int client_fd, const char *cmd, const char *args[], size_t num_args,
+                            void *context) {
+  if (num_args == 2 && strcmp(args[0], "replay") == 0) {
+    if (!status_ok(gpio_inject_replay(args[1]))) {
+      LOG_WARN("Could not replay GPIO trace %s\n", args[1]);
+    }
+    return;
+  }
+
+  GpioAddress address = { 0 };
+  if (num_args != 3 || !prv_parse_address(args[0], args[1], &address)) {
+    LOG_WARN("Usage: gpio <port> <pin> <0|1|rising|falling> or gpio replay <file>\n");
+    return;
+  }
+
+  if (strcmp(args[2], "rising") == 0) {
+    gpio_inject_edge(&address, INTERRUPT_EDGE_RISING);
+  } else if (strcmp(args[2], "falling") == 0) {
+    gpio_inject_edge(&address, INTERRUPT_EDGE_FALLING);
+  } else {
+    gpio_inject_set_state(&address, (GpioState)strtoul(args[2], NULL, 10));
+  }
+}
+
+void gpio_inject_init(void) {
+  if (!s_cmd_registered) {
+    x86_cmd_register_handler(GPIO_INJECT_CMD, prv_cmd_handler, NULL);
+    s_cmd_registered = true;
+  }
+}
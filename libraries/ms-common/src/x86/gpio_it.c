@@ -2,8 +2,11 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <time.h>
 
+#include "critical_section.h"
 #include "gpio.h"
+#include "gpio_inject.h"
 #include "interrupt_def.h"
 #include "status.h"
 #include "x86_interrupt.h"
@@ -13,6 +16,10 @@ typedef struct GpioItInterrupt {
   GpioAddress address;
   GpioItCallback callback;
   void *context;
+  InterruptEdge edge;
+  bool masked;
+  // When the last injected edge fired the interrupt
+  uint64_t edge_time_ns;
 } GpioItInterrupt;
 
 static uint8_t s_gpio_it_handler_id;
@@ -53,6 +60,8 @@ StatusCode gpio_it_register_interrupt(const GpioAddress *address, const Interrup
   s_gpio_it_interrupts[address->pin].address = *address;
   s_gpio_it_interrupts[address->pin].callback = callback;
   s_gpio_it_interrupts[address->pin].context = context;
+  s_gpio_it_interrupts[address->pin].edge = edge;
+  s_gpio_it_interrupts[address->pin].masked = false;
 
   return STATUS_CODE_OK;
 }
@@ -66,5 +75,44 @@ StatusCode gpio_it_trigger_interrupt(const GpioAddress *address) {
 }
 
 StatusCode gpio_it_mask_interrupt(const GpioAddress *address, bool masked) {
-  return status_code(STATUS_CODE_UNIMPLEMENTED);
+  if (address->port >= NUM_GPIO_PORTS || address->pin >= GPIO_PINS_PER_PORT) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  s_gpio_it_interrupts[address->pin].masked = masked;
+  return STATUS_CODE_OK;
+}
+
+StatusCode gpio_inject_edge(const GpioAddress *address, InterruptEdge edge) {
+  if (address->port >= NUM_GPIO_PORTS || address->pin >= GPIO_PINS_PER_PORT ||
+      edge >= INTERRUPT_EDGE_RISING_FALLING) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  // Like EXTI lines, only the registered port's pin can fire the interrupt
+  bool disabled = critical_section_start();
+  GpioItInterrupt *interrupt = &s_gpio_it_interrupts[address->pin];
+  bool fire = interrupt->callback != NULL && !interrupt->masked &&
+              interrupt->address.port == address->port &&
+              (interrupt->edge == edge || interrupt->edge == INTERRUPT_EDGE_RISING_FALLING);
+  if (fire) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    interrupt->edge_time_ns = (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+    x86_interrupt_trigger(interrupt->interrupt_id);
+  }
+  critical_section_end(disabled);
+
+  return STATUS_CODE_OK;
+}
+
+StatusCode gpio_inject_get_edge_time(const GpioAddress *address, uint64_t *time_ns) {
+  if (address->port >= NUM_GPIO_PORTS || address->pin >= GPIO_PINS_PER_PORT) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  bool disabled = critical_section_start();
+  *time_ns = s_gpio_it_interrupts[address->pin].edge_time_ns;
+  critical_section_end(disabled);
+  return STATUS_CODE_OK;
 }
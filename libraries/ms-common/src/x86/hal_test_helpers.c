@@ -1,8 +0,0 @@
-#include "hal_test_helpers.h"
-
-#include <stdint.h>
-
-void _test_soft_timer_set_counter(uint32_t counter_value) {
-  // Not possible on x86 ignore this.
-  return;
-}
@@ -8,6 +8,7 @@
 #include <time.h>
 
 #include "critical_section.h"
+#include "hal_test_helpers.h"
 #include "interrupt_def.h"
 #include "status.h"
 #include "x86_interrupt.h"
@@ -23,6 +24,8 @@ typedef struct POSIXTimer {
 static struct sigevent s_event;
 static POSIXTimer s_posix_timers[SOFT_TIMER_MAX_TIMERS];
 static volatile uint8_t s_active_timers = 0;
+// Added to the clock so tests can move the current time, see |_test_soft_timer_set_counter|.
+static uint32_t s_counter_offset = 0;
 
 static void prv_soft_timer_interrupt(void) {
   const bool critical = critical_section_start();
@@ -71,6 +74,7 @@ void soft_timer_init(void) {
 
   // Clear all the statics and reset all the clocks.
   s_active_timers = 0;
+  s_counter_offset = 0;
   for (uint32_t i = 0; i < SOFT_TIMER_MAX_TIMERS; i++) {
     s_posix_timers[i].inuse = false;
     if (s_posix_timers[i].created) {
@@ -144,3 +148,19 @@ uint32_t soft_timer_remaining_time(SoftTimerId timer_id) {
   timer_gettime(s_posix_timers[timer_id].timer_id, &spec);
   return spec.it_value.tv_sec * 1000000 + spec.it_value.tv_nsec / 1000;
 }
+
+static uint32_t prv_get_clock_us(void) {
+  struct timespec ts = { 0 };
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  // Truncation to 32 bits mirrors the rollover of the STM32 TIM2 counter.
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000);
+}
+
+uint32_t soft_timer_get_current_time(void) {
+  return prv_get_clock_us() + s_counter_offset;
+}
+
+void _test_soft_timer_set_counter(uint32_t counter_value) {
+  // Only moves the current time - the POSIX timers run on their own
+  s_counter_offset = counter_value - prv_get_clock_us();
+}
@@ -1,9 +1,13 @@
 #include "spi.h"
+#include "hal_test_helpers.h"
 #include "log.h"
 #include "spi_mcu.h"
 
 static GpioState s_cs_curr_state = GPIO_STATE_HIGH;
 
+// Number of transactions, see |_test_spi_get_num_transactions|.
+static uint32_t s_num_transactions = 0;
+
 StatusCode spi_init(SpiPort spi, const SpiSettings *settings) {
   LOG_DEBUG("Note this is an x86 version of SPI\n");
   if (spi >= NUM_SPI_PORTS) {
@@ -34,6 +38,10 @@ StatusCode spi_rx(SpiPort spi, uint8_t *rx_data, size_t rx_len, uint8_t placehol
   return STATUS_CODE_OK;
 }
 StatusCode spi_cs_set_state(SpiPort spi, GpioState state) {
+  if (state == GPIO_STATE_LOW && s_cs_curr_state != GPIO_STATE_LOW) {
+    // every CS assertion starts a new transaction
+    s_num_transactions++;
+  }
   s_cs_curr_state = state;
   if (state == GPIO_STATE_LOW) {
     LOG_DEBUG("CS state set to LOW\n");
@@ -68,3 +76,7 @@ StatusCode spi_exchange(SpiPort spi, uint8_t *tx_data, size_t tx_len, uint8_t *r
 
   return STATUS_CODE_OK;
 }
+
+uint32_t _test_spi_get_num_transactions(void) {
+  return s_num_transactions;
+}
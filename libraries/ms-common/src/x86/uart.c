@@ -1,17 +1,278 @@
+// Each port is backed by a pseudo-terminal, so external tools can talk to it like a
+// USB-serial adapter. Its slave path is logged on init.
+//
+// Configured through the environment:
+//   MIDSUN_X86_UART_DIR: if set, a symlink to each port's pty is made at <dir>/uart<port>.
+//   MIDSUN_X86_UART_PACING: if set, bytes take as long as they would on the wire at the
+//                           configured baudrate (8N1) in both directions.
+//
+// Like the CAN HW threads, an RX thread reads whatever is available and splits it
+// into lines for the RX handler within a single critical section. TX data is queued
+// in the TX FIFO and written out in batches by a TX thread.
 #include "uart.h"
 
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "critical_section.h"
+#include "hal_test_helpers.h"
+#include "log.h"
+#include "misc.h"
+#include "x86_interrupt.h"
+
+#define UART_DIR_ENV "MIDSUN_X86_UART_DIR"
+#define UART_PACING_ENV "MIDSUN_X86_UART_PACING"
+#define UART_INVALID_FD -1
+// Check for a new endpoint once every 10ms
+#define UART_RX_POLL_PERIOD_MS 10
+// 8N1: start + 8 data + stop bits
+#define UART_BITS_PER_BYTE 10
+
+typedef struct UartPortData {
+  UartStorage *storage;
+  uint32_t baudrate;
+  // Our end of the pty or test socket. The number stays the same on re-init.
+  int fd;
+  // Held open so the pty master doesn't see a hangup while nothing is connected
+  int pty_slave_fd;
+  // Replaces the pty on the next init (see _test_uart_connect())
+  int test_fd;
+  bool started;
+  pthread_t rx_thread;
+  pthread_t tx_thread;
+  sem_t tx_sem;
+} UartPortData;
+
+static UartPortData s_port[NUM_UART_PORTS] = {
+  [0 ... NUM_UART_PORTS - 1] = { .fd = UART_INVALID_FD,
+                                 .pty_slave_fd = UART_INVALID_FD,
+                                 .test_fd = UART_INVALID_FD },
+};
+static bool s_pacing = false;
+
+static void prv_pace(const UartPortData *port, size_t num_bytes) {
+  if (s_pacing && port->baudrate != 0) {
+    usleep((useconds_t)((uint64_t)num_bytes * UART_BITS_PER_BYTE * 1000000 / port->baudrate));
+  }
+}
+
+// Splits the received bytes into lines ending with the delimiter, or as much as
+// fits in the buffer.
+static void prv_rx_batch(UartStorage *storage, const uint8_t *data, size_t len) {
+  while (len > 0) {
+    size_t space = UART_MAX_BUFFER_LEN - fifo_size(&storage->rx_fifo);
+    size_t chunk = MIN(len, space);
+    const uint8_t *delimiter = memchr(data, storage->delimiter, chunk);
+    if (delimiter != NULL) {
+      chunk = (size_t)(delimiter - data) + 1;
+    }
+
+    fifo_push_arr(&storage->rx_fifo, data, chunk);
+    data += chunk;
+    len -= chunk;
+
+    size_t num_bytes = fifo_size(&storage->rx_fifo);
+    if (delimiter != NULL || num_bytes == UART_MAX_BUFFER_LEN) {
+      storage->rx_line_buf[num_bytes] = '\0';
+      fifo_pop_arr(&storage->rx_fifo, storage->rx_line_buf, num_bytes);
+
+      if (storage->rx_handler != NULL) {
+        storage->rx_handler(storage->rx_line_buf, num_bytes, storage->context);
+      }
+    }
+  }
+}
+
+static void *prv_rx_thread(void *arg) {
+  UartPortData *port = arg;
+  x86_interrupt_pthread_init();
+
+  uint8_t buffer[UART_MAX_BUFFER_LEN];
+  while (true) {
+    struct pollfd poll_fd = { .fd = port->fd, .events = POLLIN };
+    if (poll(&poll_fd, 1, UART_RX_POLL_PERIOD_MS) <= 0) {
+      continue;
+    }
+
+    ssize_t len = read(port->fd, buffer, sizeof(buffer));
+    if (len <= 0) {
+      // The other end is gone - wait for it to be replaced
+      usleep(UART_RX_POLL_PERIOD_MS * 1000);
+      continue;
+    }
+    prv_pace(port, (size_t)len);
+
+    // Deliver the whole batch as one "interrupt"
+    bool disabled = critical_section_start();
+    prv_rx_batch(port->storage, buffer, (size_t)len);
+    critical_section_end(disabled);
+  }
+
+  return NULL;
+}
+
+static void *prv_tx_thread(void *arg) {
+  UartPortData *port = arg;
+  x86_interrupt_pthread_init();
+
+  uint8_t buffer[UART_MAX_BUFFER_LEN];
+  while (true) {
+    sem_wait(&port->tx_sem);
+
+    // Send everything queued so far - later wakeups for it find the FIFO empty
+    size_t len = fifo_size(&port->storage->tx_fifo);
+    if (len == 0) {
+      continue;
+    }
+    fifo_pop_arr(&port->storage->tx_fifo, buffer, len);
+
+    size_t written = 0;
+    while (written < len) {
+      ssize_t ret = write(port->fd, buffer + written, len - written);
+      if (ret <= 0) {
+        break;
+      }
+      written += (size_t)ret;
+    }
+    prv_pace(port, len);
+  }
+
+  return NULL;
+}
+
+static int prv_open_pty(UartPort uart, UartPortData *port) {
+  int master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master_fd < 0 || grantpt(master_fd) < 0 || unlockpt(master_fd) < 0) {
+    return UART_INVALID_FD;
+  }
+
+  const char *slave_path = ptsname(master_fd);
+  port->pty_slave_fd = open(slave_path, O_RDWR | O_NOCTTY);
+  if (port->pty_slave_fd < 0) {
+    close(master_fd);
+    return UART_INVALID_FD;
+  }
+
+  // Pass bytes through untouched
+  struct termios tio;
+  tcgetattr(port->pty_slave_fd, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(port->pty_slave_fd, TCSANOW, &tio);
+
+  LOG_DEBUG("UART port %d: %s\n", uart, slave_path);
+  const char *dir = getenv(UART_DIR_ENV);
+  if (dir != NULL) {
+    char link_path[256];
+    snprintf(link_path, sizeof(link_path), "%s/uart%d", dir, uart);
+    unlink(link_path);
+    if (symlink(slave_path, link_path) < 0) {
+      LOG_WARN("Could not link %s to %s\n", link_path, slave_path);
+    }
+  }
+
+  return master_fd;
+}
+
 StatusCode uart_init(UartPort uart, UartSettings *settings, UartStorage *storage) {
-  return status_code(STATUS_CODE_UNIMPLEMENTED);
+  if (uart >= NUM_UART_PORTS || settings == NULL || storage == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+  UartPortData *port = &s_port[uart];
+
+  int new_fd = UART_INVALID_FD;
+  if (port->test_fd != UART_INVALID_FD) {
+    new_fd = port->test_fd;
+    port->test_fd = UART_INVALID_FD;
+  } else if (port->fd == UART_INVALID_FD) {
+    new_fd = prv_open_pty(uart, port);
+    if (new_fd == UART_INVALID_FD) {
+      return status_msg(STATUS_CODE_INTERNAL_ERROR, "Failed to open UART pty");
+    }
+  }
+
+  bool disabled = critical_section_start();
+  memset(storage, 0, sizeof(*storage));
+  storage->rx_handler = settings->rx_handler;
+  storage->context = settings->context;
+  storage->delimiter = '\n';
+  fifo_init(&storage->tx_fifo, storage->tx_buf);
+  fifo_init(&storage->rx_fifo, storage->rx_buf);
+  port->storage = storage;
+  port->baudrate = settings->baudrate;
+
+  if (new_fd != UART_INVALID_FD) {
+    if (port->fd == UART_INVALID_FD) {
+      port->fd = new_fd;
+    } else {
+      // Swap the endpoint under the running threads
+      dup2(new_fd, port->fd);
+      close(new_fd);
+    }
+  }
+  critical_section_end(disabled);
+
+  if (!port->started) {
+    s_pacing = (getenv(UART_PACING_ENV) != NULL);
+    sem_init(&port->tx_sem, 0, 0);
+    pthread_create(&port->rx_thread, NULL, prv_rx_thread, port);
+    pthread_create(&port->tx_thread, NULL, prv_tx_thread, port);
+    port->started = true;
+  }
+
+  return STATUS_CODE_OK;
 }
 
 StatusCode uart_set_rx_handler(UartPort uart, UartRxHandler rx_handler, void *context) {
-  return status_code(STATUS_CODE_UNIMPLEMENTED);
+  if (uart >= NUM_UART_PORTS || s_port[uart].storage == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  bool disabled = critical_section_start();
+  s_port[uart].storage->rx_handler = rx_handler;
+  s_port[uart].storage->context = context;
+  critical_section_end(disabled);
+
+  return STATUS_CODE_OK;
 }
 
 StatusCode uart_set_delimiter(UartPort uart, uint8_t delimiter) {
-  return status_code(STATUS_CODE_UNIMPLEMENTED);
+  if (uart >= NUM_UART_PORTS || s_port[uart].storage == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  bool disabled = critical_section_start();
+  s_port[uart].storage->delimiter = (char)delimiter;
+  critical_section_end(disabled);
+
+  return STATUS_CODE_OK;
 }
 
 StatusCode uart_tx(UartPort uart, uint8_t *tx_data, size_t len) {
-  return status_code(STATUS_CODE_UNIMPLEMENTED);
+  if (uart >= NUM_UART_PORTS || s_port[uart].storage == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  status_ok_or_return(fifo_push_arr(&s_port[uart].storage->tx_fifo, tx_data, len));
+  sem_post(&s_port[uart].tx_sem);
+
+  return STATUS_CODE_OK;
+}
+
+StatusCode _test_uart_connect(UartPort uart, int fd) {
+  if (uart >= NUM_UART_PORTS || fd < 0) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  if (s_port[uart].test_fd != UART_INVALID_FD) {
+    close(s_port[uart].test_fd);
+  }
+  s_port[uart].test_fd = fd;
+  return STATUS_CODE_OK;
 }
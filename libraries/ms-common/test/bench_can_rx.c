@@ -0,0 +1,36 @@
+#include "bench.h"
+#include "can_rx.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+// Roughly what a busy node like the driver controls board registers
+#define BENCH_CAN_RX_NUM_HANDLERS 32
+
+static CanRxHandlers s_rx_handlers;
+static CanRxHandler s_rx_handler_storage[BENCH_CAN_RX_NUM_HANDLERS];
+static CanMessageId s_lookup_id;
+
+static StatusCode prv_rx_callback(const CanMessage *msg, void *context, CanAckStatus *ack_reply) {
+  return STATUS_CODE_OK;
+}
+
+static void prv_lookup(void *context) {
+  // Cycle through every registered ID plus one miss
+  s_lookup_id = (CanMessageId)((s_lookup_id + 1) % (BENCH_CAN_RX_NUM_HANDLERS + 1));
+  can_rx_get_handler(&s_rx_handlers, s_lookup_id);
+}
+
+void setup_test(void) {
+  can_rx_init(&s_rx_handlers, s_rx_handler_storage, BENCH_CAN_RX_NUM_HANDLERS);
+  // Register in reverse so the handlers aren't already in lookup order
+  for (CanMessageId id = BENCH_CAN_RX_NUM_HANDLERS; id > 0; id--) {
+    can_rx_register_handler(&s_rx_handlers, id, prv_rx_callback, NULL);
+  }
+  s_lookup_id = 0;
+}
+
+void teardown_test(void) {}
+
+void bench_can_rx_get_handler(void) {
+  BENCH_RUN(prv_lookup, NULL, 64);
+}
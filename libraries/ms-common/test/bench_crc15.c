@@ -0,0 +1,24 @@
+#include "bench.h"
+#include "crc15.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+// One LTC6811 register group: 6 data bytes, the PEC covers all of them
+#define BENCH_CRC15_REGISTER_GROUP_LEN 6
+
+static uint8_t s_data[BENCH_CRC15_REGISTER_GROUP_LEN] = { 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB };
+static volatile uint16_t s_crc;
+
+static void prv_calculate(void *context) {
+  s_crc = crc15_calculate(s_data, sizeof(s_data));
+}
+
+void setup_test(void) {
+  crc15_init_table();
+}
+
+void teardown_test(void) {}
+
+void bench_crc15_register_group(void) {
+  BENCH_RUN(prv_calculate, NULL, 64);
+}
@@ -0,0 +1,35 @@
+#include "bench.h"
+#include "event_queue.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+static void prv_raise_process(void *context) {
+  Event e = { 0 };
+  event_raise((EventId)(uintptr_t)context, 0);
+  event_process(&e);
+}
+
+static void prv_fill_drain(void *context) {
+  Event e = { 0 };
+  for (EventId id = 0; id < EVENT_QUEUE_SIZE; id++) {
+    event_raise_priority((EventPriority)(id % NUM_EVENT_PRIORITIES), id, 0);
+  }
+  while (event_process(&e) == STATUS_CODE_OK) {
+  }
+}
+
+void setup_test(void) {
+  event_queue_init();
+}
+
+void teardown_test(void) {}
+
+// Steady state of most main loops: one event in flight at a time
+void bench_event_queue_raise_process(void) {
+  BENCH_RUN(prv_raise_process, (void *)1, 64);
+}
+
+// Worst case: a full queue spread across every priority
+void bench_event_queue_fill_drain(void) {
+  BENCH_RUN(prv_fill_drain, NULL, 1);
+}
@@ -0,0 +1,35 @@
+#include "bench.h"
+#include "fifo.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define BENCH_FIFO_BUFFER_LEN 16
+
+static Fifo s_fifo;
+static uint32_t s_buffer[BENCH_FIFO_BUFFER_LEN];
+
+static void prv_push_pop(void *context) {
+  uint32_t elem = 0x12345678;
+  fifo_push(&s_fifo, &elem);
+  fifo_pop(&s_fifo, &elem);
+}
+
+static void prv_push_pop_arr(void *context) {
+  uint32_t elems[BENCH_FIFO_BUFFER_LEN] = { 0 };
+  fifo_push_arr(&s_fifo, elems, BENCH_FIFO_BUFFER_LEN);
+  fifo_pop_arr(&s_fifo, elems, BENCH_FIFO_BUFFER_LEN);
+}
+
+void setup_test(void) {
+  fifo_init(&s_fifo, s_buffer);
+}
+
+void teardown_test(void) {}
+
+void bench_fifo_push_pop(void) {
+  BENCH_RUN(prv_push_pop, NULL, 64);
+}
+
+void bench_fifo_push_pop_arr(void) {
+  BENCH_RUN(prv_push_pop_arr, NULL, 8);
+}
@@ -0,0 +1,83 @@
+// Compares the fixed-point conversions with the float math they replaced. x86 has an FPU, so the
+// gap here understates the one on the Cortex-M0, where every float operation is a library call.
+#include <string.h>
+
+#include "bench.h"
+#include "fixed_point.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+// An ADS1259 sample at 60 SPS: 20 usable bits against a 2.5V reference
+#define BENCH_FIXED_POINT_USABLE_BITS 20
+#define BENCH_FIXED_POINT_VREF_V 2.5
+#define BENCH_FIXED_POINT_VREF_UV 2500000
+
+static volatile uint32_t s_raw = 0x102030;
+static volatile float s_velocity_ms = 12.3456f;
+static volatile double s_reading_v;
+static volatile int32_t s_reading_fixed;
+static volatile uint16_t s_velocity_cms;
+
+static void prv_ads1259_double(void *context) {
+  double resolution = (double)(1 << (BENCH_FIXED_POINT_USABLE_BITS - 1));
+  s_reading_v = (s_raw >> (24 - BENCH_FIXED_POINT_USABLE_BITS)) * BENCH_FIXED_POINT_VREF_V /
+                (resolution - 1);
+}
+
+static void prv_ads1259_fixed(void *context) {
+  int32_t code = (int32_t)(s_raw >> (24 - BENCH_FIXED_POINT_USABLE_BITS));
+  s_reading_fixed = fixed_scale(code, BENCH_FIXED_POINT_VREF_UV,
+                                (1 << (BENCH_FIXED_POINT_USABLE_BITS - 1)) - 1);
+}
+
+static void prv_velocity_float(void *context) {
+  s_velocity_cms = (uint16_t)(s_velocity_ms * 100);
+}
+
+static void prv_velocity_fixed(void *context) {
+  float velocity_ms = s_velocity_ms;
+  uint32_t bits = 0;
+  memcpy(&bits, &velocity_ms, sizeof(bits));
+  int32_t velocity = fixed_mul(fixed_from_float_bits(bits, 24),
+                               fixed_from_int(100, FIXED_Q16_FRAC_BITS), 24);
+  s_velocity_cms = (uint16_t)fixed_trunc(velocity, FIXED_Q16_FRAC_BITS);
+}
+
+static void prv_mul_float(void *context) {
+  s_reading_v = s_reading_v * 1.0001;
+}
+
+static void prv_mul_fixed(void *context) {
+  s_reading_fixed = fixed_mul(s_reading_fixed, 0x10007, FIXED_Q16_FRAC_BITS);
+}
+
+void setup_test(void) {
+  s_reading_v = 1.0;
+  s_reading_fixed = FIXED_ONE(FIXED_Q16_FRAC_BITS);
+}
+
+void teardown_test(void) {}
+
+void bench_fixed_point_ads1259_double(void) {
+  BENCH_RUN(prv_ads1259_double, NULL, 64);
+}
+
+void bench_fixed_point_ads1259_fixed(void) {
+  BENCH_RUN(prv_ads1259_fixed, NULL, 64);
+}
+
+void bench_fixed_point_velocity_float(void) {
+  BENCH_RUN(prv_velocity_float, NULL, 64);
+}
+
+void bench_fixed_point_velocity_fixed(void) {
+  BENCH_RUN(prv_velocity_fixed, NULL, 64);
+}
+
+void bench_fixed_point_mul_double(void) {
+  BENCH_RUN(prv_mul_float, NULL, 64);
+}
+
+void bench_fixed_point_mul_fixed(void) {
+  BENCH_RUN(prv_mul_fixed, NULL, 64);
+}
@@ -0,0 +1,150 @@
+// Compares the indexed 4-ary heap against pqueue on soft timer-like loads. pqueue can't cancel
+// entries, so it leaves tombstones: rescheduling a timer pushes it again and stale entries are
+// skipped when they're popped.
+#include "bench.h"
+#include "pqueue.h"
+#include "pqueue_indexed.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+// Timers in flight, as many as soft_timer can hold
+#define BENCH_PQUEUE_NUM_TIMERS 16
+// Room for the tombstones of rescheduled timers
+#define BENCH_PQUEUE_NUM_NODES (4 * BENCH_PQUEUE_NUM_TIMERS + 1)
+#define BENCH_PQUEUE_MAX_PERIOD 32
+
+typedef struct BenchTimer {
+  uint16_t deadline;
+  PQueueHandle handle;
+} BenchTimer;
+
+static BenchTimer s_timers[BENCH_PQUEUE_NUM_TIMERS];
+static uint32_t s_seed;
+
+static PQueue s_pqueue;
+static PQueueNode s_pqueue_nodes[BENCH_PQUEUE_NUM_NODES];
+
+static PQueueIndexed s_indexed;
+static PQueueIndexedNode s_indexed_nodes[BENCH_PQUEUE_NUM_TIMERS];
+static PQueueIndexedEntry s_indexed_entries[BENCH_PQUEUE_NUM_TIMERS];
+
+static uint16_t prv_period(void) {
+  s_seed = s_seed * 1103515245u + 12345u;
+  return (uint16_t)((s_seed >> 16) % BENCH_PQUEUE_MAX_PERIOD + 1);
+}
+
+// Pops the next live timer, skipping tombstones
+static BenchTimer *prv_pqueue_pop_live(void) {
+  while (true) {
+    uint16_t prio = s_pqueue.nodes[1].prio;
+    BenchTimer *timer = pqueue_pop(&s_pqueue);
+    if (timer == NULL || timer->deadline == prio) {
+      return timer;
+    }
+  }
+}
+
+static void prv_pqueue_fill_drain(void *context) {
+  for (size_t i = 0; i < BENCH_PQUEUE_NUM_TIMERS; i++) {
+    pqueue_push(&s_pqueue, &s_timers[i], s_timers[i].deadline);
+  }
+  while (pqueue_pop(&s_pqueue) != NULL) {
+  }
+}
+
+static void prv_indexed_fill_drain(void *context) {
+  for (size_t i = 0; i < BENCH_PQUEUE_NUM_TIMERS; i++) {
+    pqueue_indexed_push(&s_indexed, &s_timers[i], s_timers[i].deadline, NULL);
+  }
+  while (pqueue_indexed_pop(&s_indexed) != NULL) {
+  }
+}
+
+// One timer fires and restarts, and another is rescheduled before it fires, as when a watchdog
+// or an ACK deadline is pushed back.
+static void prv_pqueue_timer_mix(void *context) {
+  BenchTimer *fired = prv_pqueue_pop_live();
+  fired->deadline = (uint16_t)(fired->deadline + prv_period());
+  pqueue_push(&s_pqueue, fired, fired->deadline);
+
+  BenchTimer *rescheduled = &s_timers[s_seed % BENCH_PQUEUE_NUM_TIMERS];
+  rescheduled->deadline = (uint16_t)(fired->deadline + prv_period());
+  TEST_ASSERT_OK(pqueue_push(&s_pqueue, rescheduled, rescheduled->deadline));
+}
+
+static void prv_indexed_timer_mix(void *context) {
+  BenchTimer *fired = pqueue_indexed_pop(&s_indexed);
+  fired->deadline = (uint16_t)(fired->deadline + prv_period());
+  pqueue_indexed_push(&s_indexed, fired, fired->deadline, &fired->handle);
+
+  BenchTimer *rescheduled = &s_timers[s_seed % BENCH_PQUEUE_NUM_TIMERS];
+  rescheduled->deadline = (uint16_t)(fired->deadline + prv_period());
+  pqueue_indexed_update(&s_indexed, rescheduled->handle, rescheduled->deadline);
+}
+
+// Every timer is cancelled and started again, as when a state change restarts a module's timers.
+static void prv_pqueue_restart_all(void *context) {
+  for (size_t i = 0; i < BENCH_PQUEUE_NUM_TIMERS; i++) {
+    s_timers[i].deadline = prv_period();
+  }
+  pqueue_init(&s_pqueue, s_pqueue_nodes, BENCH_PQUEUE_NUM_NODES);
+  for (size_t i = 0; i < BENCH_PQUEUE_NUM_TIMERS; i++) {
+    pqueue_push(&s_pqueue, &s_timers[i], s_timers[i].deadline);
+  }
+}
+
+static void prv_indexed_restart_all(void *context) {
+  void *data[BENCH_PQUEUE_NUM_TIMERS];
+  uint16_t prios[BENCH_PQUEUE_NUM_TIMERS];
+  PQueueHandle handles[BENCH_PQUEUE_NUM_TIMERS];
+  for (size_t i = 0; i < BENCH_PQUEUE_NUM_TIMERS; i++) {
+    s_timers[i].deadline = prv_period();
+    data[i] = &s_timers[i];
+    prios[i] = s_timers[i].deadline;
+  }
+  pqueue_indexed_heapify(&s_indexed, data, prios, BENCH_PQUEUE_NUM_TIMERS, handles);
+  for (size_t i = 0; i < BENCH_PQUEUE_NUM_TIMERS; i++) {
+    s_timers[i].handle = handles[i];
+  }
+}
+
+void setup_test(void) {
+  s_seed = 0x5eed;
+  for (size_t i = 0; i < BENCH_PQUEUE_NUM_TIMERS; i++) {
+    s_timers[i].deadline = prv_period();
+  }
+  pqueue_init(&s_pqueue, s_pqueue_nodes, BENCH_PQUEUE_NUM_NODES);
+  pqueue_indexed_init(&s_indexed, s_indexed_nodes, s_indexed_entries);
+}
+
+void teardown_test(void) {}
+
+void bench_pqueue_fill_drain(void) {
+  BENCH_RUN(prv_pqueue_fill_drain, NULL, 4);
+}
+
+void bench_pqueue_indexed_fill_drain(void) {
+  BENCH_RUN(prv_indexed_fill_drain, NULL, 4);
+}
+
+void bench_pqueue_timer_mix(void) {
+  for (size_t i = 0; i < BENCH_PQUEUE_NUM_TIMERS; i++) {
+    pqueue_push(&s_pqueue, &s_timers[i], s_timers[i].deadline);
+  }
+  BENCH_RUN(prv_pqueue_timer_mix, NULL, 64);
+}
+
+void bench_pqueue_indexed_timer_mix(void) {
+  for (size_t i = 0; i < BENCH_PQUEUE_NUM_TIMERS; i++) {
+    pqueue_indexed_push(&s_indexed, &s_timers[i], s_timers[i].deadline, &s_timers[i].handle);
+  }
+  BENCH_RUN(prv_indexed_timer_mix, NULL, 64);
+}
+
+void bench_pqueue_restart_all(void) {
+  BENCH_RUN(prv_pqueue_restart_all, NULL, 4);
+}
+
+void bench_pqueue_indexed_restart_all(void) {
+  BENCH_RUN(prv_indexed_restart_all, NULL, 4);
+}
@@ -0,0 +1,68 @@
+#include <string.h>
+#include <sys/socket.h>
+
+#include "bench.h"
+#include "hal_test_helpers.h"
+#include "interrupt.h"
+#include "test_helpers.h"
+#include "uart.h"
+#include "unity.h"
+
+// Roughly a COBS-encoded CAN UART packet, framed by a 0
+#define BENCH_UART_FRAME_LEN 20
+#define BENCH_UART_BURST 16
+
+static UartStorage s_tx_storage;
+static UartStorage s_rx_storage;
+static volatile uint32_t s_num_frames;
+
+static void prv_rx_handler(const uint8_t *rx_arr, size_t len, void *context) {
+  s_num_frames++;
+}
+
+static void prv_send_frames(size_t num_frames) {
+  uint8_t frame[BENCH_UART_FRAME_LEN];
+  memset(frame, 0xA5, sizeof(frame));
+  frame[BENCH_UART_FRAME_LEN - 1] = 0;
+
+  uint32_t expected = s_num_frames + num_frames;
+  for (size_t i = 0; i < num_frames; i++) {
+    uart_tx(UART_PORT_1, frame, sizeof(frame));
+  }
+  while (s_num_frames != expected) {
+  }
+}
+
+// One frame at a time, like a request/response
+static void prv_latency(void *context) {
+  prv_send_frames(1);
+}
+
+static void prv_burst(void *context) {
+  prv_send_frames(BENCH_UART_BURST);
+}
+
+void setup_test(void) {
+  interrupt_init();
+
+  int fds[2];
+  TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  TEST_ASSERT_OK(_test_uart_connect(UART_PORT_1, fds[0]));
+  TEST_ASSERT_OK(_test_uart_connect(UART_PORT_2, fds[1]));
+
+  UartSettings settings = { .baudrate = 115200, .rx_handler = prv_rx_handler };
+  TEST_ASSERT_OK(uart_init(UART_PORT_1, &settings, &s_tx_storage));
+  TEST_ASSERT_OK(uart_init(UART_PORT_2, &settings, &s_rx_storage));
+  TEST_ASSERT_OK(uart_set_delimiter(UART_PORT_2, 0));
+  s_num_frames = 0;
+}
+
+void teardown_test(void) {}
+
+void bench_uart_latency(void) {
+  BENCH_RUN(prv_latency, NULL, 1);
+}
+
+void bench_uart_burst(void) {
+  BENCH_RUN(prv_burst, NULL, 1);
+}
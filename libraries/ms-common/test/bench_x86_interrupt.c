@@ -0,0 +1,47 @@
+#include "bench.h"
+#include "critical_section.h"
+#include "interrupt.h"
+#include "test_helpers.h"
+#include "unity.h"
+#include "x86_interrupt.h"
+
+#define BENCH_X86_INTERRUPT_BURST 16
+
+static uint8_t s_interrupt_id;
+static volatile uint32_t s_num_runs;
+
+static void prv_handler(uint8_t interrupt_id) {
+  s_num_runs++;
+}
+
+static void prv_trigger(void *context) {
+  x86_interrupt_trigger(s_interrupt_id);
+}
+
+// Like a burst of CAN frames arriving while the main loop is in a critical section
+static void prv_trigger_burst(void *context) {
+  bool disabled = critical_section_start();
+  for (size_t i = 0; i < BENCH_X86_INTERRUPT_BURST; i++) {
+    x86_interrupt_trigger(s_interrupt_id);
+  }
+  critical_section_end(disabled);
+}
+
+void setup_test(void) {
+  interrupt_init();
+  uint8_t handler_id = 0;
+  x86_interrupt_register_handler(prv_handler, &handler_id);
+  InterruptSettings settings = { .type = INTERRUPT_TYPE_INTERRUPT,
+                                 .priority = INTERRUPT_PRIORITY_NORMAL };
+  x86_interrupt_register_interrupt(handler_id, &settings, &s_interrupt_id);
+}
+
+void teardown_test(void) {}
+
+void bench_x86_interrupt_trigger(void) {
+  BENCH_RUN(prv_trigger, NULL, 16);
+}
+
+void bench_x86_interrupt_trigger_burst(void) {
+  BENCH_RUN(prv_trigger_burst, NULL, 1);
+}
@@ -0,0 +1,162 @@
+#include "adc_source.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "adc.h"
+#include "gpio.h"
+#include "interrupt.h"
+#include "soft_timer.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_ADC_SOURCE_CHANNEL ADC_CHANNEL_1
+#define TEST_ADC_SOURCE_CSV_FILE "test_adc_source.csv"
+#define TEST_ADC_SOURCE_BIN_FILE "test_adc_source.bin"
+#define TEST_ADC_SOURCE_NUM_SCANS 4
+
+static volatile uint16_t s_scanned[TEST_ADC_SOURCE_NUM_SCANS];
+static volatile size_t s_num_scanned;
+
+static void prv_scan_callback(AdcChannel adc_channel, void *context) {
+  uint16_t reading = 0;
+  adc_read_raw(adc_channel, &reading);
+  if (s_num_scanned < TEST_ADC_SOURCE_NUM_SCANS) {
+    s_scanned[s_num_scanned++] = reading;
+  }
+}
+
+static uint16_t prv_read(void) {
+  uint16_t reading = 0;
+  TEST_ASSERT_OK(adc_read_raw(TEST_ADC_SOURCE_CHANNEL, &reading));
+  return reading;
+}
+
+void setup_test(void) {
+  gpio_init();
+  interrupt_init();
+  soft_timer_init();
+
+  AdcSource source = { .type = ADC_SOURCE_CONSTANT, .offset = ADC_SOURCE_DEFAULT_RAW };
+  TEST_ASSERT_OK(adc_source_set(TEST_ADC_SOURCE_CHANNEL, &source));
+  TEST_ASSERT_OK(adc_source_set_sample_period(ADC_SOURCE_DEFAULT_SAMPLE_PERIOD_US));
+
+  adc_init(ADC_MODE_SINGLE);
+  adc_set_channel(TEST_ADC_SOURCE_CHANNEL, true);
+  s_num_scanned = 0;
+}
+
+void teardown_test(void) {
+  unlink(TEST_ADC_SOURCE_CSV_FILE);
+  unlink(TEST_ADC_SOURCE_BIN_FILE);
+}
+
+void test_adc_source_default(void) {
+  TEST_ASSERT_EQUAL(ADC_SOURCE_DEFAULT_RAW, prv_read());
+
+  AdcSource source = { .type = ADC_SOURCE_CONSTANT, .offset = 5000 };
+  TEST_ASSERT_OK(adc_source_set(TEST_ADC_SOURCE_CHANNEL, &source));
+  TEST_ASSERT_EQUAL(ADC_SOURCE_MAX_RAW, prv_read());
+
+  source.type = NUM_ADC_SOURCE_TYPES;
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, adc_source_set(TEST_ADC_SOURCE_CHANNEL, &source));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, adc_source_set(NUM_ADC_CHANNELS, &source));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, adc_source_set_sample_period(0));
+}
+
+// Each conversion advances the signal by one sample period.
+void test_adc_source_waveforms(void) {
+  AdcSource source = {
+    .type = ADC_SOURCE_SINE,
+    .offset = 2000,
+    .amplitude = 1000,
+    .period_us = 4 * ADC_SOURCE_DEFAULT_SAMPLE_PERIOD_US,
+  };
+  TEST_ASSERT_OK(adc_source_set(TEST_ADC_SOURCE_CHANNEL, &source));
+  TEST_ASSERT_UINT_WITHIN(1, 2000, prv_read());
+  TEST_ASSERT_UINT_WITHIN(1, 3000, prv_read());
+  TEST_ASSERT_UINT_WITHIN(1, 2000, prv_read());
+  TEST_ASSERT_UINT_WITHIN(1, 1000, prv_read());
+  TEST_ASSERT_UINT_WITHIN(1, 2000, prv_read());
+
+  // Doubling the sample rate halves the step
+  TEST_ASSERT_OK(adc_source_set_sample_period(ADC_SOURCE_DEFAULT_SAMPLE_PERIOD_US / 2));
+  source.type = ADC_SOURCE_RAMP;
+  source.offset = 100;
+  source.amplitude = 400;
+  TEST_ASSERT_OK(adc_source_set(TEST_ADC_SOURCE_CHANNEL, &source));
+  for (uint16_t i = 0; i < 8; i++) {
+    TEST_ASSERT_EQUAL(100 + 50 * i, prv_read());
+  }
+  TEST_ASSERT_EQUAL(100, prv_read());
+}
+
+void test_adc_source_noise(void) {
+  AdcSource source = { .type = ADC_SOURCE_NOISE, .offset = 2048, .amplitude = 100 };
+  TEST_ASSERT_OK(adc_source_set(TEST_ADC_SOURCE_CHANNEL, &source));
+
+  uint16_t first[16];
+  bool varies = false;
+  for (size_t i = 0; i < SIZEOF_ARRAY(first); i++) {
+    first[i] = prv_read();
+    TEST_ASSERT_UINT_WITHIN(100, 2048, first[i]);
+    varies |= (first[i] != first[0]);
+  }
+  TEST_ASSERT_TRUE(varies);
+
+  // Setting the source again restarts the same sequence
+  TEST_ASSERT_OK(adc_source_set(TEST_ADC_SOURCE_CHANNEL, &source));
+  for (size_t i = 0; i < SIZEOF_ARRAY(first); i++) {
+    TEST_ASSERT_EQUAL(first[i], prv_read());
+  }
+}
+
+void test_adc_source_replay(void) {
+  FILE *file = fopen(TEST_ADC_SOURCE_CSV_FILE, "w");
+  fprintf(file, "raw\n10\n20\n9999\n");
+  fclose(file);
+
+  AdcSource source = { .type = ADC_SOURCE_REPLAY, .replay_file = TEST_ADC_SOURCE_CSV_FILE };
+  TEST_ASSERT_OK(adc_source_set(TEST_ADC_SOURCE_CHANNEL, &source));
+  TEST_ASSERT_EQUAL(10, prv_read());
+  TEST_ASSERT_EQUAL(20, prv_read());
+  TEST_ASSERT_EQUAL(ADC_SOURCE_MAX_RAW, prv_read());
+  TEST_ASSERT_EQUAL(10, prv_read());
+
+  const uint16_t values[] = { 1, 2, 3 };
+  file = fopen(TEST_ADC_SOURCE_BIN_FILE, "wb");
+  fwrite(values, sizeof(values[0]), SIZEOF_ARRAY(values), file);
+  fclose(file);
+
+  source.replay_file = TEST_ADC_SOURCE_BIN_FILE;
+  TEST_ASSERT_OK(adc_source_set(TEST_ADC_SOURCE_CHANNEL, &source));
+  for (size_t i = 0; i < 2 * SIZEOF_ARRAY(values); i++) {
+    TEST_ASSERT_EQUAL(values[i % SIZEOF_ARRAY(values)], prv_read());
+  }
+
+  source.replay_file = "missing.csv";
+  TEST_ASSERT_NOT_OK(adc_source_set(TEST_ADC_SOURCE_CHANNEL, &source));
+}
+
+// The continuous scan samples once per period, and reads return the last scan.
+void test_adc_source_continuous(void) {
+  AdcSource source = {
+    .type = ADC_SOURCE_RAMP,
+    .offset = 0,
+    .amplitude = 1000,
+    .period_us = 100 * 1000,
+  };
+  TEST_ASSERT_OK(adc_source_set(TEST_ADC_SOURCE_CHANNEL, &source));
+  TEST_ASSERT_OK(adc_source_set_sample_period(1000));
+
+  adc_init(ADC_MODE_CONTINUOUS);
+  TEST_ASSERT_OK(adc_register_callback(TEST_ADC_SOURCE_CHANNEL, prv_scan_callback, NULL));
+  while (s_num_scanned < TEST_ADC_SOURCE_NUM_SCANS) {
+  }
+  adc_init(ADC_MODE_SINGLE);
+
+  // Some samples may have been taken before the callback was registered
+  for (size_t i = 1; i < TEST_ADC_SOURCE_NUM_SCANS; i++) {
+    TEST_ASSERT_EQUAL(s_scanned[i - 1] + 10, s_scanned[i]);
+  }
+}
@@ -0,0 +1,54 @@
+// Output writes and SPI transactions are only counted on x86, so this is excluded on STM32.
+#include "gpio.h"
+#include "hal_test_helpers.h"
+#include "spi.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_SPI_PORT SPI_PORT_1
+
+static const GpioAddress s_address = { .port = GPIO_PORT_A, .pin = 0 };
+
+void setup_test(void) {
+  gpio_init();
+}
+
+void teardown_test(void) {}
+
+// Every successful gpio_set_state or gpio_toggle_state is one write, even if the state doesn't
+// change.
+void test_bus_traffic_gpio_writes(void) {
+  GpioSettings settings = { .direction = GPIO_DIR_OUT, .state = GPIO_STATE_LOW };
+  uint32_t writes_before = _test_gpio_get_num_writes();
+  TEST_ASSERT_OK(gpio_init_pin(&s_address, &settings));
+  TEST_ASSERT_EQUAL(writes_before, _test_gpio_get_num_writes());
+
+  TEST_ASSERT_OK(gpio_set_state(&s_address, GPIO_STATE_HIGH));
+  TEST_ASSERT_OK(gpio_set_state(&s_address, GPIO_STATE_HIGH));
+  TEST_ASSERT_OK(gpio_toggle_state(&s_address));
+  TEST_ASSERT_EQUAL(writes_before + 3, _test_gpio_get_num_writes());
+
+  // Rejected writes aren't counted
+  TEST_ASSERT_NOT_OK(gpio_set_state(&s_address, NUM_GPIO_STATES));
+  GpioAddress invalid_address = { .port = NUM_GPIO_PORTS, .pin = 0 };
+  TEST_ASSERT_NOT_OK(gpio_toggle_state(&invalid_address));
+  TEST_ASSERT_EQUAL(writes_before + 3, _test_gpio_get_num_writes());
+}
+
+// A transaction is counted when CS is asserted, so holding CS low across exchanges is one.
+void test_bus_traffic_spi_transactions(void) {
+  uint8_t tx_data[2] = { 0x12, 0x34 };
+  uint8_t rx_data[2] = { 0 };
+  uint32_t transactions_before = _test_spi_get_num_transactions();
+  TEST_ASSERT_OK(spi_exchange(TEST_SPI_PORT, tx_data, sizeof(tx_data), rx_data, sizeof(rx_data)));
+  TEST_ASSERT_OK(spi_exchange(TEST_SPI_PORT, tx_data, sizeof(tx_data), NULL, 0));
+  TEST_ASSERT_EQUAL(transactions_before + 2, _test_spi_get_num_transactions());
+
+  TEST_ASSERT_OK(spi_cs_set_state(TEST_SPI_PORT, GPIO_STATE_LOW));
+  TEST_ASSERT_OK(spi_cs_set_state(TEST_SPI_PORT, GPIO_STATE_LOW));
+  TEST_ASSERT_OK(spi_cs_set_state(TEST_SPI_PORT, GPIO_STATE_HIGH));
+  TEST_ASSERT_EQUAL(transactions_before + 3, _test_spi_get_num_transactions());
+
+  TEST_ASSERT_NOT_OK(spi_exchange(NUM_SPI_PORTS, tx_data, sizeof(tx_data), NULL, 0));
+  TEST_ASSERT_EQUAL(transactions_before + 3, _test_spi_get_num_transactions());
+}
@@ -0,0 +1,151 @@
+#include "can_trace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "log.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_TRACE_FILENAME "test_can_trace.trace"
+#define TEST_NUM_RECORDS (CAN_TRACE_CHUNK_RECORDS * 3 + 17)
+#define TEST_MAX_CHUNKS 8
+
+static uint64_t s_chunk_index[TEST_MAX_CHUNKS];
+static CanTraceReader s_reader;
+
+// Records come in pairs sharing a timestamp, 20 us apart
+static uint64_t prv_timestamp(size_t i) {
+  return (uint64_t)(i / 2) * 20;
+}
+
+static void prv_write_trace(uint64_t *chunk_index, size_t max_chunks, size_t num_records) {
+  FILE *fp = fopen(TEST_TRACE_FILENAME, "wb");
+  TEST_ASSERT_NOT_NULL(fp);
+
+  CanTraceWriter writer;
+  TEST_ASSERT_OK(can_trace_writer_init(&writer, fp, chunk_index, max_chunks));
+  for (size_t i = 0; i < num_records; i++) {
+    const uint8_t data[] = { (uint8_t)i, (uint8_t)(i >> 8) };
+    CanTraceRecord record;
+    can_trace_record_init(&record, prv_timestamp(i), (uint32_t)i, (i % 3) == 0, data,
+                          sizeof(data), (i % 2) ? CAN_TRACE_FLAG_TX : 0);
+    TEST_ASSERT_OK(can_trace_writer_append(&writer, &record));
+  }
+  TEST_ASSERT_OK(can_trace_writer_close(&writer));
+  fclose(fp);
+}
+
+static void prv_check_trace(size_t num_records) {
+  TEST_ASSERT_EQUAL(num_records, s_reader.num_records);
+  TEST_ASSERT_EQUAL((num_records + CAN_TRACE_CHUNK_RECORDS - 1) / CAN_TRACE_CHUNK_RECORDS,
+                    s_reader.num_chunks);
+
+  for (size_t i = 0; i < num_records; i++) {
+    const CanTraceRecord *record = &s_reader.records[i];
+    uint32_t id = 0;
+    bool extended = false;
+    can_trace_record_get_id(record, &id, &extended);
+    TEST_ASSERT_EQUAL(prv_timestamp(i), record->timestamp_us);
+    TEST_ASSERT_EQUAL(i, id);
+    TEST_ASSERT_EQUAL((i % 3) == 0, extended);
+    TEST_ASSERT_EQUAL(2, record->dlc);
+    TEST_ASSERT_EQUAL((uint8_t)i, record->data[0]);
+  }
+
+  // seeking lands on the first of each pair of records sharing a timestamp
+  TEST_ASSERT_EQUAL(0, can_trace_reader_seek(&s_reader, 0));
+  TEST_ASSERT_EQUAL(2, can_trace_reader_seek(&s_reader, 1));
+  TEST_ASSERT_EQUAL(CAN_TRACE_CHUNK_RECORDS,
+                    can_trace_reader_seek(&s_reader, prv_timestamp(CAN_TRACE_CHUNK_RECORDS)));
+  const uint64_t mid_chunk_us = prv_timestamp(CAN_TRACE_CHUNK_RECORDS * 2) + 1;
+  TEST_ASSERT_EQUAL(CAN_TRACE_CHUNK_RECORDS * 2 + 2,
+                    can_trace_reader_seek(&s_reader, mid_chunk_us));
+  TEST_ASSERT_EQUAL(num_records - 1,
+                    can_trace_reader_seek(&s_reader, prv_timestamp(num_records - 1)));
+  TEST_ASSERT_EQUAL(num_records, can_trace_reader_seek(&s_reader, UINT64_MAX));
+}
+
+void setup_test(void) {
+  memset(&s_reader, 0, sizeof(s_reader));
+}
+
+void teardown_test(void) {
+  can_trace_reader_close(&s_reader);
+  remove(TEST_TRACE_FILENAME);
+}
+
+void test_can_trace_record(void) {
+  const uint8_t data[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  CanTraceRecord record;
+  uint32_t id = 0;
+  bool extended = false;
+
+  can_trace_record_init(&record, 1234, 0x1ABCDEF0, true, data, sizeof(data), CAN_TRACE_FLAG_TX);
+  TEST_ASSERT_EQUAL(24, sizeof(record));
+  TEST_ASSERT_EQUAL(8, record.dlc);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(data, record.data, 8);
+  can_trace_record_get_id(&record, &id, &extended);
+  TEST_ASSERT_EQUAL(0x1ABCDEF0, id);
+  TEST_ASSERT_TRUE(extended);
+
+  // standard IDs are masked to 11 bits, and no data is fine
+  can_trace_record_init(&record, 1234, 0xFFFF, false, NULL, 0, 0);
+  can_trace_record_get_id(&record, &id, &extended);
+  TEST_ASSERT_EQUAL(0x7FF, id);
+  TEST_ASSERT_FALSE(extended);
+  TEST_ASSERT_EQUAL(0, record.dlc);
+}
+
+void test_can_trace_indexed(void) {
+  prv_write_trace(s_chunk_index, TEST_MAX_CHUNKS, TEST_NUM_RECORDS);
+  TEST_ASSERT_OK(can_trace_reader_open(&s_reader, TEST_TRACE_FILENAME));
+  // the index is used in place
+  TEST_ASSERT_NULL(s_reader.owned_index);
+  prv_check_trace(TEST_NUM_RECORDS);
+}
+
+void test_can_trace_unindexed(void) {
+  prv_write_trace(NULL, 0, TEST_NUM_RECORDS);
+  TEST_ASSERT_OK(can_trace_reader_open(&s_reader, TEST_TRACE_FILENAME));
+  TEST_ASSERT_NOT_NULL(s_reader.owned_index);
+  prv_check_trace(TEST_NUM_RECORDS);
+}
+
+// A trace too long for the index buffer is written without one.
+void test_can_trace_index_overflow(void) {
+  prv_write_trace(s_chunk_index, 2, TEST_NUM_RECORDS);
+  TEST_ASSERT_OK(can_trace_reader_open(&s_reader, TEST_TRACE_FILENAME));
+  TEST_ASSERT_NOT_NULL(s_reader.owned_index);
+  prv_check_trace(TEST_NUM_RECORDS);
+}
+
+// A recorder that dies mid-record leaves a partial record, which is ignored.
+void test_can_trace_truncated(void) {
+  prv_write_trace(NULL, 0, TEST_NUM_RECORDS);
+  FILE *fp = fopen(TEST_TRACE_FILENAME, "ab");
+  TEST_ASSERT_NOT_NULL(fp);
+  const uint8_t partial[sizeof(CanTraceRecord) / 2] = { 0 };
+  fwrite(partial, sizeof(partial), 1, fp);
+  fclose(fp);
+
+  TEST_ASSERT_OK(can_trace_reader_open(&s_reader, TEST_TRACE_FILENAME));
+  prv_check_trace(TEST_NUM_RECORDS);
+}
+
+void test_can_trace_empty(void) {
+  prv_write_trace(s_chunk_index, TEST_MAX_CHUNKS, 0);
+  TEST_ASSERT_OK(can_trace_reader_open(&s_reader, TEST_TRACE_FILENAME));
+  TEST_ASSERT_EQUAL(0, s_reader.num_records);
+  TEST_ASSERT_EQUAL(0, can_trace_reader_seek(&s_reader, 0));
+}
+
+void test_can_trace_invalid(void) {
+  TEST_ASSERT_NOT_OK(can_trace_reader_open(&s_reader, "does_not_exist.trace"));
+
+  FILE *fp = fopen(TEST_TRACE_FILENAME, "wb");
+  TEST_ASSERT_NOT_NULL(fp);
+  fprintf(fp, "ID 123 DLC 8 extended 0\n");
+  fclose(fp);
+  TEST_ASSERT_NOT_OK(can_trace_reader_open(&s_reader, TEST_TRACE_FILENAME));
+}
@@ -0,0 +1,131 @@
+// Normal builds compile the stats out, so build an instrumented event queue into this test. Its
+// definitions take the place of the uninstrumented ones in the ms-common archive.
+#ifndef EVENT_QUEUE_STATS
+#define EVENT_QUEUE_STATS
+#endif
+#include "../src/event_queue.c"
+#include "../src/event_queue_stats.c"
+#include "../src/event_queue_stats_tx.c"
+
+#include "can.h"
+#include "delay.h"
+#include "event_queue.h"
+#include "interrupt.h"
+#include "soft_timer.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_STATS_SOURCE_ID 3
+#define TEST_STATS_MSG_ID 40
+#define TEST_STATS_TX_QUEUE_LEN 4
+
+static CanMessage s_tx_msgs[EVENT_QUEUE_STATS_MAX_EVENT_IDS];
+static size_t s_num_tx_msgs;
+static size_t s_tx_queue_free;
+
+StatusCode TEST_MOCK(can_transmit)(const CanMessage *msg, const CanAckRequest *ack_request) {
+  if (s_tx_queue_free == 0) {
+    return status_code(STATUS_CODE_RESOURCE_EXHAUSTED);
+  }
+  s_tx_queue_free--;
+  s_tx_msgs[s_num_tx_msgs++] = *msg;
+  return STATUS_CODE_OK;
+}
+
+void setup_test(void) {
+  interrupt_init();
+  soft_timer_init();
+  event_queue_init();
+  s_num_tx_msgs = 0;
+  s_tx_queue_free = 0;
+}
+
+void teardown_test(void) {}
+
+void test_event_queue_stats_latency_bucket(void) {
+  TEST_ASSERT_EQUAL(0, event_queue_stats_latency_bucket(0));
+  TEST_ASSERT_EQUAL(1, event_queue_stats_latency_bucket(1));
+  TEST_ASSERT_EQUAL(2, event_queue_stats_latency_bucket(2));
+  TEST_ASSERT_EQUAL(2, event_queue_stats_latency_bucket(3));
+  TEST_ASSERT_EQUAL(11, event_queue_stats_latency_bucket(1024));
+  TEST_ASSERT_EQUAL(EVENT_QUEUE_STATS_LATENCY_BUCKETS - 1,
+                    event_queue_stats_latency_bucket(UINT32_MAX));
+}
+
+void test_event_queue_stats_record(void) {
+  const EventQueueStats *stats = event_queue_stats_get();
+
+  event_queue_stats_record_raise(EVENT_PRIORITY_HIGH, 5, 3, false);
+  event_queue_stats_record_raise(EVENT_PRIORITY_HIGH, 5, 2, false);
+  event_queue_stats_record_raise(EVENT_PRIORITY_HIGH, 5, EVENT_QUEUE_SIZE, true);
+  event_queue_stats_record_raise(EVENT_PRIORITY_LOW, UINT16_MAX, EVENT_QUEUE_SIZE, true);
+  TEST_ASSERT_EQUAL(3, stats->high_water[EVENT_PRIORITY_HIGH]);
+  TEST_ASSERT_EQUAL(0, stats->high_water[EVENT_PRIORITY_LOW]);
+  TEST_ASSERT_EQUAL(1, stats->dropped[5]);
+  // IDs past the end share the last counter
+  TEST_ASSERT_EQUAL(1, stats->dropped[EVENT_QUEUE_STATS_MAX_EVENT_IDS - 1]);
+
+  event_queue_stats_record_latency(100);
+  event_queue_stats_record_latency(127);
+  TEST_ASSERT_EQUAL(2, stats->latency_us_log2[event_queue_stats_latency_bucket(100)]);
+  event_queue_stats_dump();
+
+  event_queue_stats_reset();
+  TEST_ASSERT_EQUAL(0, stats->high_water[EVENT_PRIORITY_HIGH]);
+  TEST_ASSERT_EQUAL(0, stats->dropped[5]);
+}
+
+// Only non-zero stats are sent, resuming where the last call left off when the TX queue fills.
+void test_event_queue_stats_transmit(void) {
+  event_queue_stats_record_raise(EVENT_PRIORITY_HIGHEST, 1, 2, false);
+  event_queue_stats_record_raise(EVENT_PRIORITY_LOWEST, 1, 7, false);
+  for (EventId id = 10; id < 14; id++) {
+    event_queue_stats_record_raise(EVENT_PRIORITY_NORMAL, id, EVENT_QUEUE_SIZE, true);
+  }
+  event_queue_stats_record_latency(300);
+
+  size_t cursor = 0;
+  s_tx_queue_free = TEST_STATS_TX_QUEUE_LEN;
+  TEST_ASSERT_EQUAL(STATUS_CODE_RESOURCE_EXHAUSTED,
+                    event_queue_stats_transmit(TEST_STATS_SOURCE_ID, TEST_STATS_MSG_ID, &cursor));
+  TEST_ASSERT_EQUAL(TEST_STATS_TX_QUEUE_LEN, s_num_tx_msgs);
+
+  s_tx_queue_free = TEST_STATS_TX_QUEUE_LEN;
+  TEST_ASSERT_OK(event_queue_stats_transmit(TEST_STATS_SOURCE_ID, TEST_STATS_MSG_ID, &cursor));
+  TEST_ASSERT_EQUAL(0, cursor);
+  TEST_ASSERT_EQUAL(7, s_num_tx_msgs);
+
+  TEST_ASSERT_EQUAL(TEST_STATS_SOURCE_ID, s_tx_msgs[0].source_id);
+  TEST_ASSERT_EQUAL(TEST_STATS_MSG_ID, s_tx_msgs[0].msg_id);
+  TEST_ASSERT_EQUAL(8, s_tx_msgs[0].dlc);
+  TEST_ASSERT_EQUAL(EVENT_QUEUE_STATS_ENTRY_HIGH_WATER, s_tx_msgs[1].data_u8[0]);
+  TEST_ASSERT_EQUAL(EVENT_PRIORITY_LOWEST, s_tx_msgs[1].data_u16[1]);
+  TEST_ASSERT_EQUAL(7, s_tx_msgs[1].data_u32[1]);
+  TEST_ASSERT_EQUAL(EVENT_QUEUE_STATS_ENTRY_DROPPED, s_tx_msgs[5].data_u8[0]);
+  TEST_ASSERT_EQUAL(13, s_tx_msgs[5].data_u16[1]);
+  TEST_ASSERT_EQUAL(1, s_tx_msgs[5].data_u32[1]);
+  TEST_ASSERT_EQUAL(EVENT_QUEUE_STATS_ENTRY_LATENCY, s_tx_msgs[6].data_u8[0]);
+  TEST_ASSERT_EQUAL(event_queue_stats_latency_bucket(300), s_tx_msgs[6].data_u16[1]);
+}
+
+void test_event_queue_stats_instrumented(void) {
+  const EventQueueStats *stats = event_queue_stats_get();
+  for (EventId id = 0; id <= EVENT_QUEUE_SIZE; id++) {
+    event_raise(id, 0);
+  }
+
+  TEST_ASSERT_EQUAL(EVENT_QUEUE_SIZE, stats->high_water[EVENT_PRIORITY_NORMAL]);
+  TEST_ASSERT_EQUAL(1, stats->dropped[EVENT_QUEUE_SIZE]);
+
+  delay_ms(2);
+  Event e = { 0 };
+  while (status_ok(event_process(&e))) {
+  }
+  // Everything waited at least 2ms
+  uint32_t waited = 0;
+  for (size_t i = event_queue_stats_latency_bucket(2000); i < EVENT_QUEUE_STATS_LATENCY_BUCKETS;
+       i++) {
+    waited += stats->latency_us_log2[i];
+  }
+  TEST_ASSERT_EQUAL(EVENT_QUEUE_SIZE, waited);
+}
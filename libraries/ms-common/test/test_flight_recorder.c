@@ -0,0 +1,119 @@
+#include "flight_recorder.h"
+
+#include <string.h>
+
+#include "crc32.h"
+#include "event_queue.h"
+#include "flash.h"
+#include "interrupt.h"
+#include "soft_timer.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+static FlightRecorderRing s_saved;
+
+void setup_test(void) {
+  interrupt_init();
+  soft_timer_init();
+  crc32_init();
+  flash_init();
+  flash_erase(FLIGHT_RECORDER_FLASH_PAGE);
+  TEST_ASSERT_OK(flight_recorder_init());
+}
+
+void teardown_test(void) {
+  flash_erase(FLIGHT_RECORDER_FLASH_PAGE);
+}
+
+// The ring keeps the newest entries in order once it wraps.
+void test_flight_recorder_wraps(void) {
+  const uint16_t num_recorded = FLIGHT_RECORDER_NUM_ENTRIES + 10;
+  for (uint16_t i = 0; i < num_recorded; i++) {
+    flight_recorder_record(FLIGHT_RECORDER_ENTRY_EVENT, 0, i);
+  }
+  flight_recorder_freeze(0x42, 0);
+  // Reboot to save the ring
+  TEST_ASSERT_OK(flight_recorder_init());
+  TEST_ASSERT_OK(flight_recorder_load(&s_saved));
+
+  TEST_ASSERT_EQUAL(FLIGHT_RECORDER_NUM_ENTRIES, flight_recorder_num_entries(&s_saved));
+  // The oldest entries were overwritten, and the fault took one more slot
+  const FlightRecorderEntry *oldest = flight_recorder_get_entry(&s_saved, 0);
+  TEST_ASSERT_EQUAL(FLIGHT_RECORDER_ENTRY_EVENT, oldest->type);
+  TEST_ASSERT_EQUAL(num_recorded - FLIGHT_RECORDER_NUM_ENTRIES + 1, oldest->value);
+  for (size_t i = 1; i < FLIGHT_RECORDER_NUM_ENTRIES - 1; i++) {
+    TEST_ASSERT_EQUAL(oldest->value + i, flight_recorder_get_entry(&s_saved, i)->value);
+  }
+}
+
+// Nothing is recorded after a freeze, and the ring is saved on the next boot.
+void test_flight_recorder_freeze_and_save(void) {
+  flight_recorder_record(FLIGHT_RECORDER_ENTRY_CAN_RX, 8, 0x123);
+  flight_recorder_record(FLIGHT_RECORDER_ENTRY_EVENT, EVENT_PRIORITY_HIGH, 7);
+  TEST_ASSERT_FALSE(flight_recorder_is_frozen());
+
+  flight_recorder_freeze(0x1234, 0xABCD);
+  TEST_ASSERT_TRUE(flight_recorder_is_frozen());
+  // Later faults and entries are ignored
+  flight_recorder_freeze(0x5678, 0);
+  flight_recorder_record(FLIGHT_RECORDER_ENTRY_EVENT, 0, 8);
+
+  // Nothing is saved until the next boot
+  TEST_ASSERT_EQUAL(STATUS_CODE_UNINITIALIZED, flight_recorder_load(&s_saved));
+  TEST_ASSERT_OK(flight_recorder_init());
+  TEST_ASSERT_FALSE(flight_recorder_is_frozen());
+
+  TEST_ASSERT_OK(flight_recorder_load(&s_saved));
+  TEST_ASSERT_EQUAL(0x1234, s_saved.fault.code);
+  TEST_ASSERT_EQUAL(0xABCD, s_saved.fault.arg);
+  TEST_ASSERT_EQUAL(3, flight_recorder_num_entries(&s_saved));
+  const FlightRecorderEntry *entry = flight_recorder_get_entry(&s_saved, 0);
+  TEST_ASSERT_EQUAL(FLIGHT_RECORDER_ENTRY_CAN_RX, entry->type);
+  TEST_ASSERT_EQUAL(8, entry->arg);
+  TEST_ASSERT_EQUAL(0x123, entry->value);
+  entry = flight_recorder_get_entry(&s_saved, 2);
+  TEST_ASSERT_EQUAL(FLIGHT_RECORDER_ENTRY_FAULT, entry->type);
+  TEST_ASSERT_EQUAL(0x1234, entry->value);
+
+  // A boot without a fault leaves the saved ring alone
+  TEST_ASSERT_OK(flight_recorder_init());
+  TEST_ASSERT_OK(flight_recorder_load(&s_saved));
+  TEST_ASSERT_EQUAL(0x1234, s_saved.fault.code);
+}
+
+// A board that keeps running can save the ring without rebooting.
+void test_flight_recorder_persist(void) {
+  TEST_ASSERT_OK(flight_recorder_persist());
+  TEST_ASSERT_EQUAL(STATUS_CODE_UNINITIALIZED, flight_recorder_load(&s_saved));
+
+  flight_recorder_record(FLIGHT_RECORDER_ENTRY_USER, 1, 2);
+  flight_recorder_freeze(0x99, 0);
+  TEST_ASSERT_OK(flight_recorder_persist());
+  TEST_ASSERT_OK(flight_recorder_load(&s_saved));
+  TEST_ASSERT_EQUAL(0x99, s_saved.fault.code);
+  TEST_ASSERT_EQUAL(2, flight_recorder_num_entries(&s_saved));
+
+  // Later calls don't touch flash again
+  flash_erase(FLIGHT_RECORDER_FLASH_PAGE);
+  TEST_ASSERT_OK(flight_recorder_persist());
+  TEST_ASSERT_EQUAL(STATUS_CODE_UNINITIALIZED, flight_recorder_load(&s_saved));
+}
+
+void test_flight_recorder_decode(void) {
+  flight_recorder_record(FLIGHT_RECORDER_ENTRY_CAN_TX, 2, 0x10);
+  flight_recorder_freeze(0x1, 0);
+  TEST_ASSERT_OK(flight_recorder_persist());
+
+  uint8_t page[sizeof(FlightRecorderRing)];
+  TEST_ASSERT_OK(flash_read(FLASH_PAGE_TO_ADDR(FLIGHT_RECORDER_FLASH_PAGE), sizeof(page), page,
+                            sizeof(page)));
+  TEST_ASSERT_OK(flight_recorder_decode(page, sizeof(page), &s_saved));
+  TEST_ASSERT_EQUAL(2, flight_recorder_num_entries(&s_saved));
+
+  TEST_ASSERT_EQUAL(STATUS_CODE_UNINITIALIZED,
+                    flight_recorder_decode(page, sizeof(page) - 1, &s_saved));
+  // Corruption is caught by the CRC
+  page[sizeof(page) - 1] ^= 0x1;
+  TEST_ASSERT_EQUAL(STATUS_CODE_UNINITIALIZED,
+                    flight_recorder_decode(page, sizeof(page), &s_saved));
+}
@@ -0,0 +1,155 @@
+#include "gpio_inject.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gpio.h"
+#include "gpio_it.h"
+#include "interrupt.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_GPIO_INJECT_TRACE_FILE "test_gpio_inject.trace"
+
+static const GpioAddress s_address = { .port = GPIO_PORT_B, .pin = 3 };
+static const InterruptSettings s_settings = {
+  .type = INTERRUPT_TYPE_INTERRUPT,       //
+  .priority = INTERRUPT_PRIORITY_NORMAL,  //
+};
+
+static volatile uint32_t s_num_edges;
+static volatile GpioState s_state_in_isr;
+static volatile uint64_t s_isr_time_ns;
+
+static uint64_t prv_now_ns(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+static void prv_callback(const GpioAddress *address, void *context) {
+  GpioState state = NUM_GPIO_STATES;
+  gpio_get_state(address, &state);
+  s_state_in_isr = state;
+  s_isr_time_ns = prv_now_ns();
+  s_num_edges++;
+}
+
+void setup_test(void) {
+  interrupt_init();
+  gpio_init();
+  gpio_it_init();
+
+  GpioSettings settings = { .direction = GPIO_DIR_IN };
+  gpio_init_pin(&s_address, &settings);
+  s_num_edges = 0;
+  s_state_in_isr = NUM_GPIO_STATES;
+}
+
+void teardown_test(void) {
+  unlink(TEST_GPIO_INJECT_TRACE_FILE);
+}
+
+// Level changes fire the interrupt only on the registered edge.
+void test_gpio_inject_set_state(void) {
+  TEST_ASSERT_OK(gpio_it_register_interrupt(&s_address, &s_settings, INTERRUPT_EDGE_RISING,
+                                            prv_callback, NULL));
+
+  TEST_ASSERT_OK(gpio_inject_set_state(&s_address, GPIO_STATE_HIGH));
+  TEST_ASSERT_EQUAL(1, s_num_edges);
+  TEST_ASSERT_EQUAL(GPIO_STATE_HIGH, s_state_in_isr);
+
+  // No edge without a change, and falling edges are ignored
+  TEST_ASSERT_OK(gpio_inject_set_state(&s_address, GPIO_STATE_HIGH));
+  TEST_ASSERT_OK(gpio_inject_set_state(&s_address, GPIO_STATE_LOW));
+  TEST_ASSERT_EQUAL(1, s_num_edges);
+
+  GpioState state = GPIO_STATE_HIGH;
+  TEST_ASSERT_OK(gpio_get_state(&s_address, &state));
+  TEST_ASSERT_EQUAL(GPIO_STATE_LOW, state);
+
+  // Outputs read back what was written
+  GpioAddress output = { .port = GPIO_PORT_A, .pin = 3 };
+  GpioSettings settings = { .direction = GPIO_DIR_OUT, .state = GPIO_STATE_LOW };
+  gpio_init_pin(&output, &settings);
+  TEST_ASSERT_OK(gpio_inject_set_state(&output, GPIO_STATE_HIGH));
+  TEST_ASSERT_OK(gpio_get_state(&output, &state));
+  TEST_ASSERT_EQUAL(GPIO_STATE_LOW, state);
+  TEST_ASSERT_EQUAL(1, s_num_edges);
+
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, gpio_inject_set_state(&s_address, NUM_GPIO_STATES));
+}
+
+void test_gpio_inject_edges(void) {
+  TEST_ASSERT_OK(gpio_it_register_interrupt(&s_address, &s_settings,
+                                            INTERRUPT_EDGE_RISING_FALLING, prv_callback, NULL));
+
+  TEST_ASSERT_OK(gpio_inject_edge(&s_address, INTERRUPT_EDGE_RISING));
+  TEST_ASSERT_OK(gpio_inject_edge(&s_address, INTERRUPT_EDGE_FALLING));
+  TEST_ASSERT_EQUAL(2, s_num_edges);
+
+  // The same pin on another port shares the line but isn't selected
+  GpioAddress other_port = { .port = GPIO_PORT_A, .pin = s_address.pin };
+  TEST_ASSERT_OK(gpio_inject_edge(&other_port, INTERRUPT_EDGE_RISING));
+  TEST_ASSERT_EQUAL(2, s_num_edges);
+
+  TEST_ASSERT_OK(gpio_it_mask_interrupt(&s_address, true));
+  TEST_ASSERT_OK(gpio_inject_edge(&s_address, INTERRUPT_EDGE_RISING));
+  TEST_ASSERT_EQUAL(2, s_num_edges);
+  TEST_ASSERT_OK(gpio_it_mask_interrupt(&s_address, false));
+  TEST_ASSERT_OK(gpio_inject_edge(&s_address, INTERRUPT_EDGE_RISING));
+  TEST_ASSERT_EQUAL(3, s_num_edges);
+
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    gpio_inject_edge(&s_address, INTERRUPT_EDGE_RISING_FALLING));
+}
+
+// The edge time lets the ISR latency be measured.
+void test_gpio_inject_edge_time(void) {
+  TEST_ASSERT_OK(gpio_it_register_interrupt(&s_address, &s_settings, INTERRUPT_EDGE_RISING,
+                                            prv_callback, NULL));
+
+  uint64_t before_ns = prv_now_ns();
+  TEST_ASSERT_OK(gpio_inject_set_state(&s_address, GPIO_STATE_HIGH));
+  uint64_t edge_ns = 0;
+  TEST_ASSERT_OK(gpio_inject_get_edge_time(&s_address, &edge_ns));
+
+  TEST_ASSERT_EQUAL(1, s_num_edges);
+  TEST_ASSERT_TRUE(before_ns <= edge_ns);
+  TEST_ASSERT_TRUE(edge_ns <= s_isr_time_ns);
+}
+
+void test_gpio_inject_replay(void) {
+  TEST_ASSERT_OK(gpio_it_register_interrupt(&s_address, &s_settings,
+                                            INTERRUPT_EDGE_RISING_FALLING, prv_callback, NULL));
+
+  FILE *file = fopen(TEST_GPIO_INJECT_TRACE_FILE, "w");
+  fprintf(file, "# time_us port pin state\n");
+  fprintf(file, "0 B 3 1\n");
+  fprintf(file, "1000 b 3 0\n");
+  fprintf(file, "\n");
+  fprintf(file, "1000 1 3 1\n");
+  fprintf(file, "5000 B 3 0\n");
+  fclose(file);
+
+  uint64_t start_ns = prv_now_ns();
+  TEST_ASSERT_OK(gpio_inject_replay(TEST_GPIO_INJECT_TRACE_FILE));
+  TEST_ASSERT_EQUAL(STATUS_CODE_RESOURCE_EXHAUSTED,
+                    gpio_inject_replay(TEST_GPIO_INJECT_TRACE_FILE));
+  // The last interrupt may still be on its way once the replay is done
+  while (gpio_inject_replaying() || s_num_edges < 4) {
+  }
+
+  TEST_ASSERT_TRUE(prv_now_ns() - start_ns >= 5000 * 1000);
+  TEST_ASSERT_EQUAL(4, s_num_edges);
+  TEST_ASSERT_EQUAL(GPIO_STATE_LOW, s_state_in_isr);
+
+  // Bad traces are rejected before anything is replayed
+  file = fopen(TEST_GPIO_INJECT_TRACE_FILE, "w");
+  fprintf(file, "10 B 3 1\n5 B 3 0\n");
+  fclose(file);
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, gpio_inject_replay(TEST_GPIO_INJECT_TRACE_FILE));
+  TEST_ASSERT_FALSE(gpio_inject_replaying());
+  TEST_ASSERT_EQUAL(4, s_num_edges);
+}
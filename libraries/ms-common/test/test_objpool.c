@@ -100,3 +100,30 @@ void test_objpool_copy_free(void) {
   // We should still be able to free the node if this happens.
   TEST_ASSERT_OK(objpool_free_node(&gv_pool, node));
 }
+
+void test_objpool_max_nodes(void) {
+  ObjectPool pool;
+  TestObject nodes[OBJPOOL_MAX_NODES];
+  bool returned[OBJPOOL_MAX_NODES] = { false };
+
+  TEST_ASSERT_OK(objpool_init(&pool, nodes, NULL, NULL));
+
+  // Every node should be handed out exactly once, including those past the first 32
+  for (size_t i = 0; i < OBJPOOL_MAX_NODES; i++) {
+    TestObject *node = objpool_get_node(&pool);
+    TEST_ASSERT_NOT_NULL(node);
+    size_t index = (size_t)(node - nodes);
+    TEST_ASSERT_TRUE(index < OBJPOOL_MAX_NODES);
+    TEST_ASSERT_FALSE(returned[index]);
+    returned[index] = true;
+  }
+  TEST_ASSERT_NULL(objpool_get_node(&pool));
+
+  for (size_t i = 32; i < OBJPOOL_MAX_NODES; i++) {
+    TEST_ASSERT_TRUE(returned[i]);
+  }
+
+  // A freed node above index 31 is handed out again
+  TEST_ASSERT_OK(objpool_free_node(&pool, &nodes[OBJPOOL_MAX_NODES - 1]));
+  TEST_ASSERT_EQUAL_PTR(&nodes[OBJPOOL_MAX_NODES - 1], objpool_get_node(&pool));
+}
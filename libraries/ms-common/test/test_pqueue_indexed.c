@@ -0,0 +1,220 @@
+#include "misc.h"
+#include "pqueue_indexed.h"
+#include "status.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_PQUEUE_INDEXED_SIZE 15
+#define TEST_PQUEUE_INDEXED_RANDOM_OPS 2000
+
+static PQueueIndexed s_queue;
+static PQueueIndexedNode s_nodes[TEST_PQUEUE_INDEXED_SIZE];
+static PQueueIndexedEntry s_entries[TEST_PQUEUE_INDEXED_SIZE];
+
+static uint32_t s_seed;
+
+static uint32_t prv_rand(void) {
+  s_seed = s_seed * 1103515245u + 12345u;
+  return s_seed >> 16;
+}
+
+// Checks every node is no smaller than its parent and every entry knows where its node is
+static void prv_assert_heap(void) {
+  for (size_t i = 0; i < s_queue.size; i++) {
+    if (i != 0) {
+      TEST_ASSERT_TRUE(s_nodes[(i - 1) / PQUEUE_INDEXED_ARITY].prio <= s_nodes[i].prio);
+    }
+    TEST_ASSERT_EQUAL(i, s_entries[s_nodes[i].handle].heap_index);
+  }
+}
+
+void setup_test(void) {
+  s_seed = 0x5eed;
+  TEST_ASSERT_OK(pqueue_indexed_init(&s_queue, s_nodes, s_entries));
+}
+
+void teardown_test(void) {}
+
+void test_pqueue_indexed_desc_order(void) {
+  uint16_t prios[] = { 50, 10, 20, 2, 17, 5, 4000, 0, 3, 240 };
+
+  for (size_t i = 0; i < SIZEOF_ARRAY(prios); i++) {
+    TEST_ASSERT_OK(pqueue_indexed_push(&s_queue, &prios[i], prios[i], NULL));
+  }
+  prv_assert_heap();
+
+  uint16_t last_prio = 0;
+  for (size_t i = 0; i < SIZEOF_ARRAY(prios); i++) {
+    uint16_t peek_prio = UINT16_MAX;
+    TEST_ASSERT_NOT_NULL(pqueue_indexed_peek(&s_queue, &peek_prio));
+    uint16_t *prio = pqueue_indexed_pop(&s_queue);
+    TEST_ASSERT_EQUAL(*prio, peek_prio);
+    TEST_ASSERT_MESSAGE(last_prio <= *prio, "Last priority was lower than new priority!");
+    last_prio = *prio;
+  }
+  TEST_ASSERT_NULL(pqueue_indexed_pop(&s_queue));
+  TEST_ASSERT_NULL(pqueue_indexed_peek(&s_queue, NULL));
+}
+
+void test_pqueue_indexed_out_of_space(void) {
+  // Every node can be used
+  for (size_t i = 0; i < TEST_PQUEUE_INDEXED_SIZE + 5; i++) {
+    StatusCode result = pqueue_indexed_push(&s_queue, (void *)i, (uint16_t)i, NULL);
+    if (i < TEST_PQUEUE_INDEXED_SIZE) {
+      TEST_ASSERT_EQUAL(STATUS_CODE_OK, result);
+    } else {
+      TEST_ASSERT_EQUAL(STATUS_CODE_RESOURCE_EXHAUSTED, result);
+    }
+  }
+
+  for (size_t i = 0; i < TEST_PQUEUE_INDEXED_SIZE + 5; i++) {
+    TEST_ASSERT_EQUAL((i < TEST_PQUEUE_INDEXED_SIZE) ? (void *)i : NULL,
+                      pqueue_indexed_pop(&s_queue));
+  }
+}
+
+void test_pqueue_indexed_remove(void) {
+  PQueueHandle handles[10];
+  for (size_t i = 0; i < SIZEOF_ARRAY(handles); i++) {
+    TEST_ASSERT_OK(pqueue_indexed_push(&s_queue, (void *)i, (uint16_t)(i * 10), &handles[i]));
+  }
+
+  // The minimum, an inner node and a leaf
+  TEST_ASSERT_OK(pqueue_indexed_remove(&s_queue, handles[0]));
+  TEST_ASSERT_OK(pqueue_indexed_remove(&s_queue, handles[2]));
+  TEST_ASSERT_OK(pqueue_indexed_remove(&s_queue, handles[9]));
+  prv_assert_heap();
+  TEST_ASSERT_EQUAL(7, pqueue_indexed_size(&s_queue));
+
+  TEST_ASSERT_FALSE(pqueue_indexed_is_queued(&s_queue, handles[2]));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, pqueue_indexed_remove(&s_queue, handles[2]));
+
+  size_t expected[] = { 1, 3, 4, 5, 6, 7, 8 };
+  for (size_t i = 0; i < SIZEOF_ARRAY(expected); i++) {
+    TEST_ASSERT_EQUAL((void *)expected[i], pqueue_indexed_pop(&s_queue));
+  }
+}
+
+void test_pqueue_indexed_update(void) {
+  PQueueHandle handles[5];
+  for (size_t i = 0; i < SIZEOF_ARRAY(handles); i++) {
+    TEST_ASSERT_OK(
+        pqueue_indexed_push(&s_queue, (void *)i, (uint16_t)(100 + i * 10), &handles[i]));
+  }
+
+  // Move the last entry to the front and the first to the back
+  TEST_ASSERT_OK(pqueue_indexed_update(&s_queue, handles[4], 0));
+  TEST_ASSERT_OK(pqueue_indexed_update(&s_queue, handles[0], 1000));
+  prv_assert_heap();
+
+  size_t expected[] = { 4, 1, 2, 3, 0 };
+  for (size_t i = 0; i < SIZEOF_ARRAY(expected); i++) {
+    TEST_ASSERT_EQUAL((void *)expected[i], pqueue_indexed_pop(&s_queue));
+  }
+
+  // Popped entries can't be updated
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, pqueue_indexed_update(&s_queue, handles[0], 5));
+}
+
+void test_pqueue_indexed_invalid_handle(void) {
+  PQueueHandle handle = PQUEUE_INDEXED_INVALID_HANDLE;
+  TEST_ASSERT_OK(pqueue_indexed_push(&s_queue, NULL, 1, &handle));
+  TEST_ASSERT_TRUE(pqueue_indexed_is_queued(&s_queue, handle));
+
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    pqueue_indexed_remove(&s_queue, PQUEUE_INDEXED_INVALID_HANDLE));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    pqueue_indexed_update(&s_queue, TEST_PQUEUE_INDEXED_SIZE, 1));
+  TEST_ASSERT_FALSE(pqueue_indexed_is_queued(&s_queue, TEST_PQUEUE_INDEXED_SIZE));
+
+  PQueueIndexedEntry entries[TEST_PQUEUE_INDEXED_SIZE + 1];
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, pqueue_indexed_init(&s_queue, s_nodes, entries));
+}
+
+void test_pqueue_indexed_heapify(void) {
+  void *data[TEST_PQUEUE_INDEXED_SIZE];
+  uint16_t prios[TEST_PQUEUE_INDEXED_SIZE];
+  PQueueHandle handles[TEST_PQUEUE_INDEXED_SIZE];
+  for (size_t i = 0; i < TEST_PQUEUE_INDEXED_SIZE; i++) {
+    prios[i] = (uint16_t)(prv_rand() % 100);
+    data[i] = &prios[i];
+  }
+
+  // Replaces anything already queued
+  TEST_ASSERT_OK(pqueue_indexed_push(&s_queue, NULL, 0, NULL));
+  TEST_ASSERT_OK(pqueue_indexed_heapify(&s_queue, data, prios, SIZEOF_ARRAY(prios), handles));
+  TEST_ASSERT_EQUAL(TEST_PQUEUE_INDEXED_SIZE, pqueue_indexed_size(&s_queue));
+  prv_assert_heap();
+
+  // Handles work as if the entries were pushed
+  TEST_ASSERT_OK(pqueue_indexed_update(&s_queue, handles[3], 0));
+  TEST_ASSERT_EQUAL(&prios[3], pqueue_indexed_pop(&s_queue));
+  TEST_ASSERT_OK(pqueue_indexed_remove(&s_queue, handles[7]));
+
+  uint16_t last_prio = 0;
+  while (pqueue_indexed_size(&s_queue) != 0) {
+    uint16_t *prio = pqueue_indexed_pop(&s_queue);
+    TEST_ASSERT_NOT_EQUAL(&prios[7], prio);
+    TEST_ASSERT_TRUE(last_prio <= *prio);
+    last_prio = *prio;
+  }
+
+  void *too_many[TEST_PQUEUE_INDEXED_SIZE + 1] = { 0 };
+  uint16_t too_many_prios[TEST_PQUEUE_INDEXED_SIZE + 1] = { 0 };
+  TEST_ASSERT_EQUAL(STATUS_CODE_RESOURCE_EXHAUSTED,
+                    pqueue_indexed_heapify(&s_queue, too_many, too_many_prios,
+                                           SIZEOF_ARRAY(too_many_prios), NULL));
+}
+
+// Random pushes, pops, removals and updates against a list of what should be queued.
+void test_pqueue_indexed_random(void) {
+  uint16_t prios[TEST_PQUEUE_INDEXED_SIZE];
+  bool queued[TEST_PQUEUE_INDEXED_SIZE] = { 0 };
+  size_t num_queued = 0;
+
+  for (size_t op = 0; op < TEST_PQUEUE_INDEXED_RANDOM_OPS; op++) {
+    PQueueHandle handle = (PQueueHandle)(prv_rand() % TEST_PQUEUE_INDEXED_SIZE);
+    uint16_t prio = (uint16_t)(prv_rand() % 50);
+
+    switch (prv_rand() % 4) {
+      case 0:
+        if (num_queued < TEST_PQUEUE_INDEXED_SIZE) {
+          TEST_ASSERT_OK(pqueue_indexed_push(&s_queue, NULL, prio, &handle));
+          TEST_ASSERT_FALSE(queued[handle]);
+          queued[handle] = true;
+          prios[handle] = prio;
+          num_queued++;
+        }
+        break;
+      case 1:
+        if (num_queued != 0) {
+          uint16_t min_prio = UINT16_MAX;
+          for (size_t i = 0; i < TEST_PQUEUE_INDEXED_SIZE; i++) {
+            if (queued[i]) {
+              min_prio = MIN(min_prio, prios[i]);
+            }
+          }
+          handle = s_nodes[0].handle;
+          TEST_ASSERT_EQUAL(min_prio, prios[handle]);
+          pqueue_indexed_pop(&s_queue);
+          queued[handle] = false;
+          num_queued--;
+        }
+        break;
+      case 2:
+        TEST_ASSERT_EQUAL(queued[handle] ? STATUS_CODE_OK : STATUS_CODE_INVALID_ARGS,
+                          pqueue_indexed_remove(&s_queue, handle));
+        num_queued -= queued[handle];
+        queued[handle] = false;
+        break;
+      default:
+        TEST_ASSERT_EQUAL(queued[handle] ? STATUS_CODE_OK : STATUS_CODE_INVALID_ARGS,
+                          pqueue_indexed_update(&s_queue, handle, prio));
+        prios[handle] = prio;
+        break;
+    }
+
+    TEST_ASSERT_EQUAL(num_queued, pqueue_indexed_size(&s_queue));
+    prv_assert_heap();
+  }
+}
@@ -0,0 +1,168 @@
+#include "slab.h"
+
+#include <string.h>
+
+#include "test_helpers.h"
+#include "unity.h"
+
+// More than an object pool can hold
+#define TEST_SLAB_SIZE 100
+#define TEST_SLAB_DEFAULT UINT16_MAX
+
+typedef struct TestObject {
+  uint16_t data;
+} TestObject;
+
+typedef struct TestLargeObject {
+  uint32_t data[4];
+} TestLargeObject;
+
+static Slab s_slab;
+static SLAB_STORAGE(TestObject, TEST_SLAB_SIZE) s_storage;
+
+static void prv_node_init(void *node, void *context) {
+  TestObject *obj = node;
+  obj->data = TEST_SLAB_DEFAULT;
+}
+
+void setup_test(void) {
+  slab_init(&s_slab, &s_storage, TestObject, prv_node_init, NULL);
+}
+
+void teardown_test(void) {}
+
+void test_slab_multi(void) {
+  TestObject *nodes[TEST_SLAB_SIZE] = { 0 };
+
+  for (int i = 0; i < TEST_SLAB_SIZE; i++) {
+    nodes[i] = slab_get_node(&s_slab);
+    TEST_ASSERT_NOT_NULL(nodes[i]);
+    TEST_ASSERT_EQUAL(TEST_SLAB_DEFAULT, nodes[i]->data);
+    nodes[i]->data = (uint16_t)i;
+  }
+  TEST_ASSERT_NULL(slab_get_node(&s_slab));
+
+  for (int i = 0; i < TEST_SLAB_SIZE; i++) {
+    TEST_ASSERT_EQUAL(i, nodes[i]->data);
+  }
+
+  const SlabStats *stats = slab_get_stats(&s_slab);
+  TEST_ASSERT_EQUAL(TEST_SLAB_SIZE, stats->in_use);
+  TEST_ASSERT_EQUAL(TEST_SLAB_SIZE, stats->high_water);
+  TEST_ASSERT_EQUAL(1, stats->failed);
+
+  for (int i = 0; i < TEST_SLAB_SIZE; i++) {
+    TEST_ASSERT_OK(slab_free_node(&s_slab, nodes[i]));
+  }
+  TEST_ASSERT_EQUAL(0, stats->in_use);
+  TEST_ASSERT_EQUAL(TEST_SLAB_SIZE, stats->high_water);
+
+  for (int i = 0; i < TEST_SLAB_SIZE; i++) {
+    TestObject *node = slab_get_node(&s_slab);
+
+    // Expect our nodes to be reset
+    TEST_ASSERT_EQUAL(TEST_SLAB_DEFAULT, node->data);
+  }
+}
+
+// Allocation takes the first free node, wherever it is in the bitset.
+void test_slab_reuses_free_node(void) {
+  TestObject *nodes[TEST_SLAB_SIZE] = { 0 };
+  for (int i = 0; i < TEST_SLAB_SIZE; i++) {
+    nodes[i] = slab_get_node(&s_slab);
+  }
+
+  TEST_ASSERT_OK(slab_free_node(&s_slab, nodes[70]));
+  TEST_ASSERT_OK(slab_free_node(&s_slab, nodes[40]));
+  TEST_ASSERT_EQUAL_PTR(nodes[40], slab_get_node(&s_slab));
+  TEST_ASSERT_EQUAL_PTR(nodes[70], slab_get_node(&s_slab));
+  TEST_ASSERT_NULL(slab_get_node(&s_slab));
+}
+
+void test_slab_invalid_free(void) {
+  TestObject *node = slab_get_node(&s_slab);
+
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, slab_free_node(&s_slab, NULL));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    slab_free_node(&s_slab, s_storage.buffer + sizeof(s_storage.buffer)));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, slab_free_node(&s_slab, (uint8_t *)node + 1));
+
+  // Double free
+  TEST_ASSERT_OK(slab_free_node(&s_slab, node));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, slab_free_node(&s_slab, node));
+  TEST_ASSERT_EQUAL(0, slab_get_stats(&s_slab)->in_use);
+}
+
+void test_slab_invalid_init(void) {
+  static uint8_t buffer[SLAB_NODE_STRIDE(1) * (SLAB_MAX_NODES + 1)];
+  static uint32_t bitset[SLAB_BITSET_WORDS(SLAB_MAX_NODES + 1)];
+  Slab slab;
+
+  TEST_ASSERT_EQUAL(STATUS_CODE_OUT_OF_RANGE, slab_init_verbose(&slab, buffer, sizeof(buffer),
+                                                                bitset, SIZEOF_ARRAY(bitset), 1,
+                                                                NULL, NULL));
+  // Not enough bits for every node
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    slab_init_verbose(&slab, buffer, SLAB_NODE_STRIDE(1) * SLAB_MAX_NODES, bitset,
+                                      SLAB_BITSET_WORDS(SLAB_MAX_NODES) - 1, 1, NULL, NULL));
+  TEST_ASSERT_OK(slab_init_verbose(&slab, buffer, SLAB_NODE_STRIDE(1) * SLAB_MAX_NODES, bitset,
+                                   SLAB_BITSET_WORDS(SLAB_MAX_NODES), 1, NULL, NULL));
+  TEST_ASSERT_EQUAL(SLAB_MAX_NODES, slab.num_nodes);
+}
+
+// Allocations come from the smallest class that fits, falling back to larger ones once it's full.
+void test_slab_size_classes(void) {
+  static SLAB_STORAGE(TestLargeObject, 1) large_storage;
+  Slab classes[2];
+  SlabAllocator allocator;
+  slab_init(&classes[0], &s_storage, TestObject, NULL, NULL);
+  slab_init(&classes[1], &large_storage, TestLargeObject, NULL, NULL);
+
+  Slab unsorted[2] = { classes[1], classes[0] };
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, slab_allocator_init(&allocator, unsorted));
+  TEST_ASSERT_OK(slab_allocator_init(&allocator, classes));
+
+  // Too big for any class
+  TEST_ASSERT_NULL(slab_alloc(&allocator, sizeof(TestLargeObject) + 1));
+
+  TestObject *small = NULL;
+  for (int i = 0; i < TEST_SLAB_SIZE; i++) {
+    small = slab_alloc(&allocator, sizeof(TestObject));
+    TEST_ASSERT_NOT_NULL(small);
+  }
+  TEST_ASSERT_EQUAL(TEST_SLAB_SIZE, slab_get_stats(&classes[0])->in_use);
+
+  TestObject *fallback = slab_alloc(&allocator, sizeof(TestObject));
+  TEST_ASSERT_NOT_NULL(fallback);
+  TEST_ASSERT_EQUAL(1, slab_get_stats(&classes[1])->in_use);
+  TEST_ASSERT_NULL(slab_alloc(&allocator, 1));
+
+  TEST_ASSERT_OK(slab_free(&allocator, fallback));
+  TEST_ASSERT_OK(slab_free(&allocator, small));
+  TEST_ASSERT_EQUAL(0, slab_get_stats(&classes[1])->in_use);
+  TEST_ASSERT_EQUAL(TEST_SLAB_SIZE - 1, slab_get_stats(&classes[0])->in_use);
+
+  TestObject other;
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, slab_free(&allocator, &other));
+}
+
+// Canaries only exist when built with SLAB_CANARIES.
+void test_slab_canaries(void) {
+  TestObject *node = slab_get_node(&s_slab);
+  TEST_ASSERT_OK(slab_check_canaries(&s_slab));
+
+#ifdef SLAB_CANARIES
+  // Overrun the node
+  memset(node, 0xFF, sizeof(*node) + 1);
+  TEST_ASSERT_EQUAL(STATUS_CODE_INTERNAL_ERROR, slab_check_canaries(&s_slab));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INTERNAL_ERROR, slab_free_node(&s_slab, node));
+  TEST_ASSERT_EQUAL(2, slab_get_stats(&s_slab)->corrupted);
+
+  // Freeing restored it
+  TEST_ASSERT_OK(slab_check_canaries(&s_slab));
+#else
+  TEST_ASSERT_EQUAL(sizeof(TestObject), s_slab.stride);
+  TEST_ASSERT_OK(slab_free_node(&s_slab, node));
+  TEST_ASSERT_EQUAL(0, slab_get_stats(&s_slab)->corrupted);
+#endif
+}
@@ -3,6 +3,7 @@
 #include <stdbool.h>
 
 #include "critical_section.h"
+#include "delay.h"
 #include "hal_test_helpers.h"
 #include "interrupt.h"
 #include "log.h"
@@ -211,3 +212,16 @@ void test_soft_timer_too_short(void) {
   TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
                     soft_timer_start(SOFT_TIMER_MIN_TIME_US - 1, prv_timeout_cb, NULL, NULL));
 }
+
+// The current time should advance monotonically across the counter rollover.
+void test_soft_timer_current_time(void) {
+  _test_soft_timer_set_counter(UINT32_MAX - 1000);
+  const uint32_t start = soft_timer_get_current_time();
+  delay_ms(5);
+  const uint32_t end = soft_timer_get_current_time();
+
+  // The counter wrapped while we waited
+  TEST_ASSERT_TRUE(start > UINT32_MAX - 2000);
+  TEST_ASSERT_TRUE(end < start);
+  TEST_ASSERT_UINT32_WITHIN(4000, 7000, end - start);
+}
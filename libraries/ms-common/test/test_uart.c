@@ -0,0 +1,137 @@
+#include "uart.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "hal_test_helpers.h"
+#include "interrupt.h"
+#include "log.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_UART_MAX_LINES 4
+#define TEST_UART_TIMEOUT_MS 1000
+
+static UartStorage s_storage;
+static UartStorage s_loopback_storage;
+static int s_peer_fd;
+
+static uint8_t s_lines[TEST_UART_MAX_LINES][UART_MAX_BUFFER_LEN + 1];
+static size_t s_line_lens[TEST_UART_MAX_LINES];
+static volatile size_t s_num_lines;
+
+static void prv_rx_handler(const uint8_t *rx_arr, size_t len, void *context) {
+  if (s_num_lines < TEST_UART_MAX_LINES) {
+    memcpy(s_lines[s_num_lines], rx_arr, len);
+    s_line_lens[s_num_lines] = len;
+    s_num_lines++;
+  }
+}
+
+static void prv_wait_for_lines(size_t num_lines) {
+  for (size_t i = 0; i < TEST_UART_TIMEOUT_MS && s_num_lines < num_lines; i++) {
+    usleep(1000);
+  }
+  TEST_ASSERT_EQUAL(num_lines, s_num_lines);
+}
+
+static UartSettings s_settings = {
+  .baudrate = 115200,
+  .rx_handler = prv_rx_handler,
+};
+
+void setup_test(void) {
+  interrupt_init();
+  memset(s_lines, 0, sizeof(s_lines));
+  s_num_lines = 0;
+
+  int fds[2];
+  TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  TEST_ASSERT_OK(_test_uart_connect(UART_PORT_1, fds[0]));
+  s_peer_fd = fds[1];
+  TEST_ASSERT_OK(uart_init(UART_PORT_1, &s_settings, &s_storage));
+}
+
+void teardown_test(void) {
+  close(s_peer_fd);
+}
+
+void test_uart_tx(void) {
+  uint8_t data[] = "hello";
+  TEST_ASSERT_OK(uart_tx(UART_PORT_1, data, sizeof(data)));
+
+  struct pollfd poll_fd = { .fd = s_peer_fd, .events = POLLIN };
+  TEST_ASSERT_EQUAL(1, poll(&poll_fd, 1, TEST_UART_TIMEOUT_MS));
+  uint8_t rx_data[sizeof(data)] = { 0 };
+  TEST_ASSERT_EQUAL(sizeof(data), read(s_peer_fd, rx_data, sizeof(rx_data)));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(data, rx_data, sizeof(data));
+}
+
+// Bytes arriving together are split into lines, and partial lines are kept.
+void test_uart_rx_lines(void) {
+  const char *data = "ab\ncd\nef";
+  TEST_ASSERT_EQUAL(strlen(data), write(s_peer_fd, data, strlen(data)));
+  prv_wait_for_lines(2);
+  TEST_ASSERT_EQUAL_STRING("ab\n", s_lines[0]);
+  TEST_ASSERT_EQUAL_STRING("cd\n", s_lines[1]);
+  TEST_ASSERT_EQUAL(3, s_line_lens[1]);
+
+  TEST_ASSERT_EQUAL(1, write(s_peer_fd, "\n", 1));
+  prv_wait_for_lines(3);
+  TEST_ASSERT_EQUAL_STRING("ef\n", s_lines[2]);
+}
+
+// Without a delimiter, the handler is called once the buffer fills.
+void test_uart_rx_full(void) {
+  TEST_ASSERT_OK(uart_set_delimiter(UART_PORT_1, 0));
+
+  uint8_t data[UART_MAX_BUFFER_LEN + 10];
+  memset(data, 'a', sizeof(data));
+  data[sizeof(data) - 1] = 0;
+  TEST_ASSERT_EQUAL(sizeof(data), write(s_peer_fd, data, sizeof(data)));
+
+  prv_wait_for_lines(2);
+  TEST_ASSERT_EQUAL(UART_MAX_BUFFER_LEN, s_line_lens[0]);
+  TEST_ASSERT_EQUAL(10, s_line_lens[1]);
+  TEST_ASSERT_EQUAL(0, s_lines[1][9]);
+}
+
+void test_uart_back_to_back(void) {
+  int fds[2];
+  TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  TEST_ASSERT_OK(_test_uart_connect(UART_PORT_2, fds[0]));
+  TEST_ASSERT_OK(_test_uart_connect(UART_PORT_3, fds[1]));
+  TEST_ASSERT_OK(uart_init(UART_PORT_2, &s_settings, &s_loopback_storage));
+  TEST_ASSERT_OK(uart_init(UART_PORT_3, &s_settings, &s_storage));
+
+  uint8_t data[] = "ping\n";
+  TEST_ASSERT_OK(uart_tx(UART_PORT_2, data, strlen((char *)data)));
+  prv_wait_for_lines(1);
+  TEST_ASSERT_EQUAL_STRING("ping\n", s_lines[0]);
+}
+
+// Without a test socket, the port is a pty that can be found through the environment.
+void test_uart_pty(void) {
+  char dir[] = "/tmp/test_uart_XXXXXX";
+  TEST_ASSERT_NOT_NULL(mkdtemp(dir));
+  setenv("MIDSUN_X86_UART_DIR", dir, 1);
+  TEST_ASSERT_OK(uart_init(UART_PORT_4, &s_settings, &s_loopback_storage));
+  unsetenv("MIDSUN_X86_UART_DIR");
+
+  char link_path[64];
+  snprintf(link_path, sizeof(link_path), "%s/uart%d", dir, UART_PORT_4);
+  int pty_fd = open(link_path, O_RDWR | O_NOCTTY);
+  unlink(link_path);
+  rmdir(dir);
+  TEST_ASSERT_TRUE(pty_fd >= 0);
+
+  TEST_ASSERT_EQUAL(4, write(pty_fd, "pty\n", 4));
+  prv_wait_for_lines(1);
+  TEST_ASSERT_EQUAL_STRING("pty\n", s_lines[0]);
+  close(pty_fd);
+}
@@ -2,6 +2,7 @@
 
 // Voltage reference value
 #define EXTERNAL_VREF_V 2.5
+#define EXTERNAL_VREF_UV 2500000
 
 // ADS1259 Configuration and control commands
 
@@ -27,6 +27,9 @@ typedef struct {
 
 typedef enum { ADT_PWM_PORT_1, ADT_PWM_PORT_2, ADT_PWM_PORT_3, NUM_ADT_PWM_PORTS } AdtPwmPort;
 
+// 4 tachometer inputs, one per fan
+typedef enum { ADT_TACH_1, ADT_TACH_2, ADT_TACH_3, ADT_TACH_4, NUM_ADT_TACHS } AdtTach;
+
 // Initialize the Adt7476a with the given settings; the select pin is an STM32 GPIO pin.
 StatusCode adt7476a_init(Adt7476aStorage *storage, Adt7476aSettings *settings);
 
@@ -36,3 +39,7 @@ StatusCode adt7476a_set_speed(I2CPort port, uint8_t speed_percent, AdtPwmPort pw
 
 StatusCode adt7476a_get_status(I2CPort port, uint8_t adt7476a_i2c_addr, uint8_t *register_1_data,
                                uint8_t *register_2_data);
+
+// Read a fan's speed from its tachometer. Stalled or missing fans read 0 RPM.
+StatusCode adt7476a_get_fan_rpm(I2CPort port, uint8_t adt7476a_i2c_addr, AdtTach tach,
+                                uint16_t *rpm);
@@ -32,6 +32,11 @@
 #define ADT7476A_TACH_4_LOW 0x2E   // default 0xFF
 #define ADT7476A_TACH_4_HIGH 0x2F  // default 0xFF
 
+// Tach readings count periods of a 90 kHz clock over one fan revolution (see p.31)
+#define ADT7476A_TACH_CLOCK_HZ 90000
+// Reading for a stalled fan, or one slower than the tach can measure
+#define ADT7476A_TACH_STALLED 0xFFFF
+
 #define ADT7476A_MANUAL_MODE_MASK 0b11100010
 #define ADT7476A_CONFIG_REG_1_MASK 0b00000101
 #define ADT7476A_CONFIG_REG_3_MASK 0b00000001
@@ -122,6 +122,7 @@ StatusCode ltc_afe_request_aux_conversion(LtcAfeStorage *afe);
 // Process events
 bool ltc_afe_process_event(LtcAfeStorage *afe, const Event *e);
 
-// Mark cell for discharging (takes effect after config is re-written)
+// Mark cell for discharging (takes effect after config is re-written, which happens whenever a
+// cell or aux conversion is triggered)
 // |cell| should be [0, settings.num_cells)
 StatusCode ltc_afe_toggle_cell_discharge(LtcAfeStorage *afe, uint16_t cell, bool discharge);
@@ -2,9 +2,9 @@
 
 #include "ads1259_adc_defs.h"
 #include "delay.h"
+#include "fixed_point.h"
 #include "interrupt.h"
 #include "log.h"
-#include "math.h"
 #include "soft_timer.h"
 
 // Used to determine length of time needed between convert command sent and data collection
@@ -70,15 +70,16 @@ static Ads1259StatusCode prv_checksum(Ads1259Storage *storage) {
 
 // using the amount of noise free bits based on the SPS and VREF calculate analog voltage value
 // 0x000000-0x7FFFFF positive range, 0xFFFFFF - 0x800000 neg range, rightmost is greatest magnitude
+// This runs for every sample, so it's done in fixed point rather than soft-float doubles
 static void prv_convert_data(Ads1259Storage *storage) {
-  double resolution = pow(2, s_num_usable_bits[ADS1259_DATA_RATE_SPS] - 1);
+  const uint8_t usable_bits = s_num_usable_bits[ADS1259_DATA_RATE_SPS];
+  const int32_t resolution = 1 << (usable_bits - 1);
   if (storage->conv_data.raw & RX_NEG_VOLTAGE_BIT) {
-    storage->reading = 0 - ((RX_MAX_VALUE - storage->conv_data.raw) >>
-                            (24 - s_num_usable_bits[ADS1259_DATA_RATE_SPS])) *
-                               EXTERNAL_VREF_V / resolution;
+    int32_t code = (int32_t)((RX_MAX_VALUE - storage->conv_data.raw) >> (24 - usable_bits));
+    storage->reading_uv = -fixed_scale(code, EXTERNAL_VREF_UV, resolution);
   } else {
-    storage->reading = (storage->conv_data.raw >> (24 - s_num_usable_bits[ADS1259_DATA_RATE_SPS])) *
-                       EXTERNAL_VREF_V / (resolution - 1);
+    int32_t code = (int32_t)(storage->conv_data.raw >> (24 - usable_bits));
+    storage->reading_uv = fixed_scale(code, EXTERNAL_VREF_UV, resolution - 1);
   }
 }
 
@@ -114,7 +115,7 @@ StatusCode ads1259_init(Ads1259Storage *storage, Ads1259Settings *settings) {
   return STATUS_CODE_OK;
 }
 
-// Reads conversion data to data struct in storage. data->reading gives total value
+// Reads conversion data to data struct in storage. storage->reading_uv gives total value
 StatusCode ads1259_get_conversion_data(Ads1259Storage *storage) {
   prv_send_command(storage, ADS1259_START_CONV);
   soft_timer_start_millis(s_conversion_time_ms_lookup[ADS1259_DATA_RATE_SPS],
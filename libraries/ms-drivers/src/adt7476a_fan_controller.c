@@ -8,6 +8,7 @@
 #include "gpio_it.h"
 #include "i2c.h"
 #include "interrupt.h"
+#include "misc.h"
 #include "soft_timer.h"
 
 // need to set interrupt once fan goes out of range
@@ -56,6 +57,31 @@ StatusCode adt7476a_get_status(I2CPort port, uint8_t adt7476a_i2c_read_address,
   return STATUS_CODE_OK;
 }
 
+StatusCode adt7476a_get_fan_rpm(I2CPort port, uint8_t adt7476a_i2c_read_address, AdtTach tach,
+                                uint16_t *rpm) {
+  if (tach >= NUM_ADT_TACHS || rpm == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  // the tach registers are consecutive low/high pairs, and reading the low byte first freezes the
+  // high byte until it's read so the halves match
+  uint8_t low_reg = (uint8_t)(ADT7476A_TACH_1_LOW + 2 * tach);
+  uint8_t low = 0;
+  uint8_t high = 0;
+  status_ok_or_return(
+      i2c_read_reg(port, adt7476a_i2c_read_address, low_reg, &low, ADT7476A_REG_SIZE));
+  status_ok_or_return(i2c_read_reg(port, adt7476a_i2c_read_address, (uint8_t)(low_reg + 1), &high,
+                                   ADT7476A_REG_SIZE));
+
+  uint16_t count = (uint16_t)((high << 8) | low);
+  if (count == 0 || count == ADT7476A_TACH_STALLED) {
+    *rpm = 0;
+  } else {
+    *rpm = (uint16_t)MIN((uint32_t)ADT7476A_TACH_CLOCK_HZ * 60 / count, (uint32_t)UINT16_MAX);
+  }
+  return STATUS_CODE_OK;
+}
+
 StatusCode adt7476a_init(Adt7476aStorage *storage, Adt7476aSettings *settings) {
   if (storage == NULL || settings == NULL) {
     return status_code(STATUS_CODE_INVALID_ARGS);
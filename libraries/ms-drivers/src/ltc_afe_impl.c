@@ -249,6 +249,10 @@ StatusCode ltc_afe_impl_init(LtcAfeStorage *afe, const LtcAfeSettings *settings)
 }
 
 StatusCode ltc_afe_impl_trigger_cell_conv(LtcAfeStorage *afe) {
+  // Rewrite the config so discharge changes since the aux conversions apply to this conversion
+  uint8_t gpio_bits =
+      LTC6811_GPIO1_PD_OFF | LTC6811_GPIO3_PD_OFF | LTC6811_GPIO4_PD_OFF | LTC6811_GPIO5_PD_OFF;
+  status_ok_or_return(prv_write_config(afe, gpio_bits));
   return prv_trigger_adc_conversion(afe);
 }
 
@@ -1,5 +1,6 @@
 #include "spv1020_mppt.h"
 #include "log.h"
+#include "spv1020_mppt_defs.h"
 
 // This file implements an x86 approximation of the stm32-specific functionality.
 // See ../spv1020_mppt.c for the shared functions.
@@ -12,6 +13,13 @@
 
 static bool s_is_shut = false;
 
+// Issue the command over the x86 SPI model so that bus traffic is accounted for like on stm32.
+// The response is discarded: callers substitute the fixed values above.
+static StatusCode prv_send_command(SpiPort port, uint8_t command, size_t rx_len) {
+  uint8_t rx_data[2] = { 0 };
+  return spi_exchange(port, &command, 1, rx_data, rx_len);
+}
+
 StatusCode spv1020_shut(SpiPort port) {
   if (port >= NUM_SPI_PORTS) {
     return STATUS_CODE_INVALID_ARGS;
@@ -44,24 +52,28 @@ StatusCode spv1020_turn_on(SpiPort port) {
 
 StatusCode spv1020_read_current(SpiPort port, uint16_t *current) {
   LOG_DEBUG("SPV1020 MPPT command: Read current\n");
+  status_ok_or_return(prv_send_command(port, SPV1020_CMD_READ_CURRENT, 2));
   *current = FIXED_CURRENT;
   return STATUS_CODE_OK;
 }
 
 StatusCode spv1020_read_voltage_in(SpiPort port, uint16_t *vin) {
   LOG_DEBUG("SPV1020 MPPT command: Read vin\n");
+  status_ok_or_return(prv_send_command(port, SPV1020_CMD_READ_VIN, 2));
   *vin = FIXED_VIN;
   return STATUS_CODE_OK;
 }
 
 StatusCode spv1020_read_pwm(SpiPort port, uint16_t *pwm) {
   LOG_DEBUG("SPV1020 MPPT command: Read pwm\n");
+  status_ok_or_return(prv_send_command(port, SPV1020_CMD_READ_PWM, 2));
   *pwm = FIXED_PWM;
   return STATUS_CODE_OK;
 }
 
 StatusCode spv1020_read_status(SpiPort port, uint8_t *status) {
   LOG_DEBUG("SPV1020 MPPT command: Read status\n");
+  status_ok_or_return(prv_send_command(port, SPV1020_CMD_READ_STATUS, 1));
   *status = FIXED_STATUS;
   return STATUS_CODE_OK;
 }
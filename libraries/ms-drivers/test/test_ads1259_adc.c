@@ -217,6 +217,7 @@ void test_ads1259_get_conversion_data() {
   // TEST_ASSERT_EQUAL(test_raw, s_storage.conv_data.raw);
   // TEST_ASSERT_EQUAL((test_raw >> 4) * EXTERNAL_VREF_V / (pow(2, 19) - 1), s_storage.reading);
   // TEST_ASSERT_EQUAL(50, s_storage.reading);
+  TEST_ASSERT_EQUAL(EXTERNAL_VREF_UV, s_storage.reading_uv);
 
   // test with max neg data
   s_test_mode = ADS1259_MODE_MAX_NEG_DATA;
@@ -224,6 +225,7 @@ void test_ads1259_get_conversion_data() {
   ads1259_get_conversion_data(&s_storage);
   delay_ms(TEST_DATA_SETTLING_TIME_MS);
   // TEST_ASSERT_EQUAL(-50, s_storage.reading);
+  TEST_ASSERT_EQUAL(-EXTERNAL_VREF_UV, s_storage.reading_uv);
 
   // test with min readable pos data
   s_test_mode = ADS1259_MODE_MIN_POS_DATA;
@@ -253,6 +255,9 @@ void test_ads1259_get_conversion_data() {
   TEST_ASSERT_EQUAL(0x30, s_storage.conv_data.LSB);
   TEST_ASSERT_EQUAL(test_raw, s_storage.conv_data.raw);
   // TEST_ASSERT_EQUAL(6.299126, s_storage.reading);
+  // The fixed-point conversion is within a microvolt of the double math it replaced
+  double expected_v = (test_raw >> 4) * EXTERNAL_VREF_V / ((1 << 19) - 1);
+  TEST_ASSERT_INT32_WITHIN(1, (int32_t)(expected_v * 1000000), s_storage.reading_uv);
 
   // test checksum fault triggered
   s_test_mode = ADS1259_MODE_CHECKSUM_FAULT;
@@ -27,6 +27,7 @@ typedef struct Adt7476aMockRegisters {
   uint8_t PWM_SPEED_2;
   uint8_t INTERRUPT_STATUS_1;
   uint8_t INTERRUPT_STATUS_2;
+  uint8_t TACH[ADT7476A_TACH_4_HIGH - ADT7476A_TACH_1_LOW + 1];
 } Adt7476aMockRegisters;
 
 static Adt7476aMockRegisters s_mock_registers;
@@ -72,6 +73,10 @@ StatusCode TEST_MOCK(i2c_read_reg)(I2CPort i2c, I2CAddress addr, uint8_t reg, ui
     case ADT7476A_INTERRUPT_STATUS_REGISTER_2:
       *rx_data = s_mock_registers.INTERRUPT_STATUS_2;
       break;
+    // Commands used in adt7476a_get_fan_rpm()
+    case ADT7476A_TACH_1_LOW ... ADT7476A_TACH_4_HIGH:
+      *rx_data = s_mock_registers.TACH[cmd - ADT7476A_TACH_1_LOW];
+      break;
   }
   return STATUS_CODE_OK;
 }
@@ -189,3 +194,26 @@ void test_adt7476a_get_status(void) {
   // trigger interrupt and fetch data
   gpio_it_trigger_interrupt(&test_output_pin);
 }
+
+static void prv_set_tach(AdtTach tach, uint16_t count) {
+  s_mock_registers.TACH[2 * tach] = (uint8_t)(count & 0xFF);
+  s_mock_registers.TACH[2 * tach + 1] = (uint8_t)(count >> 8);
+}
+
+// test that tach readings are converted to RPM
+void test_adt7476a_get_fan_rpm(void) {
+  uint16_t rpm = 0;
+
+  // 90 kHz clock counted over a revolution: 2700 counts is 2000 RPM
+  prv_set_tach(ADT_TACH_3, 2700);
+  TEST_ASSERT_OK(adt7476a_get_fan_rpm(TEST_I2C_PORT, TEST_I2C_ADDRESS, ADT_TACH_3, &rpm));
+  TEST_ASSERT_EQUAL(2000, rpm);
+
+  // a stalled fan
+  prv_set_tach(ADT_TACH_1, ADT7476A_TACH_STALLED);
+  TEST_ASSERT_OK(adt7476a_get_fan_rpm(TEST_I2C_PORT, TEST_I2C_ADDRESS, ADT_TACH_1, &rpm));
+  TEST_ASSERT_EQUAL(0, rpm);
+
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    adt7476a_get_fan_rpm(TEST_I2C_PORT, TEST_I2C_ADDRESS, NUM_ADT_TACHS, &rpm));
+}
@@ -2,13 +2,19 @@
 // Module for interacting with the ADS1015 ADC over I2C.
 // I2C, GPIO, Interrupt, and Soft Timers should be initialized.
 //
-// The ADS1015 supports a conversion ready pin that we use as an interrupt.
+// The ADS1015 supports a conversion ready pin that we use as an interrupt. With a single channel
+// enabled, the ADS1015 converts continuously and each interrupt only reads the result. Otherwise,
+// each interrupt also starts a single-shot conversion on the next enabled channel.
+//
+// Conversions can be filtered per channel (see ads1015_filter.h) before they're stored, so reads
+// and callbacks see the filtered reading.
 //
 // Uses a watchdog to detect if the ADS1015 has stopped triggering interrupts.
 // Although we use GPIO interrupts to detect conversion ready, it seems like
 // it's possible for us to miss it during bus glitching. This forces an
 // interrupt if we haven't triggered within a few conversion periods.
 #include <stdbool.h>
+#include "ads1015_filter.h"
 #include "gpio.h"
 #include "i2c.h"
 #include "soft_timer.h"
@@ -46,6 +52,7 @@ typedef struct Ads1015Storage {
   uint8_t pending_channel_bitset;
   Ads1015Callback channel_callback[NUM_ADS1015_CHANNELS];
   void *callback_context[NUM_ADS1015_CHANNELS];
+  Ads1015Filter filters[NUM_ADS1015_CHANNELS];
 
   SoftTimerId watchdog_timer;
   bool watchdog_kicked;
@@ -60,6 +67,11 @@ StatusCode ads1015_init(Ads1015Storage *storage, I2CPort i2c_port, Ads1015Addres
 StatusCode ads1015_configure_channel(Ads1015Storage *storage, Ads1015Channel channel, bool enable,
                                      Ads1015Callback callback, void *context);
 
+// Sets up filtering of the channel's conversions and clears its filter history. All channels
+// start unfiltered.
+StatusCode ads1015_configure_filter(Ads1015Storage *storage, Ads1015Channel channel,
+                                    const Ads1015FilterSettings *settings);
+
 // Reads raw 12 bit conversion results which are expressed in two's complement
 // format.
 StatusCode ads1015_read_raw(Ads1015Storage *storage, Ads1015Channel channel, int16_t *reading);
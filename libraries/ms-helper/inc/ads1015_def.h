@@ -88,6 +88,10 @@
   (ADS1015_START_SINGLE_CONV | ADS1015_AIN(channel) | ADS1015_PGA_FSR_4096 | \
    ADS1015_CONVERSION_MODE_SINGLE)
 
+// Converts the channel continuously, pulsing ALERT/RDY after each conversion
+#define ADS1015_CONFIG_REGISTER_MSB_CONT(channel) \
+  (ADS1015_AIN(channel) | ADS1015_PGA_FSR_4096 | ADS1015_CONVERSION_MODE_CONT)
+
 #define ADS1015_CONFIG_REGISTER_MSB_IDLE \
   (ADS1015_IDLE | ADS1015_AIN_0 | ADS1015_PGA_FSR_4096 | ADS1015_CONVERSION_MODE_SINGLE)
 
@@ -0,0 +1,30 @@
+#pragma once
+// Per-channel filtering for ADS1015 conversions
+// Each conversion goes through an optional 3-sample median, to reject single-sample spikes, then
+// an optional first-order IIR low-pass. Both run in integer math from the conversion interrupt.
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ADS1015_FILTER_MEDIAN_WINDOW 3
+// Keeps the scaled IIR state of a 12-bit reading well within an int32_t
+#define ADS1015_FILTER_MAX_IIR_SHIFT 8
+
+typedef struct Ads1015FilterSettings {
+  bool median;
+  // Each conversion moves the output 1 / 2^iir_shift of the way to it. 0 disables the IIR.
+  uint8_t iir_shift;
+} Ads1015FilterSettings;
+
+typedef struct Ads1015Filter {
+  Ads1015FilterSettings settings;
+  int16_t history[ADS1015_FILTER_MEDIAN_WINDOW];
+  uint8_t num_samples;
+  // Output scaled by 2^iir_shift so the fraction isn't lost between conversions
+  int32_t iir_state;
+} Ads1015Filter;
+
+// Clears the filter's history. The next conversion passes through unchanged.
+void ads1015_filter_reset(Ads1015Filter *filter);
+
+// Returns the filtered reading after adding |raw|.
+int16_t ads1015_filter_update(Ads1015Filter *filter, int16_t raw);
@@ -0,0 +1,68 @@
+#pragma once
+// Closed-loop fan duty from a temperature, with stall detection from tach feedback.
+//
+// Each update computes the duty as a feedforward from a temperature to duty curve plus a PI
+// correction that holds the temperature at a target:
+//  - The curve is piecewise linear between its points and clamped to its end points outside them.
+//  - The curve follows rising temperatures right away, but falling ones only once they've dropped
+//    |hysteresis_dC| below it, so the duty doesn't hunt around a point of the curve.
+//  - The PI terms trim the curve's duty by the error from |target_dC|, so fans run slower than the
+//    curve while the temperature is under the target. The integral stops accumulating while the
+//    duty is saturated, so it doesn't wind up while fans are flat out or off.
+//
+// Tach readings of fans driven at or above |stall_min_duty| that stay under |stall_min_rpm| for
+// |stall_updates| readings in a row mark the fan as stalled, until it reads fast enough again.
+//
+// The module is hardware agnostic: the caller reads temperatures and tachs and drives the fans.
+// Temperatures are in deci-celsius and duties in percent.
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "interp_table.h"
+#include "status.h"
+
+#define FAN_REGULATOR_MAX_DUTY 100
+#define FAN_REGULATOR_MAX_FANS 8
+
+typedef struct FanRegulatorSettings {
+  // Temperature to duty curve, with increasing temperatures and duties in [0, 100]. Must persist.
+  const InterpTable *curve;
+  int32_t hysteresis_dC;
+
+  int32_t target_dC;
+  // Duty percent per dC of error, in Q16.16
+  int32_t kp;
+  // Duty percent per dC of error per second, in Q16.16
+  int32_t ki;
+
+  uint8_t num_fans;
+  uint8_t stall_min_duty;
+  uint16_t stall_min_rpm;
+  uint8_t stall_updates;
+} FanRegulatorSettings;
+
+typedef struct FanRegulatorStorage {
+  FanRegulatorSettings settings;
+  // Temperature the curve is evaluated at, which lags falling temperatures by the hysteresis
+  int32_t curve_temp_dC;
+  bool primed;
+  // Q16.16 duty percent
+  int32_t integral;
+  uint8_t duty;
+  uint8_t slow_updates[FAN_REGULATOR_MAX_FANS];
+} FanRegulatorStorage;
+
+// Set up |storage| from |settings|. The first update starts the curve at its temperature.
+StatusCode fan_regulator_init(FanRegulatorStorage *storage, const FanRegulatorSettings *settings);
+
+// Update the duty from the latest |temp_dC|, |dt_ms| after the previous update, and return it.
+uint8_t fan_regulator_update(FanRegulatorStorage *storage, int32_t temp_dC, uint32_t dt_ms);
+
+// Duty from the last update, or 0 before the first.
+uint8_t fan_regulator_get_duty(const FanRegulatorStorage *storage);
+
+// Record a tach reading for |fan| at the current duty, returning whether the fan is stalled.
+bool fan_regulator_update_tach(FanRegulatorStorage *storage, uint8_t fan, uint16_t rpm);
+
+// Whether |fan| is stalled as of its last tach reading.
+bool fan_regulator_is_stalled(const FanRegulatorStorage *storage, uint8_t fan);
@@ -0,0 +1,36 @@
+#pragma once
+// Piecewise-linear interpolation over a table of points, in fixed point.
+//
+// An InterpTable maps x to y through points whose x values are strictly increasing or strictly
+// decreasing, e.g. thermistor resistance vs temperature. Lookups binary search for the segment
+// holding x, so they're O(log n) in the number of points and need no floating point.
+//
+// The y values can be listed per point, or left NULL for evenly spaced y values starting at
+// |y_start| in steps of |y_step| - handy for tables sampled at a fixed interval.
+// Intermediate products are 64-bit, so any int32_t points work.
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "status.h"
+
+typedef struct InterpTable {
+  const int32_t *x;
+  // NULL for evenly spaced y values
+  const int32_t *y;
+  int32_t y_start;
+  int32_t y_step;
+  // Must be at least 2
+  size_t num_points;
+} InterpTable;
+
+// Interpolate y at |x|, rounded to the nearest integer.
+// Returns STATUS_CODE_OUT_OF_RANGE if |x| is outside of the table.
+StatusCode interp_table_lookup(const InterpTable *table, int32_t x, int32_t *y);
+
+// Like interp_table_lookup(), but |x| outside of the table is extrapolated from the nearest
+// segment. The result saturates at the int32_t limits.
+int32_t interp_table_eval(const InterpTable *table, int32_t x);
+
+// Whether |x| is within the table's range.
+bool interp_table_in_range(const InterpTable *table, int32_t x);
@@ -70,6 +70,9 @@ typedef struct Mcp2515Storage {
   void *context;
 
   Mcp2515Errors errors;
+
+  // TX buffers we haven't requested since the controller last reported them free
+  uint8_t tx_free;
 } Mcp2515Storage;
 
 // Initializes the MCP2515 CAN controller.
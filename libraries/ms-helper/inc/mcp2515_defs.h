@@ -146,11 +146,6 @@
 #define MCP2515_NUM_MASK_REGISTERS_STANDARD 2
 #define MCP2515_NUM_MASK_REGISTERS_EXTENDED 4
 
-typedef struct Mcp2515LoadTxPayload {
-  uint8_t cmd;
-  uint64_t data;
-} __attribute__((packed)) Mcp2515LoadTxPayload;
-
 // TX/RX buffer ID registers - See Registers 3-3 to 3-7, 4-4 to 4-8
 typedef struct Mcp2515IdRegs {
   uint8_t sidh;
@@ -177,6 +172,18 @@ typedef struct Mcp2515IdRegs {
   } dlc;
 } Mcp2515IdRegs;
 
+// A whole TX/RX buffer from SIDH onwards, so READ RX/LOAD TX can transfer a frame in
+// one burst - the address auto-increments through the data bytes
+typedef struct Mcp2515FrameRegs {
+  Mcp2515IdRegs id_regs;
+  uint64_t data;
+} __attribute__((packed)) Mcp2515FrameRegs;
+
+typedef struct Mcp2515LoadTxPayload {
+  uint8_t cmd;
+  Mcp2515FrameRegs frame;
+} __attribute__((packed)) Mcp2515LoadTxPayload;
+
 typedef union Mcp2515Id {
   struct {
     uint32_t eid0 : 8;
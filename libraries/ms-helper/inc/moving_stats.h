@@ -0,0 +1,91 @@
+#pragma once
+// Streaming statistics over a stream of integer samples, all updated in O(1) per sample.
+//
+// A MovingStatsStorage tracks, for the samples pushed since it was initialized or last reset:
+//  - a moving average over a long window, meant for smoothed, noise-rejecting decisions
+//  - a moving average over a short window (the most recent samples of the long window), meant for
+//    fast-responding decisions such as overcurrent detection
+//  - the variance of the long window
+//  - an exponentially weighted moving average (EWMA) with weight 2^-ewma_shift
+//  - the minimum and maximum sample seen
+// Window averages are running sums: each push adds the new sample and subtracts the one leaving the
+// window, so there's no re-summing of the ring. Until a window has filled, its statistics are over
+// the samples received so far.
+//
+// The ring buffer is provided by the caller so that windows can be sized per use.
+// To avoid overflow, samples must satisfy |sample| < 2^16 for the variance and
+// |sample| < 2^(31 - ewma_shift) for the EWMA.
+//
+// A MovingStatsEwma is just the EWMA, for when many channels need light filtering and a ring buffer
+// per channel would cost too much RAM.
+//
+// The module does no locking: pushes and reads of the same storage must not preempt each other.
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "status.h"
+
+#define MOVING_STATS_MAX_EWMA_SHIFT 16
+
+typedef struct MovingStatsEwma {
+  int32_t accumulator;  // the average scaled by 2^shift
+  uint8_t shift;
+  bool primed;  // the first sample seeds the average instead of being blended in from 0
+} MovingStatsEwma;
+
+typedef struct MovingStatsSettings {
+  // Ring buffer of at least |long_window| samples. Must persist.
+  int32_t *buffer;
+  uint16_t long_window;
+  // Must be between 1 and |long_window|.
+  uint16_t short_window;
+  // EWMA weight of each new sample is 2^-ewma_shift; 0 simply tracks the latest sample.
+  uint8_t ewma_shift;
+} MovingStatsSettings;
+
+typedef struct MovingStatsStorage {
+  int32_t *buffer;
+  uint16_t long_window;
+  uint16_t short_window;
+  uint16_t head;   // index in |buffer| that the next sample is written to
+  uint16_t count;  // number of samples in the long window, saturates at |long_window|
+  int64_t long_sum;
+  int64_t short_sum;
+  int64_t long_sum_squares;
+  MovingStatsEwma ewma;
+  int32_t min;
+  int32_t max;
+} MovingStatsStorage;
+
+// Set up |ewma| with weight 2^-shift per sample.
+StatusCode moving_stats_ewma_init(MovingStatsEwma *ewma, uint8_t shift);
+
+// Blend |sample| into |ewma| and return the updated average.
+int32_t moving_stats_ewma_push(MovingStatsEwma *ewma, int32_t sample);
+
+// Return the current average, or 0 if no samples have been pushed.
+int32_t moving_stats_ewma_get(const MovingStatsEwma *ewma);
+
+// Set up |storage| from |settings|. The storage is reset.
+StatusCode moving_stats_init(MovingStatsStorage *storage, const MovingStatsSettings *settings);
+
+// Forget all samples, keeping the settings.
+void moving_stats_reset(MovingStatsStorage *storage);
+
+// Add a sample, evicting the oldest one from each full window.
+void moving_stats_push(MovingStatsStorage *storage, int32_t sample);
+
+// Number of samples currently in the long window.
+uint16_t moving_stats_count(const MovingStatsStorage *storage);
+
+// Averages truncate toward zero. All getters return 0 if no samples have been pushed.
+int32_t moving_stats_long_average(const MovingStatsStorage *storage);
+int32_t moving_stats_short_average(const MovingStatsStorage *storage);
+int32_t moving_stats_ewma(const MovingStatsStorage *storage);
+
+// Population variance of the long window, in squared sample units.
+uint32_t moving_stats_variance(const MovingStatsStorage *storage);
+
+// Extremes of every sample pushed since the last init or reset.
+int32_t moving_stats_min(const MovingStatsStorage *storage);
+int32_t moving_stats_max(const MovingStatsStorage *storage);
@@ -5,12 +5,22 @@
 // The thermistor and its fixed resistor forms a voltage divider.
 // A temperature value ranging from 0~100 degrees is calculated from the voltage
 // divider.
+//
+// Conversions binary search the resistance table. For a hot path, thermistor_adc_lut_init()
+// precomputes the temperature for raw ADC codes of a given divider so that each conversion is an
+// index and a single interpolation.
 #include "adc.h"
 #include "gpio.h"
 
 // A 10kOhm resistor is used as the fixed value
 #define THERMISTOR_FIXED_RESISTANCE_OHMS 10000
 
+// Full scale of the 12-bit ADC
+#define THERMISTOR_ADC_MAX_CODE 4095
+// The ADC LUT holds one temperature every 2^THERMISTOR_ADC_LUT_SHIFT codes
+#define THERMISTOR_ADC_LUT_SHIFT 4
+#define THERMISTOR_ADC_LUT_SIZE (((THERMISTOR_ADC_MAX_CODE + 1) >> THERMISTOR_ADC_LUT_SHIFT) + 1)
+
 // ThermistorPosition indicates which resistor the node voltage is measured from
 // ex: VDDA ---> R1 ---> R2 ---> GND
 typedef enum {
@@ -24,6 +34,13 @@ typedef struct ThermistorStorage {
   AdcChannel adc_channel;
 } ThermistorStorage;
 
+typedef struct ThermistorAdcLut {
+  int16_t temperature_dc[THERMISTOR_ADC_LUT_SIZE];
+  // Codes within the range of the resistance table
+  uint16_t min_code;
+  uint16_t max_code;
+} ThermistorAdcLut;
+
 // Initializes the GPIO pin and ADC Channel associated with the thermistor
 StatusCode thermistor_init(ThermistorStorage *storage, GpioAddress thermistor_gpio,
                            ThermistorPosition position);
@@ -38,3 +55,11 @@ StatusCode thermistor_calculate_temp(uint32_t thermistor_resistance_ohms, uint16
 // Calculates the thermistor resistance given a certain temperature in dC
 StatusCode thermistor_calculate_resistance(uint16_t temperature_dc,
                                            uint16_t *thermistor_resistor_ohms);
+
+// Precomputes the temperature for raw ADC codes of a divider with the thermistor at |position|.
+// Codes are assumed to be ratiometric to the divider supply.
+StatusCode thermistor_adc_lut_init(ThermistorAdcLut *lut, ThermistorPosition position);
+
+// Converts a raw ADC code to deciCelsius using a precomputed LUT
+StatusCode thermistor_adc_lut_get_temp(const ThermistorAdcLut *lut, uint16_t code,
+                                       uint16_t *temperature_dc);
@@ -0,0 +1,19 @@
+#pragma once
+// Drives the analog inputs of emulated ADS1015s on x86
+// Each device is identified by its I2C port and address, and converts whichever input is set when
+// its conversion completes. The emulated device pulses the ready pin after every conversion, so
+// conversions reach the driver through its GPIO interrupt like they do on hardware, and
+// gpio_inject_get_edge_time() on the ready pin gives the time of the last conversion.
+//
+// Inputs are external to the driver, so they're kept across ads1015_init(). Every input starts at
+// 0. They can also be set over the "cmd" x86 socket:
+//   ads1015 <i2c_port> <address> <channel> <raw>
+#include <stdint.h>
+
+#include "ads1015.h"
+#include "status.h"
+
+// Sets the input of a channel as a raw 12-bit two's complement code, which is clamped to the
+// converter's range.
+StatusCode ads1015_inject_set_raw(I2CPort i2c_port, Ads1015Address i2c_addr,
+                                  Ads1015Channel channel, int16_t raw);
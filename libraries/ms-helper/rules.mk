@@ -10,6 +10,9 @@ $(T)_DEPS := ms-common
 
 ifeq (x86,$(PLATFORM))
 $(T)_EXCLUDE_TESTS := mcp2515 adc_periodic_reader
+else
+# SPI transactions are only counted and ADS1015 inputs only injected on x86
+$(T)_EXCLUDE_TESTS := mcp2515_spi ads1015_inject
 endif
 
 $(T)_test_thermistor_MOCKS := adc_read_converted adc_get_channel adc_set_channel
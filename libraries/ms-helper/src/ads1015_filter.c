@@ -0,0 +1,73 @@
+#include "ads1015_filter.h"
+
+#include <string.h>
+
+#include "ads1015.h"
+#include "critical_section.h"
+
+static int16_t prv_median_of_3(int16_t a, int16_t b, int16_t c) {
+  if (a > b) {
+    int16_t tmp = a;
+    a = b;
+    b = tmp;
+  }
+  // a <= b, so the median is b unless c falls outside of [a, b]
+  if (c < a) {
+    return a;
+  } else if (c > b) {
+    return b;
+  }
+  return c;
+}
+
+void ads1015_filter_reset(Ads1015Filter *filter) {
+  memset(filter->history, 0, sizeof(filter->history));
+  filter->num_samples = 0;
+  filter->iir_state = 0;
+}
+
+int16_t ads1015_filter_update(Ads1015Filter *filter, int16_t raw) {
+  bool first = (filter->num_samples == 0);
+
+  // Oldest sample first
+  memmove(&filter->history[0], &filter->history[1],
+          sizeof(filter->history) - sizeof(filter->history[0]));
+  filter->history[ADS1015_FILTER_MEDIAN_WINDOW - 1] = raw;
+  if (filter->num_samples < ADS1015_FILTER_MEDIAN_WINDOW) {
+    filter->num_samples++;
+  }
+
+  int16_t value = raw;
+  if (filter->settings.median && filter->num_samples == ADS1015_FILTER_MEDIAN_WINDOW) {
+    value = prv_median_of_3(filter->history[0], filter->history[1], filter->history[2]);
+  }
+
+  uint8_t shift = filter->settings.iir_shift;
+  if (shift == 0) {
+    return value;
+  }
+  if (first) {
+    // Start from the first reading instead of slewing up from 0
+    filter->iir_state = (int32_t)value << shift;
+  } else {
+    // state += value - state / 2^shift, which keeps the output in the state's upper bits
+    filter->iir_state += value - (filter->iir_state >> shift);
+  }
+  // The state settles within [value, value + 1) * 2^shift, so flooring it has no offset
+  return (int16_t)(filter->iir_state >> shift);
+}
+
+StatusCode ads1015_configure_filter(Ads1015Storage *storage, Ads1015Channel channel,
+                                    const Ads1015FilterSettings *settings) {
+  if (storage == NULL || channel >= NUM_ADS1015_CHANNELS || settings == NULL ||
+      settings->iir_shift > ADS1015_FILTER_MAX_IIR_SHIFT) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  // The conversion interrupt updates the filter
+  bool disabled = critical_section_start();
+  storage->filters[channel].settings = *settings;
+  ads1015_filter_reset(&storage->filters[channel]);
+  critical_section_end(disabled);
+  return STATUS_CODE_OK;
+}
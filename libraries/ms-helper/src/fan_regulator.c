@@ -0,0 +1,91 @@
+#include "fan_regulator.h"
+
+#include <string.h>
+
+#include "fixed_point.h"
+#include "misc.h"
+
+#define FAN_REGULATOR_MAX_DUTY_Q16 fixed_from_int(FAN_REGULATOR_MAX_DUTY, FIXED_Q16_FRAC_BITS)
+#define FAN_REGULATOR_MS_PER_S 1000
+
+// Evaluates the curve, holding its end points outside of it
+static int32_t prv_curve_duty(const InterpTable *curve, int32_t temp_dC) {
+  int32_t first = curve->x[0];
+  int32_t last = curve->x[curve->num_points - 1];
+  return interp_table_eval(curve, MIN(MAX(temp_dC, first), last));
+}
+
+static int32_t prv_clamp_duty(int64_t duty_q16) {
+  return (int32_t)MIN(MAX(duty_q16, 0), (int64_t)FAN_REGULATOR_MAX_DUTY_Q16);
+}
+
+StatusCode fan_regulator_init(FanRegulatorStorage *storage, const FanRegulatorSettings *settings) {
+  if (storage == NULL || settings == NULL || settings->curve == NULL ||
+      settings->curve->x == NULL || settings->curve->num_points < 2 ||
+      settings->curve->x[settings->curve->num_points - 1] <= settings->curve->x[0] ||
+      settings->hysteresis_dC < 0 || settings->num_fans > FAN_REGULATOR_MAX_FANS) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  memset(storage, 0, sizeof(*storage));
+  storage->settings = *settings;
+  return STATUS_CODE_OK;
+}
+
+uint8_t fan_regulator_update(FanRegulatorStorage *storage, int32_t temp_dC, uint32_t dt_ms) {
+  const FanRegulatorSettings *settings = &storage->settings;
+
+  // The curve rises with the temperature but only falls once it's outside the hysteresis
+  if (!storage->primed || temp_dC > storage->curve_temp_dC) {
+    storage->curve_temp_dC = temp_dC;
+    storage->primed = true;
+  } else if (temp_dC < storage->curve_temp_dC - settings->hysteresis_dC) {
+    storage->curve_temp_dC = temp_dC + settings->hysteresis_dC;
+  }
+  int64_t feedforward_q16 = fixed_from_int(prv_curve_duty(settings->curve, storage->curve_temp_dC),
+                                           FIXED_Q16_FRAC_BITS);
+
+  int32_t error_dC = temp_dC - settings->target_dC;
+  int64_t proportional_q16 = fixed_mul(settings->kp, error_dC, 0);
+  int32_t integral_q16 = fixed_saturate(
+      (int64_t)storage->integral +
+      fixed_scale(fixed_mul(settings->ki, error_dC, 0), (int32_t)dt_ms, FAN_REGULATOR_MS_PER_S));
+
+  // Only take the new integral if it doesn't push a saturated duty further out
+  int64_t duty_q16 = feedforward_q16 + proportional_q16 + integral_q16;
+  bool saturated_high = duty_q16 > FAN_REGULATOR_MAX_DUTY_Q16 && error_dC > 0;
+  bool saturated_low = duty_q16 < 0 && error_dC < 0;
+  if (!saturated_high && !saturated_low) {
+    storage->integral = integral_q16;
+  }
+
+  duty_q16 = feedforward_q16 + proportional_q16 + storage->integral;
+  storage->duty = (uint8_t)fixed_to_int(prv_clamp_duty(duty_q16), FIXED_Q16_FRAC_BITS);
+  return storage->duty;
+}
+
+uint8_t fan_regulator_get_duty(const FanRegulatorStorage *storage) {
+  return storage->duty;
+}
+
+bool fan_regulator_update_tach(FanRegulatorStorage *storage, uint8_t fan, uint16_t rpm) {
+  const FanRegulatorSettings *settings = &storage->settings;
+  if (fan >= settings->num_fans) {
+    return false;
+  }
+
+  // Fans driven too slowly to spin reliably don't count as stalled
+  if (storage->duty >= settings->stall_min_duty && rpm < settings->stall_min_rpm) {
+    if (storage->slow_updates[fan] < UINT8_MAX) {
+      storage->slow_updates[fan]++;
+    }
+  } else if (rpm >= settings->stall_min_rpm) {
+    storage->slow_updates[fan] = 0;
+  }
+  return fan_regulator_is_stalled(storage, fan);
+}
+
+bool fan_regulator_is_stalled(const FanRegulatorStorage *storage, uint8_t fan) {
+  return fan < storage->settings.num_fans &&
+         storage->slow_updates[fan] >= MAX(storage->settings.stall_updates, 1);
+}
@@ -0,0 +1,72 @@
+#include "interp_table.h"
+
+static int32_t prv_y(const InterpTable *table, size_t i) {
+  if (table->y != NULL) {
+    return table->y[i];
+  }
+  return table->y_start + (int32_t)i * table->y_step;
+}
+
+static bool prv_increasing(const InterpTable *table) {
+  return table->x[table->num_points - 1] > table->x[0];
+}
+
+// Returns the index of the first point of the segment that |x| falls in, clamped to the end
+// segments for |x| outside of the table.
+static size_t prv_find_segment(const InterpTable *table, int32_t x) {
+  const bool increasing = prv_increasing(table);
+  size_t lo = 0;
+  size_t hi = table->num_points - 1;
+  // Invariant: the segment starts in [lo, hi)
+  while (hi - lo > 1) {
+    size_t mid = lo + (hi - lo) / 2;
+    bool before_mid = increasing ? (x < table->x[mid]) : (x > table->x[mid]);
+    if (before_mid) {
+      hi = mid;
+    } else {
+      lo = mid;
+    }
+  }
+  return lo;
+}
+
+bool interp_table_in_range(const InterpTable *table, int32_t x) {
+  int32_t first = table->x[0];
+  int32_t last = table->x[table->num_points - 1];
+  return prv_increasing(table) ? (x >= first && x <= last) : (x <= first && x >= last);
+}
+
+int32_t interp_table_eval(const InterpTable *table, int32_t x) {
+  size_t i = prv_find_segment(table, x);
+  int64_t x0 = table->x[i];
+  int64_t dx = (int64_t)table->x[i + 1] - x0;
+  int64_t y0 = prv_y(table, i);
+  int64_t dy = (int64_t)prv_y(table, i + 1) - y0;
+
+  // Round to nearest: add half the divisor with the sign of the quotient
+  int64_t num = ((int64_t)x - x0) * dy;
+  if (dx < 0) {
+    num = -num;
+    dx = -dx;
+  }
+  num += (num < 0) ? -dx / 2 : dx / 2;
+  int64_t y = y0 + num / dx;
+
+  if (y > INT32_MAX) {
+    return INT32_MAX;
+  } else if (y < INT32_MIN) {
+    return INT32_MIN;
+  }
+  return (int32_t)y;
+}
+
+StatusCode interp_table_lookup(const InterpTable *table, int32_t x, int32_t *y) {
+  if (table == NULL || table->x == NULL || table->num_points < 2 || y == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  } else if (!interp_table_in_range(table, x)) {
+    return status_code(STATUS_CODE_OUT_OF_RANGE);
+  }
+
+  *y = interp_table_eval(table, x);
+  return STATUS_CODE_OK;
+}
@@ -9,27 +9,27 @@
 #include "mcp2515_defs.h"
 #include "soft_timer.h"
 
+// Frames are moved in a single burst starting at the ID registers
 typedef struct Mcp2515TxBuffer {
   uint8_t id;
-  uint8_t data;
   uint8_t rts;
+  uint8_t status_req;
 } Mcp2515TxBuffer;
 
 typedef struct Mcp2515RxBuffer {
   uint8_t id;
-  uint8_t data;
   uint8_t int_flag;
 } Mcp2515RxBuffer;
 
 static const Mcp2515TxBuffer s_tx_buffers[] = {
-  { .id = MCP2515_LOAD_TXB0SIDH, .data = MCP2515_LOAD_TXB0D0, .rts = MCP2515_RTS_TXB0 },
-  { .id = MCP2515_LOAD_TXB1SIDH, .data = MCP2515_LOAD_TXB1D0, .rts = MCP2515_RTS_TXB1 },
-  { .id = MCP2515_LOAD_TXB2SIDH, .data = MCP2515_LOAD_TXB2D0, .rts = MCP2515_RTS_TXB2 },
+  { .id = MCP2515_LOAD_TXB0SIDH, .rts = MCP2515_RTS_TXB0, .status_req = MCP2515_STATUS_TX0REQ },
+  { .id = MCP2515_LOAD_TXB1SIDH, .rts = MCP2515_RTS_TXB1, .status_req = MCP2515_STATUS_TX1REQ },
+  { .id = MCP2515_LOAD_TXB2SIDH, .rts = MCP2515_RTS_TXB2, .status_req = MCP2515_STATUS_TX2REQ },
 };
 
 static const Mcp2515RxBuffer s_rx_buffers[] = {
-  { .id = MCP2515_READ_RXB0SIDH, .data = MCP2515_READ_RXB0D0, .int_flag = MCP2515_CANINT_RX0IE },
-  { .id = MCP2515_READ_RXB1SIDH, .data = MCP2515_READ_RXB1D0, .int_flag = MCP2515_CANINT_RX1IE },
+  { .id = MCP2515_READ_RXB0SIDH, .int_flag = MCP2515_CANINT_RX0IE },
+  { .id = MCP2515_READ_RXB1SIDH, .int_flag = MCP2515_CANINT_RX1IE },
 };
 
 static const uint8_t s_brp_lookup[NUM_MCP2515_BITRATES] = {
@@ -51,13 +51,14 @@ static void prv_read(Mcp2515Storage *storage, uint8_t addr, uint8_t *read_data,
   spi_exchange(storage->spi_port, payload, sizeof(payload), read_data, read_len);
 }
 
-static void prv_write(Mcp2515Storage *storage, uint8_t addr, uint8_t *write_data,
+static void prv_write(Mcp2515Storage *storage, uint8_t addr, const uint8_t *write_data,
                       size_t write_len) {
   uint8_t payload[MCP2515_MAX_WRITE_BUFFER_LEN];
   payload[0] = MCP2515_CMD_WRITE;
   payload[1] = addr;
   memcpy(&payload[2], write_data, write_len);
-  spi_exchange(storage->spi_port, payload, sizeof(payload), write_data, write_len);
+  // Only send what's being written - the address keeps incrementing otherwise
+  spi_exchange(storage->spi_port, payload, 2 + write_len, NULL, 0);
 }
 
 // See 12.10: *addr = (data & mask) | (*addr & ~mask)
@@ -74,40 +75,45 @@ static uint8_t prv_read_status(Mcp2515Storage *storage) {
   return read_data[0];
 }
 
+// Returns a bit for each TX buffer that isn't pending transmission
+static uint8_t prv_tx_free_from_status(uint8_t status) {
+  uint8_t tx_free = 0;
+  for (size_t i = 0; i < SIZEOF_ARRAY(s_tx_buffers); i++) {
+    if (!(status & s_tx_buffers[i].status_req)) {
+      tx_free |= 1 << i;
+    }
+  }
+  return tx_free;
+}
+
 static void prv_handle_rx(Mcp2515Storage *storage, uint8_t int_flags) {
   for (size_t i = 0; i < SIZEOF_ARRAY(s_rx_buffers); i++) {
-    Mcp2515RxBuffer *rx_buf = &s_rx_buffers[i];
+    const Mcp2515RxBuffer *rx_buf = &s_rx_buffers[i];
     if (int_flags & rx_buf->int_flag) {
-      // Read ID
-      uint8_t id_payload[] = { MCP2515_CMD_READ_RX | rx_buf->id };
-      Mcp2515IdRegs read_id_regs = { 0 };
-      spi_exchange(storage->spi_port, id_payload, sizeof(id_payload), (uint8_t *)&read_id_regs,
-                   sizeof(read_id_regs));
+      // Read ID, DLC and data in one go. Raising CS after READ RX clears the
+      // interrupt flag so a new message can be loaded.
+      uint8_t payload[] = { MCP2515_CMD_READ_RX | rx_buf->id };
+      Mcp2515FrameRegs frame = { 0 };
+      spi_exchange(storage->spi_port, payload, sizeof(payload), (uint8_t *)&frame, sizeof(frame));
 
       Mcp2515Id id = {
-        .sid_0_2 = read_id_regs.sidl.sid_0_2,
-        .sidh = read_id_regs.sidh,
-        .eid0 = read_id_regs.eid0,
-        .eid8 = read_id_regs.eid8,
-        .eid_16_17 = read_id_regs.sidl.eid_16_17,
+        .sid_0_2 = frame.id_regs.sidl.sid_0_2,
+        .sidh = frame.id_regs.sidh,
+        .eid0 = frame.id_regs.eid0,
+        .eid8 = frame.id_regs.eid8,
+        .eid_16_17 = frame.id_regs.sidl.eid_16_17,
       };
 
-      bool extended = read_id_regs.sidl.ide;
-      size_t dlc = read_id_regs.dlc.dlc;
+      bool extended = frame.id_regs.sidl.ide;
+      size_t dlc = frame.id_regs.dlc.dlc;
 
       if (!extended) {
         // Standard IDs have garbage in the extended fields
         id.raw >>= MCP2515_EXTENDED_ID_LEN;
       }
 
-      uint8_t data_payload[] = { MCP2515_CMD_READ_RX | rx_buf->data };
-      uint64_t read_data = 0;
-      spi_exchange(storage->spi_port, data_payload, sizeof(data_payload), (uint8_t *)&read_data,
-                   sizeof(read_data));
-      // Clear the interrupt flag so a new message can be loaded
-      prv_bit_modify(storage, MCP2515_CTRL_REG_CANINTF, rx_buf->int_flag, 0x0);
       if (storage->rx_cb != NULL) {
-        storage->rx_cb(id.raw, extended, read_data, dlc, storage->context);
+        storage->rx_cb(id.raw, extended, frame.data, dlc, storage->context);
       }
     }
   }
@@ -127,8 +133,16 @@ static void prv_handle_error(Mcp2515Storage *storage, uint8_t int_flags, uint8_t
   }
 
   storage->errors.eflg = err_flags;
-  prv_read(storage, MCP2515_CTRL_REG_TEC, &storage->errors.tec, 1);
-  prv_read(storage, MCP2515_CTRL_REG_REC, &storage->errors.rec, 1);
+  if (!(int_flags & MCP2515_CANINT_EFLAG) && !err_flags) {
+    // Nothing to report - skip reading the error counters on every RX
+    return;
+  }
+
+  // TEC and REC are adjacent
+  uint8_t counters[2] = { 0 };
+  prv_read(storage, MCP2515_CTRL_REG_TEC, counters, sizeof(counters));
+  storage->errors.tec = counters[0];
+  storage->errors.rec = counters[1];
 
   if (err_flags) {
     if (storage->bus_err_cb != NULL) {
@@ -145,7 +159,7 @@ static void prv_handle_int(const GpioAddress *address, void *context) {
   struct {
     uint8_t canintf;
     uint8_t eflg;
-  } regs;
+  } regs = { 0 };
   prv_read(storage, MCP2515_CTRL_REG_CANINTF, (uint8_t *)&regs, sizeof(regs));
   // Mask out flags we don't care about
   regs.canintf &= MCP2515_CANINT_EFLAG | MCP2515_CANINT_RX0IE | MCP2515_CANINT_RX1IE;
@@ -162,6 +176,7 @@ StatusCode mcp2515_init(Mcp2515Storage *storage, const Mcp2515Settings *settings
   storage->bus_err_cb = settings->bus_err_cb;
   storage->context = settings->context;
   storage->int_pin = settings->int_pin;
+  storage->tx_free = (1 << SIZEOF_ARRAY(s_tx_buffers)) - 1;
 
   const SpiSettings spi_settings = {
     .baudrate = settings->spi_baudrate,
@@ -245,6 +260,8 @@ StatusCode mcp2515_init(Mcp2515Storage *storage, const Mcp2515Settings *settings
   uint8_t opmode =
       (settings->loopback ? MCP2515_CANCTRL_OPMODE_LOOPBACK : MCP2515_CANCTRL_OPMODE_NORMAL);
   prv_bit_modify(storage, MCP2515_CTRL_REG_CANCTRL, MCP2515_CANCTRL_OPMODE_MASK, opmode);
+  // One-shot mode, CLKOUT enabled /8 - set once here rather than before every TX
+  prv_bit_modify(storage, MCP2515_CTRL_REG_CANCTRL, 0x1f, 0x0f);
 
   // Active-low interrupt pin
   const GpioSettings gpio_settings = {
@@ -275,19 +292,18 @@ StatusCode mcp2515_tx(Mcp2515Storage *storage, uint32_t id, bool extended, uint6
                       size_t dlc) {
   CRITICAL_SECTION_AUTOEND;
 
-  // Ensure the CANCTRL register is set to the correct value
-  prv_bit_modify(storage, MCP2515_CTRL_REG_CANCTRL, 0x1f, 0x0f);
-  // Get free transmit buffer
-  uint8_t tx_status =
-      __builtin_ffs(~prv_read_status(storage) &
-                    (MCP2515_STATUS_TX0REQ | MCP2515_STATUS_TX1REQ | MCP2515_STATUS_TX2REQ));
-  if (tx_status == 0) {
-    return status_code(STATUS_CODE_RESOURCE_EXHAUSTED);
+  if (storage->tx_free == 0) {
+    // Only ask the controller which buffers are done once we've used up the ones we
+    // know are free
+    storage->tx_free = prv_tx_free_from_status(prv_read_status(storage));
+    if (storage->tx_free == 0) {
+      return status_code(STATUS_CODE_RESOURCE_EXHAUSTED);
+    }
   }
 
-  // Status format: 0b01010100 = all TXxREQ bits set
-  // ffs returns 1-indexed: (x-3)/2 -> 0b00000111 = all TXxREQ bits set
-  Mcp2515TxBuffer *tx_buf = &s_tx_buffers[(tx_status - 3) / 2];
+  size_t tx_index = (size_t)__builtin_ctz(storage->tx_free);
+  const Mcp2515TxBuffer *tx_buf = &s_tx_buffers[tx_index];
+  storage->tx_free &= (uint8_t)~(1 << tx_index);
 
   Mcp2515Id tx_id = { .raw = id };
   // If it's a standard id, make sure it lines up in the right bits
@@ -306,23 +322,14 @@ StatusCode mcp2515_tx(Mcp2515Storage *storage, uint32_t id, bool extended, uint6
     .dlc = { .dlc = dlc, .rtr = false },
   };
 
-  // Load ID: SIDH, SIDL, EID8, EID0, RTSnDLC
-  uint8_t id_payload[] = {
-    MCP2515_CMD_LOAD_TX | tx_buf->id,
-    tx_id_regs.sidh,
-    tx_id_regs.sidl.raw,
-    tx_id_regs.eid8,
-    tx_id_regs.eid0,
-    tx_id_regs.dlc.raw,
-  };
-  spi_exchange(storage->spi_port, id_payload, sizeof(id_payload), NULL, 0);
-
-  // Load data
-  Mcp2515LoadTxPayload data_payload = {
-    .cmd = MCP2515_CMD_LOAD_TX | tx_buf->data,
-    .data = data,
+  // Load ID: SIDH, SIDL, EID8, EID0, RTSnDLC, then the data in the same burst
+  Mcp2515LoadTxPayload payload = {
+    .cmd = MCP2515_CMD_LOAD_TX | tx_buf->id,
+    .frame = { .id_regs = tx_id_regs, .data = data },
   };
-  spi_exchange(storage->spi_port, (uint8_t *)&data_payload, sizeof(data_payload), NULL, 0);
+  // Only send the data bytes that are used
+  size_t payload_len = offsetof(Mcp2515LoadTxPayload, frame.data) + MIN(dlc, sizeof(data));
+  spi_exchange(storage->spi_port, (uint8_t *)&payload, payload_len, NULL, 0);
 
   // Send message
   uint8_t send_payload[] = { MCP2515_CMD_RTS | tx_buf->rts };
@@ -0,0 +1,138 @@
+#include "moving_stats.h"
+
+#include <stddef.h>
+
+StatusCode moving_stats_ewma_init(MovingStatsEwma *ewma, uint8_t shift) {
+  if (ewma == NULL || shift > MOVING_STATS_MAX_EWMA_SHIFT) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+  ewma->accumulator = 0;
+  ewma->shift = shift;
+  ewma->primed = false;
+  return STATUS_CODE_OK;
+}
+
+int32_t moving_stats_ewma_push(MovingStatsEwma *ewma, int32_t sample) {
+  const int32_t scale = (int32_t)1 << ewma->shift;
+  if (!ewma->primed) {
+    ewma->accumulator = sample * scale;
+    ewma->primed = true;
+  } else {
+    // avg += (sample - avg) / 2^shift, kept scaled by 2^shift to hold onto the fractional part
+    ewma->accumulator += sample - ewma->accumulator / scale;
+  }
+  return ewma->accumulator / scale;
+}
+
+int32_t moving_stats_ewma_get(const MovingStatsEwma *ewma) {
+  return ewma->accumulator / ((int32_t)1 << ewma->shift);
+}
+
+StatusCode moving_stats_init(MovingStatsStorage *storage, const MovingStatsSettings *settings) {
+  if (storage == NULL || settings == NULL || settings->buffer == NULL ||
+      settings->long_window == 0 || settings->short_window == 0 ||
+      settings->short_window > settings->long_window) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+  status_ok_or_return(moving_stats_ewma_init(&storage->ewma, settings->ewma_shift));
+
+  storage->buffer = settings->buffer;
+  storage->long_window = settings->long_window;
+  storage->short_window = settings->short_window;
+  moving_stats_reset(storage);
+  return STATUS_CODE_OK;
+}
+
+void moving_stats_reset(MovingStatsStorage *storage) {
+  storage->head = 0;
+  storage->count = 0;
+  storage->long_sum = 0;
+  storage->short_sum = 0;
+  storage->long_sum_squares = 0;
+  storage->ewma.accumulator = 0;
+  storage->ewma.primed = false;
+  storage->min = 0;
+  storage->max = 0;
+}
+
+void moving_stats_push(MovingStatsStorage *storage, int32_t sample) {
+  if (!storage->ewma.primed) {
+    storage->min = sample;
+    storage->max = sample;
+  } else if (sample < storage->min) {
+    storage->min = sample;
+  } else if (sample > storage->max) {
+    storage->max = sample;
+  }
+  moving_stats_ewma_push(&storage->ewma, sample);
+
+  // evict the sample leaving the short window, which is still in the ring
+  if (storage->count >= storage->short_window) {
+    uint16_t idx = (uint16_t)((storage->head + storage->long_window - storage->short_window) %
+                              storage->long_window);
+    storage->short_sum -= storage->buffer[idx];
+  }
+
+  // evict the sample leaving the long window, which is about to be overwritten
+  if (storage->count == storage->long_window) {
+    const int32_t oldest = storage->buffer[storage->head];
+    storage->long_sum -= oldest;
+    storage->long_sum_squares -= (int64_t)oldest * oldest;
+  } else {
+    storage->count++;
+  }
+
+  storage->buffer[storage->head] = sample;
+  storage->head = (uint16_t)((storage->head + 1) % storage->long_window);
+  storage->long_sum += sample;
+  storage->short_sum += sample;
+  storage->long_sum_squares += (int64_t)sample * sample;
+}
+
+uint16_t moving_stats_count(const MovingStatsStorage *storage) {
+  return storage->count;
+}
+
+int32_t moving_stats_long_average(const MovingStatsStorage *storage) {
+  if (storage->count == 0) {
+    return 0;
+  }
+  return (int32_t)(storage->long_sum / storage->count);
+}
+
+int32_t moving_stats_short_average(const MovingStatsStorage *storage) {
+  uint16_t n = (storage->count < storage->short_window) ? storage->count : storage->short_window;
+  if (n == 0) {
+    return 0;
+  }
+  return (int32_t)(storage->short_sum / n);
+}
+
+int32_t moving_stats_ewma(const MovingStatsStorage *storage) {
+  return moving_stats_ewma_get(&storage->ewma);
+}
+
+uint32_t moving_stats_variance(const MovingStatsStorage *storage) {
+  if (storage->count == 0) {
+    return 0;
+  }
+  // var = (sum(x^2) - sum(x)^2 / n) / n, which avoids rounding the mean before squaring it
+  const uint64_t n = storage->count;
+  const uint64_t abs_sum =
+      (uint64_t)((storage->long_sum < 0) ? -storage->long_sum : storage->long_sum);
+  const uint64_t sum_squares = (uint64_t)storage->long_sum_squares;
+  const uint64_t square_of_sum = abs_sum * abs_sum / n;
+  if (square_of_sum >= sum_squares) {
+    return 0;
+  }
+  const uint64_t variance = (sum_squares - square_of_sum) / n;
+  return (variance > UINT32_MAX) ? UINT32_MAX : (uint32_t)variance;
+}
+
+int32_t moving_stats_min(const MovingStatsStorage *storage) {
+  return storage->min;
+}
+
+int32_t moving_stats_max(const MovingStatsStorage *storage) {
+  return storage->max;
+}
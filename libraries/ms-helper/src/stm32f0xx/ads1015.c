@@ -1,8 +1,10 @@
 #include "ads1015.h"
 // The general idea is that the ALERT/RDY pin asserts whenever a conversion
 // result is ready, and after storing the result the channel is switched to the
-// next and ADS1015 is restarted for the new conversion. If no channels are
-// enabled, the interrupt on ALERT/RDY pin is masked.
+// next and ADS1015 is restarted for the new conversion. If only one channel is
+// enabled, the ADS1015 converts it continuously instead, so each interrupt is a
+// single read. If no channels are enabled, the interrupt on ALERT/RDY pin is
+// masked.
 //
 // Channel rotation is implemented through the use of bitsets. The main bitset
 // holds the state of each channel(enable/disable). The pending bitset
@@ -29,6 +31,12 @@ static void prv_mark_channel_enabled(Ads1015Channel channel, bool enable, uint8_
   }
 }
 
+// With a single channel there's nothing to rotate through, so it's converted
+// continuously.
+static bool prv_is_continuous(uint8_t channel_bitset) {
+  return __builtin_popcount(channel_bitset) == 1;
+}
+
 // Writes to register given upper and lower bytes.
 static StatusCode prv_setup_register(Ads1015Storage *storage, uint8_t reg, uint8_t msb,
                                      uint8_t lsb) {
@@ -46,13 +54,16 @@ static StatusCode prv_read_register(I2CPort i2c_port, uint8_t i2c_addr, uint8_t
   return STATUS_CODE_OK;
 }
 
-// Switches to the given channel by writing to config register.
+// Switches to the given channel by writing to config register, which also
+// starts its conversion.
 static StatusCode prv_set_channel(Ads1015Storage *storage, Ads1015Channel channel) {
   if (channel >= NUM_ADS1015_CHANNELS) {
     return status_code(STATUS_CODE_INVALID_ARGS);
   }
-  status_ok_or_return(prv_setup_register(storage, ADS1015_ADDRESS_POINTER_CONFIG,
-                                         ADS1015_CONFIG_REGISTER_MSB(channel),
+  uint8_t msb = prv_is_continuous(storage->channel_bitset)
+                    ? ADS1015_CONFIG_REGISTER_MSB_CONT(channel)
+                    : ADS1015_CONFIG_REGISTER_MSB(channel);
+  status_ok_or_return(prv_setup_register(storage, ADS1015_ADDRESS_POINTER_CONFIG, msb,
                                          ADS1015_CONFIG_REGISTER_LSB(ADS1015_DATA_RATE)));
   storage->current_channel = channel;
   return STATUS_CODE_OK;
@@ -88,9 +99,10 @@ static void prv_interrupt_handler(const GpioAddress *address, void *context) {
                       read_conv_register, SIZEOF_ARRAY(read_conv_register));
     // Following line puts the two read bytes into an int16.
     // 4 least significant bits are not part of the result hence the bitshift.
+    int16_t raw = (int16_t)(((read_conv_register[0] << 8) | read_conv_register[1]) >>
+                            ADS1015_NUM_RESERVED_BITS_CONV_REG);
     storage->channel_readings[current_channel] =
-        ((read_conv_register[0] << 8) | read_conv_register[1]) >>
-        ADS1015_NUM_RESERVED_BITS_CONV_REG;
+        ads1015_filter_update(&storage->filters[current_channel], raw);
 
     storage->data_valid = true;
 
@@ -101,6 +113,12 @@ static void prv_interrupt_handler(const GpioAddress *address, void *context) {
     }
   }
 
+  storage->watchdog_kicked = true;
+  if (prv_is_continuous(channel_bitset)) {
+    // The next conversion is already underway
+    return;
+  }
+
   prv_mark_channel_enabled(current_channel, false, &storage->pending_channel_bitset);
   if (storage->pending_channel_bitset == ADS1015_BITSET_EMPTY) {
     // Reset the pending bitset once gone through a cycle of channel rotation.
@@ -109,8 +127,6 @@ static void prv_interrupt_handler(const GpioAddress *address, void *context) {
   current_channel = __builtin_ffs(storage->pending_channel_bitset) - 1;
   // Update so that the ADS1015 reads from the next channel.
   prv_set_channel(storage, current_channel);
-
-  storage->watchdog_kicked = true;
 }
 
 // Initiates ads1015 by setting up registers and enabling ALRT/RDY Pin.
@@ -172,10 +188,19 @@ StatusCode ads1015_configure_channel(Ads1015Storage *storage, Ads1015Channel cha
   storage->channel_callback[channel] = callback;
   storage->callback_context[channel] = context;
 
-  if ((channel_bitset == ADS1015_BITSET_EMPTY) && enable) {
-    // Set the given channel since the first channel is being enabled.
-    status_ok_or_return(prv_set_channel(storage, channel));
-  } else if (!enable) {
+  if (storage->channel_bitset != channel_bitset) {
+    ads1015_filter_reset(&storage->filters[channel]);
+  }
+
+  if (prv_is_continuous(storage->channel_bitset) && storage->channel_bitset != channel_bitset) {
+    // Start converting the only enabled channel continuously.
+    Ads1015Channel only_channel = __builtin_ffs(storage->channel_bitset) - 1;
+    status_ok_or_return(prv_set_channel(storage, only_channel));
+  } else if (prv_is_continuous(channel_bitset) && enable) {
+    // Leave continuous mode so the next interrupt can rotate to the new channel.
+    status_ok_or_return(prv_set_channel(storage, storage->current_channel));
+  }
+  if (!enable) {
     // Set the reading to an invalid value if channel is being disabled.
     storage->channel_readings[channel] = ADS1015_DISABLED_CHANNEL_READING;
   }
@@ -1,6 +1,7 @@
 #include "thermistor.h"
 #include <limits.h>
 #include <stdint.h>
+#include "interp_table.h"
 #include "log.h"
 
 // src:
@@ -8,7 +9,7 @@
 // Expected resistance in milliohms for a given temperature in celsius
 //
 // This table covers the range [0 C, 100 C] in 1 degree steps
-static const uint32_t s_resistance_lookup[] = {
+static const int32_t s_resistance_lookup[] = {
   27218600, 26076000, 24987700, 23950900, 22962900, 22021100, 21123000, 20266600, 19449500,
   18669800, 17925500, 17213900, 16534400, 15885600, 15265800, 14673500, 14107500, 13566400,
   13048900, 12554000, 12080500, 11628100, 11194700, 10779500, 10381500, 10000000, 9634200,
@@ -30,6 +31,13 @@ static const uint32_t s_resistance_lookup[] = {
 #define THERMISTOR_DECICELSIUS_TO_CELSIUS(x) ((x) / 10)
 #define THERMISTOR_CELSIUS_TO_DECICELSIUS(x) ((x)*10)
 
+static const InterpTable s_temperature_table = {
+  .x = s_resistance_lookup,
+  .y_start = 0,
+  .y_step = THERMISTOR_CELSIUS_TO_DECICELSIUS(1),
+  .num_points = SIZEOF_ARRAY(s_resistance_lookup),
+};
+
 StatusCode thermistor_init(ThermistorStorage *storage, GpioAddress thermistor_gpio,
                            ThermistorPosition position) {
   storage->position = position;
@@ -79,21 +87,18 @@ StatusCode thermistor_get_temp(ThermistorStorage *storage, uint16_t *temperature
 
 StatusCode thermistor_calculate_temp(uint32_t thermistor_resistance_ohms,
                                      uint16_t *temperature_dc) {
-  // Find the approximate target temperature from the arguments passed
-  for (uint16_t i = 0; i < SIZEOF_ARRAY(s_resistance_lookup) - 1; i++) {
-    if (thermistor_resistance_ohms * 1000 <= s_resistance_lookup[i] &&
-        thermistor_resistance_ohms * 1000 >= s_resistance_lookup[i + 1]) {
-      // Return the temperature with the linear approximation in deciCelsius
-      *temperature_dc = (uint16_t)(
-          ((uint32_t)i * 1000 + ((s_resistance_lookup[i] - thermistor_resistance_ohms * 1000) *
-                                 1000 / (s_resistance_lookup[i] - s_resistance_lookup[i + 1]))) /
-          100);
-      return STATUS_CODE_OK;
-    }
+  int64_t resistance_milliohms = (int64_t)thermistor_resistance_ohms * 1000;
+  int32_t temperature = 0;
+  if (resistance_milliohms > INT32_MAX ||
+      !status_ok(interp_table_lookup(&s_temperature_table, (int32_t)resistance_milliohms,
+                                     &temperature))) {
+    // Sets the returned temperature to be absurdly large
+    *temperature_dc = UINT16_MAX;
+    return status_msg(STATUS_CODE_OUT_OF_RANGE, "Temperature out of lookup table range.");
   }
-  // Sets the returned temperature to be absurdly large
-  *temperature_dc = UINT16_MAX;
-  return status_msg(STATUS_CODE_OUT_OF_RANGE, "Temperature out of lookup table range.");
+
+  *temperature_dc = (uint16_t)temperature;
+  return STATUS_CODE_OK;
 }
 
 StatusCode thermistor_calculate_resistance(uint16_t temperature_dc,
@@ -104,11 +109,11 @@ StatusCode thermistor_calculate_resistance(uint16_t temperature_dc,
   } else if (temperature_dc == THERMISTOR_CELSIUS_TO_DECICELSIUS(THERMISTOR_LOOKUP_RANGE)) {
     // For the higher lookup edge case
     *thermistor_resistor_ohms =
-        THERMISTOR_MILLIOHMS_TO_OHMS(s_resistance_lookup[THERMISTOR_LOOKUP_RANGE]);
+        (uint16_t)THERMISTOR_MILLIOHMS_TO_OHMS(s_resistance_lookup[THERMISTOR_LOOKUP_RANGE]);
   } else {
     // Linearly interpolate between the two points and then convert to Ohms
     uint16_t lower_temp = THERMISTOR_DECICELSIUS_TO_CELSIUS(temperature_dc);
-    *thermistor_resistor_ohms = THERMISTOR_MILLIOHMS_TO_OHMS(
+    *thermistor_resistor_ohms = (uint16_t)THERMISTOR_MILLIOHMS_TO_OHMS(
         (s_resistance_lookup[lower_temp] * 10 +
          (s_resistance_lookup[lower_temp + 1] - s_resistance_lookup[lower_temp]) *
              (temperature_dc % 10)) /
@@ -117,3 +122,74 @@ StatusCode thermistor_calculate_resistance(uint16_t temperature_dc,
 
   return STATUS_CODE_OK;
 }
+
+// Thermistor resistance in milliohms at a raw ADC code, saturating where the divider can't tell
+static int32_t prv_code_to_milliohms(ThermistorPosition position, uint32_t code) {
+  int64_t fixed_milliohms = (int64_t)THERMISTOR_FIXED_RESISTANCE_OHMS * 1000;
+  int64_t num = (position == THERMISTOR_POSITION_R1) ? THERMISTOR_ADC_MAX_CODE - (int64_t)code
+                                                     : (int64_t)code;
+  int64_t den = (int64_t)THERMISTOR_ADC_MAX_CODE - num;
+  if (num <= 0) {
+    return 0;
+  } else if (den <= 0) {
+    return INT32_MAX;
+  }
+
+  int64_t resistance = fixed_milliohms * num / den;
+  return (resistance > INT32_MAX) ? INT32_MAX : (int32_t)resistance;
+}
+
+StatusCode thermistor_adc_lut_init(ThermistorAdcLut *lut, ThermistorPosition position) {
+  if (lut == NULL || position >= NUM_THERMISTOR_POSITIONS) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  // Entries outside of the table are extrapolated so codes near its edges still interpolate
+  for (uint32_t i = 0; i < THERMISTOR_ADC_LUT_SIZE; i++) {
+    int32_t resistance = prv_code_to_milliohms(position, i << THERMISTOR_ADC_LUT_SHIFT);
+    int32_t temperature = interp_table_eval(&s_temperature_table, resistance);
+    if (temperature > INT16_MAX) {
+      temperature = INT16_MAX;
+    } else if (temperature < INT16_MIN) {
+      temperature = INT16_MIN;
+    }
+    lut->temperature_dc[i] = (int16_t)temperature;
+  }
+
+  // The valid codes are contiguous since resistance is monotonic in the code
+  bool found = false;
+  for (uint16_t code = 0; code <= THERMISTOR_ADC_MAX_CODE; code++) {
+    if (interp_table_in_range(&s_temperature_table, prv_code_to_milliohms(position, code))) {
+      if (!found) {
+        lut->min_code = code;
+        found = true;
+      }
+      lut->max_code = code;
+    }
+  }
+  if (!found) {
+    return status_msg(STATUS_CODE_INTERNAL_ERROR, "No ADC codes within lookup table range.");
+  }
+
+  return STATUS_CODE_OK;
+}
+
+StatusCode thermistor_adc_lut_get_temp(const ThermistorAdcLut *lut, uint16_t code,
+                                       uint16_t *temperature_dc) {
+  if (code < lut->min_code || code > lut->max_code) {
+    *temperature_dc = UINT16_MAX;
+    return status_msg(STATUS_CODE_OUT_OF_RANGE, "Temperature out of lookup table range.");
+  }
+
+  const uint16_t step = 1 << THERMISTOR_ADC_LUT_SHIFT;
+  uint16_t index = code >> THERMISTOR_ADC_LUT_SHIFT;
+  int32_t offset = code & (step - 1);
+  int32_t lower = lut->temperature_dc[index];
+  int32_t delta = (lut->temperature_dc[index + 1] - lower) * offset;
+  // Round to nearest
+  delta += (delta < 0) ? -step / 2 : step / 2;
+  int32_t temperature = lower + delta / step;
+
+  *temperature_dc = (temperature < 0) ? 0 : (uint16_t)temperature;
+  return STATUS_CODE_OK;
+}
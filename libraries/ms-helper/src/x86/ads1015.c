@@ -1,16 +1,41 @@
 // This module emulates the behavior of ADS1015 on x86.
-// Instead of having interrupts raised by the device once a channel finishes
-// conversion, there is a soft timer with prv_timer_callback that is called
-// periodically to update channel readings and switch to the next channel. The
-// rotation of the channels is implemented using bitsets. The readings are just
-// a arbitrary value.
+// The emulated device converts on a soft timer and pulses the ALERT/RDY pin
+// once each conversion is done, which reaches the driver through its GPIO
+// interrupt like it does on hardware. The driver side mirrors the STM32
+// implementation: the interrupt handler reads the result, filters and stores
+// it, and switches to the next enabled channel. The rotation of the channels is
+// implemented using bitsets. Conversions read the inputs set through
+// ads1015_inject.h.
 #include "ads1015.h"
+#include <stdlib.h>
 #include <string.h>
 #include "ads1015_def.h"
+#include "ads1015_inject.h"
+#include "critical_section.h"
+#include "gpio_inject.h"
+#include "gpio_it.h"
+#include "log.h"
 #include "soft_timer.h"
+#include "x86_cmd.h"
 
 #define ADS1015_CHANNEL_UPDATE_PERIOD_US ADS1015_CONVERSION_TIME_US_1600_SPS
-#define ADS1015_CHANNEL_ARBITRARY_READING 0
+#define ADS1015_INJECT_CMD "ads1015"
+#define ADS1015_RAW_MAX ((ADS1015_NUMBER_OF_CODES / 2) - 1)
+#define ADS1015_RAW_MIN (-(ADS1015_NUMBER_OF_CODES / 2))
+
+// State of the emulated chip, which outlives the driver's storage
+typedef struct Ads1015Device {
+  int16_t inputs[NUM_ADS1015_CHANNELS];
+  SoftTimerId conversion_timer;
+  bool converting;
+} Ads1015Device;
+
+static Ads1015Device s_devices[NUM_I2C_PORTS][NUM_ADS1015_ADDRESSES];
+static bool s_cmd_registered = false;
+
+static Ads1015Device *prv_get_device(Ads1015Storage *storage) {
+  return &s_devices[storage->i2c_port][storage->i2c_addr - ADS1015_I2C_BASE_ADDRESS];
+}
 
 // Checks if a channel is enabled (true) or disabled (false).
 static bool prv_channel_is_enabled(Ads1015Storage *storage, Ads1015Channel channel) {
@@ -26,6 +51,12 @@ static void prv_mark_channel_enabled(Ads1015Channel channel, bool enable, uint8_
   }
 }
 
+// With a single channel there's nothing to rotate through, so it's converted
+// continuously.
+static bool prv_is_continuous(uint8_t channel_bitset) {
+  return __builtin_popcount(channel_bitset) == 1;
+}
+
 // Sets the current channel of the storage.
 static StatusCode prv_set_channel(Ads1015Storage *storage, Ads1015Channel channel) {
   if (channel >= NUM_ADS1015_CHANNELS) {
@@ -36,43 +67,134 @@ static StatusCode prv_set_channel(Ads1015Storage *storage, Ads1015Channel channe
   return STATUS_CODE_OK;
 }
 
-// Periodically calls channels' callbacks imitating the interrupt behavior.
-static void prv_timer_callback(SoftTimerId id, void *context) {
+// Periodically completes a conversion by pulsing the ready pin, as the device
+// does with the comparator set up as a conversion ready signal.
+static void prv_conversion_timer_callback(SoftTimerId id, void *context) {
+  Ads1015Storage *storage = context;
+  Ads1015Device *device = prv_get_device(storage);
+
+  if (storage->channel_bitset != ADS1015_BITSET_EMPTY) {
+    gpio_inject_edge(&storage->ready_pin, INTERRUPT_EDGE_RISING);
+  }
+  soft_timer_start(ADS1015_CHANNEL_UPDATE_PERIOD_US, prv_conversion_timer_callback, storage,
+                   &device->conversion_timer);
+}
+
+// This function is registered as the callback for ALRT/RDY Pin.
+// Reads and stores the conversion value in storage, and switches to the next
+// enabled channel. Also if there is a callback on a channel, it will be run
+// here.
+static void prv_interrupt_handler(const GpioAddress *address, void *context) {
   Ads1015Storage *storage = context;
   Ads1015Channel current_channel = storage->current_channel;
+  uint8_t channel_bitset = storage->channel_bitset;
 
   if (prv_channel_is_enabled(storage, current_channel)) {
-    storage->channel_readings[current_channel] = ADS1015_CHANNEL_ARBITRARY_READING;
+    int16_t raw = prv_get_device(storage)->inputs[current_channel];
+    storage->channel_readings[current_channel] =
+        ads1015_filter_update(&storage->filters[current_channel], raw);
+    storage->data_valid = true;
+
     // Runs the users callback if not NULL.
     if (storage->channel_callback[current_channel] != NULL) {
       storage->channel_callback[current_channel](current_channel,
                                                  storage->callback_context[current_channel]);
     }
   }
+
+  if (prv_is_continuous(channel_bitset)) {
+    return;
+  }
+
   // Disable the channel on the pending bitset.
   prv_mark_channel_enabled(current_channel, false, &storage->pending_channel_bitset);
   // Reset the pending bitset once gone through a cycle of channel rotation.
   if (storage->pending_channel_bitset == ADS1015_BITSET_EMPTY) {
-    storage->pending_channel_bitset = storage->channel_bitset;
+    storage->pending_channel_bitset = channel_bitset;
   }
   // Obtain the next enabled channel.
   current_channel = (Ads1015Channel)(__builtin_ffs(storage->pending_channel_bitset) - 1);
   // Update so that the ADS1015 reads from the next channel.
   prv_set_channel(storage, current_channel);
-  soft_timer_start(ADS1015_CHANNEL_UPDATE_PERIOD_US, prv_timer_callback, storage, NULL);
 }
 
-// Inits the storage for ADS1015 and starts the soft timer.
+static void prv_cmd_handler(int client_fd, const char *cmd, const char *args[], size_t num_args,
+                            void *context) {
+  if (num_args != 4) {
+    LOG_WARN("Usage: ads1015 <i2c_port> <address> <channel> <raw>\n");
+    return;
+  }
+
+  I2CPort i2c_port = (I2CPort)strtoul(args[0], NULL, 10);
+  Ads1015Address i2c_addr = (Ads1015Address)strtoul(args[1], NULL, 10);
+  Ads1015Channel channel = (Ads1015Channel)strtoul(args[2], NULL, 10);
+  int16_t raw = (int16_t)strtol(args[3], NULL, 10);
+  if (!status_ok(ads1015_inject_set_raw(i2c_port, i2c_addr, channel, raw))) {
+    LOG_WARN("Invalid ADS1015 input %s %s %s\n", args[0], args[1], args[2]);
+  }
+}
+
+StatusCode ads1015_inject_set_raw(I2CPort i2c_port, Ads1015Address i2c_addr,
+                                  Ads1015Channel channel, int16_t raw) {
+  if (i2c_port >= NUM_I2C_PORTS || i2c_addr >= NUM_ADS1015_ADDRESSES ||
+      channel >= NUM_ADS1015_CHANNELS) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  if (raw > ADS1015_RAW_MAX) {
+    raw = ADS1015_RAW_MAX;
+  } else if (raw < ADS1015_RAW_MIN) {
+    raw = ADS1015_RAW_MIN;
+  }
+  bool disabled = critical_section_start();
+  s_devices[i2c_port][i2c_addr].inputs[channel] = raw;
+  critical_section_end(disabled);
+  return STATUS_CODE_OK;
+}
+
+// Inits the storage for ADS1015, registers the interrupt handler on ALRT/RDY
+// pin and starts the emulated conversions.
 StatusCode ads1015_init(Ads1015Storage *storage, I2CPort i2c_port, Ads1015Address i2c_addr,
                         GpioAddress *ready_pin) {
-  if (storage == NULL || ready_pin == NULL) {
+  if (storage == NULL || ready_pin == NULL || i2c_port >= NUM_I2C_PORTS ||
+      i2c_addr >= NUM_ADS1015_ADDRESSES) {
     return status_code(STATUS_CODE_INVALID_ARGS);
   }
+  if (!s_cmd_registered) {
+    x86_cmd_register_handler(ADS1015_INJECT_CMD, prv_cmd_handler, NULL);
+    s_cmd_registered = true;
+  }
+
   memset(storage, 0, sizeof(Ads1015Storage));
   for (Ads1015Channel channel = 0; channel < NUM_ADS1015_CHANNELS; channel++) {
     storage->channel_readings[channel] = ADS1015_DISABLED_CHANNEL_READING;
   }
-  return soft_timer_start(ADS1015_CHANNEL_UPDATE_PERIOD_US, prv_timer_callback, storage, NULL);
+  storage->watchdog_timer = SOFT_TIMER_INVALID_TIMER;
+  storage->i2c_port = i2c_port;
+  storage->i2c_addr = i2c_addr + ADS1015_I2C_BASE_ADDRESS;
+  storage->ready_pin = *ready_pin;
+
+  GpioSettings gpio_settings = {
+    .direction = GPIO_DIR_IN,  //
+  };
+  InterruptSettings it_settings = {
+    .type = INTERRUPT_TYPE_INTERRUPT,       //
+    .priority = INTERRUPT_PRIORITY_NORMAL,  //
+  };
+  status_ok_or_return(gpio_init_pin(ready_pin, &gpio_settings));
+  status_ok_or_return(gpio_it_register_interrupt(ready_pin, &it_settings, INTERRUPT_EDGE_RISING,
+                                                 prv_interrupt_handler, storage));
+  // Mask the interrupt until channels are enabled by the user.
+  status_ok_or_return(gpio_it_mask_interrupt(ready_pin, true));
+
+  // soft_timer_init() doesn't cancel timers, so stop conversions from a previous init
+  Ads1015Device *device = prv_get_device(storage);
+  if (device->converting) {
+    soft_timer_cancel(device->conversion_timer);
+  }
+  device->converting = true;
+  return soft_timer_start(ADS1015_CHANNEL_UPDATE_PERIOD_US, prv_conversion_timer_callback, storage,
+                          &device->conversion_timer);
 }
 
 // Enable/disables a channel, and sets a callback for the channel.
@@ -81,15 +203,29 @@ StatusCode ads1015_configure_channel(Ads1015Storage *storage, Ads1015Channel cha
   if (storage == NULL || channel >= NUM_ADS1015_CHANNELS) {
     return status_code(STATUS_CODE_INVALID_ARGS);
   }
+  status_ok_or_return(gpio_it_mask_interrupt(&storage->ready_pin, true));
+
+  uint8_t channel_bitset = storage->channel_bitset;
   prv_mark_channel_enabled(channel, enable, &storage->channel_bitset);
   storage->pending_channel_bitset = storage->channel_bitset;
   storage->channel_callback[channel] = callback;
   storage->callback_context[channel] = context;
 
+  if (storage->channel_bitset != channel_bitset) {
+    ads1015_filter_reset(&storage->filters[channel]);
+  }
+
+  if (prv_is_continuous(storage->channel_bitset) && storage->channel_bitset != channel_bitset) {
+    // Start converting the only enabled channel continuously.
+    prv_set_channel(storage, (Ads1015Channel)(__builtin_ffs(storage->channel_bitset) - 1));
+  }
   if (!enable) {
     storage->channel_readings[channel] = ADS1015_DISABLED_CHANNEL_READING;
   }
-  return STATUS_CODE_OK;
+
+  // Unmask the interrupt if at least one channel is enabled.
+  return gpio_it_mask_interrupt(&storage->ready_pin,
+                                storage->channel_bitset == ADS1015_BITSET_EMPTY);
 }
 
 // Reads raw results from the storage.
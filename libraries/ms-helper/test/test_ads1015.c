@@ -204,3 +204,30 @@ void test_ads1015_start_with_all_channels_disabled(void) {
                       ads1015_read_converted(&s_storage, channel, &reading));
   }
 }
+
+void test_ads1015_configure_filter_invalid_input(void) {
+  Ads1015FilterSettings settings = { .median = true, .iir_shift = 2 };
+  TEST_ASSERT_EQUAL(STATUS_CODE_OK,
+                    ads1015_configure_filter(&s_storage, ADS1015_CHANNEL_0, &settings));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    ads1015_configure_filter(NULL, ADS1015_CHANNEL_0, &settings));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    ads1015_configure_filter(&s_storage, NUM_ADS1015_CHANNELS, &settings));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    ads1015_configure_filter(&s_storage, ADS1015_CHANNEL_0, NULL));
+  settings.iir_shift = ADS1015_FILTER_MAX_IIR_SHIFT + 1;
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    ads1015_configure_filter(&s_storage, ADS1015_CHANNEL_0, &settings));
+}
+
+// Filtered channels should still read back valid conversions.
+void test_ads1015_filtered_channel(void) {
+  int16_t reading = ADS1015_READ_UNSUCCESSFUL;
+  Ads1015FilterSettings settings = { .median = true, .iir_shift = 2 };
+
+  ads1015_configure_filter(&s_storage, ADS1015_CHANNEL_3, &settings);
+  ads1015_configure_channel(&s_storage, ADS1015_CHANNEL_3, true, NULL, NULL);
+  delay_ms(TEST_ADS1015_CONV_DELAY_MS);
+  TEST_ASSERT_EQUAL(STATUS_CODE_OK, ads1015_read_raw(&s_storage, ADS1015_CHANNEL_3, &reading));
+  TEST_ASSERT_TRUE(prv_channel_reading_valid(reading));
+}
@@ -0,0 +1,70 @@
+#include "ads1015_filter.h"
+
+#include "misc.h"
+#include "unity.h"
+
+static Ads1015Filter s_filter;
+
+static void prv_setup_filter(bool median, uint8_t iir_shift) {
+  s_filter.settings.median = median;
+  s_filter.settings.iir_shift = iir_shift;
+  ads1015_filter_reset(&s_filter);
+}
+
+void setup_test(void) {}
+
+void teardown_test(void) {}
+
+void test_ads1015_filter_passthrough(void) {
+  prv_setup_filter(false, 0);
+  const int16_t samples[] = { 0, 2047, -2048, 5, 5, 1000 };
+  for (size_t i = 0; i < SIZEOF_ARRAY(samples); i++) {
+    TEST_ASSERT_EQUAL(samples[i], ads1015_filter_update(&s_filter, samples[i]));
+  }
+}
+
+// Single-sample spikes are rejected, while steps come through a sample late.
+void test_ads1015_filter_median(void) {
+  prv_setup_filter(true, 0);
+  // Until the window fills up, the latest sample comes through
+  TEST_ASSERT_EQUAL(100, ads1015_filter_update(&s_filter, 100));
+  TEST_ASSERT_EQUAL(102, ads1015_filter_update(&s_filter, 102));
+  TEST_ASSERT_EQUAL(100, ads1015_filter_update(&s_filter, 100));
+  TEST_ASSERT_EQUAL(100, ads1015_filter_update(&s_filter, 100));
+
+  TEST_ASSERT_EQUAL(100, ads1015_filter_update(&s_filter, 2000));
+  TEST_ASSERT_EQUAL(100, ads1015_filter_update(&s_filter, 99));
+  TEST_ASSERT_EQUAL(99, ads1015_filter_update(&s_filter, -1500));
+
+  TEST_ASSERT_EQUAL(99, ads1015_filter_update(&s_filter, 500));
+  TEST_ASSERT_EQUAL(500, ads1015_filter_update(&s_filter, 500));
+}
+
+void test_ads1015_filter_iir(void) {
+  prv_setup_filter(false, 2);
+  // Starts at the first sample
+  TEST_ASSERT_EQUAL(400, ads1015_filter_update(&s_filter, 400));
+  // Each sample moves a quarter of the way
+  TEST_ASSERT_EQUAL(300, ads1015_filter_update(&s_filter, 0));
+  TEST_ASSERT_EQUAL(225, ads1015_filter_update(&s_filter, 0));
+
+  // Settles on a constant input without a rounding offset
+  for (int i = 0; i < 100; i++) {
+    ads1015_filter_update(&s_filter, -100);
+  }
+  TEST_ASSERT_EQUAL(-100, ads1015_filter_update(&s_filter, -100));
+
+  // Resetting starts over from the next sample
+  ads1015_filter_reset(&s_filter);
+  TEST_ASSERT_EQUAL(1234, ads1015_filter_update(&s_filter, 1234));
+}
+
+void test_ads1015_filter_median_then_iir(void) {
+  prv_setup_filter(true, ADS1015_FILTER_MAX_IIR_SHIFT);
+  for (int i = 0; i < 3; i++) {
+    TEST_ASSERT_EQUAL(2047, ads1015_filter_update(&s_filter, 2047));
+  }
+  // The spike never reaches the IIR
+  TEST_ASSERT_EQUAL(2047, ads1015_filter_update(&s_filter, -2048));
+  TEST_ASSERT_EQUAL(2047, ads1015_filter_update(&s_filter, 2047));
+}
@@ -0,0 +1,141 @@
+#include "ads1015_inject.h"
+
+#include <string.h>
+
+#include "ads1015.h"
+#include "ads1015_def.h"
+#include "critical_section.h"
+#include "delay.h"
+#include "gpio_inject.h"
+#include "gpio_it.h"
+#include "i2c.h"
+#include "interrupt.h"
+#include "soft_timer.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_ADS1015_I2C_PORT I2C_PORT_1
+#define TEST_ADS1015_ADDR ADS1015_ADDRESS_VDD
+// Enough for a few rounds of conversions on every channel
+#define TEST_ADS1015_CONV_DELAY_MS 10
+
+static Ads1015Storage s_storage;
+static GpioAddress s_ready_pin = { .port = GPIO_PORT_A, .pin = 10 };
+static volatile uint32_t s_num_conversions[NUM_ADS1015_CHANNELS];
+
+static void prv_count_conversion(Ads1015Channel channel, void *context) {
+  s_num_conversions[channel]++;
+}
+
+void setup_test(void) {
+  gpio_init();
+  interrupt_init();
+  gpio_it_init();
+  soft_timer_init();
+  I2CSettings i2c_settings = {
+    .speed = I2C_SPEED_FAST,                   //
+    .scl = { .port = GPIO_PORT_B, .pin = 8 },  //
+    .sda = { .port = GPIO_PORT_B, .pin = 9 },  //
+  };
+  i2c_init(TEST_ADS1015_I2C_PORT, &i2c_settings);
+  TEST_ASSERT_OK(ads1015_init(&s_storage, TEST_ADS1015_I2C_PORT, TEST_ADS1015_ADDR, &s_ready_pin));
+
+  for (Ads1015Channel channel = 0; channel < NUM_ADS1015_CHANNELS; channel++) {
+    TEST_ASSERT_OK(ads1015_inject_set_raw(TEST_ADS1015_I2C_PORT, TEST_ADS1015_ADDR, channel, 0));
+  }
+  memset((void *)s_num_conversions, 0, sizeof(s_num_conversions));
+}
+
+void teardown_test(void) {}
+
+void test_ads1015_inject_invalid_args(void) {
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    ads1015_inject_set_raw(NUM_I2C_PORTS, TEST_ADS1015_ADDR, 0, 0));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    ads1015_inject_set_raw(TEST_ADS1015_I2C_PORT, NUM_ADS1015_ADDRESSES, 0, 0));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, ads1015_inject_set_raw(
+                                                  TEST_ADS1015_I2C_PORT, TEST_ADS1015_ADDR,
+                                                  NUM_ADS1015_CHANNELS, 0));
+}
+
+// Each channel reads its own input, and inputs beyond 12 bits are clamped.
+void test_ads1015_inject_channels(void) {
+  int16_t reading = 0;
+  TEST_ASSERT_OK(ads1015_inject_set_raw(TEST_ADS1015_I2C_PORT, TEST_ADS1015_ADDR,
+                                        ADS1015_CHANNEL_0, 1234));
+  TEST_ASSERT_OK(ads1015_inject_set_raw(TEST_ADS1015_I2C_PORT, TEST_ADS1015_ADDR,
+                                        ADS1015_CHANNEL_2, -30000));
+  TEST_ASSERT_OK(ads1015_inject_set_raw(TEST_ADS1015_I2C_PORT, TEST_ADS1015_ADDR,
+                                        ADS1015_CHANNEL_3, 5000));
+  for (Ads1015Channel channel = 0; channel < NUM_ADS1015_CHANNELS; channel++) {
+    ads1015_configure_channel(&s_storage, channel, true, prv_count_conversion, NULL);
+  }
+  delay_ms(TEST_ADS1015_CONV_DELAY_MS);
+
+  const int16_t expected[NUM_ADS1015_CHANNELS] = { 1234, 0, -2048, 2047 };
+  for (Ads1015Channel channel = 0; channel < NUM_ADS1015_CHANNELS; channel++) {
+    TEST_ASSERT_OK(ads1015_read_raw(&s_storage, channel, &reading));
+    TEST_ASSERT_EQUAL(expected[channel], reading);
+    TEST_ASSERT_NOT_EQUAL(0, s_num_conversions[channel]);
+  }
+}
+
+// Each conversion pulses the ready pin, and a lone channel gets every conversion.
+void test_ads1015_inject_ready_pin(void) {
+  uint64_t first_edge_ns = 0;
+  uint64_t last_edge_ns = 0;
+  // No edges reach the driver while every channel is disabled
+  delay_ms(TEST_ADS1015_CONV_DELAY_MS);
+  TEST_ASSERT_OK(gpio_inject_get_edge_time(&s_ready_pin, &first_edge_ns));
+  TEST_ASSERT_EQUAL(0, first_edge_ns);
+
+  ads1015_configure_channel(&s_storage, ADS1015_CHANNEL_1, true, prv_count_conversion, NULL);
+  delay_ms(TEST_ADS1015_CONV_DELAY_MS / 2);
+  TEST_ASSERT_OK(gpio_inject_get_edge_time(&s_ready_pin, &first_edge_ns));
+  uint32_t lone_conversions = s_num_conversions[ADS1015_CHANNEL_1];
+  TEST_ASSERT_NOT_EQUAL(0, first_edge_ns);
+  TEST_ASSERT_NOT_EQUAL(0, lone_conversions);
+
+  delay_ms(TEST_ADS1015_CONV_DELAY_MS / 2);
+  TEST_ASSERT_OK(gpio_inject_get_edge_time(&s_ready_pin, &last_edge_ns));
+  TEST_ASSERT_TRUE(last_edge_ns > first_edge_ns);
+
+  // With a second channel, the conversions are split between them
+  ads1015_configure_channel(&s_storage, ADS1015_CHANNEL_2, true, prv_count_conversion, NULL);
+  memset((void *)s_num_conversions, 0, sizeof(s_num_conversions));
+  delay_ms(TEST_ADS1015_CONV_DELAY_MS);
+  TEST_ASSERT_UINT32_WITHIN(1, s_num_conversions[ADS1015_CHANNEL_1],
+                            s_num_conversions[ADS1015_CHANNEL_2]);
+}
+
+// Filtering rejects a spike on the input and smooths a step.
+void test_ads1015_inject_filtered(void) {
+  int16_t reading = 0;
+  Ads1015FilterSettings settings = { .median = true, .iir_shift = 1 };
+  TEST_ASSERT_OK(ads1015_configure_filter(&s_storage, ADS1015_CHANNEL_0, &settings));
+  TEST_ASSERT_OK(ads1015_inject_set_raw(TEST_ADS1015_I2C_PORT, TEST_ADS1015_ADDR,
+                                        ADS1015_CHANNEL_0, 100));
+  ads1015_configure_channel(&s_storage, ADS1015_CHANNEL_0, true, prv_count_conversion, NULL);
+  delay_ms(TEST_ADS1015_CONV_DELAY_MS);
+  TEST_ASSERT_OK(ads1015_read_raw(&s_storage, ADS1015_CHANNEL_0, &reading));
+  TEST_ASSERT_EQUAL(100, reading);
+
+  // Hold the spike for exactly one conversion
+  while (s_num_conversions[ADS1015_CHANNEL_0] == 0) {
+  }
+  bool disabled = critical_section_start();
+  s_num_conversions[ADS1015_CHANNEL_0] = 0;
+  ads1015_inject_set_raw(TEST_ADS1015_I2C_PORT, TEST_ADS1015_ADDR, ADS1015_CHANNEL_0, 2000);
+  critical_section_end(disabled);
+  while (s_num_conversions[ADS1015_CHANNEL_0] == 0) {
+  }
+  ads1015_inject_set_raw(TEST_ADS1015_I2C_PORT, TEST_ADS1015_ADDR, ADS1015_CHANNEL_0, 100);
+  TEST_ASSERT_OK(ads1015_read_raw(&s_storage, ADS1015_CHANNEL_0, &reading));
+  TEST_ASSERT_EQUAL(100, reading);
+
+  // A step settles after a few conversions
+  ads1015_inject_set_raw(TEST_ADS1015_I2C_PORT, TEST_ADS1015_ADDR, ADS1015_CHANNEL_0, 500);
+  delay_ms(TEST_ADS1015_CONV_DELAY_MS * 2);
+  TEST_ASSERT_OK(ads1015_read_raw(&s_storage, ADS1015_CHANNEL_0, &reading));
+  TEST_ASSERT_EQUAL(500, reading);
+}
@@ -0,0 +1,176 @@
+#include "fan_regulator.h"
+
+#include <stdlib.h>
+
+#include "fixed_point.h"
+#include "log.h"
+#include "misc.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+// 0% below 25 C, 30% at 25 C, up to 100% at 45 C
+static const int32_t s_curve_x[] = { 249, 250, 350, 450 };
+static const int32_t s_curve_y[] = { 0, 30, 50, 100 };
+static const InterpTable s_curve = {
+  .x = s_curve_x,
+  .y = s_curve_y,
+  .num_points = SIZEOF_ARRAY(s_curve_x),
+};
+
+#define TEST_TARGET_DC 350
+#define TEST_HYSTERESIS_DC 20
+#define TEST_NUM_FANS 2
+#define TEST_STALL_MIN_DUTY 20
+#define TEST_STALL_MIN_RPM 300
+#define TEST_STALL_UPDATES 3
+
+// Thermal model of a pack with fans: heat flows in at a fixed rate and out through a conductance
+// to ambient that grows with duty. Without the fans it settles at 60 C, and at full duty at 28 C.
+#define TEST_MODEL_AMBIENT_DC 250.0
+#define TEST_MODEL_HEAT 1.0
+#define TEST_MODEL_CONDUCTANCE_OFF (TEST_MODEL_HEAT / 350.0)
+#define TEST_MODEL_CONDUCTANCE_FULL (TEST_MODEL_HEAT / 30.0)
+// Heat capacity, giving time constants of 30 s at full duty to 350 s with the fans off
+#define TEST_MODEL_CAPACITY (TEST_MODEL_CONDUCTANCE_FULL * 30.0)
+#define TEST_MODEL_UPDATE_MS 1000
+#define TEST_MODEL_DURATION_S 1800
+
+static FanRegulatorStorage s_storage;
+
+static FanRegulatorSettings prv_settings(int32_t kp, int32_t ki) {
+  FanRegulatorSettings settings = {
+    .curve = &s_curve,
+    .hysteresis_dC = TEST_HYSTERESIS_DC,
+    .target_dC = TEST_TARGET_DC,
+    .kp = kp,
+    .ki = ki,
+    .num_fans = TEST_NUM_FANS,
+    .stall_min_duty = TEST_STALL_MIN_DUTY,
+    .stall_min_rpm = TEST_STALL_MIN_RPM,
+    .stall_updates = TEST_STALL_UPDATES,
+  };
+  return settings;
+}
+
+// Advances the model by one update at |duty|, returning the new temperature
+static double prv_model_step(double temp_dC, uint8_t duty) {
+  double conductance = TEST_MODEL_CONDUCTANCE_OFF +
+                       (TEST_MODEL_CONDUCTANCE_FULL - TEST_MODEL_CONDUCTANCE_OFF) * duty / 100.0;
+  double dt_s = TEST_MODEL_UPDATE_MS / 1000.0;
+  double heat_flow = TEST_MODEL_HEAT - conductance * (temp_dC - TEST_MODEL_AMBIENT_DC);
+  return temp_dC + heat_flow * dt_s / TEST_MODEL_CAPACITY;
+}
+
+void setup_test(void) {}
+
+void teardown_test(void) {}
+
+void test_fan_regulator_invalid_settings(void) {
+  FanRegulatorSettings settings = prv_settings(0, 0);
+  settings.curve = NULL;
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, fan_regulator_init(&s_storage, &settings));
+
+  settings = prv_settings(0, 0);
+  settings.num_fans = FAN_REGULATOR_MAX_FANS + 1;
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, fan_regulator_init(&s_storage, &settings));
+
+  const int32_t decreasing_x[] = { 450, 250 };
+  const InterpTable decreasing = { .x = decreasing_x, .y = s_curve_y, .num_points = 2 };
+  settings = prv_settings(0, 0);
+  settings.curve = &decreasing;
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, fan_regulator_init(&s_storage, &settings));
+}
+
+// Without PI terms the duty follows the curve, held at its ends.
+void test_fan_regulator_curve(void) {
+  FanRegulatorSettings settings = prv_settings(0, 0);
+  settings.hysteresis_dC = 0;
+  TEST_ASSERT_OK(fan_regulator_init(&s_storage, &settings));
+  TEST_ASSERT_EQUAL(0, fan_regulator_get_duty(&s_storage));
+
+  TEST_ASSERT_EQUAL(0, fan_regulator_update(&s_storage, 100, TEST_MODEL_UPDATE_MS));
+  TEST_ASSERT_EQUAL(30, fan_regulator_update(&s_storage, 250, TEST_MODEL_UPDATE_MS));
+  TEST_ASSERT_EQUAL(40, fan_regulator_update(&s_storage, 300, TEST_MODEL_UPDATE_MS));
+  TEST_ASSERT_EQUAL(75, fan_regulator_update(&s_storage, 400, TEST_MODEL_UPDATE_MS));
+  TEST_ASSERT_EQUAL(100, fan_regulator_update(&s_storage, 600, TEST_MODEL_UPDATE_MS));
+  TEST_ASSERT_EQUAL(100, fan_regulator_get_duty(&s_storage));
+}
+
+// Falling temperatures only lower the duty once they leave the hysteresis band.
+void test_fan_regulator_hysteresis(void) {
+  FanRegulatorSettings settings = prv_settings(0, 0);
+  TEST_ASSERT_OK(fan_regulator_init(&s_storage, &settings));
+
+  TEST_ASSERT_EQUAL(75, fan_regulator_update(&s_storage, 400, TEST_MODEL_UPDATE_MS));
+  TEST_ASSERT_EQUAL(75, fan_regulator_update(&s_storage, 400 - TEST_HYSTERESIS_DC,
+                                             TEST_MODEL_UPDATE_MS));
+  // Past the band the curve trails the temperature by the hysteresis
+  TEST_ASSERT_EQUAL(65, fan_regulator_update(&s_storage, 400 - TEST_HYSTERESIS_DC - 20,
+                                             TEST_MODEL_UPDATE_MS));
+  // Rising temperatures are followed right away
+  TEST_ASSERT_EQUAL(80, fan_regulator_update(&s_storage, 410, TEST_MODEL_UPDATE_MS));
+}
+
+// The PI loop holds the modelled pack at the target, moving the fans smoothly to get there.
+void test_fan_regulator_holds_target_on_model(void) {
+  // 2% per C proportional, 0.1% per C per second integral
+  FanRegulatorSettings settings = prv_settings(FIXED_ONE(16) / 5, FIXED_ONE(16) / 100);
+  TEST_ASSERT_OK(fan_regulator_init(&s_storage, &settings));
+
+  // Start from a hot pack
+  double temp_dC = 450.0;
+  uint8_t previous_duty = fan_regulator_update(&s_storage, (int32_t)temp_dC, 0);
+  uint8_t max_step = 0;
+  for (uint32_t t = 0; t < TEST_MODEL_DURATION_S; t++) {
+    temp_dC = prv_model_step(temp_dC, previous_duty);
+    uint8_t duty = fan_regulator_update(&s_storage, (int32_t)temp_dC, TEST_MODEL_UPDATE_MS);
+    if (t > 60) {
+      max_step = (uint8_t)MAX(max_step, abs(duty - previous_duty));
+    }
+    previous_duty = duty;
+  }
+  LOG_DEBUG("settled at %d dC with %d%% duty, max step %d%%\n", (int)temp_dC, previous_duty,
+            max_step);
+
+  TEST_ASSERT_INT_WITHIN(10, TEST_TARGET_DC, (int32_t)temp_dC);
+  // Holding 35 C takes about 23% duty in the model, well under the curve's 50%
+  TEST_ASSERT_INT_WITHIN(3, 23, previous_duty);
+  TEST_ASSERT_TRUE(max_step <= 2);
+}
+
+// A long stretch at full duty doesn't wind up the integral.
+void test_fan_regulator_anti_windup(void) {
+  FanRegulatorSettings settings = prv_settings(0, FIXED_ONE(16) / 10);
+  settings.hysteresis_dC = 0;
+  TEST_ASSERT_OK(fan_regulator_init(&s_storage, &settings));
+
+  for (uint32_t i = 0; i < 1000; i++) {
+    TEST_ASSERT_EQUAL(100, fan_regulator_update(&s_storage, 500, TEST_MODEL_UPDATE_MS));
+  }
+  // Back under the target, the duty drops below the curve right away
+  TEST_ASSERT_TRUE(fan_regulator_update(&s_storage, 300, TEST_MODEL_UPDATE_MS) < 40);
+}
+
+// Fans that stay slow while driven are stalled until they spin back up.
+void test_fan_regulator_stall_detection(void) {
+  FanRegulatorSettings settings = prv_settings(0, 0);
+  TEST_ASSERT_OK(fan_regulator_init(&s_storage, &settings));
+
+  // Fans aren't expected to spin while they're off
+  TEST_ASSERT_EQUAL(0, fan_regulator_update(&s_storage, 200, TEST_MODEL_UPDATE_MS));
+  for (uint8_t i = 0; i < 2 * TEST_STALL_UPDATES; i++) {
+    TEST_ASSERT_FALSE(fan_regulator_update_tach(&s_storage, 0, 0));
+  }
+
+  TEST_ASSERT_EQUAL(75, fan_regulator_update(&s_storage, 400, TEST_MODEL_UPDATE_MS));
+  for (uint8_t i = 0; i < TEST_STALL_UPDATES - 1; i++) {
+    TEST_ASSERT_FALSE(fan_regulator_update_tach(&s_storage, 0, TEST_STALL_MIN_RPM - 1));
+    TEST_ASSERT_FALSE(fan_regulator_update_tach(&s_storage, 1, 2000));
+  }
+  TEST_ASSERT_TRUE(fan_regulator_update_tach(&s_storage, 0, TEST_STALL_MIN_RPM - 1));
+  TEST_ASSERT_TRUE(fan_regulator_is_stalled(&s_storage, 0));
+  TEST_ASSERT_FALSE(fan_regulator_is_stalled(&s_storage, 1));
+
+  TEST_ASSERT_FALSE(fan_regulator_update_tach(&s_storage, 0, TEST_STALL_MIN_RPM));
+  TEST_ASSERT_FALSE(fan_regulator_is_stalled(&s_storage, TEST_NUM_FANS));
+}
@@ -0,0 +1,99 @@
+#include "interp_table.h"
+
+#include "misc.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+static const int32_t s_increasing_x[] = { -100, 0, 100, 1000 };
+static const int32_t s_increasing_y[] = { 50, 0, 1000, 1000 };
+
+// Evenly spaced y from 0 in steps of 10, like a thermistor table
+static const int32_t s_decreasing_x[] = { 27218600, 26076000, 24987700, 23950900, 22962900 };
+
+static const InterpTable s_increasing = {
+  .x = s_increasing_x,
+  .y = s_increasing_y,
+  .num_points = SIZEOF_ARRAY(s_increasing_x),
+};
+
+static const InterpTable s_decreasing = {
+  .x = s_decreasing_x,
+  .y_start = 0,
+  .y_step = 10,
+  .num_points = SIZEOF_ARRAY(s_decreasing_x),
+};
+
+void setup_test(void) {}
+
+void teardown_test(void) {}
+
+void test_interp_table_increasing(void) {
+  int32_t y = 0;
+  // Exactly on the points
+  for (size_t i = 0; i < SIZEOF_ARRAY(s_increasing_x); i++) {
+    TEST_ASSERT_OK(interp_table_lookup(&s_increasing, s_increasing_x[i], &y));
+    TEST_ASSERT_EQUAL(s_increasing_y[i], y);
+  }
+
+  TEST_ASSERT_OK(interp_table_lookup(&s_increasing, -50, &y));
+  TEST_ASSERT_EQUAL(25, y);
+  TEST_ASSERT_OK(interp_table_lookup(&s_increasing, 37, &y));
+  TEST_ASSERT_EQUAL(370, y);
+  TEST_ASSERT_OK(interp_table_lookup(&s_increasing, 500, &y));
+  TEST_ASSERT_EQUAL(1000, y);
+}
+
+void test_interp_table_decreasing(void) {
+  int32_t y = 0;
+  for (size_t i = 0; i < SIZEOF_ARRAY(s_decreasing_x); i++) {
+    TEST_ASSERT_OK(interp_table_lookup(&s_decreasing, s_decreasing_x[i], &y));
+    TEST_ASSERT_EQUAL((int32_t)i * 10, y);
+  }
+
+  // Halfway between the second and third points
+  TEST_ASSERT_OK(interp_table_lookup(&s_decreasing, (26076000 + 24987700) / 2, &y));
+  TEST_ASSERT_EQUAL(15, y);
+}
+
+// Results are rounded to the nearest integer for both slopes.
+void test_interp_table_rounding(void) {
+  const int32_t x[] = { 0, 3 };
+  const int32_t rising_y[] = { 0, 1 };
+  const int32_t falling_y[] = { 0, -1 };
+  const InterpTable rising = { .x = x, .y = rising_y, .num_points = SIZEOF_ARRAY(x) };
+  const InterpTable falling = { .x = x, .y = falling_y, .num_points = SIZEOF_ARRAY(x) };
+
+  TEST_ASSERT_EQUAL(0, interp_table_eval(&rising, 1));
+  TEST_ASSERT_EQUAL(1, interp_table_eval(&rising, 2));
+  TEST_ASSERT_EQUAL(0, interp_table_eval(&falling, 1));
+  TEST_ASSERT_EQUAL(-1, interp_table_eval(&falling, 2));
+}
+
+void test_interp_table_out_of_range(void) {
+  int32_t y = 0;
+  TEST_ASSERT_EQUAL(STATUS_CODE_OUT_OF_RANGE, interp_table_lookup(&s_increasing, -101, &y));
+  TEST_ASSERT_EQUAL(STATUS_CODE_OUT_OF_RANGE, interp_table_lookup(&s_increasing, 1001, &y));
+  TEST_ASSERT_EQUAL(STATUS_CODE_OUT_OF_RANGE, interp_table_lookup(&s_decreasing, 27218601, &y));
+  TEST_ASSERT_EQUAL(STATUS_CODE_OUT_OF_RANGE, interp_table_lookup(&s_decreasing, 0, &y));
+
+  TEST_ASSERT_FALSE(interp_table_in_range(&s_decreasing, 22962899));
+  TEST_ASSERT_TRUE(interp_table_in_range(&s_decreasing, 22962900));
+
+  InterpTable invalid = s_increasing;
+  invalid.num_points = 1;
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, interp_table_lookup(&invalid, 0, &y));
+}
+
+// Evaluating outside of the table extends the end segments.
+void test_interp_table_extrapolate(void) {
+  TEST_ASSERT_EQUAL(100, interp_table_eval(&s_increasing, -200));
+  TEST_ASSERT_EQUAL(1000, interp_table_eval(&s_increasing, 5000));
+  TEST_ASSERT_EQUAL(-10, interp_table_eval(&s_decreasing, 27218600 + (27218600 - 26076000)));
+
+  // Steep tables saturate
+  const int32_t steep_x[] = { 0, 1 };
+  const int32_t steep_y[] = { 0, 1000 };
+  const InterpTable steep = { .x = steep_x, .y = steep_y, .num_points = SIZEOF_ARRAY(steep_x) };
+  TEST_ASSERT_EQUAL(INT32_MAX, interp_table_eval(&steep, INT32_MAX));
+  TEST_ASSERT_EQUAL(INT32_MIN, interp_table_eval(&steep, INT32_MIN));
+}
@@ -0,0 +1,65 @@
+// Counts the SPI transactions the MCP2515 driver needs per frame using the x86 SPI
+// model. The model reads back dummy data, so this only checks the bus traffic.
+#include "gpio.h"
+#include "gpio_it.h"
+#include "hal_test_helpers.h"
+#include "interrupt.h"
+#include "mcp2515.h"
+#include "soft_timer.h"
+#include "spi.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+static Mcp2515Storage s_mcp2515;
+static const GpioAddress s_int_pin = { .port = GPIO_PORT_A, .pin = 8 };
+static volatile uint32_t s_num_rx;
+
+static void prv_handle_rx(uint32_t id, bool extended, uint64_t data, size_t dlc, void *context) {
+  s_num_rx++;
+}
+
+void setup_test(void) {
+  gpio_init();
+  interrupt_init();
+  gpio_it_init();
+  soft_timer_init();
+  s_num_rx = 0;
+
+  const Mcp2515Settings mcp2515_settings = {
+    .spi_port = SPI_PORT_2,
+    .spi_baudrate = 6000000,
+    .mosi = { .port = GPIO_PORT_B, 15 },
+    .miso = { .port = GPIO_PORT_B, 14 },
+    .sclk = { .port = GPIO_PORT_B, 13 },
+    .cs = { .port = GPIO_PORT_B, 12 },
+    .int_pin = s_int_pin,
+    .can_bitrate = MCP2515_BITRATE_500KBPS,
+    .rx_cb = prv_handle_rx,
+  };
+  TEST_ASSERT_OK(mcp2515_init(&s_mcp2515, &mcp2515_settings));
+}
+
+void teardown_test(void) {}
+
+// Each frame is one LOAD TX burst and an RTS. The TX buffer status is only read once
+// all three buffers have been used.
+void test_mcp2515_spi_tx(void) {
+  for (size_t i = 0; i < 3; i++) {
+    uint32_t start = _test_spi_get_num_transactions();
+    TEST_ASSERT_OK(mcp2515_tx(&s_mcp2515, 0x123, false, 0x1122334455667788, 8));
+    TEST_ASSERT_EQUAL(2, _test_spi_get_num_transactions() - start);
+  }
+
+  uint32_t start = _test_spi_get_num_transactions();
+  TEST_ASSERT_OK(mcp2515_tx(&s_mcp2515, 0x1EADBEEF, true, 0x11, 1));
+  TEST_ASSERT_EQUAL(3, _test_spi_get_num_transactions() - start);
+}
+
+// An RX interrupt reads the flags, then the whole frame in one READ RX burst.
+void test_mcp2515_spi_rx(void) {
+  uint32_t start = _test_spi_get_num_transactions();
+  TEST_ASSERT_OK(gpio_it_trigger_interrupt(&s_int_pin));
+
+  TEST_ASSERT_EQUAL(1, s_num_rx);
+  TEST_ASSERT_EQUAL(2, _test_spi_get_num_transactions() - start);
+}
@@ -0,0 +1,147 @@
+#include "moving_stats.h"
+
+#include "log.h"
+#include "misc.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_LONG_WINDOW 8
+#define TEST_SHORT_WINDOW 2
+
+static int32_t s_buffer[TEST_LONG_WINDOW];
+static MovingStatsStorage s_storage;
+
+void setup_test(void) {
+  const MovingStatsSettings settings = {
+    .buffer = s_buffer,
+    .long_window = TEST_LONG_WINDOW,
+    .short_window = TEST_SHORT_WINDOW,
+    .ewma_shift = 2,
+  };
+  TEST_ASSERT_OK(moving_stats_init(&s_storage, &settings));
+}
+
+void teardown_test(void) {}
+
+void test_moving_stats_invalid_settings(void) {
+  MovingStatsSettings settings = {
+    .buffer = s_buffer,
+    .long_window = TEST_LONG_WINDOW,
+    .short_window = TEST_LONG_WINDOW + 1,
+  };
+  TEST_ASSERT_NOT_OK(moving_stats_init(&s_storage, &settings));
+
+  settings.short_window = 0;
+  TEST_ASSERT_NOT_OK(moving_stats_init(&s_storage, &settings));
+
+  settings.short_window = 1;
+  settings.buffer = NULL;
+  TEST_ASSERT_NOT_OK(moving_stats_init(&s_storage, &settings));
+
+  settings.buffer = s_buffer;
+  settings.ewma_shift = MOVING_STATS_MAX_EWMA_SHIFT + 1;
+  TEST_ASSERT_NOT_OK(moving_stats_init(&s_storage, &settings));
+}
+
+void test_moving_stats_empty(void) {
+  TEST_ASSERT_EQUAL(0, moving_stats_count(&s_storage));
+  TEST_ASSERT_EQUAL(0, moving_stats_long_average(&s_storage));
+  TEST_ASSERT_EQUAL(0, moving_stats_short_average(&s_storage));
+  TEST_ASSERT_EQUAL(0, moving_stats_ewma(&s_storage));
+  TEST_ASSERT_EQUAL(0, moving_stats_variance(&s_storage));
+}
+
+// Before the windows fill, statistics are over the samples received so far.
+void test_moving_stats_partial_window(void) {
+  moving_stats_push(&s_storage, 10);
+  TEST_ASSERT_EQUAL(1, moving_stats_count(&s_storage));
+  TEST_ASSERT_EQUAL(10, moving_stats_long_average(&s_storage));
+  TEST_ASSERT_EQUAL(10, moving_stats_short_average(&s_storage));
+  TEST_ASSERT_EQUAL(10, moving_stats_ewma(&s_storage));
+
+  moving_stats_push(&s_storage, 20);
+  moving_stats_push(&s_storage, 30);
+  TEST_ASSERT_EQUAL(3, moving_stats_count(&s_storage));
+  TEST_ASSERT_EQUAL(20, moving_stats_long_average(&s_storage));
+  TEST_ASSERT_EQUAL(25, moving_stats_short_average(&s_storage));
+}
+
+// Check the running sums against a brute force computation over many wraps of the ring.
+void test_moving_stats_matches_brute_force(void) {
+  int32_t history[100];
+  for (int32_t i = 0; i < (int32_t)SIZEOF_ARRAY(history); i++) {
+    // a deterministic, noisy, sign-changing sequence
+    history[i] = ((i * 7919) % 2001) - 1000;
+    moving_stats_push(&s_storage, history[i]);
+
+    int32_t n_long = MIN(i + 1, TEST_LONG_WINDOW);
+    int32_t n_short = MIN(i + 1, TEST_SHORT_WINDOW);
+    int64_t long_sum = 0;
+    int64_t short_sum = 0;
+    for (int32_t j = 0; j < n_long; j++) {
+      long_sum += history[i - j];
+      if (j < n_short) {
+        short_sum += history[i - j];
+      }
+    }
+    int64_t long_mean = long_sum / n_long;
+    int64_t squared_error = 0;
+    for (int32_t j = 0; j < n_long; j++) {
+      squared_error += (history[i - j] - long_mean) * (history[i - j] - long_mean);
+    }
+
+    TEST_ASSERT_EQUAL(long_mean, moving_stats_long_average(&s_storage));
+    TEST_ASSERT_EQUAL(short_sum / n_short, moving_stats_short_average(&s_storage));
+    // the brute force uses a truncated mean, so allow a little slack
+    TEST_ASSERT_UINT32_WITHIN(2, (uint32_t)(squared_error / n_long),
+                              moving_stats_variance(&s_storage));
+  }
+}
+
+// The short window reacts to a step before the long window does.
+void test_moving_stats_short_window_responds_first(void) {
+  for (uint16_t i = 0; i < TEST_LONG_WINDOW; i++) {
+    moving_stats_push(&s_storage, 0);
+  }
+  moving_stats_push(&s_storage, 1000);
+  moving_stats_push(&s_storage, 1000);
+  TEST_ASSERT_EQUAL(1000, moving_stats_short_average(&s_storage));
+  TEST_ASSERT_EQUAL(250, moving_stats_long_average(&s_storage));
+}
+
+void test_moving_stats_min_max(void) {
+  moving_stats_push(&s_storage, 5);
+  TEST_ASSERT_EQUAL(5, moving_stats_min(&s_storage));
+  TEST_ASSERT_EQUAL(5, moving_stats_max(&s_storage));
+
+  moving_stats_push(&s_storage, -3);
+  moving_stats_push(&s_storage, 12);
+  moving_stats_push(&s_storage, 4);
+  TEST_ASSERT_EQUAL(-3, moving_stats_min(&s_storage));
+  TEST_ASSERT_EQUAL(12, moving_stats_max(&s_storage));
+
+  moving_stats_reset(&s_storage);
+  moving_stats_push(&s_storage, 7);
+  TEST_ASSERT_EQUAL(7, moving_stats_min(&s_storage));
+  TEST_ASSERT_EQUAL(7, moving_stats_max(&s_storage));
+  TEST_ASSERT_EQUAL(1, moving_stats_count(&s_storage));
+}
+
+void test_moving_stats_ewma_converges(void) {
+  MovingStatsEwma ewma;
+  TEST_ASSERT_OK(moving_stats_ewma_init(&ewma, 3));
+  TEST_ASSERT_EQUAL(-400, moving_stats_ewma_push(&ewma, -400));
+
+  // each step closes 1/8 of the gap
+  TEST_ASSERT_EQUAL(-300, moving_stats_ewma_push(&ewma, 400));
+
+  for (uint8_t i = 0; i < 100; i++) {
+    moving_stats_ewma_push(&ewma, 400);
+  }
+  TEST_ASSERT_INT_WITHIN(1, 400, moving_stats_ewma_get(&ewma));
+
+  // a shift of 0 tracks the latest sample
+  TEST_ASSERT_OK(moving_stats_ewma_init(&ewma, 0));
+  moving_stats_ewma_push(&ewma, 10);
+  TEST_ASSERT_EQUAL(-20, moving_stats_ewma_push(&ewma, -20));
+}
@@ -7,6 +7,7 @@
 #include "unity.h"
 
 #define THERMISTOR_TEMPERATURE_TOLERANCE_DECICELSIUS 5
+#define THERMISTOR_ADC_LUT_TOLERANCE_DECICELSIUS 1
 
 // The tests cases return different voltage values depending on the inputted adc
 // channel inputs Each value is used for a different test case Channel 0~3 used
@@ -263,3 +264,34 @@ void test_resistance_lookup(void) {
   thermistor_calculate_resistance(755, &resistance);
   TEST_ASSERT_UINT16_WITHIN(1, 1897, resistance);
 }
+
+// The ADC LUT should agree with searching the resistance table for every code it accepts
+static void prv_test_adc_lut(ThermistorPosition position) {
+  ThermistorAdcLut lut;
+  TEST_ASSERT_OK(thermistor_adc_lut_init(&lut, position));
+  TEST_ASSERT_TRUE(lut.min_code < lut.max_code);
+
+  for (uint32_t code = lut.min_code; code <= lut.max_code; code++) {
+    uint32_t num = (position == THERMISTOR_POSITION_R1) ? THERMISTOR_ADC_MAX_CODE - code : code;
+    uint32_t den = THERMISTOR_ADC_MAX_CODE - num;
+    uint32_t resistance_ohms = (THERMISTOR_FIXED_RESISTANCE_OHMS * num + den / 2) / den;
+
+    uint16_t expected = 0;
+    uint16_t temperature = 0;
+    TEST_ASSERT_OK(thermistor_calculate_temp(resistance_ohms, &expected));
+    TEST_ASSERT_OK(thermistor_adc_lut_get_temp(&lut, (uint16_t)code, &temperature));
+    TEST_ASSERT_UINT16_WITHIN(THERMISTOR_ADC_LUT_TOLERANCE_DECICELSIUS, expected, temperature);
+  }
+
+  uint16_t temperature = 0;
+  TEST_ASSERT_EQUAL(STATUS_CODE_OUT_OF_RANGE,
+                    thermistor_adc_lut_get_temp(&lut, lut.min_code - 1, &temperature));
+  TEST_ASSERT_EQUAL(UINT16_MAX, temperature);
+  TEST_ASSERT_EQUAL(STATUS_CODE_OUT_OF_RANGE,
+                    thermistor_adc_lut_get_temp(&lut, lut.max_code + 1, &temperature));
+}
+
+void test_thermistor_adc_lut(void) {
+  prv_test_adc_lut(THERMISTOR_POSITION_R1);
+  prv_test_adc_lut(THERMISTOR_POSITION_R2);
+}
@@ -1,4 +1,9 @@
 #pragma once
 // Retargets standard IO to UART
+#include <stdint.h>
 
 void retarget_init(void);
+
+// Called by the hard fault handler with the faulting PC and LR before it breaks into the debugger.
+// Does nothing by default - define it elsewhere to record hard faults.
+void retarget_hard_fault_hook(uint32_t pc, uint32_t lr);
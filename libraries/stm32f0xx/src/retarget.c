@@ -52,6 +52,8 @@ int _write(int fd, char *ptr, int len) {
   return len;
 }
 
+__attribute__((weak)) void retarget_hard_fault_hook(uint32_t pc, uint32_t lr) {}
+
 __attribute__((naked, section(".hardfault"))) void HardFault_Handler(void) {
   // Get the appropriate stack pointer, depending on our mode,
   // and use it as the parameter to the C handler. This function
@@ -132,5 +134,7 @@ __attribute__((used, section(".hardfault"))) void HardFault_HandlerC(uint32_t *h
   printf("MMAR: 0x%lx\n", _MMAR);
   printf("BFAR: 0x%lx\n", _BFAR);
 
+  retarget_hard_fault_hook(stacked_pc, stacked_lr);
+
   __asm("BKPT #0\n");  // Break into the debugger
 }
@@ -1,5 +1,13 @@
 #pragma once
-
+// Emulates interrupts on x86. By default, interrupts are realtime signals
+// (SIGRTMIN + priority) handled on top of whichever thread doesn't block them.
+//
+// Building with X86_INTERRUPT_DISPATCHER (implied by COPTIONS=tsan) runs them on a
+// dispatcher thread instead, so handlers aren't subject to signal handler
+// restrictions and nothing else sees EINTR. The main thread is only preempted at
+// critical section boundaries - see x86_interrupt.c.
+
+#include <signal.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <sys/types.h>
@@ -26,9 +34,21 @@ StatusCode x86_interrupt_register_interrupt(uint8_t handler_id, const InterruptS
 // Triggers a software interrupt by interrupt_id.
 StatusCode x86_interrupt_trigger(uint8_t interrupt_id);
 
-// Configures the block mask on the signal handler for critical sections.
-void x86_interrupt_mask(void);
-void x86_interrupt_unmask(void);
+// Blocks interrupts on the calling thread for critical sections. The previous
+// signal mask is stored in |prev_mask| so it can be restored with
+// x86_interrupt_unmask().
+void x86_interrupt_mask(sigset_t *prev_mask);
+void x86_interrupt_unmask(const sigset_t *prev_mask);
+
+// Returns true if no interrupt can currently preempt the calling thread, i.e. it
+// permanently blocks them or is running a high priority handler. Doesn't make a
+// syscall.
+bool x86_interrupt_masked(void);
+
+// Keeps other threads, including the interrupt dispatcher, out until the
+// matching unlock. Nests per-thread. Pending interrupts may run on unlock.
+void x86_interrupt_lock(void);
+void x86_interrupt_unlock(void);
 
 // Inits the correct signal mask on a pthread.
 void x86_interrupt_pthread_init(void);
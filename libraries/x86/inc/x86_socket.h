@@ -9,9 +9,11 @@
 #define X86_SOCKET_MAX_PENDING_CONNECTIONS 3
 #define X86_SOCKET_RX_BUFFER_LEN 1024
 
-// client_fd provided to allow reply to specific client
+// client_fd provided to allow reply to specific client. |rx_data| is the
+// client's own buffer, null terminated after |rx_len| bytes - it can be parsed in
+// place, but is only valid until the handler returns.
 struct X86SocketThread;
-typedef void (*X86SocketHandler)(struct X86SocketThread *thread, int client_fd, const char *rx_data,
+typedef void (*X86SocketHandler)(struct X86SocketThread *thread, int client_fd, char *rx_data,
                                  size_t rx_len, void *context);
 
 typedef struct X86SocketThread {
@@ -23,6 +25,8 @@ typedef struct X86SocketThread {
   void *context;
 
   int client_fds[X86_SOCKET_MAX_CLIENTS];
+  // Fixed per-client buffers so nothing is allocated per message
+  char rx_buffers[X86_SOCKET_MAX_CLIENTS][X86_SOCKET_RX_BUFFER_LEN + 1];
 } X86SocketThread;
 
 // Initializes server thread on @[pid]/[progname]/module_name
@@ -1,8 +1,17 @@
 #include "x86_cmd.h"
+#include <assert.h>
 #include <stddef.h>
-#include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include "log.h"
+#include "misc.h"
+
+// Open addressing - keeping the table at most half full keeps probes short
+#define X86_CMD_TABLE_SIZE (2 * X86_CMD_MAX_HANDLERS)
+#define X86_CMD_TABLE_MASK (X86_CMD_TABLE_SIZE - 1)
+
+static_assert((X86_CMD_TABLE_SIZE & X86_CMD_TABLE_MASK) == 0,
+              "X86_CMD_MAX_HANDLERS must be a power of 2");
 
 typedef struct X86CmdHandler {
   const char *cmd;
@@ -12,44 +21,75 @@ typedef struct X86CmdHandler {
 
 typedef struct X86CmdThread {
   X86SocketThread socket;
-  X86CmdHandler handlers[X86_CMD_MAX_HANDLERS];
+  X86CmdHandler handlers[X86_CMD_TABLE_SIZE];
   size_t num_handlers;
 } X86CmdThread;
 
 static X86CmdThread s_cmd_thread;
 
-static void prv_socket_handler(struct X86SocketThread *thread, int client_fd, const char *rx_data,
+// FNV-1a
+static uint32_t prv_hash(const char *str) {
+  uint32_t hash = 2166136261u;
+  while (*str != '\0') {
+    hash ^= (uint8_t)*str++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Returns the slot holding |cmd|, or the empty slot it would go in
+static X86CmdHandler *prv_find_slot(X86CmdThread *thread, const char *cmd) {
+  uint32_t hash = prv_hash(cmd);
+  for (uint32_t i = 0; i < X86_CMD_TABLE_SIZE; i++) {
+    X86CmdHandler *handler = &thread->handlers[(hash + i) & X86_CMD_TABLE_MASK];
+    if (handler->cmd == NULL || strcmp(handler->cmd, cmd) == 0) {
+      return handler;
+    }
+  }
+  return NULL;
+}
+
+// Splits |buf| on spaces and newlines in place. Tokens past |max_tokens| are
+// ignored. Returns the number of tokens.
+static size_t prv_tokenize(char *buf, const char *tokens[], size_t max_tokens) {
+  size_t num_tokens = 0;
+  while (num_tokens < max_tokens) {
+    while (*buf == ' ' || *buf == '\n') {
+      buf++;
+    }
+    if (*buf == '\0') {
+      break;
+    }
+
+    tokens[num_tokens++] = buf;
+    while (*buf != '\0' && *buf != ' ' && *buf != '\n') {
+      buf++;
+    }
+    if (*buf != '\0') {
+      *buf++ = '\0';
+    }
+  }
+  return num_tokens;
+}
+
+static void prv_socket_handler(struct X86SocketThread *thread, int client_fd, char *rx_data,
                                size_t rx_len, void *context) {
   X86CmdThread *cmd_thread = context;
 
   LOG_DEBUG("Received command %s\n", rx_data);
 
-  // Data will be mangled by strtok - make sure we always end with a null
-  // terminator
-  char *buf = malloc(rx_len + 1);
-  buf[rx_len] = '\0';
-
-  const char *args[X86_CMD_MAX_ARGS] = { 0 };
-  strncpy(buf, rx_data, rx_len);
-
-  // Don't support more than one command per packet
-  char *save_ptr = NULL;
-  const char *cmd_word = strtok_r(buf, " \n", &save_ptr);
-  size_t num_args = 0;
-  while (num_args < X86_CMD_MAX_ARGS &&
-         (args[num_args] = strtok_r(NULL, " \n", &save_ptr)) != NULL) {
-    num_args++;
+  // The socket null terminates the data, so it can be split where it is. Don't
+  // support more than one command per packet.
+  const char *tokens[X86_CMD_MAX_ARGS + 1] = { 0 };
+  size_t num_tokens = prv_tokenize(rx_data, tokens, SIZEOF_ARRAY(tokens));
+  if (num_tokens == 0) {
+    return;
   }
 
-  for (size_t i = 0; i < cmd_thread->num_handlers; i++) {
-    if (strcmp(cmd_thread->handlers[i].cmd, cmd_word) == 0) {
-      cmd_thread->handlers[i].fn(client_fd, cmd_word, args, num_args,
-                                 cmd_thread->handlers[i].context);
-      break;
-    }
+  X86CmdHandler *handler = prv_find_slot(cmd_thread, tokens[0]);
+  if (handler != NULL && handler->cmd != NULL) {
+    handler->fn(client_fd, tokens[0], &tokens[1], num_tokens - 1, handler->context);
   }
-
-  free(buf);
 }
 
 void x86_cmd_init(void) {
@@ -59,11 +99,18 @@ void x86_cmd_init(void) {
 StatusCode x86_cmd_register_handler(const char *cmd, X86CmdHandlerFn fn, void *context) {
   X86CmdThread *thread = &s_cmd_thread;
 
-  if (thread->num_handlers >= X86_CMD_MAX_HANDLERS) {
+  if (cmd == NULL || fn == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  } else if (thread->num_handlers >= X86_CMD_MAX_HANDLERS) {
     return status_code(STATUS_CODE_RESOURCE_EXHAUSTED);
   }
 
-  thread->handlers[thread->num_handlers] = (X86CmdHandler){
+  X86CmdHandler *handler = prv_find_slot(thread, cmd);
+  if (handler->cmd != NULL) {
+    return status_msg(STATUS_CODE_INVALID_ARGS, "Command already registered");
+  }
+
+  *handler = (X86CmdHandler){
     .cmd = cmd,         //
     .fn = fn,           //
     .context = context  //
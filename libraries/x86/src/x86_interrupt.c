@@ -8,6 +8,13 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#ifdef X86_INTERRUPT_DISPATCHER
+#include <poll.h>
+#include <stdatomic.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#endif
+
 #include "interrupt_def.h"
 #include "log.h"
 #include "status.h"
@@ -15,22 +22,22 @@
 #define NUM_X86_INTERRUPT_HANDLERS 64
 #define NUM_X86_INTERRUPT_INTERRUPTS 128
 
-typedef enum {
-  X86_INTERRUPT_STATE_NONE = 0,
-  X86_INTERRUPT_STATE_MASK,
-  X86_INTERRUPT_STATE_UNMASK,
-} X86InterruptState;
-
 typedef struct Interrupt {
   InterruptPriority priority;
   uint8_t handler_id;
   bool is_event;
 } Interrupt;
 
-static bool s_in_handler_flag = false;
-static X86InterruptState s_interrupt_state_update = X86_INTERRUPT_STATE_NONE;
+// Priority of the handler running on this thread, or NUM_INTERRUPT_PRIORITIES
+// outside of one.
+static __thread InterruptPriority s_handler_priority = NUM_INTERRUPT_PRIORITIES;
+// Set on threads that never run interrupts (see x86_interrupt_pthread_init()).
+static __thread bool s_thread_masked = false;
 
-static pid_t s_pid = 0;
+// Keeps threads out of each other's critical sections. The depth is per-thread
+// so the mutex is only taken at the outermost level.
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread uint32_t s_lock_depth = 0;
 
 static uint8_t s_x86_interrupt_next_interrupt_id = 0;
 static uint8_t s_x86_interrupt_next_handler_id = 0;
@@ -38,55 +45,315 @@ static uint8_t s_x86_interrupt_next_handler_id = 0;
 static Interrupt s_x86_interrupt_interrupts_map[NUM_X86_INTERRUPT_INTERRUPTS];
 static x86InterruptHandler s_x86_interrupt_handlers[NUM_X86_INTERRUPT_HANDLERS];
 
-// Signal handler for all interrupts. Prioritization is handled by the
-// implementation of signals and the init function. Signals of higher priority
-// interrupt the running of this function. All other signals are stored in a
-// pqueue and are executed in order of priority then arrival. Runs the handler
-// associated with the interrupt id it receives via the sival_int.
-static void prv_sig_handler(int signum, siginfo_t *info, void *ptr) {
-  (void)signum;
-  (void)ptr;
-  s_in_handler_flag = true;
-  if (info->si_value.sival_int < NUM_X86_INTERRUPT_INTERRUPTS) {
+static void prv_interrupt_signals(sigset_t *set) {
+  sigemptyset(set);
+  sigaddset(set, SIGRTMIN + INTERRUPT_PRIORITY_LOW);
+  sigaddset(set, SIGRTMIN + INTERRUPT_PRIORITY_NORMAL);
+  sigaddset(set, SIGRTMIN + INTERRUPT_PRIORITY_HIGH);
+}
+
+// Runs the handler associated with the interrupt id.
+static void prv_run_isr(InterruptPriority priority, int interrupt_id) {
+  // Handlers nest, so restore the preempted handler's priority on the way out
+  InterruptPriority prev_priority = s_handler_priority;
+  s_handler_priority = priority;
+  if (interrupt_id >= 0 && interrupt_id < s_x86_interrupt_next_interrupt_id) {
     // If the interrupt is an event don't run the handler as it is just a wake
     // event.
-    if (!s_x86_interrupt_interrupts_map[info->si_value.sival_int].is_event) {
+    if (!s_x86_interrupt_interrupts_map[interrupt_id].is_event) {
       // Execute the handler passing it the interrupt ID. To determine which
       // handler look up in the interrupts map by interrupt ID.
-      s_x86_interrupt_handlers[s_x86_interrupt_interrupts_map[info->si_value.sival_int].handler_id](
-          info->si_value.sival_int);
+      s_x86_interrupt_handlers[s_x86_interrupt_interrupts_map[interrupt_id].handler_id](
+          (uint8_t)interrupt_id);
     }
   }
-  s_in_handler_flag = false;
+  s_handler_priority = prev_priority;
 }
 
-// Blocks all interrupts (excluding signals to block/unblock interrupts) when
-// triggered. Should use signal number |SIGRTMIN + NUM_INTERRUPT_PRIORITIES| to
-// trigger. This has to be run as a signal handler since a thread can only
-// manipulate its own signal mask or its children up until the point they are
-// spawned. As a result the signal handling thread MUST be interrupted in order
-// to change its signal mask in the event of a critical section.
-static void prv_sig_state_handler(int signum, siginfo_t *info, void *ptr) {
-  (void)signum;
-  // We actually need to manipulate the block mask of the context that is
-  // restored for this thread. So we alter |ctx| rather than directly calling
-  // |pthread_sigmask| as this gets overridden on context switch after exiting
-  // the handler.
-  ucontext_t *ctx = ptr;
+#ifdef X86_INTERRUPT_DISPATCHER
+// Interrupts are posted to a lock-free queue per priority and run one at a time
+// by a dispatcher thread, which holds the lock while it runs them. Every thread
+// blocks the interrupt signals, so the soft timers' signals are read by the
+// dispatcher through a signalfd instead of interrupting a thread.
+//
+// Like on the NVIC, pending interrupts run highest priority first, then in the
+// order they were triggered. The main thread is only "preempted" at critical
+// section boundaries: when it triggers an interrupt or ends its outermost
+// critical section, it waits for the interrupts pending at that point to run.
+
+// Must be a power of 2
+#define X86_INTERRUPT_QUEUE_LEN 256
+#define X86_INTERRUPT_QUEUE_MASK (X86_INTERRUPT_QUEUE_LEN - 1)
+
+// Bounded multi-producer queue: each cell's sequence number says whether it's
+// free to write (== tail) or ready to read (== head + 1).
+typedef struct X86InterruptQueueCell {
+  atomic_size_t seq;
+  uint8_t interrupt_id;
+} X86InterruptQueueCell;
+
+typedef struct X86InterruptQueue {
+  X86InterruptQueueCell cells[X86_INTERRUPT_QUEUE_LEN];
+  atomic_size_t tail;
+  // Only touched by the dispatcher
+  size_t head;
+} X86InterruptQueue;
+
+static X86InterruptQueue s_queues[NUM_INTERRUPT_PRIORITIES];
+static pthread_t s_dispatcher;
+static bool s_dispatcher_started = false;
+static int s_wake_fd = -1;
+static int s_signal_fd = -1;
+static atomic_bool s_dispatcher_sleeping;
+
+// Used to wait for pending interrupts - the counts are free-running
+static atomic_uint s_num_posted;
+static atomic_uint s_num_run;
+static atomic_uint s_num_waiters;
+static pthread_mutex_t s_wait_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_wait_cond = PTHREAD_COND_INITIALIZER;
+
+static bool prv_queue_push(X86InterruptQueue *queue, uint8_t interrupt_id) {
+  size_t pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  X86InterruptQueueCell *cell = NULL;
+  while (true) {
+    cell = &queue->cells[pos & X86_INTERRUPT_QUEUE_MASK];
+    size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+    ssize_t diff = (ssize_t)seq - (ssize_t)pos;
+    if (diff == 0) {
+      // Claim the cell
+      if (atomic_compare_exchange_weak_explicit(&queue->tail, &pos, pos + 1,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // Full
+      return false;
+    } else {
+      // Another producer claimed it first
+      pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    }
+  }
 
-  // Based on the sival_int change the state of interrupts. If invalid number
-  // silently ignore.
-  if (info->si_value.sival_int == X86_INTERRUPT_STATE_MASK) {
-    sigaddset(&ctx->uc_sigmask, SIGRTMIN + INTERRUPT_PRIORITY_LOW);
-    sigaddset(&ctx->uc_sigmask, SIGRTMIN + INTERRUPT_PRIORITY_NORMAL);
-    sigaddset(&ctx->uc_sigmask, SIGRTMIN + INTERRUPT_PRIORITY_HIGH);
-  } else if (info->si_value.sival_int == X86_INTERRUPT_STATE_UNMASK) {
-    sigdelset(&ctx->uc_sigmask, SIGRTMIN + INTERRUPT_PRIORITY_LOW);
-    sigdelset(&ctx->uc_sigmask, SIGRTMIN + INTERRUPT_PRIORITY_NORMAL);
-    sigdelset(&ctx->uc_sigmask, SIGRTMIN + INTERRUPT_PRIORITY_HIGH);
+  cell->interrupt_id = interrupt_id;
+  atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+  return true;
+}
+
+static X86InterruptQueueCell *prv_queue_peek(X86InterruptQueue *queue) {
+  X86InterruptQueueCell *cell = &queue->cells[queue->head & X86_INTERRUPT_QUEUE_MASK];
+  size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+  return (seq == queue->head + 1) ? cell : NULL;
+}
+
+static bool prv_queue_pop(X86InterruptQueue *queue, uint8_t *interrupt_id) {
+  X86InterruptQueueCell *cell = prv_queue_peek(queue);
+  if (cell == NULL) {
+    return false;
   }
+  *interrupt_id = cell->interrupt_id;
+  // Free the cell for the producer one lap ahead
+  atomic_store_explicit(&cell->seq, queue->head + X86_INTERRUPT_QUEUE_LEN, memory_order_release);
+  queue->head++;
+  return true;
+}
+
+static bool prv_pending(void) {
+  for (size_t i = 0; i < NUM_INTERRUPT_PRIORITIES; i++) {
+    if (prv_queue_peek(&s_queues[i]) != NULL) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static StatusCode prv_post(InterruptPriority priority, uint8_t interrupt_id) {
+  if (!prv_queue_push(&s_queues[priority], interrupt_id)) {
+    return status_msg(STATUS_CODE_RESOURCE_EXHAUSTED, "Interrupt queue full");
+  }
+  atomic_fetch_add(&s_num_posted, 1);
+
+  // Pairs with the fence in the dispatcher so it either sees the interrupt
+  // before sleeping or we see it sleeping
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load(&s_dispatcher_sleeping)) {
+    uint64_t wake = 1;
+    write(s_wake_fd, &wake, sizeof(wake));
+  }
+  return STATUS_CODE_OK;
+}
+
+static void prv_read_signals(void) {
+  struct signalfd_siginfo info;
+  while (read(s_signal_fd, &info, sizeof(info)) == (ssize_t)sizeof(info)) {
+    int priority = (int)info.ssi_signo - SIGRTMIN;
+    if (priority >= 0 && priority < NUM_INTERRUPT_PRIORITIES && info.ssi_int >= 0 &&
+        info.ssi_int < NUM_X86_INTERRUPT_INTERRUPTS) {
+      prv_post((InterruptPriority)priority, (uint8_t)info.ssi_int);
+    }
+  }
+}
+
+static bool prv_run_next(void) {
+  // Only pick the interrupt once the lock is ours, since higher priority ones can
+  // be triggered while a critical section holds us off
+  x86_interrupt_lock();
+  // Enum order is highest priority first
+  for (size_t i = 0; i < NUM_INTERRUPT_PRIORITIES; i++) {
+    uint8_t interrupt_id = 0;
+    if (prv_queue_pop(&s_queues[i], &interrupt_id)) {
+      prv_run_isr((InterruptPriority)i, interrupt_id);
+      x86_interrupt_unlock();
+
+      atomic_fetch_add(&s_num_run, 1);
+      if (atomic_load(&s_num_waiters) > 0) {
+        pthread_mutex_lock(&s_wait_lock);
+        pthread_cond_broadcast(&s_wait_cond);
+        pthread_mutex_unlock(&s_wait_lock);
+      }
+      return true;
+    }
+  }
+  x86_interrupt_unlock();
+  return false;
+}
+
+static void *prv_dispatcher_thread(void *arg) {
+  x86_interrupt_pthread_init();
+  LOG_DEBUG("Interrupt dispatcher thread started\n");
+
+  struct pollfd fds[] = {
+    { .fd = s_wake_fd, .events = POLLIN },
+    { .fd = s_signal_fd, .events = POLLIN },
+  };
+  while (true) {
+    if (prv_run_next()) {
+      continue;
+    }
+
+    // Stale results from the last poll would read the wake fd when nothing woke us
+    fds[0].revents = 0;
+    fds[1].revents = 0;
+
+    atomic_store(&s_dispatcher_sleeping, true);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!prv_pending()) {
+      poll(fds, 2, -1);
+    }
+    atomic_store(&s_dispatcher_sleeping, false);
+
+    if (fds[0].revents & POLLIN) {
+      // Nonblocking, so a wake already consumed just fails with EAGAIN
+      uint64_t wakes = 0;
+      read(s_wake_fd, &wakes, sizeof(wakes));
+    }
+    if (fds[1].revents & POLLIN) {
+      prv_read_signals();
+    }
+  }
+
+  return NULL;
+}
+
+static void prv_start_dispatcher(void) {
+  for (size_t i = 0; i < NUM_INTERRUPT_PRIORITIES; i++) {
+    for (size_t j = 0; j < X86_INTERRUPT_QUEUE_LEN; j++) {
+      atomic_init(&s_queues[i].cells[j].seq, j);
+    }
+    atomic_init(&s_queues[i].tail, 0);
+    s_queues[i].head = 0;
+  }
+
+  // Block the signals on this thread before anything else is spawned so every
+  // thread inherits it, leaving the signals to the signalfd
+  sigset_t signals;
+  prv_interrupt_signals(&signals);
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+  s_signal_fd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+  s_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (s_signal_fd < 0 || s_wake_fd < 0) {
+    LOG_CRITICAL("Failed to create interrupt dispatcher fds\n");
+    return;
+  }
+
+  pthread_create(&s_dispatcher, NULL, prv_dispatcher_thread, NULL);
+  s_dispatcher_started = true;
+}
+
+// Waits for the interrupts pending on the dispatcher to run, as if they had
+// preempted the calling thread.
+static void prv_preempt(void) {
+  if (s_thread_masked || s_handler_priority != NUM_INTERRUPT_PRIORITIES) {
+    // Other threads and handlers don't get preempted
+    return;
+  }
+
+  unsigned int target = atomic_load(&s_num_posted);
+  if ((int)(atomic_load(&s_num_run) - target) >= 0) {
+    return;
+  }
+
+  atomic_fetch_add(&s_num_waiters, 1);
+  pthread_mutex_lock(&s_wait_lock);
+  while ((int)(atomic_load(&s_num_run) - target) < 0) {
+    pthread_cond_wait(&s_wait_cond, &s_wait_lock);
+  }
+  pthread_mutex_unlock(&s_wait_lock);
+  atomic_fetch_sub(&s_num_waiters, 1);
 }
 
+void x86_interrupt_init(void) {
+  // Log the main thread ID for debugging.
+  LOG_DEBUG("Main Thread (id:%ld)\n", pthread_self());
+
+  if (!s_dispatcher_started) {
+    prv_start_dispatcher();
+  }
+
+  // Stale interrupts can still be pending, so only clear statics while the
+  // dispatcher isn't running one. They're dropped since their ids are gone.
+  x86_interrupt_lock();
+  s_handler_priority = NUM_INTERRUPT_PRIORITIES;
+  s_x86_interrupt_next_interrupt_id = 0;
+  s_x86_interrupt_next_handler_id = 0;
+  memset(&s_x86_interrupt_interrupts_map, 0, sizeof(s_x86_interrupt_interrupts_map));
+  memset(&s_x86_interrupt_handlers, 0, sizeof(s_x86_interrupt_handlers));
+  x86_interrupt_unlock();
+}
+
+StatusCode x86_interrupt_trigger(uint8_t interrupt_id) {
+  if (interrupt_id >= s_x86_interrupt_next_interrupt_id) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  status_ok_or_return(prv_post(s_x86_interrupt_interrupts_map[interrupt_id].priority,
+                               interrupt_id));
+  if (s_lock_depth == 0) {
+    // Interrupts aren't disabled, so they run right away
+    prv_preempt();
+  }
+  return STATUS_CODE_OK;
+}
+
+bool x86_interrupt_masked(void) {
+  // Interrupts never run on top of a thread
+  return true;
+}
+#else
+static pid_t s_pid = 0;
+
+// Signal handler for all interrupts. Prioritization is handled by the
+// implementation of signals and the init function. Signals of higher priority
+// interrupt the running of this function. All other signals are stored in a
+// pqueue and are executed in order of priority then arrival.
+static void prv_sig_handler(int signum, siginfo_t *info, void *ptr) {
+  (void)ptr;
+  prv_run_isr((InterruptPriority)(signum - SIGRTMIN), info->si_value.sival_int);
+}
+
+// Handlers run on top of the interrupted thread, so there's nothing to wait for
+static void prv_preempt(void) {}
+
 void x86_interrupt_init(void) {
   // Log the main thread ID for debugging.
   LOG_DEBUG("Main Thread (id:%ld)\n", pthread_self());
@@ -122,28 +389,44 @@ void x86_interrupt_init(void) {
   act.sa_mask = block_mask;
   sigaction(SIGRTMIN + INTERRUPT_PRIORITY_HIGH, &act, NULL);
 
-  // Add a rule for the masking (critical sectioning) of the signals.
-  act.sa_mask = block_mask;
-  act.sa_sigaction = prv_sig_state_handler;
-  sigaction(SIGRTMIN + NUM_INTERRUPT_PRIORITIES, &act, NULL);
-
   // Clear statics.
-  s_interrupt_state_update = X86_INTERRUPT_STATE_NONE;
-  s_in_handler_flag = false;
+  s_handler_priority = NUM_INTERRUPT_PRIORITIES;
   s_x86_interrupt_next_interrupt_id = 0;
   s_x86_interrupt_next_handler_id = 0;
   memset(&s_x86_interrupt_interrupts_map, 0, sizeof(s_x86_interrupt_interrupts_map));
   memset(&s_x86_interrupt_handlers, 0, sizeof(s_x86_interrupt_handlers));
 }
 
+StatusCode x86_interrupt_trigger(uint8_t interrupt_id) {
+  if (interrupt_id >= s_x86_interrupt_next_interrupt_id) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  // Enqueue a new signal sent to this process that has a signal number
+  // determined by the id for the callback it is going to run.
+  siginfo_t value_store;
+  value_store.si_value.sival_int = interrupt_id;
+  sigqueue(s_pid, SIGRTMIN + (int)s_x86_interrupt_interrupts_map[interrupt_id].priority,
+           value_store.si_value);
+
+  return STATUS_CODE_OK;
+}
+
+bool x86_interrupt_masked(void) {
+  return s_thread_masked || s_handler_priority == INTERRUPT_PRIORITY_HIGH;
+}
+#endif
+
 StatusCode x86_interrupt_register_handler(x86InterruptHandler handler, uint8_t *handler_id) {
   if (s_x86_interrupt_next_handler_id >= NUM_X86_INTERRUPT_HANDLERS) {
     return status_code(STATUS_CODE_RESOURCE_EXHAUSTED);
   }
 
+  x86_interrupt_lock();
   *handler_id = s_x86_interrupt_next_handler_id;
   s_x86_interrupt_next_handler_id++;
   s_x86_interrupt_handlers[*handler_id] = handler;
+  x86_interrupt_unlock();
 
   return STATUS_CODE_OK;
 }
@@ -157,53 +440,57 @@ StatusCode x86_interrupt_register_interrupt(uint8_t handler_id, const InterruptS
     return status_code(STATUS_CODE_RESOURCE_EXHAUSTED);
   }
 
-  *interrupt_id = s_x86_interrupt_next_interrupt_id;
-  s_x86_interrupt_next_interrupt_id++;
   Interrupt interrupt = {
     .priority = settings->priority, .handler_id = handler_id, .is_event = (bool)settings->type
   };
+  x86_interrupt_lock();
+  *interrupt_id = s_x86_interrupt_next_interrupt_id;
   s_x86_interrupt_interrupts_map[*interrupt_id] = interrupt;
-
-  return STATUS_CODE_OK;
-}
-
-StatusCode x86_interrupt_trigger(uint8_t interrupt_id) {
-  if (interrupt_id >= s_x86_interrupt_next_interrupt_id) {
-    return status_code(STATUS_CODE_INVALID_ARGS);
-  }
-
-  // Enqueue a new signal sent to this process that has a signal number
-  // determined by the id for the callback it is going to run.
-  siginfo_t value_store;
-  value_store.si_value.sival_int = interrupt_id;
-  sigqueue(s_pid, SIGRTMIN + (int)s_x86_interrupt_interrupts_map[interrupt_id].priority,
-           value_store.si_value);
+  s_x86_interrupt_next_interrupt_id++;
+  x86_interrupt_unlock();
 
   return STATUS_CODE_OK;
 }
 
 void x86_interrupt_pthread_init(void) {
   sigset_t block_mask;
-  sigemptyset(&block_mask);
-  sigaddset(&block_mask, SIGRTMIN + INTERRUPT_PRIORITY_LOW);
-  sigaddset(&block_mask, SIGRTMIN + INTERRUPT_PRIORITY_NORMAL);
-  sigaddset(&block_mask, SIGRTMIN + INTERRUPT_PRIORITY_HIGH);
-  sigaddset(&block_mask, SIGRTMIN + NUM_INTERRUPT_PRIORITIES);
+  prv_interrupt_signals(&block_mask);
   pthread_sigmask(SIG_BLOCK, &block_mask, NULL);
+  s_thread_masked = true;
 }
 
-void x86_interrupt_mask(void) {
-  siginfo_t value_store;
-  value_store.si_value.sival_int = X86_INTERRUPT_STATE_MASK;
-  sigqueue(s_pid, SIGRTMIN + NUM_INTERRUPT_PRIORITIES, value_store.si_value);
+void x86_interrupt_mask(sigset_t *prev_mask) {
+  // Interrupts are delivered to the process, but only threads that don't block
+  // them run the handlers. Blocking them on this thread is enough since the
+  // others block them permanently. Like on an embedded device, they still queue.
+  sigset_t block_mask;
+  prv_interrupt_signals(&block_mask);
+  pthread_sigmask(SIG_BLOCK, &block_mask, prev_mask);
 }
 
-void x86_interrupt_unmask(void) {
-  siginfo_t value_store;
-  value_store.si_value.sival_int = X86_INTERRUPT_STATE_UNMASK;
-  sigqueue(s_pid, SIGRTMIN + NUM_INTERRUPT_PRIORITIES, value_store.si_value);
+void x86_interrupt_unmask(const sigset_t *prev_mask) {
+  pthread_sigmask(SIG_SETMASK, prev_mask, NULL);
+}
+
+void x86_interrupt_lock(void) {
+  if (s_lock_depth++ == 0) {
+    pthread_mutex_lock(&s_lock);
+  }
+}
+
+void x86_interrupt_unlock(void) {
+  if (s_lock_depth == 0) {
+    return;
+  }
+
+  s_lock_depth--;
+  if (s_lock_depth == 0) {
+    pthread_mutex_unlock(&s_lock);
+    // Interrupts that were held off can run now
+    prv_preempt();
+  }
 }
 
 bool x86_interrupt_in_handler(void) {
-  return s_in_handler_flag;
+  return s_handler_priority != NUM_INTERRUPT_PRIORITIES;
 }
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
@@ -12,7 +13,8 @@
 #include "x86_interrupt.h"
 
 #define X86_SOCKET_INVALID_FD -1
-#define X86_SOCKET_BUFFER_LEN 1024
+// epoll tag for the server socket - clients are tagged with their slot
+#define X86_SOCKET_SERVER_SLOT X86_SOCKET_MAX_CLIENTS
 
 // glibc - http://man7.org/linux/man-pages/man3/program_invocation_name.3.html
 extern char *program_invocation_short_name;
@@ -41,6 +43,41 @@ static StatusCode prv_setup_socket(X86SocketThread *thread, int *server_fd) {
   return STATUS_CODE_OK;
 }
 
+static void prv_add_client(X86SocketThread *thread, int epoll_fd, int client_fd) {
+  for (uint32_t i = 0; i < X86_SOCKET_MAX_CLIENTS; i++) {
+    if (thread->client_fds[i] == X86_SOCKET_INVALID_FD) {
+      // Tag the client with its slot so events don't need to search for it
+      struct epoll_event event = { .events = EPOLLIN, .data.u32 = i };
+      if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_fd, &event) < 0) {
+        break;
+      }
+      thread->client_fds[i] = client_fd;
+      LOG_DEBUG("New client %d connected to %s!\n", client_fd, thread->module_name);
+      return;
+    }
+  }
+
+  LOG_DEBUG("Rejecting client %d on %s - too many clients\n", client_fd, thread->module_name);
+  close(client_fd);
+}
+
+static void prv_handle_client(X86SocketThread *thread, uint32_t slot) {
+  int client_fd = thread->client_fds[slot];
+  char *buffer = thread->rx_buffers[slot];
+  // SEQPACKET gives us one message per read - leave room to null terminate it
+  ssize_t read_len = read(client_fd, buffer, X86_SOCKET_RX_BUFFER_LEN);
+  if (read_len <= 0) {
+    // Disconnected - closing the fd also removes it from the epoll set
+    LOG_DEBUG("Client %d disconnected from %s\n", client_fd, thread->module_name);
+    close(client_fd);
+    thread->client_fds[slot] = X86_SOCKET_INVALID_FD;
+    return;
+  }
+
+  buffer[read_len] = '\0';
+  thread->handler(thread, client_fd, buffer, (size_t)read_len, thread->context);
+}
+
 static void *prv_server_thread(void *context) {
   X86SocketThread *thread = context;
 
@@ -52,60 +89,38 @@ static void *prv_server_thread(void *context) {
     return NULL;
   }
 
+  int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  struct epoll_event server_event = { .events = EPOLLIN, .data.u32 = X86_SOCKET_SERVER_SLOT };
+  if (epoll_fd < 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server_fd, &server_event) < 0) {
+    LOG_DEBUG("Failed to set up epoll for %s\n", thread->module_name);
+    return NULL;
+  }
+
   LOG_DEBUG("Started RX server for %s (PID %d)\n", thread->module_name, getpid());
   pthread_barrier_wait(&thread->barrier);
 
   // Mutex unlocked when thread should exit
   while (pthread_mutex_trylock(&thread->keep_alive) != 0) {
-    // Build new fd set - select will mangle it
-    fd_set read_fds;
-    FD_ZERO(&read_fds);
-    FD_SET(server_fd, &read_fds);
-    int max_fd = server_fd;
-
-    for (int i = 0; i < X86_SOCKET_MAX_CLIENTS; i++) {
-      if (thread->client_fds[i] != X86_SOCKET_INVALID_FD) {
-        FD_SET(thread->client_fds[i], &read_fds);
-        max_fd = MAX(max_fd, thread->client_fds[i]);
-      }
-    }
-
-    select(max_fd + 1, &read_fds, NULL, NULL, NULL);
-
-    if (FD_ISSET(server_fd, &read_fds)) {
-      // Server read - new client
-      int new_socket = accept(server_fd, NULL, NULL);
-      if (new_socket < 0) {
-        LOG_DEBUG("Failed to accept new client!\n");
-      }
-      LOG_DEBUG("New client %d connected to %s!\n", new_socket, thread->module_name);
-
-      for (size_t i = 0; i < X86_SOCKET_MAX_CLIENTS; i++) {
-        if (thread->client_fds[i] == X86_SOCKET_INVALID_FD) {
-          thread->client_fds[i] = new_socket;
-          break;
-        }
-      }
-    }
-
-    // Handle client reads
-    for (size_t i = 0; i < X86_SOCKET_MAX_CLIENTS; i++) {
-      int client_fd = thread->client_fds[i];
-      if (client_fd != X86_SOCKET_INVALID_FD && FD_ISSET(client_fd, &read_fds)) {
-        char buffer[X86_SOCKET_BUFFER_LEN] = { 0 };
-        ssize_t read_len = read(client_fd, buffer, X86_SOCKET_BUFFER_LEN);
-        if (read_len <= 0) {
-          // Disconnected
-          LOG_DEBUG("Client %d disconnected from %s\n", client_fd, thread->module_name);
-          close(client_fd);
-          thread->client_fds[i] = X86_SOCKET_INVALID_FD;
+    struct epoll_event events[X86_SOCKET_MAX_CLIENTS + 1];
+    int num_events = epoll_wait(epoll_fd, events, (int)SIZEOF_ARRAY(events), -1);
+
+    for (int i = 0; i < num_events; i++) {
+      uint32_t slot = events[i].data.u32;
+      if (slot == X86_SOCKET_SERVER_SLOT) {
+        // Server read - new client
+        int new_socket = accept(server_fd, NULL, NULL);
+        if (new_socket < 0) {
+          LOG_DEBUG("Failed to accept new client!\n");
         } else {
-          thread->handler(thread, client_fd, buffer, (size_t)read_len, thread->context);
+          prv_add_client(thread, epoll_fd, new_socket);
         }
+      } else if (thread->client_fds[slot] != X86_SOCKET_INVALID_FD) {
+        prv_handle_client(thread, slot);
       }
     }
   }
 
+  close(epoll_fd);
   return NULL;
 }
 
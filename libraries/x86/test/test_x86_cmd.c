@@ -47,3 +47,27 @@ void test_x86_cmd_client(void) {
   TEST_ASSERT_EQUAL_STRING("test", s_cmd);
   TEST_ASSERT_EQUAL(4, s_num_args);
 }
+
+void test_x86_cmd_tokenize(void) {
+  volatile bool received = false;
+  TEST_ASSERT_OK(x86_cmd_register_handler("tokens", prv_handler, &received));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    x86_cmd_register_handler("tokens", prv_handler, &received));
+
+  int client_fd = test_x86_socket_client_init(X86_CMD_SOCKET_NAME);
+
+  // Unknown commands and empty packets are dropped
+  const char *unknown = "unknown a b";
+  TEST_ASSERT_OK(x86_socket_write(client_fd, unknown, strlen(unknown)));
+  TEST_ASSERT_OK(x86_socket_write(client_fd, " \n", 2));
+
+  // Extra whitespace is skipped and args past the max are ignored
+  const char *cmd = "  tokens  a\nb c d e f g\n";
+  TEST_ASSERT_OK(x86_socket_write(client_fd, cmd, strlen(cmd)));
+
+  while (!received) {
+  }
+
+  TEST_ASSERT_EQUAL_STRING("tokens", s_cmd);
+  TEST_ASSERT_EQUAL(X86_CMD_MAX_ARGS, s_num_args);
+}
@@ -0,0 +1,73 @@
+#include <signal.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "interrupt_def.h"
+#include "test_helpers.h"
+#include "unity.h"
+#include "x86_interrupt.h"
+
+#define TEST_X86_INTERRUPT_MAX_RUNS 8
+
+static uint8_t s_handler_id;
+static uint8_t s_interrupt_ids[NUM_INTERRUPT_PRIORITIES];
+static InterruptPriority s_runs[TEST_X86_INTERRUPT_MAX_RUNS];
+static volatile size_t s_num_runs;
+static bool s_in_handler;
+
+static void prv_handler(uint8_t interrupt_id) {
+  for (InterruptPriority i = 0; i < NUM_INTERRUPT_PRIORITIES; i++) {
+    if (s_interrupt_ids[i] == interrupt_id && s_num_runs < TEST_X86_INTERRUPT_MAX_RUNS) {
+      s_runs[s_num_runs++] = i;
+    }
+  }
+  s_in_handler = x86_interrupt_in_handler();
+}
+
+void setup_test(void) {
+  x86_interrupt_init();
+  memset(s_runs, 0, sizeof(s_runs));
+  s_num_runs = 0;
+  s_in_handler = false;
+
+  TEST_ASSERT_OK(x86_interrupt_register_handler(prv_handler, &s_handler_id));
+  for (InterruptPriority i = 0; i < NUM_INTERRUPT_PRIORITIES; i++) {
+    InterruptSettings settings = { .type = INTERRUPT_TYPE_INTERRUPT, .priority = i };
+    TEST_ASSERT_OK(x86_interrupt_register_interrupt(s_handler_id, &settings, &s_interrupt_ids[i]));
+  }
+}
+
+void teardown_test(void) {}
+
+// An interrupt triggered outside of a critical section runs right away.
+void test_x86_interrupt_trigger(void) {
+  TEST_ASSERT_OK(x86_interrupt_trigger(s_interrupt_ids[INTERRUPT_PRIORITY_NORMAL]));
+  TEST_ASSERT_EQUAL(1, s_num_runs);
+  TEST_ASSERT_EQUAL(INTERRUPT_PRIORITY_NORMAL, s_runs[0]);
+  TEST_ASSERT_TRUE(s_in_handler);
+  TEST_ASSERT_FALSE(x86_interrupt_in_handler());
+
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, x86_interrupt_trigger(NUM_INTERRUPT_PRIORITIES));
+}
+
+// Interrupts held off by a critical section run highest priority first once it ends.
+void test_x86_interrupt_priority(void) {
+  sigset_t prev_mask;
+  x86_interrupt_mask(&prev_mask);
+  x86_interrupt_lock();
+
+  TEST_ASSERT_OK(x86_interrupt_trigger(s_interrupt_ids[INTERRUPT_PRIORITY_LOW]));
+  TEST_ASSERT_OK(x86_interrupt_trigger(s_interrupt_ids[INTERRUPT_PRIORITY_NORMAL]));
+  TEST_ASSERT_OK(x86_interrupt_trigger(s_interrupt_ids[INTERRUPT_PRIORITY_HIGH]));
+  TEST_ASSERT_OK(x86_interrupt_trigger(s_interrupt_ids[INTERRUPT_PRIORITY_LOW]));
+  TEST_ASSERT_EQUAL(0, s_num_runs);
+
+  x86_interrupt_unlock();
+  x86_interrupt_unmask(&prev_mask);
+
+  TEST_ASSERT_EQUAL(4, s_num_runs);
+  TEST_ASSERT_EQUAL(INTERRUPT_PRIORITY_HIGH, s_runs[0]);
+  TEST_ASSERT_EQUAL(INTERRUPT_PRIORITY_NORMAL, s_runs[1]);
+  TEST_ASSERT_EQUAL(INTERRUPT_PRIORITY_LOW, s_runs[2]);
+  TEST_ASSERT_EQUAL(INTERRUPT_PRIORITY_LOW, s_runs[3]);
+}
@@ -17,7 +17,7 @@ static X86SocketThread s_thread;
 static char s_rx_data[30];
 static size_t s_rx_len;
 
-static void prv_handler(X86SocketThread *thread, int client_fd, const char *rx_data, size_t rx_len,
+static void prv_handler(X86SocketThread *thread, int client_fd, char *rx_data, size_t rx_len,
                         void *context) {
   bool *received = context;
 
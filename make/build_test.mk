@@ -19,7 +19,13 @@ $(T)_EXCLUDE_TESTS += $(EXCLUDED_TESTS)
 $(T)_EXCLUDED_TESTS := $(foreach test,$($(T)_EXCLUDE_TESTS),$($(T)_TEST_ROOT)/test_$(test).c)
 $(T)_TEST_SRC := $(filter-out $($(T)_EXCLUDED_TESTS),$($(T)_TEST_SRC))
 
-$(T)_TEST_OBJ := $($(T)_TEST_SRC:$($(T)_TEST_ROOT)/%.c=$($(T)_TEST_OBJ_DIR)/%.o)
+# Find all bench_*.c files - these are micro-benchmarks, built like tests but only run by make bench
+$(T)_BENCH_SRC := $(wildcard $($(T)_TEST_ROOT)/bench_*.c)
+$(T)_EXCLUDED_BENCHES := $(foreach bench,$($(T)_EXCLUDE_BENCHES),$($(T)_TEST_ROOT)/bench_$(bench).c)
+$(T)_BENCH_SRC := $(filter-out $($(T)_EXCLUDED_BENCHES),$($(T)_BENCH_SRC))
+
+$(T)_TEST_OBJ := $($(T)_TEST_SRC:$($(T)_TEST_ROOT)/%.c=$($(T)_TEST_OBJ_DIR)/%.o) \
+                 $($(T)_BENCH_SRC:$($(T)_TEST_ROOT)/%.c=$($(T)_TEST_OBJ_DIR)/%.o)
 -include $($(T)_TEST_OBJ:.o=.d) #:
 
 # Generate the appropriate test runners for our unit tests
@@ -29,14 +35,27 @@ $(T)_TEST_RUNNERS_OBJ := $($(T)_TEST_RUNNERS:$($(T)_GEN_DIR)/%.c=$($(T)_TEST_OBJ
 
 .SECONDARY: $($(T)_TEST_RUNNERS)
 
+# Benchmark runners run every bench* function as a Unity test case
+$(T)_BENCH_RUNNERS := $($(T)_BENCH_SRC:$($(T)_TEST_ROOT)/bench_%.c=$($(T)_GEN_DIR)/bench_%_runner.c)
+$(T)_BENCH_RUNNERS_OBJ := $($(T)_BENCH_RUNNERS:$($(T)_GEN_DIR)/%.c=$($(T)_TEST_OBJ_DIR)/%.o)
+-include $($(T)_BENCH_RUNNERS_OBJ:.o=.d) #:
+
+.SECONDARY: $($(T)_BENCH_RUNNERS)
+
 # Generate the expected build outputs - one for each runner
 $(T)_TESTS := $($(T)_TEST_RUNNERS:$($(T)_GEN_DIR)/%.c=$($(T)_TEST_BIN_DIR)/%$(PLATFORM_EXT))
+$(T)_BENCHES := $($(T)_BENCH_RUNNERS:$($(T)_GEN_DIR)/%.c=$($(T)_TEST_BIN_DIR)/%$(PLATFORM_EXT))
 
 # Generate the test runners
 $($(T)_GEN_DIR)/%_runner.c: $($(T)_TEST_ROOT)/%.c | $($(T)_GEN_DIR)
 	@echo "Generating $(notdir $@)"
 	@$(UNITY_GEN_RUNNER) $< $@
 
+# Generate the benchmark runners
+$($(T)_BENCH_RUNNERS): $($(T)_GEN_DIR)/%_runner.c: $($(T)_TEST_ROOT)/%.c | $($(T)_GEN_DIR)
+	@echo "Generating $(notdir $@)"
+	@$(UNITY_GEN_RUNNER) --test_prefix=bench $< $@
+
 # Compile the unit tests
 $($(T)_TEST_OBJ_DIR)/%.o: $($(T)_TEST_ROOT)/%.c | $(T) $(dir $($(T)_TEST_OBJ))
 	@echo "T: $(notdir $<) -> $(notdir $@)"
@@ -47,8 +66,8 @@ $($(T)_TEST_OBJ_DIR)/%.o: $($(T)_GEN_DIR)/%.c | $(T) $(dir $($(T)_TEST_RUNNERS_O
 	@echo "T: $(notdir $<) -> $(notdir $@)"
 	@$(CC) -MD -MP -c -o $@ $< $($(firstword $|)_CFLAGS) $(addprefix -I,$($(firstword $|)_INC_DIRS) $(unity_INC_DIRS))
 
-# Build each test - only include the test's runner and unit tests.
-$($(T)_TESTS): $($(T)_TEST_BIN_DIR)/%_runner$(PLATFORM_EXT): \
+# Build each test or benchmark - only include its runner and unit tests.
+$($(T)_TESTS) $($(T)_BENCHES): $($(T)_TEST_BIN_DIR)/%_runner$(PLATFORM_EXT): \
                  $($(T)_TEST_OBJ_DIR)/%.o $($(T)_TEST_OBJ_DIR)/%_runner.o \
                  $(call dep_to_lib,$($(T)_TEST_DEPS)) | $(T) $($(T)_TEST_BIN_DIR)
 	@echo "Building test $(notdir $(@:%_runner$(PLATFORM_EXT)=%)) for $(PLATFORM)"
@@ -57,7 +76,7 @@ $($(T)_TESTS): $($(T)_TEST_BIN_DIR)/%_runner$(PLATFORM_EXT): \
     -L$(STATIC_LIB_DIR) $(addprefix -l,$(foreach lib,$($(firstword $|)_TEST_DEPS),$($(lib)_DEPS))) \
     $(LDFLAGS) $(addprefix -I,$($(firstword $|)_INC_DIRS) $(unity_INC_DIRS))
 
-.PHONY: test test_ test_$(T)
+.PHONY: test test_ test_$(T) bench bench_$(T) bench_all
 
 ifeq ($(T),$(filter $(T),$(LIBRARY) $(PROJECT)))
 ifeq (,$(TEST))
@@ -77,7 +96,22 @@ test_$(T): $($(T)_TESTS)
 
 test_all: test_$(T)
 
-build_all: $($(T)_TESTS)
+build_all: $($(T)_TESTS) $($(T)_BENCHES)
+
+# Run the benchmarks and collect their results as CSV in $(BENCH_DIR)/$(T).csv
+ifeq ($(T),$(filter $(T),$(LIBRARY) $(PROJECT)))
+bench: bench_$(T)
+endif
+
+bench_$(T): $($(T)_BENCHES) | $(BENCH_DIR)
+	@echo "Running benchmarks - $(@:bench_%=%)"
+	@($(call session_wrapper,$(foreach test,$^,$(call test_run,$(test)) &&) true)) \
+    > $(BENCH_DIR)/$(@:bench_%=%).log 2>&1; status=$$?; cat $(BENCH_DIR)/$(@:bench_%=%).log; \
+    echo "$(BENCH_CSV_HEADER)" > $(BENCH_DIR)/$(@:bench_%=%).csv; \
+    grep '^BENCH,' $(BENCH_DIR)/$(@:bench_%=%).log | cut -d, -f2- >> $(BENCH_DIR)/$(@:bench_%=%).csv; \
+    echo "Results written to $(BENCH_DIR)/$(@:bench_%=%).csv"; exit $$status
+
+bench_all: bench_$(T)
 
 DIRS := $(sort $(DIRS) $($(T)_GEN_DIR) $($(T)_TEST_BIN_DIR) \
-               $(dir $($(T)_TEST_OBJ) $($(T)_TEST_RUNNERS_OBJ)))
+               $(dir $($(T)_TEST_OBJ) $($(T)_TEST_RUNNERS_OBJ) $($(T)_BENCH_RUNNERS_OBJ)))
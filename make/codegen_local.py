@@ -0,0 +1,316 @@
+#!/usr/bin/env python3
+"""Local codegen-tooling generation.
+
+The CAN codegen output in libraries/codegen-tooling is released from the codegen-tooling repo.
+Messages defined in this repo ahead of a release are listed in
+libraries/codegen-tooling/can_messages_local.json, and this script generates them into the
+released headers the same way the upstream templates do. It then renders the CAN message table
+(can_msg_table.h/.c) from libraries/codegen-tooling/templates with every message in the headers.
+
+It's run by `make update_codegen` after fetching a release, so the local output survives updates.
+Running it again regenerates everything in place.
+
+Usage: python3 make/codegen_local.py [-folder libraries/codegen-tooling]
+"""
+import argparse
+import json
+import os
+import re
+from string import Template
+
+DEFINITIONS_FILE = 'can_messages_local.json'
+
+COLUMN_LIMIT = 100
+INDENT = '  '
+
+# Fields per message and bytes per field for each packing type
+FIELD_TYPES = {
+    'u8': (8, 1),
+    'u16': (4, 2),
+    'u32': (2, 4),
+    'u64': (1, 8),
+}
+
+ENUM_ENTRY = re.compile(r'^  SYSTEM_CAN_MESSAGE_(\w+) = (\d+),\n', re.MULTILINE)
+NUM_MESSAGES = re.compile(r'^  NUM_SYSTEM_CAN_MESSAGES = \d+\n', re.MULTILINE)
+DEVICE_ENTRY = re.compile(r'^  SYSTEM_CAN_DEVICE_(\w+) = \d+,\n', re.MULTILINE)
+PACK_MACRO = re.compile(r'^#define CAN_PACK_(\w+)\(msg_ptr,?\s*([^)]*)\)\s*'
+                        r'can_pack_impl_(\w+)\(\s*\(msg_ptr\),\s*SYSTEM_CAN_DEVICE_(\w+),'
+                        r'\s*SYSTEM_CAN_MESSAGE_\w+(?:,\s*(\d+))?', re.MULTILINE)
+
+TABLE_TEMPLATES = ['can_msg_table.h', 'can_msg_table.c']
+
+
+def wrap_call(prefix, args, suffix, first_indent=''):
+    """Formats a call, wrapping its arguments aligned after the opening parenthesis.
+
+    Lines are filled greedily so each stays under the column limit once a line continuation is
+    added.
+
+    Args:
+        prefix: string up to and including the opening parenthesis
+        args: list of argument strings
+        suffix: string following the last argument, e.g. ')'
+        first_indent: string to indent the first line with
+
+    Returns:
+        A list of lines without continuations.
+    """
+    limit = COLUMN_LIMIT - 2
+    lines = []
+    line = first_indent + prefix
+    continuation = ' ' * len(line)
+    for i, arg in enumerate(args):
+        token = arg + (',' if i < len(args) - 1 else suffix)
+        if line.endswith('(') or line == continuation:
+            candidate = line + token
+        else:
+            candidate = line + ' ' + token
+        if len(candidate) > limit and line != continuation and not line.endswith('('):
+            lines.append(line)
+            candidate = continuation + token
+        line = candidate
+    if not args:
+        line += suffix
+    lines.append(line)
+    return lines
+
+
+def macro(lines):
+    """Joins the lines of a macro with aligned line continuations.
+
+    Args:
+        lines: list of lines, the first being the #define
+
+    Returns:
+        The macro as a string, joined onto one line if it fits.
+    """
+    joined = lines[0] + ' ' + ' '.join(line.strip() for line in lines[1:])
+    if len(lines) == 2 and len(joined) <= COLUMN_LIMIT:
+        return joined + '\n'
+
+    width = max(len(line) for line in lines[:-1]) + 1
+    return ''.join(line.ljust(width) + '\\\n' for line in lines[:-1]) + lines[-1] + '\n'
+
+
+def field_args(msg, suffix=''):
+    """Returns the macro parameter names of the message's fields."""
+    return ['{}_{}{}'.format(field, msg['type'], suffix) for field in msg['fields']]
+
+
+def impl_args(msg, args, empty):
+    """Returns the argument list for a can_(un)pack_impl call, padded with |empty|."""
+    if msg['type'] == 'empty':
+        return []
+    num_fields, _ = FIELD_TYPES[msg['type']]
+    padding = [empty] * (num_fields - len(args))
+    return ['({})'.format(arg) for arg in args] + padding
+
+
+def dlc(msg):
+    """Returns the data length of the message in bytes."""
+    if msg['type'] == 'empty':
+        return 0
+    _, field_bytes = FIELD_TYPES[msg['type']]
+    return field_bytes * len(msg['fields'])
+
+
+def gen_pack(msg):
+    """Generates the CAN_PACK_* macro for a message."""
+    params = ['msg_ptr'] + field_args(msg)
+    header = wrap_call('#define CAN_PACK_{}('.format(msg['name']), params, ')')
+    device = 'SYSTEM_CAN_DEVICE_{}'.format(msg['source'])
+    msg_id = 'SYSTEM_CAN_MESSAGE_{}'.format(msg['name'])
+    if msg['type'] == 'empty':
+        body = wrap_call('can_pack_impl_empty(', ['(msg_ptr)', device, msg_id], ')', INDENT)
+    else:
+        args = ['(msg_ptr)', device, msg_id, str(dlc(msg))]
+        args += impl_args(msg, field_args(msg), 'CAN_PACK_IMPL_EMPTY')
+        body = wrap_call('can_pack_impl_{}('.format(msg['type']), args, ')', INDENT)
+    return macro(header + body)
+
+
+def gen_transmit(msg):
+    """Generates the CAN_TRANSMIT_* macro for a message."""
+    params = field_args(msg)
+    ack = 'NULL'
+    if msg['critical']:
+        params = ['ack_ptr'] + params
+        ack = '(ack_ptr)'
+    header = wrap_call('#define CAN_TRANSMIT_{}('.format(msg['name']), params, ')')
+    pack_args = ['&msg'] + ['({})'.format(arg) for arg in field_args(msg)]
+    pack = wrap_call('CAN_PACK_{}('.format(msg['name']), pack_args, ');', INDENT * 2)
+    body = [INDENT + '({', INDENT * 2 + 'CanMessage msg = { 0 };'] + pack
+    body += [
+        INDENT * 2 + 'StatusCode status = can_transmit(&msg, {});'.format(ack),
+        INDENT * 2 + 'status;',
+        INDENT + '})',
+    ]
+    return macro(header + body)
+
+
+def gen_unpack(msg):
+    """Generates the CAN_UNPACK_* macro for a message."""
+    params = ['msg_ptr'] + field_args(msg, '_ptr')
+    header = wrap_call('#define CAN_UNPACK_{}('.format(msg['name']), params, ')')
+    args = ['(msg_ptr)', str(dlc(msg))]
+    args += impl_args(msg, field_args(msg, '_ptr'), 'CAN_UNPACK_IMPL_EMPTY')
+    body = wrap_call('can_unpack_impl_{}('.format(msg['type']), args, ')', INDENT)
+    return macro(header + body)
+
+
+def message_ids(defs):
+    """Returns a dict of message name to ID from can_msg_defs.h."""
+    return {name: int(msg_id) for name, msg_id in ENUM_ENTRY.findall(defs)}
+
+
+def update_defs(defs, msg):
+    """Adds or updates the message's SystemCanMessage entry and the message count."""
+    if msg['source'] not in DEVICE_ENTRY.findall(defs):
+        raise ValueError('Unknown source device {} for {}'.format(msg['source'], msg['name']))
+
+    entry = '  SYSTEM_CAN_MESSAGE_{} = {},\n'.format(msg['name'], msg['id'])
+    entries = list(ENUM_ENTRY.finditer(defs))
+    for match in entries:
+        name, msg_id = match.group(1), int(match.group(2))
+        if name == msg['name']:
+            defs = defs[:match.start()] + entry + defs[match.end():]
+            break
+        if msg_id == msg['id']:
+            raise ValueError('{} reuses the ID of {}'.format(msg['name'], name))
+        if msg_id > msg['id']:
+            defs = defs[:match.start()] + entry + defs[match.start():]
+            break
+    else:
+        end = NUM_MESSAGES.search(defs)
+        defs = defs[:end.start()] + entry + defs[end.start():]
+
+    count = len(ENUM_ENTRY.findall(defs))
+    return NUM_MESSAGES.sub('  NUM_SYSTEM_CAN_MESSAGES = {}\n'.format(count), defs)
+
+
+def update_header(header, prefix, msg, block, ids):
+    """Adds or replaces the message's macro in a header ordered by message ID.
+
+    Args:
+        header: string contents of the header
+        prefix: macro prefix of the header, e.g. 'CAN_PACK_'
+        msg: the message definition
+        block: the generated macro
+        ids: dict of message name to ID
+
+    Returns:
+        The updated header contents.
+    """
+    define = re.compile(r'^#define {}(\w+)\('.format(prefix), re.MULTILINE)
+    for match in define.finditer(header):
+        name = match.group(1)
+        if name == msg['name']:
+            end = header.find('\n\n', match.start())
+            end = len(header) if end < 0 else end + 1
+            return header[:match.start()] + block + header[end:]
+        if ids.get(name, -1) > msg['id']:
+            return header[:match.start()] + block + '\n' + header[match.start():]
+    return header.rstrip('\n') + '\n\n' + block
+
+
+def table_messages(pack):
+    """Parses every message's source, DLC and fields out of can_pack.h.
+
+    Returns:
+        A list of (name, source, dlc, fields) tuples in header order, where fields is a list of
+        (name, offset, width) tuples.
+    """
+    messages = []
+    for match in PACK_MACRO.finditer(pack.replace('\\\n', ' ')):
+        name, params, impl_type, source, msg_dlc = match.groups()
+        fields = []
+        if impl_type != 'empty':
+            _, width = FIELD_TYPES[impl_type]
+            suffix = '_' + impl_type
+            for i, param in enumerate(p.strip() for p in params.split(',')):
+                if not param.endswith(suffix):
+                    raise ValueError('Unexpected field {} in {}'.format(param, name))
+                fields.append((param[:-len(suffix)], i * width, width))
+        messages.append((name, source, int(msg_dlc or 0), fields))
+    return messages
+
+
+def gen_table(defs, pack, templates, inc, src):
+    """Renders the CAN message table templates from the message headers.
+
+    Args:
+        defs: string contents of can_msg_defs.h
+        pack: string contents of can_pack.h
+        templates: folder holding the table templates
+        inc: folder to write the table header to
+        src: folder to write the table source to
+
+    Returns:
+        None
+    """
+    device_names = ''.join('  [SYSTEM_CAN_DEVICE_{0}] = "{0}",\n'.format(device)
+                           for device in DEVICE_ENTRY.findall(defs))
+
+    msg_defs = ''
+    for name, source, msg_dlc, fields in table_messages(pack):
+        msg_defs += '  [SYSTEM_CAN_MESSAGE_{}] = {{\n'.format(name)
+        msg_defs += '    .name = "{}",\n'.format(name)
+        msg_defs += '    .source = SYSTEM_CAN_DEVICE_{},\n'.format(source)
+        msg_defs += '    .dlc = {},\n'.format(msg_dlc)
+        msg_defs += '    .num_fields = {},\n'.format(len(fields))
+        if fields:
+            msg_defs += '    .fields = {\n'
+            msg_defs += ''.join('      {{ "{}", {}, {} }},\n'.format(*field) for field in fields)
+            msg_defs += '    },\n'
+        msg_defs += '  },\n'
+
+    for filename in TABLE_TEMPLATES:
+        with open(os.path.join(templates, filename + '.tmpl')) as template_file:
+            template = Template(template_file.read())
+        output = inc if filename.endswith('.h') else src
+        with open(os.path.join(output, filename), 'w') as output_file:
+            output_file.write(template.substitute(device_names=device_names, msg_defs=msg_defs))
+
+
+def main():
+    """Main function"""
+    parser = argparse.ArgumentParser(description='Generate local CAN messages into codegen.')
+    parser.add_argument('-folder', type=str, default='libraries/codegen-tooling',
+                        help='the codegen-tooling library folder')
+    args = parser.parse_args()
+
+    with open(os.path.join(args.folder, DEFINITIONS_FILE)) as definitions_file:
+        messages = json.load(definitions_file)['messages']
+
+    inc = os.path.join(args.folder, 'inc')
+    headers = {}
+    for filename in ['can_msg_defs.h', 'can_pack.h', 'can_transmit.h', 'can_unpack.h']:
+        with open(os.path.join(inc, filename)) as header_file:
+            headers[filename] = header_file.read()
+
+    for msg in messages:
+        if msg['type'] != 'empty':
+            if msg['type'] not in FIELD_TYPES:
+                raise ValueError('Unknown type {} for {}'.format(msg['type'], msg['name']))
+            if not 0 < len(msg['fields']) <= FIELD_TYPES[msg['type']][0]:
+                raise ValueError('Too many fields for {}'.format(msg['name']))
+        headers['can_msg_defs.h'] = update_defs(headers['can_msg_defs.h'], msg)
+
+    ids = message_ids(headers['can_msg_defs.h'])
+    for msg in messages:
+        for filename, prefix, gen in [('can_pack.h', 'CAN_PACK_', gen_pack),
+                                      ('can_transmit.h', 'CAN_TRANSMIT_', gen_transmit),
+                                      ('can_unpack.h', 'CAN_UNPACK_', gen_unpack)]:
+            headers[filename] = update_header(headers[filename], prefix, msg, gen(msg), ids)
+
+    for filename, contents in headers.items():
+        with open(os.path.join(inc, filename), 'w') as header_file:
+            header_file.write(contents)
+
+    gen_table(headers['can_msg_defs.h'], headers['can_pack.h'],
+              os.path.join(args.folder, 'templates'), inc, os.path.join(args.folder, 'src'))
+
+
+if __name__ == '__main__':
+    main()
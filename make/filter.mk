@@ -2,6 +2,12 @@ VALID_PROJECTS := $(patsubst $(PROJ_DIR)/%/rules.mk,%,$(wildcard $(PROJ_DIR)/*/r
 VALID_PLATFORMS := $(patsubst $(PLATFORMS_DIR)/%/platform.mk,%,$(wildcard $(PLATFORMS_DIR)/*/platform.mk))
 VALID_LIBRARIES := $(patsubst $(LIB_DIR)/%/rules.mk,%,$(wildcard $(LIB_DIR)/*/rules.mk))
 
+# Host tools that need x86-only features such as SocketCAN or a filesystem
+X86_ONLY_PROJECTS := can_replay
+ifneq (x86,$(PLATFORM))
+  VALID_PROJECTS := $(filter-out $(X86_ONLY_PROJECTS),$(VALID_PROJECTS))
+endif
+
 # Rules:
 # - For any universal operations (clean, lint), do not expect args
 # - For build/test all, just check for a valid PLATFORM.
@@ -9,7 +15,7 @@ VALID_LIBRARIES := $(patsubst $(LIB_DIR)/%/rules.mk,%,$(wildcard $(LIB_DIR)/*/ru
 # - For test, gdb, and program, check to see if PLATFORM and {PROJECT or {LIBRARY and TEST}} are valid
 # - For build, check if PLATFORM and {PROJECT or LIBRARY} are valid
 
-ifneq (,$(filter clean lint lint_quick pylint format format_quick build_all test_all test_format socketcan update_codegen babydriver,$(MAKECMDGOALS)))
+ifneq (,$(filter clean lint lint_quick pylint format format_quick build_all test_all bench_all test_format socketcan update_codegen babydriver,$(MAKECMDGOALS)))
   # Universal operation: do nothing - args are not used or only PLATFORM is checked
 else ifneq (,$(filter new,$(MAKECMDGOALS)))
   # New project: just make sure PROJECT or LIBRARY is defined
@@ -31,7 +37,7 @@ else
   endif
 endif
 
-ifneq (,$(filter build_all test_all test gdb program build,$(MAKECMDGOALS)))
+ifneq (,$(filter build_all test_all bench_all test bench gdb program build,$(MAKECMDGOALS)))
   # Check for valid PLATFORM
   override PLATFORM := $(filter $(VALID_PLATFORMS),$(PLATFORM))
 
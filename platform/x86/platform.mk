@@ -27,12 +27,15 @@ LDSCRIPT := $(PLATFORM_DIR)/ldscripts
 # Build flags for the device
 CDEFINES := _GNU_SOURCE
 
-ifeq (gcc,$(COMPILER))
-  CSFLAGS := -g -Os
-else ifeq (asan, $(COPTIONS))
+ifeq (asan, $(COPTIONS))
   CSFLAGS := -O1 -g -fsanitize=address -fno-omit-frame-pointer
 else ifeq (tsan, $(COPTIONS))
   CSFLAGS := -fsanitize=thread -O1 -g
+  # TSAN can't follow signal handlers running on top of the main thread, so run
+  # interrupts on a dispatcher thread instead
+  CDEFINES += X86_INTERRUPT_DISPATCHER
+else ifeq (gcc,$(COMPILER))
+  CSFLAGS := -g -Os
 else
   CSFLAGS := -O1 -g
 endif
@@ -52,7 +55,7 @@ LDFLAGS := -lrt
 
 # Shell environment variables
 FLASH_VAR := MIDSUN_X86_FLASH_FILE
-ifneq (,$(filter test test_all,$(MAKECMDGOALS)))
+ifneq (,$(filter test test_all bench bench_all,$(MAKECMDGOALS)))
 ifeq (,$(TEST))
   ENV_VARS = $(FLASH_VAR)=$(test)_flash
 else
@@ -11,6 +11,7 @@
 #include "current_sense.h"
 #include "fan_control.h"
 #include "relay_sequence.h"
+#include "soc.h"
 
 #define BMS_PERIPH_I2C_PORT I2C_PORT_2
 #define BMS_PERIPH_I2C_SDA_PIN \
@@ -29,6 +30,7 @@
 typedef struct BmsStorage {
   RelayStorage relay_storage;
   CurrentStorage current_storage;
+  SocStorage soc_storage;
   AfeReadings afe_readings;
   FanStorage fan_storage_1;
   FanStorage fan_storage_2;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "event_queue.h"
@@ -13,6 +14,7 @@
 #define NUM_CELL_MODULES_PER_AFE 6
 #define NUM_TOTAL_CELLS (NUM_AFES * NUM_CELL_MODULES_PER_AFE)
 #define NUM_THERMISTORS (NUM_TOTAL_CELLS * 2)
+#define NUM_THERMISTORS_PER_AFE (NUM_THERMISTORS / NUM_AFES)
 #define MAX_AFE_FAULTS 5
 
 typedef struct CellSenseSettings {
@@ -21,12 +23,36 @@ typedef struct CellSenseSettings {
   uint16_t overvoltage_dmv;
   uint16_t charge_overtemp_dmv;
   uint16_t discharge_overtemp_dmv;
+  // AFEs with a thermistor reading above this don't balance their cells. 0 disables the limit.
+  uint16_t balance_overtemp_dmv;
 } CellSenseSettings;
 
+// Summary of one set of AFE results, computed in a single pass as the results arrive so consumers
+// don't each rescan the readings.
+typedef struct CellStats {
+  uint16_t min;
+  uint16_t max;
+  uint8_t argmin;  // index of the first reading equal to |min|
+  uint8_t argmax;  // index of the first reading equal to |max|
+  uint32_t sum;
+  uint8_t count;  // number of readings summarized
+  // Aggregates over the readings from each AFE device
+  uint16_t afe_min[NUM_AFES];
+  uint16_t afe_max[NUM_AFES];
+  uint32_t afe_sum[NUM_AFES];
+  // The sweep these stats came from, see |AfeReadings.sequence|
+  uint32_t sequence;
+} CellStats;
+
 typedef struct AfeReadings {
   // TODO(SOFT-9): total_voltage used to be stored here as well
   uint16_t voltages[NUM_TOTAL_CELLS];
   uint16_t temps[NUM_THERMISTORS];
+  CellStats voltage_stats;
+  CellStats temp_stats;
+  // Incremented each time a new set of cell voltages arrives. The temperatures that follow belong
+  // to the same sweep, so consumers can compare |CellStats.sequence| to tell what they saw.
+  uint32_t sequence;
 } AfeReadings;
 
 typedef struct CellSenseStorage {
@@ -40,3 +66,8 @@ StatusCode cell_sense_init(const CellSenseSettings *settings, AfeReadings *readi
                            LtcAfeStorage *afe);
 
 StatusCode cell_sense_process_event(const Event *e);
+
+// Summarize |len| readings into |stats|, grouping every |readings_per_afe| readings into an AFE.
+// Readings past the last AFE are ignored. |stats->sequence| is left at 0.
+void cell_sense_compute_stats(const uint16_t *readings, size_t len, size_t readings_per_afe,
+                              CellStats *stats);
@@ -1,15 +1,19 @@
 #pragma once
 
-// Stores current readings from the ADS1259 in a ring buffer.
+// Tracks current readings from the ADS1259 with streaming statistics.
+// The long window average decides whether we're charging and is what we report; the short window
+// average catches overcurrent within a few conversions.
 // Requires interrupts and soft timers to be initialized.
 
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "moving_stats.h"
 #include "spi.h"
 #include "status.h"
 
 #define NUM_STORED_CURRENT_READINGS 20
+#define NUM_FAST_CURRENT_READINGS 4
 #define CURRENT_SENSE_SPI_PORT SPI_PORT_2
 
 // slightly larger than conversion time of adc
@@ -19,14 +23,25 @@
 #define DISCHARGE_OVERCURRENT_CA (13000)  // 130 Amps
 #define CHARGE_OVERCURRENT_CA (-8160)     // -81.6 Amps
 
+// Called from the sampling timer with each new reading (centiamps, positive is discharging) and
+// the sampling period it covers.
+typedef void (*CurrentSenseCallback)(int16_t current_ca, uint32_t period_ms, void *context);
+
 typedef struct CurrentStorage {
-  int16_t readings_ring[NUM_STORED_CURRENT_READINGS];
-  uint16_t ring_idx;
-  int16_t average;
+  int32_t readings_ring[NUM_STORED_CURRENT_READINGS];
+  MovingStatsStorage stats;
+  int16_t average;       // over the last NUM_STORED_CURRENT_READINGS readings
+  int16_t fast_average;  // over the last NUM_FAST_CURRENT_READINGS readings
   uint32_t conv_period_ms;
+  CurrentSenseCallback callback;
+  void *callback_context;
 } CurrentStorage;
 
 bool current_sense_is_charging();
 
 StatusCode current_sense_init(CurrentStorage *readings, SpiSettings *settings,
                               uint32_t conv_period_ms);
+
+// Register a callback to run on every reading. Must be called after |current_sense_init|.
+StatusCode current_sense_register_callback(CurrentStorage *storage, CurrentSenseCallback callback,
+                                           void *context);
@@ -4,6 +4,8 @@
 
 #include "adt7476a_fan_controller.h"
 #include "adt7476a_fan_controller_defs.h"
+#include "fan_regulator.h"
+#include "fixed_point.h"
 #include "i2c.h"
 #include "soft_timer.h"
 #include "status.h"
@@ -19,11 +21,32 @@
 #define MAX_BATTERY_TEMP 43
 #define MAX_FAN_SPEED 100
 
+// The fans follow a curve up to full speed at MAX_BATTERY_TEMP, trimmed by a PI loop holding the
+// hottest thermistor at the target. See fan_regulator.h.
+#define BMS_FAN_TARGET_TEMP_DC 350
+#define BMS_FAN_HYSTERESIS_DC 20
+// 2% duty per degree of error, and 0.1% more per degree each second
+#define BMS_FAN_KP (FIXED_ONE(FIXED_Q16_FRAC_BITS) / 5)
+#define BMS_FAN_KI (FIXED_ONE(FIXED_Q16_FRAC_BITS) / 100)
+
+// A fan driven at BMS_FAN_STALL_MIN_DUTY or more that reads under BMS_FAN_STALL_MIN_RPM for
+// BMS_FAN_STALL_POLLS polls in a row is reported as stalled
+#define BMS_FAN_STALL_MIN_DUTY 30
+#define BMS_FAN_STALL_MIN_RPM 500
+#define BMS_FAN_STALL_POLLS 3
+
+// The AFE thermistor readings are in dmv, from dividers supplied by the LTC6811's 3V VREF2 with
+// the thermistor on top, so a hotter thermistor reads higher like the *_overtemp_dmv limits assume
+#define BMS_FAN_THERMISTOR_VREF_DMV 30000
+
 typedef struct FanStorage {
   uint16_t speed;
   AfeReadings *readings;
   StatusCode status;
+  // Status of setting each fan's speed, or STATUS_CODE_INTERNAL_ERROR if it's stalled
   StatusCode statuses[ADT_7476A_NUM_FANS];
+  uint16_t rpms[ADT_7476A_NUM_FANS];
+  FanRegulatorStorage regulator;
   uint8_t i2c_write_addr;
   uint8_t i2c_read_addr;
 } FanStorage;
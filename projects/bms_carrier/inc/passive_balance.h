@@ -1,18 +1,45 @@
 #pragma once
 
-// Passive balancing module for AFE cells.  Periodically checks for differences in voltages between
-// cells and calls ltc_afe_toggle_cell_discharge on the cell with the highest voltage
-// to mark the cell for discharge, depending on whether the difference between the highest and
-// lowest cell voltages meets the threshold for discharging.
+// Passive balancing module for AFE cells. After each sweep of cell voltages, plans which cells to
+// discharge and marks them with ltc_afe_toggle_cell_discharge.
+//
+// Every cell at least PASSIVE_BALANCE_MIN_VOLTAGE_DIFF_MV above the lowest cell is a candidate.
+// Each AFE discharges at most PASSIVE_BALANCE_MAX_CELLS_PER_AFE of its candidates at once, highest
+// first, to bound the heat from its bleed resistors, and an AFE whose thermistors read too hot
+// doesn't discharge at all.
+//
+// Balance current pulls down the voltage a cell reads, so discharge is only on between
+// measurements: the AFE applies the plan when it writes its config for the aux conversions that
+// follow the cell conversion, and passive_balance_stop() clears it before the next cell conversion.
+
+#include <stdint.h>
 
 #include "status.h"
 
 #include "cell_sense.h"
 #include "ltc_afe.h"
 
-// Min voltage difference between highest and lowest cell values for balancing to be required.
+// Min voltage difference between a cell and the lowest cell for the cell to be discharged.
 #define PASSIVE_BALANCE_MIN_VOLTAGE_DIFF_MV 25
 
-// Iterate through all cells and call ltc_afe_toggle_cell_discharge, passing in whether the
-// difference in voltages meets the threshold.
-StatusCode passive_balance(uint16_t *result_arr, size_t len, LtcAfeStorage *afe);
+// Max number of cells discharging at once on each AFE.
+#define PASSIVE_BALANCE_MAX_CELLS_PER_AFE 3
+
+typedef struct PassiveBalancePlan {
+  // Bit i is set if cell i of the AFE should be discharged
+  uint16_t discharge_bitset[NUM_AFES];
+  uint8_t num_cells;  // number of cells set across all AFEs
+} PassiveBalancePlan;
+
+// Plan the cells to discharge from the latest sweep in |readings|. AFEs with any thermistor reading
+// above |max_temp_dmv| are left out, as are all AFEs until temperatures have been read. A
+// |max_temp_dmv| of 0 disables the temperature limit.
+void passive_balance_plan(const AfeReadings *readings, uint16_t max_temp_dmv,
+                          PassiveBalancePlan *plan);
+
+// Plan from |readings| and mark the planned cells for discharge, clearing every other cell. Should
+// be called once the cell voltages are read, before the aux conversions are triggered.
+StatusCode passive_balance(const AfeReadings *readings, uint16_t max_temp_dmv, LtcAfeStorage *afe);
+
+// Clear discharge on every cell. Should be called before the next cell conversion is triggered.
+StatusCode passive_balance_stop(LtcAfeStorage *afe);
@@ -0,0 +1,90 @@
+#pragma once
+
+// Coulomb-counting state of charge estimator.
+// Requires current sense, soft timers, flash and CRC32 to be initialized.
+//
+// Every current sense reading is integrated into the pack's remaining charge and into the net
+// energy drawn from the pack, in integer fixed point so it fits in the sampling timer callback.
+// Coulomb counting drifts, so whenever the pack has rested (|current| below a threshold) for long
+// enough that the cells have settled to their open-circuit voltage, the charge is re-anchored from
+// an OCV-vs-SOC lookup of the average cell voltage. Startup without any persisted state counts as
+// rested.
+//
+// The charge and energy are persisted to flash whenever they move by SOC_PERSIST_STEP, rather than
+// on every change, to keep flash wear down.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cell_sense.h"
+#include "current_sense.h"
+#include "flash.h"
+#include "persist.h"
+#include "status.h"
+
+#define SOC_FLASH_PAGE (NUM_FLASH_PAGES - 2)
+
+// SOC is reported in hundredths of a percent.
+#define SOC_MAX 10000
+
+// Persist after the charge moves by this much of the pack capacity (in hundredths of a percent).
+#define SOC_PERSIST_STEP 50
+
+typedef struct SocSettings {
+  // Capacity of the full pack. Must be under 400 Ah.
+  uint32_t capacity_mah;
+  // The pack is at rest while the magnitude of the current is at most this many centiamps.
+  int16_t rest_current_ca;
+  // How long the pack must rest before its cell voltages are trusted as open-circuit voltages.
+  uint32_t rest_time_ms;
+  // Cell voltages for the OCV correction and for energy integration. Must persist.
+  const AfeReadings *afe_readings;
+  // If not NULL, the estimator registers itself to receive every reading from this current sense
+  // instance. Otherwise, readings must be passed to |soc_process_current|.
+  CurrentStorage *current_storage;
+} SocSettings;
+
+// The state kept in flash. Must be a multiple of FLASH_WRITE_BYTES.
+typedef struct SocPersistData {
+  uint32_t magic;
+  int32_t charge_mah;
+  int32_t energy_wh;
+} SocPersistData;
+
+typedef struct SocStorage {
+  SocSettings settings;
+
+  int32_t charge_mah;
+  int32_t charge_residue_cams;  // sub-mAh remainder, centiamp-milliseconds
+  int32_t energy_wh;            // net energy drawn from the pack
+  int32_t energy_residue_dwms;  // sub-Wh remainder, deciwatt-milliseconds
+
+  uint32_t rest_elapsed_ms;
+  bool ocv_corrected;  // whether the current rest period has already been used for a correction
+
+  SocPersistData persist_data;
+  PersistStorage persist;
+} SocStorage;
+
+// Load the persisted state (if any) and start estimating. |storage| must be zeroed (e.g. static)
+// before the first init. Initializing it again restarts the estimate from the persisted state.
+StatusCode soc_init(SocStorage *storage, const SocSettings *settings);
+
+// Integrate one current reading (centiamps, positive is discharging) spanning |period_ms|.
+void soc_process_current(SocStorage *storage, int16_t current_ca, uint32_t period_ms);
+
+// State of charge in hundredths of a percent, from 0 to SOC_MAX. Always 0 before |soc_init|.
+uint16_t soc_get_soc(const SocStorage *storage);
+
+// Remaining charge in mAh.
+int32_t soc_get_charge_mah(const SocStorage *storage);
+
+// Net energy drawn from the pack in Wh since the state was first created. Negative if more energy
+// has been put in than taken out.
+int32_t soc_get_energy_wh(const SocStorage *storage);
+
+// Write the current state to flash immediately, e.g. before the BMS powers down.
+StatusCode soc_commit(SocStorage *storage);
+
+// Look up the state of charge (hundredths of a percent) for a resting cell voltage (100 uV).
+uint16_t soc_ocv_lookup(uint16_t cell_voltage_dmv);
@@ -14,8 +14,12 @@ $(T)_test_bps_heartbeat_MOCKS := fault_bps_set fault_bps_claer
 $(T)_test_relay_sequence_MOCKS := fault_bps_set fault_bps_clear gpio_set_state mcp23008_gpio_get_state
 $(T)_test_cell_sense_MOCKS := current_sense_is_charging ltc_afe_process_event
 $(T)_test_passive_balance_MOCKS := ltc_afe_toggle_cell_discharge
+$(T)_test_fan_control_MOCKS := adt7476a_get_fan_rpm
 $(T)_test_fault_bps_MOCKS := relay_fault
 $(T)_test_current_sense_MOCKS := fault_bps_set fault_bps_clear ads1259_get_conversion_data ads1259_init
+else
+# The balancing simulation reports on x86
+$(T)_EXCLUDE_TESTS := passive_balance_sim
 endif
 # Uses mocked fault handling to verify internal logic
 # TODO(SOFT-61): Should allow modules to hook into internal fault state (or read can messages) so this isn't needed
@@ -12,16 +12,19 @@ static void prv_periodic_tx(SoftTimerId timer_id, void *context);
 
 // Calculate avg cell voltage and tx along with avg current
 static void prv_current_tx(BmsStorage *storage) {
-  uint32_t avg_voltage = 0;
-  for (uint8_t cell = 0; cell < NUM_TOTAL_CELLS; cell++) {
-    avg_voltage += storage->afe_readings.voltages[cell];
-  }
-  avg_voltage /= NUM_TOTAL_CELLS;
+  uint32_t avg_voltage = storage->afe_readings.voltage_stats.sum / NUM_TOTAL_CELLS;
   CAN_TRANSMIT_BATTERY_AGGREGATE_VC(avg_voltage, (uint32_t)storage->current_storage.average);
   s_msgs_txed++;
   soft_timer_start_millis(time_between_tx_in_millis, prv_periodic_tx, storage, NULL);
 }
 
+static void prv_soc_tx(BmsStorage *storage) {
+  CAN_TRANSMIT_BATTERY_SOC(soc_get_soc(&storage->soc_storage),
+                           (uint32_t)soc_get_energy_wh(&storage->soc_storage));
+  s_msgs_txed++;
+  soft_timer_start_millis(time_between_tx_in_millis, prv_periodic_tx, storage, NULL);
+}
+
 // Tx cell voltage and its higher temperature reading
 static void prv_cell_voltage_and_temp_tx(BmsStorage *storage) {
   uint16_t cell_temp = storage->afe_readings.temps[s_msgs_txed * 2] >
@@ -61,8 +64,10 @@ static void prv_periodic_tx(SoftTimerId timer_id, void *context) {
     prv_cell_voltage_and_temp_tx(storage);
   } else if (s_msgs_txed < NUM_BATTERY_VT_MSGS + NUM_AGGREGATE_VC_MSGS) {
     prv_current_tx(storage);
-  } else if (s_msgs_txed <
-             NUM_BATTERY_VT_MSGS + NUM_AGGREGATE_VC_MSGS + NUM_BATTERY_RELAY_STATE_MSGS) {
+  } else if (s_msgs_txed < NUM_BATTERY_VT_MSGS + NUM_AGGREGATE_VC_MSGS + NUM_SOC_MSGS) {
+    prv_soc_tx(storage);
+  } else if (s_msgs_txed < NUM_BATTERY_VT_MSGS + NUM_AGGREGATE_VC_MSGS + NUM_SOC_MSGS +
+                               NUM_BATTERY_RELAY_STATE_MSGS) {
     prv_relay_state_tx(storage);
   } else if (s_msgs_txed < NUM_TOTAL_MESSAGES) {
     prv_fan_status_tx(storage);
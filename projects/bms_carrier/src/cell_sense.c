@@ -9,6 +9,7 @@
 #include "exported_enums.h"
 #include "fault_bps.h"
 #include "ltc_afe.h"
+#include "misc.h"
 #include "passive_balance.h"
 #include "status.h"
 #include "thermistor.h"
@@ -18,23 +19,21 @@ static CellSenseStorage s_storage = { 0 };
 static void prv_extract_cell_result(uint16_t *result_arr, size_t len, void *context) {
   ltc_afe_request_aux_conversion(s_storage.afe);
 
+  CellStats stats;
+  cell_sense_compute_stats(result_arr, len, NUM_CELL_MODULES_PER_AFE, &stats);
+
   bool disabled = critical_section_start();
   memcpy(s_storage.readings->voltages, result_arr, sizeof(s_storage.readings->voltages));
+  s_storage.readings->sequence++;
+  stats.sequence = s_storage.readings->sequence;
+  s_storage.readings->voltage_stats = stats;
   critical_section_end(disabled);
 
-  bool fault = false;
-  for (size_t i = 0; i < len; i++) {
-    // s_storage.total_voltage += s_storage.readings->voltages[i];
-    if (s_storage.readings->voltages[i] < s_storage.settings.undervoltage_dmv ||
-        s_storage.readings->voltages[i] > s_storage.settings.overvoltage_dmv) {
-      fault = true;
-    }
-  }
-
-  // Balance cells if needed
-  passive_balance(s_storage.readings->voltages, len, s_storage.afe);
+  // Balance cells if needed, while the aux conversions run
+  passive_balance(s_storage.readings, s_storage.settings.balance_overtemp_dmv, s_storage.afe);
 
-  if (fault) {
+  if (stats.count > 0 && (stats.min < s_storage.settings.undervoltage_dmv ||
+                          stats.max > s_storage.settings.overvoltage_dmv)) {
     fault_bps_set(EE_BPS_STATE_FAULT_AFE_CELL);
   } else {
     fault_bps_clear(EE_BPS_STATE_FAULT_AFE_CELL);
@@ -42,23 +41,69 @@ static void prv_extract_cell_result(uint16_t *result_arr, size_t len, void *cont
 }
 
 static void prv_extract_aux_result(uint16_t *result_arr, size_t len, void *context) {
+  // Balance current would pull down the cell voltages
+  passive_balance_stop(s_storage.afe);
   ltc_afe_request_cell_conversion(s_storage.afe);
 
+  CellStats stats;
+  cell_sense_compute_stats(result_arr, len, NUM_THERMISTORS_PER_AFE, &stats);
+
   bool disabled = critical_section_start();
   memcpy(s_storage.readings->temps, result_arr, sizeof(s_storage.readings->temps));
+  // the aux conversion is always requested by the cell result, so it's part of the same sweep
+  stats.sequence = s_storage.readings->sequence;
+  s_storage.readings->temp_stats = stats;
   critical_section_end(disabled);
 
   uint16_t threshold = s_storage.settings.discharge_overtemp_dmv;
   if (current_sense_is_charging()) threshold = s_storage.settings.charge_overtemp_dmv;
 
-  for (size_t i = 0; i < len; ++i) {
-    if (s_storage.readings->temps[i] > threshold) {
-      fault_bps_set(EE_BPS_STATE_FAULT_AFE_TEMP);
-      return;
+  if (stats.count > 0 && stats.max > threshold) {
+    fault_bps_set(EE_BPS_STATE_FAULT_AFE_TEMP);
+  } else {
+    fault_bps_clear(EE_BPS_STATE_FAULT_AFE_TEMP);
+  }
+}
+
+void cell_sense_compute_stats(const uint16_t *readings, size_t len, size_t readings_per_afe,
+                              CellStats *stats) {
+  memset(stats, 0, sizeof(*stats));
+  if (readings_per_afe == 0) {
+    return;
+  }
+  len = MIN(len, readings_per_afe * NUM_AFES);
+  if (len == 0) {
+    return;
+  }
+
+  stats->min = readings[0];
+  stats->max = readings[0];
+  for (size_t afe = 0; afe < NUM_AFES; afe++) {
+    stats->afe_min[afe] = UINT16_MAX;
+  }
+
+  for (size_t i = 0; i < len; i++) {
+    const uint16_t reading = readings[i];
+    const size_t afe = i / readings_per_afe;
+    if (reading < stats->min) {
+      stats->min = reading;
+      stats->argmin = (uint8_t)i;
     }
+    if (reading > stats->max) {
+      stats->max = reading;
+      stats->argmax = (uint8_t)i;
+    }
+    stats->sum += reading;
+    stats->afe_min[afe] = MIN(stats->afe_min[afe], reading);
+    stats->afe_max[afe] = MAX(stats->afe_max[afe], reading);
+    stats->afe_sum[afe] += reading;
   }
+  stats->count = (uint8_t)len;
 
-  fault_bps_clear(EE_BPS_STATE_FAULT_AFE_TEMP);
+  // AFEs without any readings report 0 rather than the sentinel
+  for (size_t afe = (len + readings_per_afe - 1) / readings_per_afe; afe < NUM_AFES; afe++) {
+    stats->afe_min[afe] = 0;
+  }
 }
 
 StatusCode cell_sense_init(const CellSenseSettings *settings, AfeReadings *afe_readings,
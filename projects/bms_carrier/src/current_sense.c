@@ -27,37 +27,37 @@ static void prv_ads_error_cb(Ads1259StatusCode code, void *context) {
 }
 
 // returns value in centiamps
-static int16_t prv_voltage_to_current(double reading) {
+static int16_t prv_voltage_to_current(int32_t reading_uv) {
   // current = voltage * 100, see confluence
-  return (int16_t)(100 * 100 * reading);
+  return (int16_t)(reading_uv / 100);
 }
 
 static void prv_periodic_ads_read(SoftTimerId id, void *context) {
-  double reading = s_ads1259_storage.reading;
-  int16_t val = prv_voltage_to_current(reading);
+  int16_t val = prv_voltage_to_current(s_ads1259_storage.reading_uv);
   CurrentStorage *storage = context;
-  storage->readings_ring[storage->ring_idx] = val;
-  storage->ring_idx = (storage->ring_idx + 1) % NUM_STORED_CURRENT_READINGS;
   ads1259_get_conversion_data(&s_ads1259_storage);
   soft_timer_start_millis(storage->conv_period_ms, prv_periodic_ads_read, context, NULL);
 
-  // update average
-  int32_t sum = 0;
-  for (uint16_t i = 0; i < NUM_STORED_CURRENT_READINGS; i++) {
-    sum += storage->readings_ring[i];
-  }
-  storage->average = sum / NUM_STORED_CURRENT_READINGS;
+  // update averages
+  moving_stats_push(&storage->stats, val);
+  storage->average = (int16_t)moving_stats_long_average(&storage->stats);
+  storage->fast_average = (int16_t)moving_stats_short_average(&storage->stats);
 
   // update s_is_charging
   // note that a negative value indicates the battery is charging
   s_is_charging = storage->average < 0;
 
-  // check faults
-  if (storage->average > DISCHARGE_OVERCURRENT_CA || storage->average < CHARGE_OVERCURRENT_CA) {
+  // check faults on the short window so we react within a few conversions
+  if (storage->fast_average > DISCHARGE_OVERCURRENT_CA ||
+      storage->fast_average < CHARGE_OVERCURRENT_CA) {
     fault_bps_set(EE_BPS_STATE_FAULT_CURRENT_SENSE);
   } else {
     fault_bps_clear(EE_BPS_STATE_FAULT_CURRENT_SENSE);
   }
+
+  if (storage->callback != NULL) {
+    storage->callback(val, storage->conv_period_ms, storage->callback_context);
+  }
 }
 
 bool current_sense_is_charging() {
@@ -78,8 +78,26 @@ StatusCode current_sense_init(CurrentStorage *storage, SpiSettings *settings,
     .error_context = NULL,
   };
   storage->conv_period_ms = conv_period_ms;
+  const MovingStatsSettings stats_settings = {
+    .buffer = storage->readings_ring,
+    .long_window = NUM_STORED_CURRENT_READINGS,
+    .short_window = NUM_FAST_CURRENT_READINGS,
+  };
+  status_ok_or_return(moving_stats_init(&storage->stats, &stats_settings));
   status_ok_or_return(ads1259_init(&s_ads1259_storage, &ads_settings));
   ads1259_get_conversion_data(&s_ads1259_storage);
   soft_timer_start_millis(storage->conv_period_ms, prv_periodic_ads_read, storage, NULL);
   return STATUS_CODE_OK;
 }
+
+StatusCode current_sense_register_callback(CurrentStorage *storage, CurrentSenseCallback callback,
+                                           void *context) {
+  if (storage == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+  // the sampling timer may fire between these, so make sure the context is in place first
+  storage->callback = NULL;
+  storage->callback_context = context;
+  storage->callback = callback;
+  return STATUS_CODE_OK;
+}
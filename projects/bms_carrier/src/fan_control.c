@@ -2,31 +2,42 @@
 
 #include "bms.h"
 #include "log.h"
-#include "math.h"
+#include "misc.h"
+#include "thermistor.h"
+
+// Off below 25 C, then from 30% at 25 C up to full speed at MAX_BATTERY_TEMP (deci-celsius to %)
+static const int32_t s_fan_curve_temps[] = { 249, 250, 350, MAX_BATTERY_TEMP * 10 };
+static const int32_t s_fan_curve_duties[] = { 0, 30, 50, MAX_FAN_SPEED };
+static const InterpTable s_fan_curve = {
+  .x = s_fan_curve_temps,
+  .y = s_fan_curve_duties,
+  .num_points = SIZEOF_ARRAY(s_fan_curve_temps),
+};
 
 static Adt7476aStorage s_adt7476a_storage;
+static ThermistorAdcLut s_thermistor_lut;
 static uint32_t s_interval_ms;
 
+// Converts an AFE thermistor reading to deci-celsius, saturating at the ends of the thermistor
+// table so readings past it still drive the fans to the nearest end of the curve
+static int32_t prv_reading_to_dC(uint16_t reading_dmv) {
+  uint32_t code = (uint32_t)MIN(reading_dmv, BMS_FAN_THERMISTOR_VREF_DMV) *
+                  THERMISTOR_ADC_MAX_CODE / BMS_FAN_THERMISTOR_VREF_DMV;
+  code = MIN(MAX(code, (uint32_t)s_thermistor_lut.min_code), (uint32_t)s_thermistor_lut.max_code);
+
+  uint16_t temperature_dC = 0;
+  thermistor_adc_lut_get_temp(&s_thermistor_lut, (uint16_t)code, &temperature_dC);
+  return temperature_dC;
+}
+
 static void prv_measure_temps(SoftTimerId timer_id, void *context) {
   FanStorage *storage = (FanStorage *)context;
 
-  uint16_t max = 0;
-  uint8_t fan_speed = 0;
+  int32_t max_dC = prv_reading_to_dC(storage->readings->temp_stats.max);
+  uint8_t fan_speed = fan_regulator_update(&storage->regulator, max_dC, s_interval_ms);
   StatusCode pwm_status_1;
   StatusCode pwm_status_2;
 
-  for (int i = 0; i < NUM_THERMISTORS; i++) {
-    if (storage->readings->temps[i] > max) {
-      max = storage->readings->temps[i];
-    }
-  }
-
-  // calculate fan speed
-
-  (max > MAX_BATTERY_TEMP)
-      ? (fan_speed = MAX_FAN_SPEED)
-      : (fan_speed = (max * ((double)MAX_FAN_SPEED / (double)MAX_BATTERY_TEMP)));
-
   pwm_status_1 = adt7476a_set_speed(BMS_FAN_CTRL_I2C_PORT_1, fan_speed, ADT_PWM_PORT_1,
                                     storage->i2c_write_addr);
   pwm_status_2 = adt7476a_set_speed(BMS_FAN_CTRL_I2C_PORT_1, fan_speed, ADT_PWM_PORT_2,
@@ -35,6 +46,14 @@ static void prv_measure_temps(SoftTimerId timer_id, void *context) {
   for (int i = 0; i < ADT_7476A_NUM_FANS; i++) {
     (i < NUM_FANS_PER_OUTPUT) ? (storage->statuses[i] = pwm_status_1)
                               : (storage->statuses[i] = pwm_status_2);
+
+    // check the tach for fans that don't spin up
+    StatusCode tach_status = adt7476a_get_fan_rpm(BMS_FAN_CTRL_I2C_PORT_1, storage->i2c_read_addr,
+                                                  (AdtTach)i, &storage->rpms[i]);
+    if (status_ok(tach_status) &&
+        fan_regulator_update_tach(&storage->regulator, (uint8_t)i, storage->rpms[i])) {
+      storage->statuses[i] = STATUS_CODE_INTERNAL_ERROR;
+    }
   }
 
   if (pwm_status_1 != STATUS_CODE_OK || pwm_status_2 != STATUS_CODE_OK) {
@@ -58,10 +77,23 @@ StatusCode fan_control_init(FanControlSettings *settings, FanStorage *storage) {
     .i2c = BMS_FAN_CTRL_I2C_PORT_1,
     .i2c_settings = settings->i2c_settings,
   };
+  const FanRegulatorSettings regulator_settings = {
+    .curve = &s_fan_curve,
+    .hysteresis_dC = BMS_FAN_HYSTERESIS_DC,
+    .target_dC = BMS_FAN_TARGET_TEMP_DC,
+    .kp = BMS_FAN_KP,
+    .ki = BMS_FAN_KI,
+    .num_fans = ADT_7476A_NUM_FANS,
+    .stall_min_duty = BMS_FAN_STALL_MIN_DUTY,
+    .stall_min_rpm = BMS_FAN_STALL_MIN_RPM,
+    .stall_updates = BMS_FAN_STALL_POLLS,
+  };
 
   s_interval_ms = settings->poll_interval_ms;
 
+  status_ok_or_return(thermistor_adc_lut_init(&s_thermistor_lut, THERMISTOR_POSITION_R1));
   status_ok_or_return(adt7476a_init(&s_adt7476a_storage, &adt7476a_settings));
+  status_ok_or_return(fan_regulator_init(&storage->regulator, &regulator_settings));
 
   prv_measure_temps(SOFT_TIMER_INVALID_TIMER, storage);
 
@@ -2,6 +2,7 @@
 
 #include "bms.h"
 #include "exported_enums.h"
+#include "flight_recorder.h"
 #include "relay_sequence.h"
 
 static BmsStorage *s_storage;
@@ -14,6 +15,7 @@ StatusCode fault_bps_init(BmsStorage *storage) {
 // Fault BPS and open relays
 StatusCode fault_bps_set(uint8_t fault_bitmask) {
   s_storage->bps_storage.fault_bitset |= fault_bitmask;
+  flight_recorder_freeze(fault_bitmask, s_storage->bps_storage.fault_bitset);
   if (fault_bitmask != EE_BPS_STATE_FAULT_RELAY) {
     relay_fault(&s_storage->relay_storage);
   }
@@ -1,3 +1,66 @@
+#include "bms.h"
+#include "crc32.h"
+#include "current_sense.h"
+#include "event_queue.h"
+#include "flash.h"
+#include "flight_recorder.h"
+#include "gpio.h"
+#include "gpio_it.h"
+#include "interrupt.h"
+#include "log.h"
+#include "soc.h"
+#include "soft_timer.h"
+#include "spi.h"
+#include "status.h"
+
+// Nominal pack capacity - should be characterized against the pack
+#define BMS_PACK_CAPACITY_MAH 36000
+#define BMS_REST_CURRENT_CA 50
+#define BMS_REST_TIME_MS 600000
+
+static BmsStorage s_storage;
+
+static SpiSettings s_current_sense_spi_settings = {
+  .baudrate = 6000000,
+  .mosi = { .port = GPIO_PORT_B, 15 },
+  .miso = { .port = GPIO_PORT_B, 14 },
+  .sclk = { .port = GPIO_PORT_B, 13 },
+  .cs = { .port = GPIO_PORT_B, 12 },
+};
+
 int main(void) {
+  gpio_init();
+  interrupt_init();
+  gpio_it_init();
+  soft_timer_init();
+  event_queue_init();
+  crc32_init();
+  // this is need for x86 but not for the stm32s
+  flash_init();
+  flight_recorder_init();
+
+  status_ok_or_return(current_sense_init(&s_storage.current_storage,
+                                         &s_current_sense_spi_settings, CONVERSION_TIME_MS));
+
+  // The AFEs, cell_sense, CAN and can_handler aren't started here yet, since the carrier's AFE
+  // wiring isn't defined. Until they are, |afe_readings| stays empty, so the SOC is coulomb
+  // counting only, without OCV correction or energy integration, and isn't sent over CAN.
+  const SocSettings soc_settings = {
+    .capacity_mah = BMS_PACK_CAPACITY_MAH,
+    .rest_current_ca = BMS_REST_CURRENT_CA,
+    .rest_time_ms = BMS_REST_TIME_MS,
+    .afe_readings = &s_storage.afe_readings,
+    .current_storage = &s_storage.current_storage,
+  };
+  status_ok_or_return(soc_init(&s_storage.soc_storage, &soc_settings));
+
+  LOG_DEBUG("BMS carrier started\n");
+  Event e = { 0 };
+  while (true) {
+    event_process(&e);
+    // BPS faults keep the board running with the relays open, so save the lead-up to the fault
+    // before power is cut
+    flight_recorder_persist();
+  }
   return 0;
 }
@@ -1,25 +1,74 @@
 #include "passive_balance.h"
-#include "log.h"
-
-StatusCode passive_balance(uint16_t *result_arr, size_t len, LtcAfeStorage *afe) {
-  // Storage for max + min voltage values as well as the cell # with the max voltage.
-  uint16_t cell_voltage_max = 0;
-  uint16_t cell_voltage_min = 0;
-  uint16_t max_voltage_cell_num = 0;
-
-  cell_voltage_max = cell_voltage_min = result_arr[0];
-
-  // Iterate through all cells in storage, updating values.
-  for (uint8_t i = 0; i < len; i++) {
-    if (result_arr[i] > cell_voltage_max) {
-      cell_voltage_max = result_arr[i];
-      max_voltage_cell_num = i;
-    } else if (result_arr[i] < cell_voltage_min) {
-      cell_voltage_min = result_arr[i];
+
+#include <string.h>
+
+#include "misc.h"
+
+// Whether the AFE is too hot to bleed any more heat into
+static bool prv_afe_too_hot(const CellStats *temp_stats, size_t afe, uint16_t max_temp_dmv) {
+  if (max_temp_dmv == 0) {
+    return false;
+  }
+  // Without any temperatures we can't tell, so wait for the first aux conversions
+  return temp_stats->count == 0 || temp_stats->afe_max[afe] > max_temp_dmv;
+}
+
+void passive_balance_plan(const AfeReadings *readings, uint16_t max_temp_dmv,
+                          PassiveBalancePlan *plan) {
+  memset(plan, 0, sizeof(*plan));
+
+  const CellStats *stats = &readings->voltage_stats;
+  if (stats->count == 0) {
+    return;
+  }
+  const uint32_t threshold = (uint32_t)stats->min + PASSIVE_BALANCE_MIN_VOLTAGE_DIFF_MV;
+
+  for (size_t afe = 0; afe < NUM_AFES; afe++) {
+    if (prv_afe_too_hot(&readings->temp_stats, afe, max_temp_dmv)) {
+      continue;
+    }
+
+    const size_t first_cell = afe * NUM_CELL_MODULES_PER_AFE;
+    const size_t end_cell = MIN(first_cell + NUM_CELL_MODULES_PER_AFE, (size_t)stats->count);
+    for (size_t i = 0; i < PASSIVE_BALANCE_MAX_CELLS_PER_AFE; i++) {
+      // Take the highest remaining cell over the threshold
+      size_t highest = end_cell;
+      for (size_t cell = first_cell; cell < end_cell; cell++) {
+        const uint16_t bit = (uint16_t)(1u << (cell - first_cell));
+        if ((plan->discharge_bitset[afe] & bit) == 0 && readings->voltages[cell] >= threshold &&
+            (highest == end_cell || readings->voltages[cell] > readings->voltages[highest])) {
+          highest = cell;
+        }
+      }
+      if (highest == end_cell) {
+        break;
+      }
+      plan->discharge_bitset[afe] |= (uint16_t)(1u << (highest - first_cell));
+      plan->num_cells++;
     }
   }
-  // Balance cell, pass in whether difference meets threshold.
-  return ltc_afe_toggle_cell_discharge(
-      afe, max_voltage_cell_num,
-      (cell_voltage_max - cell_voltage_min >= PASSIVE_BALANCE_MIN_VOLTAGE_DIFF_MV));
+}
+
+StatusCode passive_balance(const AfeReadings *readings, uint16_t max_temp_dmv, LtcAfeStorage *afe) {
+  PassiveBalancePlan plan;
+  passive_balance_plan(readings, max_temp_dmv, &plan);
+
+  const size_t num_cells = MIN((size_t)readings->voltage_stats.count, afe->settings.num_cells);
+  for (size_t cell = 0; cell < num_cells; cell++) {
+    const size_t device = cell / NUM_CELL_MODULES_PER_AFE;
+    const bool discharge =
+        (plan.discharge_bitset[device] >> (cell % NUM_CELL_MODULES_PER_AFE)) & 0x1;
+    status_ok_or_return(ltc_afe_toggle_cell_discharge(afe, (uint16_t)cell, discharge));
+  }
+
+  return STATUS_CODE_OK;
+}
+
+StatusCode passive_balance_stop(LtcAfeStorage *afe) {
+  const size_t num_cells = MIN(afe->settings.num_cells, (size_t)NUM_TOTAL_CELLS);
+  for (size_t cell = 0; cell < num_cells; cell++) {
+    status_ok_or_return(ltc_afe_toggle_cell_discharge(afe, (uint16_t)cell, false));
+  }
+
+  return STATUS_CODE_OK;
 }
@@ -0,0 +1,193 @@
+#include "soc.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "log.h"
+#include "misc.h"
+
+#define SOC_PERSIST_MAGIC 0x534F4331  // "SOC1"
+
+// 1 mAh = 3600 mA*s = 360 cA*s
+#define SOC_CAMS_PER_MAH 360000
+// 1 Wh = 3600 W*s = 36000 dW*s
+#define SOC_DWMS_PER_WH 36000000
+
+// Readings are never more than a conversion period apart; clamping the period keeps every product
+// below in 32 bits even if the sampling timer stalls.
+#define SOC_MAX_PERIOD_MS 1000
+
+typedef struct SocOcvPoint {
+  uint16_t voltage_dmv;
+  uint16_t soc;
+} SocOcvPoint;
+
+// Resting cell voltage vs state of charge, in increasing order.
+// These are typical NCR18650B values and should be characterized against the pack.
+static const SocOcvPoint s_ocv_table[] = {
+  { 30000, 0 },    { 33000, 500 },  { 34500, 1000 }, { 35500, 2000 },
+  { 36000, 3000 }, { 36500, 4000 }, { 37000, 5000 }, { 37500, 6000 },
+  { 38500, 7000 }, { 39500, 8000 }, { 40500, 9000 }, { 42000, 10000 },
+};
+
+uint16_t soc_ocv_lookup(uint16_t cell_voltage_dmv) {
+  if (cell_voltage_dmv <= s_ocv_table[0].voltage_dmv) {
+    return s_ocv_table[0].soc;
+  }
+  for (size_t i = 1; i < SIZEOF_ARRAY(s_ocv_table); i++) {
+    const SocOcvPoint *hi = &s_ocv_table[i];
+    if (cell_voltage_dmv <= hi->voltage_dmv) {
+      const SocOcvPoint *lo = &s_ocv_table[i - 1];
+      // linearly interpolate between the surrounding points
+      return (uint16_t)(lo->soc + (uint32_t)(cell_voltage_dmv - lo->voltage_dmv) *
+                                      (uint32_t)(hi->soc - lo->soc) /
+                                      (uint32_t)(hi->voltage_dmv - lo->voltage_dmv));
+    }
+  }
+  return s_ocv_table[SIZEOF_ARRAY(s_ocv_table) - 1].soc;
+}
+
+// Sum of the cell voltages in 100 uV, or 0 if the cells haven't all been read yet.
+static uint32_t prv_pack_voltage_dmv(const AfeReadings *readings) {
+  const CellStats *stats = &readings->voltage_stats;
+  if (stats->count < NUM_TOTAL_CELLS || stats->min == 0) {
+    return 0;
+  }
+  return stats->sum;
+}
+
+static void prv_clamp_charge(SocStorage *storage) {
+  const int32_t capacity_mah = (int32_t)storage->settings.capacity_mah;
+  if (storage->charge_mah > capacity_mah) {
+    storage->charge_mah = capacity_mah;
+    storage->charge_residue_cams = 0;
+  } else if (storage->charge_mah < 0) {
+    storage->charge_mah = 0;
+    storage->charge_residue_cams = 0;
+  }
+}
+
+static void prv_update_persist_data(SocStorage *storage, bool force) {
+  const int32_t step_mah =
+      MAX((int32_t)(storage->settings.capacity_mah * SOC_PERSIST_STEP / SOC_MAX), (int32_t)1);
+  int32_t moved_mah = storage->charge_mah - storage->persist_data.charge_mah;
+  if (moved_mah < 0) {
+    moved_mah = -moved_mah;
+  }
+  if (force || moved_mah >= step_mah) {
+    // the periodic persist commit notices the change and writes it out
+    storage->persist_data.charge_mah = storage->charge_mah;
+    storage->persist_data.energy_wh = storage->energy_wh;
+  }
+}
+
+static void prv_ocv_correct(SocStorage *storage) {
+  const uint32_t pack_dmv = prv_pack_voltage_dmv(storage->settings.afe_readings);
+  if (pack_dmv == 0) {
+    return;
+  }
+  const uint16_t soc = soc_ocv_lookup((uint16_t)(pack_dmv / NUM_TOTAL_CELLS));
+  storage->charge_mah = (int32_t)(soc * storage->settings.capacity_mah / SOC_MAX);
+  storage->charge_residue_cams = 0;
+  storage->ocv_corrected = true;
+  LOG_DEBUG("SOC corrected from OCV to %d\n", soc);
+  prv_update_persist_data(storage, true);
+}
+
+static void prv_current_sense_callback(int16_t current_ca, uint32_t period_ms, void *context) {
+  soc_process_current(context, current_ca, period_ms);
+}
+
+void soc_process_current(SocStorage *storage, int16_t current_ca, uint32_t period_ms) {
+  const int32_t dt_ms = (int32_t)MIN(period_ms, (uint32_t)SOC_MAX_PERIOD_MS);
+
+  // discharging current reduces the remaining charge
+  storage->charge_residue_cams -= current_ca * dt_ms;
+  const int32_t whole_mah = storage->charge_residue_cams / SOC_CAMS_PER_MAH;
+  storage->charge_mah += whole_mah;
+  storage->charge_residue_cams -= whole_mah * SOC_CAMS_PER_MAH;
+  prv_clamp_charge(storage);
+
+  // P [dW] = V [cV] * I [cA] / 1000
+  const uint32_t pack_dmv = prv_pack_voltage_dmv(storage->settings.afe_readings);
+  const int32_t power_dw = (int32_t)(pack_dmv / 100) * current_ca / 1000;
+  storage->energy_residue_dwms += power_dw * dt_ms;
+  const int32_t whole_wh = storage->energy_residue_dwms / SOC_DWMS_PER_WH;
+  storage->energy_wh += whole_wh;
+  storage->energy_residue_dwms -= whole_wh * SOC_DWMS_PER_WH;
+
+  const int32_t magnitude_ca = (current_ca < 0) ? -current_ca : current_ca;
+  if (magnitude_ca <= storage->settings.rest_current_ca) {
+    if (storage->rest_elapsed_ms < storage->settings.rest_time_ms) {
+      storage->rest_elapsed_ms += (uint32_t)dt_ms;
+    }
+    if (!storage->ocv_corrected && storage->rest_elapsed_ms >= storage->settings.rest_time_ms) {
+      prv_ocv_correct(storage);
+    }
+  } else {
+    storage->rest_elapsed_ms = 0;
+    storage->ocv_corrected = false;
+  }
+
+  prv_update_persist_data(storage, false);
+}
+
+StatusCode soc_init(SocStorage *storage, const SocSettings *settings) {
+  if (storage == NULL || settings == NULL || settings->afe_readings == NULL ||
+      settings->capacity_mah == 0 || settings->capacity_mah >= UINT32_MAX / SOC_MAX) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+  // The persist instance's commit timer holds on to it, so it's only set up on the first init.
+  // Later inits keep it running and reload from the blob it keeps in sync with flash.
+  if (storage->persist.blob != &storage->persist_data) {
+    memset(storage, 0, sizeof(*storage));
+    status_ok_or_return(persist_init(&storage->persist, SOC_FLASH_PAGE, &storage->persist_data,
+                                     sizeof(storage->persist_data), true));
+  }
+  storage->settings = *settings;
+  storage->charge_residue_cams = 0;
+  storage->energy_residue_dwms = 0;
+  storage->rest_elapsed_ms = 0;
+  storage->ocv_corrected = false;
+
+  if (storage->persist_data.magic == SOC_PERSIST_MAGIC) {
+    storage->charge_mah = storage->persist_data.charge_mah;
+    storage->energy_wh = storage->persist_data.energy_wh;
+    prv_clamp_charge(storage);
+    // we don't know how long we were off, so wait for a rest period before correcting
+    storage->ocv_corrected = true;
+  } else {
+    LOG_DEBUG("No persisted SOC, estimating from OCV\n");
+    storage->charge_mah = (int32_t)settings->capacity_mah;
+    storage->rest_elapsed_ms = settings->rest_time_ms;
+    storage->persist_data.magic = SOC_PERSIST_MAGIC;
+    prv_update_persist_data(storage, true);
+  }
+
+  if (settings->current_storage != NULL) {
+    status_ok_or_return(current_sense_register_callback(settings->current_storage,
+                                                        prv_current_sense_callback, storage));
+  }
+  return STATUS_CODE_OK;
+}
+
+uint16_t soc_get_soc(const SocStorage *storage) {
+  if (storage->settings.capacity_mah == 0) {
+    // not initialized
+    return 0;
+  }
+  return (uint16_t)((uint32_t)storage->charge_mah * SOC_MAX / storage->settings.capacity_mah);
+}
+
+int32_t soc_get_charge_mah(const SocStorage *storage) {
+  return storage->charge_mah;
+}
+
+int32_t soc_get_energy_wh(const SocStorage *storage) {
+  return storage->energy_wh;
+}
+
+StatusCode soc_commit(SocStorage *storage) {
+  prv_update_persist_data(storage, true);
+  return persist_commit(&storage->persist);
+}
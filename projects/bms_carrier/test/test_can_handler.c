@@ -18,6 +18,8 @@
 
 #define TEST_CELL_VOLTAGE 5
 #define TEST_AVG_CURRENT 6
+#define TEST_SOC 4200
+#define TEST_ENERGY_WH 123
 #define TEST_RELAY_STATE 1
 #define TEST_FAN_STATUS STATUS_CODE_INTERNAL_ERROR
 
@@ -40,6 +42,19 @@ static StatusCode prv_test_can_handler_current_tx_callback_handler(const CanMess
   return STATUS_CODE_OK;
 }
 
+static StatusCode prv_test_can_handler_soc_tx_callback_handler(const CanMessage *msg,
+                                                               void *context,
+                                                               CanAckStatus *ack_reply) {
+  TEST_ASSERT_EQUAL(SYSTEM_CAN_MESSAGE_BATTERY_SOC, msg->msg_id);
+  uint32_t soc;
+  uint32_t energy_wh;
+  CAN_UNPACK_BATTERY_SOC(msg, &soc, &energy_wh);
+  TEST_ASSERT_EQUAL(TEST_SOC, soc);
+  TEST_ASSERT_EQUAL(TEST_ENERGY_WH, energy_wh);
+  s_can_msg_count++;
+  return STATUS_CODE_OK;
+}
+
 static StatusCode prv_test_can_handler_voltage_and_tx_callback_handler(const CanMessage *msg,
                                                                        void *context,
                                                                        CanAckStatus *ack_reply) {
@@ -86,6 +101,9 @@ static StatusCode prv_test_can_handler_fan_status_tx_callback_handler(const CanM
 
 static void prv_set_bms_storage(void) {
   s_bms_storage.current_storage.average = TEST_AVG_CURRENT;
+  s_bms_storage.soc_storage.settings.capacity_mah = SOC_MAX;
+  s_bms_storage.soc_storage.charge_mah = TEST_SOC;
+  s_bms_storage.soc_storage.energy_wh = TEST_ENERGY_WH;
   s_bms_storage.relay_storage.gnd_enabled = TEST_RELAY_STATE;
   s_bms_storage.relay_storage.hv_enabled = TEST_RELAY_STATE;
 
@@ -98,6 +116,9 @@ static void prv_set_bms_storage(void) {
     s_bms_storage.afe_readings.voltages[cell] = TEST_CELL_VOLTAGE;
   }
 
+  cell_sense_compute_stats(s_bms_storage.afe_readings.voltages, NUM_TOTAL_CELLS,
+                           NUM_CELL_MODULES_PER_AFE, &s_bms_storage.afe_readings.voltage_stats);
+
   for (uint8_t thermistor = 0; thermistor < NUM_THERMISTORS; thermistor++) {
     s_bms_storage.afe_readings.temps[thermistor] = thermistor;
   }
@@ -117,6 +138,8 @@ void setup_test(void) {
                                                  BMS_CAN_EVENT_FAULT));
   TEST_ASSERT_OK(can_register_rx_handler(SYSTEM_CAN_MESSAGE_BATTERY_AGGREGATE_VC,
                                          prv_test_can_handler_current_tx_callback_handler, NULL));
+  TEST_ASSERT_OK(can_register_rx_handler(SYSTEM_CAN_MESSAGE_BATTERY_SOC,
+                                         prv_test_can_handler_soc_tx_callback_handler, NULL));
   TEST_ASSERT_OK(can_register_rx_handler(
       SYSTEM_CAN_MESSAGE_BATTERY_VT, prv_test_can_handler_voltage_and_tx_callback_handler, NULL));
   TEST_ASSERT_OK(can_register_rx_handler(SYSTEM_CAN_MESSAGE_BATTERY_RELAY_STATE,
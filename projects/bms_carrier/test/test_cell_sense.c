@@ -1,5 +1,7 @@
 #include "cell_sense.h"
 
+#include <string.h>
+
 #include "bms.h"
 #include "bms_events.h"
 #include "current_sense.h"
@@ -9,6 +11,7 @@
 #include "interrupt.h"
 #include "log.h"
 #include "ltc_afe.h"
+#include "misc.h"
 #include "ms_test_helpers.h"
 #include "soft_timer.h"
 #include "test_helpers.h"
@@ -34,12 +37,15 @@ bool TEST_MOCK(current_sense_is_charging)() {
 }
 
 uint8_t s_expected_fault_bitset;
+static uint8_t s_fault_bitset;
 void TEST_MOCK(fault_bps_set)(uint8_t fault_bitmask) {
   TEST_ASSERT_EQUAL((s_expected_fault_bitset & fault_bitmask) == 0x0, false);
+  s_fault_bitset |= fault_bitmask;
 }
 
 void TEST_MOCK(fault_bps_clear)(uint8_t fault_bitmask) {
   TEST_ASSERT_EQUAL((s_expected_fault_bitset & fault_bitmask) == 0x0, true);
+  s_fault_bitset &= (uint8_t)~fault_bitmask;
 }
 
 static bool s_afe_should_fault;
@@ -153,6 +159,8 @@ void setup_test(void) {
   s_is_charging = false;
   s_afe_should_fault = false;
   s_expected_fault_bitset = EE_BPS_STATE_OK;
+  s_fault_bitset = EE_BPS_STATE_OK;
+  s_raw_readings.temps[3] = TEMP_READING_MAX;
   TEST_ASSERT_OK(prv_init_ltc());
 }
 
@@ -246,6 +254,29 @@ void test_temp_discharging_fault_cell_sense(void) {
   MS_TEST_HELPER_ASSERT_NEXT_EVENT_ID(e, BMS_AFE_EVENT_TRIGGER_CELL_CONV);
 }
 
+// The temperature fault clears once every thermistor is back under the threshold.
+void test_temp_fault_recovers_cell_sense(void) {
+  CellSenseSettings settings = {
+    .undervoltage_dmv = VOLTAGE_READING_MIN,
+    .overvoltage_dmv = VOLTAGE_READING_MAX,
+    .charge_overtemp_dmv = TEMP_READING_MAX,
+    .discharge_overtemp_dmv = TEMP_READING_MAX - 50,
+  };
+  Event e = { 0 };
+  TEST_ASSERT_OK(cell_sense_init(&settings, &s_readings, &s_afe));
+
+  s_expected_fault_bitset = EE_BPS_STATE_FAULT_AFE_TEMP;
+  prv_test_single_loop();
+  TEST_ASSERT_EQUAL(EE_BPS_STATE_FAULT_AFE_TEMP, s_fault_bitset & EE_BPS_STATE_FAULT_AFE_TEMP);
+
+  s_raw_readings.temps[3] = TEMP_READING_MAX - 50;
+  s_expected_fault_bitset = EE_BPS_STATE_OK;
+  prv_test_single_loop();
+  TEST_ASSERT_EQUAL(0, s_fault_bitset & EE_BPS_STATE_FAULT_AFE_TEMP);
+
+  MS_TEST_HELPER_ASSERT_NEXT_EVENT_ID(e, BMS_AFE_EVENT_TRIGGER_CELL_CONV);
+}
+
 void test_afe_fsm_fault_cell_sense(void) {
   CellSenseSettings settings = {
     .undervoltage_dmv = VOLTAGE_READING_MIN,
@@ -269,3 +300,70 @@ void test_afe_fsm_fault_cell_sense(void) {
 
   MS_TEST_HELPER_ASSERT_NEXT_EVENT_ID(e, BMS_AFE_EVENT_TRIGGER_CELL_CONV);
 }
+
+void test_cell_sense_stats_per_sweep(void) {
+  CellSenseSettings settings = {
+    .undervoltage_dmv = VOLTAGE_READING_MIN,
+    .overvoltage_dmv = VOLTAGE_READING_MAX,
+    .charge_overtemp_dmv = TEMP_READING_MAX,
+    .discharge_overtemp_dmv = TEMP_READING_MAX,
+  };
+  Event e = { 0 };
+  memset(&s_readings, 0, sizeof(s_readings));
+  TEST_ASSERT_OK(cell_sense_init(&settings, &s_readings, &s_afe));
+
+  for (uint32_t sweep = 1; sweep <= NUM_GOOD_CELL_SENSE_TRIALS; sweep++) {
+    prv_test_single_loop();
+    TEST_ASSERT_EQUAL(sweep, s_readings.sequence);
+
+    const CellStats *voltage_stats = &s_readings.voltage_stats;
+    TEST_ASSERT_EQUAL(sweep, voltage_stats->sequence);
+    TEST_ASSERT_EQUAL(NUM_CELLS_TO_TEST, voltage_stats->count);
+    TEST_ASSERT_EQUAL(VOLTAGE_READING_MIN, voltage_stats->min);
+    TEST_ASSERT_EQUAL(VOLTAGE_READING_MAX, voltage_stats->max);
+    TEST_ASSERT_EQUAL(0, voltage_stats->argmin);
+    TEST_ASSERT_EQUAL(3, voltage_stats->argmax);
+    TEST_ASSERT_EQUAL(42 + 69 + 420 + 1337, voltage_stats->sum);
+
+    // the temperatures read after the voltages are tagged with the same sweep
+    TEST_ASSERT_EQUAL(sweep, s_readings.temp_stats.sequence);
+    TEST_ASSERT_EQUAL(TEMP_READING_MAX, s_readings.temp_stats.max);
+  }
+  MS_TEST_HELPER_ASSERT_NEXT_EVENT_ID(e, BMS_AFE_EVENT_TRIGGER_CELL_CONV);
+}
+
+void test_cell_sense_compute_stats(void) {
+  const uint16_t readings[] = { 30, 10, 20, 50, 10, 50, 40 };
+  CellStats stats;
+
+  cell_sense_compute_stats(readings, SIZEOF_ARRAY(readings), 3, &stats);
+  TEST_ASSERT_EQUAL(7, stats.count);
+  TEST_ASSERT_EQUAL(10, stats.min);
+  TEST_ASSERT_EQUAL(50, stats.max);
+  // ties report the first occurrence
+  TEST_ASSERT_EQUAL(1, stats.argmin);
+  TEST_ASSERT_EQUAL(3, stats.argmax);
+  TEST_ASSERT_EQUAL(210, stats.sum);
+
+  TEST_ASSERT_EQUAL(10, stats.afe_min[0]);
+  TEST_ASSERT_EQUAL(30, stats.afe_max[0]);
+  TEST_ASSERT_EQUAL(60, stats.afe_sum[0]);
+  TEST_ASSERT_EQUAL(10, stats.afe_min[1]);
+  TEST_ASSERT_EQUAL(50, stats.afe_max[1]);
+  TEST_ASSERT_EQUAL(110, stats.afe_sum[1]);
+  TEST_ASSERT_EQUAL(40, stats.afe_min[2]);
+  TEST_ASSERT_EQUAL(40, stats.afe_max[2]);
+  TEST_ASSERT_EQUAL(40, stats.afe_sum[2]);
+
+  // readings past the last AFE are ignored, and empty AFEs report 0
+  cell_sense_compute_stats(readings, SIZEOF_ARRAY(readings), 1, &stats);
+  TEST_ASSERT_EQUAL(NUM_AFES, stats.count);
+  TEST_ASSERT_EQUAL(60, stats.sum);
+  cell_sense_compute_stats(readings, 2, 3, &stats);
+  TEST_ASSERT_EQUAL(0, stats.afe_min[1]);
+  TEST_ASSERT_EQUAL(0, stats.afe_max[1]);
+
+  cell_sense_compute_stats(readings, 0, 3, &stats);
+  TEST_ASSERT_EQUAL(0, stats.count);
+  TEST_ASSERT_EQUAL(0, stats.max);
+}
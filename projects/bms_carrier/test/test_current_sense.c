@@ -23,7 +23,7 @@ static CurrentStorage s_storage;
 static uint8_t s_fault_bps_bitmask = 0;
 static bool s_fault_bps_clear = false;
 
-static double s_ads_read = 0.0;
+static int32_t s_ads_read_uv = 0;
 static Ads1259ErrorHandlerCb s_ads_cb = NULL;
 
 StatusCode TEST_MOCK(fault_bps_set)(uint8_t fault_bitmask) {
@@ -39,7 +39,7 @@ StatusCode TEST_MOCK(fault_bps_clear)(uint8_t fault_bitmask) {
 }
 
 StatusCode TEST_MOCK(ads1259_get_conversion_data)(Ads1259Storage *storage) {
-  storage->reading = s_ads_read;
+  storage->reading_uv = s_ads_read_uv;
   return STATUS_CODE_OK;
 }
 
@@ -55,21 +55,21 @@ void setup_test(void) {
   s_fault_bps_bitmask = 0;
   s_fault_bps_clear = false;
 
-  s_ads_read = 0.0;
+  s_ads_read_uv = 0;
   s_ads_cb = NULL;
 }
 
 void teardown_test(void) {}
 
 void test_is_charging(void) {
-  s_ads_read = 0.5;
+  s_ads_read_uv = 500000;
   TEST_ASSERT_OK(current_sense_init(&s_storage, &s_spi_settings, TEST_CS_CONV_DELAY));
   delay_ms(TEST_CS_CONV_DELAY * NUM_STORED_CURRENT_READINGS);
   TEST_ASSERT_FALSE(current_sense_is_charging());
   TEST_ASSERT_EQUAL(EE_BPS_STATE_FAULT_CURRENT_SENSE, s_fault_bps_bitmask);
   TEST_ASSERT(s_fault_bps_clear);
 
-  s_ads_read = -0.5;
+  s_ads_read_uv = -500000;
   delay_ms(TEST_CS_CONV_DELAY * NUM_STORED_CURRENT_READINGS);
   TEST_ASSERT_TRUE(current_sense_is_charging());
   TEST_ASSERT_EQUAL(EE_BPS_STATE_FAULT_CURRENT_SENSE, s_fault_bps_bitmask);
@@ -77,7 +77,7 @@ void test_is_charging(void) {
 }
 
 void test_oc_discharging(void) {
-  s_ads_read = 1.5;
+  s_ads_read_uv = 1500000;
   TEST_ASSERT_OK(current_sense_init(&s_storage, &s_spi_settings, TEST_CS_CONV_DELAY));
   delay_ms(TEST_CS_CONV_DELAY * NUM_STORED_CURRENT_READINGS);
   TEST_ASSERT_EQUAL(EE_BPS_STATE_FAULT_CURRENT_SENSE, s_fault_bps_bitmask);
@@ -85,7 +85,7 @@ void test_oc_discharging(void) {
 }
 
 void test_oc_charging(void) {
-  s_ads_read = -0.9;
+  s_ads_read_uv = -900000;
   s_fault_bps_clear = true;
   TEST_ASSERT_OK(current_sense_init(&s_storage, &s_spi_settings, TEST_CS_CONV_DELAY));
   delay_ms(TEST_CS_CONV_DELAY * NUM_STORED_CURRENT_READINGS);
@@ -94,12 +94,12 @@ void test_oc_charging(void) {
 }
 
 void test_ring_no_segfault(void) {
-  s_ads_read = 0.03;
+  s_ads_read_uv = 30000;
   TEST_ASSERT_OK(current_sense_init(&s_storage, &s_spi_settings, TEST_CS_CONV_DELAY));
   delay_ms(TEST_CS_CONV_DELAY * 5);
-  s_ads_read = 0.01;
+  s_ads_read_uv = 10000;
   delay_ms(TEST_CS_CONV_DELAY * (NUM_STORED_CURRENT_READINGS + 3));  // would segfault if incorrect
-  // assert it's the calculated value based on 0.01, not 0.03
+  // assert it's the calculated value based on 10mV, not 30mV
   TEST_ASSERT_EQUAL(100, s_storage.average);
 }
 
@@ -110,3 +110,17 @@ void test_error_cb(void) {
   TEST_ASSERT_EQUAL(EE_BPS_STATE_FAULT_CURRENT_SENSE, s_fault_bps_bitmask);
   TEST_ASSERT_FALSE(s_fault_bps_clear);
 }
+
+// Overcurrent should fault off the short window, well before the long window average crosses it.
+void test_oc_fast_detection(void) {
+  s_ads_read_uv = 0;
+  TEST_ASSERT_OK(current_sense_init(&s_storage, &s_spi_settings, TEST_CS_CONV_DELAY));
+  delay_ms(TEST_CS_CONV_DELAY * NUM_STORED_CURRENT_READINGS);
+  TEST_ASSERT(s_fault_bps_clear);
+
+  s_ads_read_uv = 1500000;
+  delay_ms(TEST_CS_CONV_DELAY * (NUM_FAST_CURRENT_READINGS + 2));
+  TEST_ASSERT_EQUAL(EE_BPS_STATE_FAULT_CURRENT_SENSE, s_fault_bps_bitmask);
+  TEST_ASSERT_FALSE(s_fault_bps_clear);
+  TEST_ASSERT_TRUE(s_storage.average < DISCHARGE_OVERCURRENT_CA);
+}
@@ -1,18 +1,21 @@
 #include "fan_control.h"
 
 #include "bms.h"
+#include "delay.h"
 #include "interrupt.h"
 #include "log.h"
 #include "test_helpers.h"
+#include "thermistor.h"
 
 #define FAN_SPEED_POLL_INTERVAL_MS 1000
+#define FAN_STALL_POLL_INTERVAL_MS 10
 #define I2C_WRITE_ADDR 0x5E
 #define I2C_READ_ADDR 0x5F
 #define I2C_PORT I2C_PORT_2
 #define ADT_PWM_PORT ADT_PWM_PORT_1
-#define VALID_TEMP 21
-#define MAX_TEMP 43
-#define VALID_SPEED 48
+#define VALID_TEMP_DC 210
+#define MAX_TEMP_DC (MAX_BATTERY_TEMP * 10)
+#define SPINNING_RPM 2000
 #define SDA \
   { GPIO_PORT_B, 11 }
 #define SCL \
@@ -20,40 +23,30 @@
 
 static FanStorage s_fan_storage = { 0 };
 static AfeReadings s_readings;
+static uint16_t s_rpms[ADT_7476A_NUM_FANS];
 
-StatusCode TEST_MOCK(prv_measure_temps)(SoftTimerId timer_id, void *context) {
-  FanStorage *storage = (FanStorage *)context;
-
-  uint16_t max = 0;
-  uint8_t fan_speed = 0;
+StatusCode TEST_MOCK(adt7476a_get_fan_rpm)(I2CPort port, uint8_t adt7476a_i2c_addr, AdtTach tach,
+                                           uint16_t *rpm) {
+  TEST_ASSERT_TRUE(tach < ADT_7476A_NUM_FANS);
+  *rpm = s_rpms[tach];
+  return STATUS_CODE_OK;
+}
 
+// Sets every thermistor to read as |temp_dc|, in the dmv the AFE reports
+static void prv_set_temps(uint16_t temp_dc) {
+  uint16_t thermistor_ohms = 0;
+  TEST_ASSERT_OK(thermistor_calculate_resistance(temp_dc, &thermistor_ohms));
+  uint16_t reading_dmv =
+      (uint16_t)((uint32_t)BMS_FAN_THERMISTOR_VREF_DMV * THERMISTOR_FIXED_RESISTANCE_OHMS /
+                 (THERMISTOR_FIXED_RESISTANCE_OHMS + thermistor_ohms));
   for (int i = 0; i < NUM_THERMISTORS; i++) {
-    if (storage->readings->temps[i] > max) {
-      max = storage->readings->temps[i];
-    }
+    s_readings.temps[i] = reading_dmv;
   }
-
-  // calculate fan speed
-
-  (max > MAX_BATTERY_TEMP) ? (fan_speed = MAX_FAN_SPEED)
-                           : (fan_speed = (MAX_FAN_SPEED / MAX_BATTERY_TEMP));
-
-  adt7476a_set_speed(BMS_FAN_CTRL_I2C_PORT_1, fan_speed, ADT_PWM_PORT_1, storage->i2c_write_addr);
-  adt7476a_set_speed(BMS_FAN_CTRL_I2C_PORT_1, fan_speed, ADT_PWM_PORT_2, storage->i2c_write_addr);
-
-  storage->speed = fan_speed;
-  storage->status = STATUS_CODE_OK;
-
-  return storage->status;
-}
-
-void setup_test(void) {
-  soft_timer_init();
+  cell_sense_compute_stats(s_readings.temps, NUM_THERMISTORS, NUM_THERMISTORS_PER_AFE,
+                           &s_readings.temp_stats);
 }
 
-void teardown_test(void) {}
-
-void test_fan_control_init(void) {
+static StatusCode prv_init(uint32_t poll_interval_ms) {
   I2CSettings i2c_settings = {
     .speed = I2C_SPEED_FAST,
     .scl = SCL,
@@ -62,42 +55,59 @@ void test_fan_control_init(void) {
 
   s_fan_storage.i2c_read_addr = I2C_WRITE_ADDR;
   s_fan_storage.i2c_write_addr = I2C_READ_ADDR;
-
-  for (int i = 0; i < NUM_THERMISTORS; i++) {
-    s_readings.temps[i] = VALID_TEMP;
-  }
-
   s_fan_storage.readings = &s_readings;
 
   FanControlSettings s_settings = {
     .i2c_settings = i2c_settings,
-    .poll_interval_ms = FAN_SPEED_POLL_INTERVAL_MS,
+    .poll_interval_ms = poll_interval_ms,
   };
 
-  TEST_ASSERT_OK(fan_control_init(&s_settings, &s_fan_storage));
+  return fan_control_init(&s_settings, &s_fan_storage);
+}
+
+void setup_test(void) {
+  interrupt_init();
+  soft_timer_init();
+  for (int i = 0; i < ADT_7476A_NUM_FANS; i++) {
+    s_rpms[i] = SPINNING_RPM;
+  }
+}
+
+void teardown_test(void) {}
 
-  TEST_ASSERT_EQUAL(VALID_SPEED, s_fan_storage.speed);
+// The fans stay off while the pack is cool.
+void test_fan_control_init(void) {
+  prv_set_temps(VALID_TEMP_DC);
+  TEST_ASSERT_OK(prv_init(FAN_SPEED_POLL_INTERVAL_MS));
+
+  TEST_ASSERT_EQUAL(0, s_fan_storage.speed);
   TEST_ASSERT_EQUAL(STATUS_CODE_OK, s_fan_storage.status);
 }
 
 void test_fan_max_temp(void) {
-  I2CSettings i2c_settings = {
-    .speed = I2C_SPEED_FAST,
-    .scl = SCL,
-    .sda = SDA,
-  };
+  prv_set_temps(MAX_TEMP_DC);
+  TEST_ASSERT_OK(prv_init(FAN_SPEED_POLL_INTERVAL_MS));
 
-  for (int i = 0; i < NUM_THERMISTORS; i++) {
-    s_readings.temps[i] = MAX_TEMP;
+  TEST_ASSERT_EQUAL(MAX_FAN_SPEED, s_fan_storage.speed);
+  TEST_ASSERT_EQUAL(STATUS_CODE_OK, s_fan_storage.status);
+  for (int i = 0; i < ADT_7476A_NUM_FANS; i++) {
+    TEST_ASSERT_EQUAL(STATUS_CODE_OK, s_fan_storage.statuses[i]);
+    TEST_ASSERT_EQUAL(SPINNING_RPM, s_fan_storage.rpms[i]);
   }
+}
 
-  FanControlSettings s_settings = {
-    .i2c_settings = i2c_settings,
-    .poll_interval_ms = FAN_SPEED_POLL_INTERVAL_MS,
-  };
+// A fan that doesn't spin up is reported as stalled after a few polls, until it spins again.
+void test_fan_stall(void) {
+  prv_set_temps(MAX_TEMP_DC);
+  s_rpms[1] = 0;
+  TEST_ASSERT_OK(prv_init(FAN_STALL_POLL_INTERVAL_MS));
+  TEST_ASSERT_EQUAL(STATUS_CODE_OK, s_fan_storage.statuses[1]);
 
-  TEST_ASSERT_OK(fan_control_init(&s_settings, &s_fan_storage));
+  delay_ms(FAN_STALL_POLL_INTERVAL_MS * (BMS_FAN_STALL_POLLS + 1));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INTERNAL_ERROR, s_fan_storage.statuses[1]);
+  TEST_ASSERT_EQUAL(STATUS_CODE_OK, s_fan_storage.statuses[0]);
 
-  TEST_ASSERT_EQUAL(MAX_FAN_SPEED, s_fan_storage.speed);
-  TEST_ASSERT_EQUAL(STATUS_CODE_OK, s_fan_storage.status);
+  s_rpms[1] = SPINNING_RPM;
+  delay_ms(FAN_STALL_POLL_INTERVAL_MS * 2);
+  TEST_ASSERT_EQUAL(STATUS_CODE_OK, s_fan_storage.statuses[1]);
 }
@@ -1,91 +1,111 @@
 // Test sequence for passive balancing module
 #include "passive_balance.h"
 
+#include <string.h>
+
 #include "cell_sense.h"
 #include "ltc_afe.h"
 #include "ms_test_helpers.h"
 
 #include "log.h"
 
-static uint16_t s_cell_balanced = 0;
-static bool s_cell_discharge = false;
+#define TEST_TEMP_NORMAL_DMV 1000
+#define TEST_MAX_TEMP_DMV 1500
+
+static bool s_cell_discharge[NUM_TOTAL_CELLS];
 
 StatusCode TEST_MOCK(ltc_afe_toggle_cell_discharge)(LtcAfeStorage *afe, uint16_t cell,
                                                     bool discharge) {
-  s_cell_balanced = cell;
-  s_cell_discharge = discharge;
+  TEST_ASSERT_TRUE(cell < NUM_TOTAL_CELLS);
+  s_cell_discharge[cell] = discharge;
   return STATUS_CODE_OK;
 }
 
-// To store voltages for test
-static uint16_t s_test_voltages[NUM_TOTAL_CELLS];
+// To store readings for test
+static AfeReadings s_test_readings;
 
 static LtcAfeStorage s_test_afe_storage;
 
+static StatusCode prv_balance(uint16_t max_temp_dmv) {
+  cell_sense_compute_stats(s_test_readings.voltages, NUM_TOTAL_CELLS, NUM_CELL_MODULES_PER_AFE,
+                           &s_test_readings.voltage_stats);
+  cell_sense_compute_stats(s_test_readings.temps, NUM_THERMISTORS, NUM_THERMISTORS_PER_AFE,
+                           &s_test_readings.temp_stats);
+  return passive_balance(&s_test_readings, max_temp_dmv, &s_test_afe_storage);
+}
+
+static uint8_t prv_num_discharging(void) {
+  uint8_t num_discharging = 0;
+  for (uint8_t i = 0; i < NUM_TOTAL_CELLS; i++) {
+    num_discharging += s_cell_discharge[i];
+  }
+  return num_discharging;
+}
+
 // Set all voltages to 1010.  Indices 0-3 only used in most tests for simplicity
 void setup_test(void) {
   for (uint8_t i = 0; i < NUM_TOTAL_CELLS; i++) {
-    s_test_voltages[i] = 1010;
+    s_test_readings.voltages[i] = 1010;
+    s_cell_discharge[i] = false;
+  }
+  for (uint8_t i = 0; i < NUM_THERMISTORS; i++) {
+    s_test_readings.temps[i] = TEST_TEMP_NORMAL_DMV;
   }
+  s_test_afe_storage.settings.num_cells = NUM_TOTAL_CELLS;
 }
 
 void teardown_test(void) {}
 
-// Balance a few values, ensure cell bitset is set properly.
+// Balance a few values, ensure every cell over the threshold is discharged.
 void test_normal_operation(void) {
   LOG_DEBUG("Testing passive balancing normal operation\n");
-  // Stores cell and device that should be balanced
-  uint8_t balance_cell = 2;
 
-  // Only cell 2 should be balanced
-  s_test_voltages[0] = 1000;
-  s_test_voltages[1] = 1025;
-  s_test_voltages[balance_cell] = 1030;
-  s_test_voltages[3] = 1010;
+  // Cells 1 and 2 should be balanced
+  s_test_readings.voltages[0] = 1000;
+  s_test_readings.voltages[1] = 1025;
+  s_test_readings.voltages[2] = 1030;
+  s_test_readings.voltages[3] = 1010;
 
   // Verify
-  passive_balance(s_test_voltages, NUM_TOTAL_CELLS, &s_test_afe_storage);
-  TEST_ASSERT_EQUAL(s_cell_balanced, balance_cell);
-  TEST_ASSERT_EQUAL(s_cell_discharge, true);
+  TEST_ASSERT_OK(prv_balance(0));
+  TEST_ASSERT_TRUE(s_cell_discharge[1]);
+  TEST_ASSERT_TRUE(s_cell_discharge[2]);
+  TEST_ASSERT_EQUAL(2, prv_num_discharging());
 }
 
 // First cell in range
 void test_balance_first_cell(void) {
   LOG_DEBUG("Testing balancing first cell in range\n");
   uint8_t balance_cell = 0;
-  s_cell_balanced = 1;
-  s_cell_discharge = false;
 
   // Only cell 0 should be balanced
-  s_test_voltages[balance_cell] = 1040;
-  s_test_voltages[1] = 1025;
-  s_test_voltages[2] = 1010;
-  s_test_voltages[3] = 1010;
+  s_test_readings.voltages[balance_cell] = 1040;
+  s_test_readings.voltages[1] = 1025;
+  s_test_readings.voltages[2] = 1010;
+  s_test_readings.voltages[3] = 1010;
 
   // Verify
-  passive_balance(s_test_voltages, NUM_TOTAL_CELLS, &s_test_afe_storage);
-  TEST_ASSERT_EQUAL(s_cell_balanced, balance_cell);
-  TEST_ASSERT_EQUAL(s_cell_discharge, true);
+  TEST_ASSERT_OK(prv_balance(0));
+  TEST_ASSERT_TRUE(s_cell_discharge[balance_cell]);
+  TEST_ASSERT_EQUAL(1, prv_num_discharging());
 }
 
 // Last cell in range
 void test_balance_last_cell(void) {
   LOG_DEBUG("Testing balancing last cell in range\n");
   uint8_t balance_cell = NUM_TOTAL_CELLS - 1;
-  s_cell_balanced = 0;
-  s_cell_discharge = false;
 
-  // Only last cell should be balanced
-  s_test_voltages[0] = 1000;
-  s_test_voltages[1] = 1025;
-  s_test_voltages[2] = 1030;
-  s_test_voltages[3] = 1010;
-  s_test_voltages[balance_cell] = 1040;
+  // Only the last cell should be balanced
+  s_test_readings.voltages[0] = 1020;
+  s_test_readings.voltages[1] = 1025;
+  s_test_readings.voltages[2] = 1030;
+  s_test_readings.voltages[3] = 1010;
+  s_test_readings.voltages[balance_cell] = 1040;
 
   // Verify
-  passive_balance(s_test_voltages, NUM_TOTAL_CELLS, &s_test_afe_storage);
-  TEST_ASSERT_EQUAL(s_cell_balanced, balance_cell);
-  TEST_ASSERT_EQUAL(s_cell_discharge, true);
+  TEST_ASSERT_OK(prv_balance(0));
+  TEST_ASSERT_TRUE(s_cell_discharge[balance_cell]);
+  TEST_ASSERT_EQUAL(1, prv_num_discharging());
 }
 
 // Test cell 2 at edge of PASSIVE_BALANCE_MIN_VOLTAGE_DIFF_MV
@@ -93,28 +113,80 @@ void test_balance_range(void) {
   // Same general procedures as in tests above
   LOG_DEBUG("Testing balancing around edge of range\n");
 
-  uint8_t balance_cell = 0;
-  s_cell_discharge = false;
+  uint8_t balance_cell = 2;
 
   // No cell should be balanced
-  s_test_voltages[0] = 1000;
-  s_test_voltages[1] = 1024;
-  s_test_voltages[2] = 1000 + PASSIVE_BALANCE_MIN_VOLTAGE_DIFF_MV - 1;
-  s_test_voltages[3] = 1010;
+  s_test_readings.voltages[0] = 1000;
+  s_test_readings.voltages[1] = 1024;
+  s_test_readings.voltages[balance_cell] = 1000 + PASSIVE_BALANCE_MIN_VOLTAGE_DIFF_MV - 1;
+  s_test_readings.voltages[3] = 1010;
 
   // Verify
-  passive_balance(s_test_voltages, NUM_TOTAL_CELLS, &s_test_afe_storage);
-  TEST_ASSERT_EQUAL(s_cell_discharge, false);
-
-  balance_cell = 2;
-  s_cell_balanced = 0;
-  s_cell_discharge = false;
+  TEST_ASSERT_OK(prv_balance(0));
+  TEST_ASSERT_EQUAL(0, prv_num_discharging());
 
   // Increment cell 2 voltage, should be balanced now
-  s_test_voltages[balance_cell]++;
+  s_test_readings.voltages[balance_cell]++;
 
   // Verify
-  passive_balance(s_test_voltages, NUM_TOTAL_CELLS, &s_test_afe_storage);
-  TEST_ASSERT_EQUAL(s_cell_balanced, balance_cell);
-  TEST_ASSERT_EQUAL(s_cell_discharge, true);
+  TEST_ASSERT_OK(prv_balance(0));
+  TEST_ASSERT_TRUE(s_cell_discharge[balance_cell]);
+  TEST_ASSERT_EQUAL(1, prv_num_discharging());
+
+  // Cells that come back within range stop being balanced
+  s_test_readings.voltages[balance_cell]--;
+  TEST_ASSERT_OK(prv_balance(0));
+  TEST_ASSERT_EQUAL(0, prv_num_discharging());
+}
+
+// Only the highest PASSIVE_BALANCE_MAX_CELLS_PER_AFE cells of an AFE discharge at once.
+void test_balance_per_afe_limit(void) {
+  LOG_DEBUG("Testing balancing limit per AFE\n");
+  s_test_readings.voltages[NUM_CELL_MODULES_PER_AFE] = 1000;
+  for (uint8_t i = 0; i < NUM_CELL_MODULES_PER_AFE; i++) {
+    s_test_readings.voltages[i] = (uint16_t)(1100 + i);
+  }
+
+  TEST_ASSERT_OK(prv_balance(0));
+  for (uint8_t i = 0; i < NUM_CELL_MODULES_PER_AFE; i++) {
+    TEST_ASSERT_EQUAL(i >= NUM_CELL_MODULES_PER_AFE - PASSIVE_BALANCE_MAX_CELLS_PER_AFE,
+                      s_cell_discharge[i]);
+  }
+  // The rest of the pack is within range of the lowest cell
+  TEST_ASSERT_EQUAL(PASSIVE_BALANCE_MAX_CELLS_PER_AFE, prv_num_discharging());
+}
+
+// AFEs that read too hot don't balance, and nothing balances before temperatures are read.
+void test_balance_thermal_limit(void) {
+  LOG_DEBUG("Testing balancing thermal limit\n");
+  s_test_readings.voltages[0] = 1100;
+  s_test_readings.voltages[NUM_CELL_MODULES_PER_AFE] = 1100;
+  s_test_readings.temps[NUM_THERMISTORS_PER_AFE + 1] = TEST_MAX_TEMP_DMV + 1;
+
+  TEST_ASSERT_OK(prv_balance(TEST_MAX_TEMP_DMV));
+  TEST_ASSERT_TRUE(s_cell_discharge[0]);
+  TEST_ASSERT_FALSE(s_cell_discharge[NUM_CELL_MODULES_PER_AFE]);
+
+  // Without a limit both balance
+  TEST_ASSERT_OK(prv_balance(0));
+  TEST_ASSERT_TRUE(s_cell_discharge[0]);
+  TEST_ASSERT_TRUE(s_cell_discharge[NUM_CELL_MODULES_PER_AFE]);
+
+  // No temperatures yet
+  PassiveBalancePlan plan;
+  memset(&s_test_readings.temp_stats, 0, sizeof(s_test_readings.temp_stats));
+  passive_balance_plan(&s_test_readings, TEST_MAX_TEMP_DMV, &plan);
+  TEST_ASSERT_EQUAL(0, plan.num_cells);
+}
+
+// Stopping clears discharge on every cell.
+void test_balance_stop(void) {
+  LOG_DEBUG("Testing balancing stop\n");
+  s_test_readings.voltages[0] = 1100;
+  s_test_readings.voltages[NUM_TOTAL_CELLS - 1] = 1100;
+  TEST_ASSERT_OK(prv_balance(0));
+  TEST_ASSERT_EQUAL(2, prv_num_discharging());
+
+  TEST_ASSERT_OK(passive_balance_stop(&s_test_afe_storage));
+  TEST_ASSERT_EQUAL(0, prv_num_discharging());
 }
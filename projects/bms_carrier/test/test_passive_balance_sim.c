@@ -0,0 +1,158 @@
+// Simulates balancing a pack from synthetic imbalances and reports the time it takes, comparing
+// the planner against bleeding only the highest cell.
+//
+// Each sweep is a cell conversion followed by the aux conversions, and the planned cells bleed
+// during the aux conversions at a fixed rate. Bleeding only the highest cell kept its discharge on
+// through the whole sweep. Cell voltages are tracked in nano-dmv so the readings the planner sees
+// only change once a cell has bled a whole dmv, and the simulation jumps straight to that sweep.
+#include "passive_balance.h"
+
+#include <string.h>
+
+#include "cell_sense.h"
+#include "log.h"
+#include "ltc_afe_fsm.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_SIM_NDMV_PER_DMV 1000000000ull
+#define TEST_SIM_MS_PER_HOUR (60ull * 60 * 1000)
+
+// Nominal cell voltage, 3.6 V
+#define TEST_SIM_CELL_DMV 36000
+// How fast a bleeding cell's voltage falls in the flat part of its discharge curve
+#define TEST_SIM_BLEED_DMV_PER_HOUR 10
+
+#define TEST_SIM_AUX_MS (NUM_THERMISTORS_PER_AFE * LTC_AFE_FSM_AUX_CONV_DELAY_MS)
+#define TEST_SIM_SWEEP_MS (LTC_AFE_FSM_CELL_CONV_DELAY_MS + TEST_SIM_AUX_MS)
+
+// Give up on a pack that hasn't balanced after this long
+#define TEST_SIM_MAX_HOURS 1000
+
+typedef enum {
+  TEST_SIM_STRATEGY_PLANNER = 0,
+  TEST_SIM_STRATEGY_HIGHEST_CELL,
+} TestSimStrategy;
+
+static uint64_t s_cells_ndmv[NUM_TOTAL_CELLS];
+static AfeReadings s_readings;
+
+static void prv_read_cells(void) {
+  for (size_t cell = 0; cell < NUM_TOTAL_CELLS; cell++) {
+    s_readings.voltages[cell] = (uint16_t)(s_cells_ndmv[cell] / TEST_SIM_NDMV_PER_DMV);
+  }
+  cell_sense_compute_stats(s_readings.voltages, NUM_TOTAL_CELLS, NUM_CELL_MODULES_PER_AFE,
+                           &s_readings.voltage_stats);
+}
+
+// Fills |discharging| for the next sweep, returning false once the pack is balanced
+static bool prv_plan(TestSimStrategy strategy, bool discharging[NUM_TOTAL_CELLS]) {
+  memset(discharging, 0, NUM_TOTAL_CELLS * sizeof(discharging[0]));
+  const CellStats *stats = &s_readings.voltage_stats;
+
+  if (strategy == TEST_SIM_STRATEGY_HIGHEST_CELL) {
+    discharging[stats->argmax] = true;
+    return stats->max - stats->min >= PASSIVE_BALANCE_MIN_VOLTAGE_DIFF_MV;
+  }
+
+  PassiveBalancePlan plan;
+  passive_balance_plan(&s_readings, 0, &plan);
+  for (size_t cell = 0; cell < NUM_TOTAL_CELLS; cell++) {
+    discharging[cell] = (plan.discharge_bitset[cell / NUM_CELL_MODULES_PER_AFE] >>
+                         (cell % NUM_CELL_MODULES_PER_AFE)) &
+                        0x1;
+  }
+  return plan.num_cells > 0;
+}
+
+// Returns how long the pack took to balance in ms, or UINT32_MAX if it didn't
+static uint32_t prv_time_to_balance(const uint16_t offsets_dmv[NUM_TOTAL_CELLS],
+                                    TestSimStrategy strategy) {
+  for (size_t cell = 0; cell < NUM_TOTAL_CELLS; cell++) {
+    s_cells_ndmv[cell] = ((uint64_t)TEST_SIM_CELL_DMV + offsets_dmv[cell]) * TEST_SIM_NDMV_PER_DMV;
+  }
+  // Temperatures aren't simulated
+  memset(&s_readings, 0, sizeof(s_readings));
+
+  const uint32_t bleed_ms =
+      (strategy == TEST_SIM_STRATEGY_PLANNER) ? TEST_SIM_AUX_MS : TEST_SIM_SWEEP_MS;
+  const uint64_t bleed_ndmv_per_sweep =
+      TEST_SIM_BLEED_DMV_PER_HOUR * TEST_SIM_NDMV_PER_DMV * bleed_ms / TEST_SIM_MS_PER_HOUR;
+
+  bool discharging[NUM_TOTAL_CELLS];
+  uint64_t num_sweeps = 0;
+  while (num_sweeps * TEST_SIM_SWEEP_MS < TEST_SIM_MAX_HOURS * TEST_SIM_MS_PER_HOUR) {
+    prv_read_cells();
+    if (!prv_plan(strategy, discharging)) {
+      return (uint32_t)(num_sweeps * TEST_SIM_SWEEP_MS);
+    }
+
+    // Skip ahead to the first sweep after which a reading changes
+    uint64_t sweeps_to_change = UINT64_MAX;
+    for (size_t cell = 0; cell < NUM_TOTAL_CELLS; cell++) {
+      if (discharging[cell]) {
+        uint64_t fraction_ndmv = s_cells_ndmv[cell] % TEST_SIM_NDMV_PER_DMV;
+        uint64_t sweeps = fraction_ndmv / bleed_ndmv_per_sweep + 1;
+        sweeps_to_change = (sweeps < sweeps_to_change) ? sweeps : sweeps_to_change;
+      }
+    }
+    for (size_t cell = 0; cell < NUM_TOTAL_CELLS; cell++) {
+      if (discharging[cell]) {
+        s_cells_ndmv[cell] -= sweeps_to_change * bleed_ndmv_per_sweep;
+      }
+    }
+    num_sweeps += sweeps_to_change;
+  }
+
+  return UINT32_MAX;
+}
+
+// Balances the pack both ways, checking that the planner balances it and is never meaningfully
+// slower. Returns the planner's time to balance in ms.
+static uint32_t prv_simulate(const char *name, const uint16_t offsets_dmv[NUM_TOTAL_CELLS]) {
+  uint32_t planner_ms = prv_time_to_balance(offsets_dmv, TEST_SIM_STRATEGY_PLANNER);
+  uint32_t highest_ms = prv_time_to_balance(offsets_dmv, TEST_SIM_STRATEGY_HIGHEST_CELL);
+  TEST_ASSERT_NOT_EQUAL(UINT32_MAX, planner_ms);
+  LOG_DEBUG("%s: balanced in %u min (highest cell only: %u min)\n", name,
+            (unsigned)(planner_ms / 60000), (unsigned)(highest_ms / 60000));
+
+  // The planner only bleeds between cell conversions, which costs it a little on a single cell
+  TEST_ASSERT_TRUE((uint64_t)planner_ms * TEST_SIM_AUX_MS <=
+                   (uint64_t)highest_ms * TEST_SIM_SWEEP_MS);
+  return planner_ms;
+}
+
+void setup_test(void) {}
+
+void teardown_test(void) {}
+
+void test_passive_balance_sim_single_high_cell(void) {
+  uint16_t offsets_dmv[NUM_TOTAL_CELLS] = { [2] = 300 };
+  prv_simulate("single high cell", offsets_dmv);
+}
+
+void test_passive_balance_sim_linear_spread(void) {
+  uint16_t offsets_dmv[NUM_TOTAL_CELLS];
+  for (size_t cell = 0; cell < NUM_TOTAL_CELLS; cell++) {
+    offsets_dmv[cell] = (uint16_t)(cell * 15);
+  }
+  uint32_t planner_ms = prv_simulate("linear spread", offsets_dmv);
+
+  // Bleeding every high cell at once is bounded by the largest offset rather than their sum
+  uint32_t highest_ms = prv_time_to_balance(offsets_dmv, TEST_SIM_STRATEGY_HIGHEST_CELL);
+  TEST_ASSERT_TRUE(planner_ms < highest_ms / 2);
+}
+
+void test_passive_balance_sim_random_pack(void) {
+  // Fixed seed so the pack is the same every run
+  uint32_t seed = 0x5eed;
+  uint16_t offsets_dmv[NUM_TOTAL_CELLS];
+  for (size_t cell = 0; cell < NUM_TOTAL_CELLS; cell++) {
+    seed = seed * 1103515245u + 12345u;
+    offsets_dmv[cell] = (uint16_t)((seed >> 16) % 400);
+  }
+  uint32_t planner_ms = prv_simulate("random pack", offsets_dmv);
+
+  uint32_t highest_ms = prv_time_to_balance(offsets_dmv, TEST_SIM_STRATEGY_HIGHEST_CELL);
+  TEST_ASSERT_TRUE(planner_ms < highest_ms / 2);
+}
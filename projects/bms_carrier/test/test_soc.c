@@ -0,0 +1,220 @@
+#include "soc.h"
+
+#include <string.h>
+
+#include "crc32.h"
+#include "flash.h"
+#include "interrupt.h"
+#include "log.h"
+#include "misc.h"
+#include "soft_timer.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_CAPACITY_MAH 36000
+#define TEST_REST_CURRENT_CA 50
+#define TEST_REST_TIME_MS 60000
+#define TEST_SAMPLE_PERIOD_MS CONVERSION_TIME_MS
+
+// A resting cell voltage that maps to 50% in the OCV table
+#define TEST_HALF_CELL_DMV 37000
+
+// A segment of a replayed current trace: a constant current (centiamps) for some time
+typedef struct TestTraceSegment {
+  int16_t current_ca;
+  uint32_t duration_ms;
+} TestTraceSegment;
+
+// A drive: pull away, cruise, hard acceleration, regen braking, cruise, then a charging stop.
+static const TestTraceSegment s_drive_trace[] = {
+  { 3000, 20000 },  { 1500, 120000 }, { 8000, 10000 }, { -4000, 5000 },
+  { 1500, 120000 }, { 12000, 3000 },  { -7000, 4000 }, { -6000, 40000 },
+};
+
+static AfeReadings s_afe_readings;
+static SocStorage s_storage;
+static SocSettings s_settings;
+
+static void prv_set_cell_voltages(uint16_t voltage_dmv) {
+  for (uint8_t cell = 0; cell < NUM_TOTAL_CELLS; cell++) {
+    s_afe_readings.voltages[cell] = voltage_dmv;
+  }
+  cell_sense_compute_stats(s_afe_readings.voltages, NUM_TOTAL_CELLS, NUM_CELL_MODULES_PER_AFE,
+                           &s_afe_readings.voltage_stats);
+}
+
+// Run |duration_ms| of |current_ca| through the estimator, one sample at a time.
+static void prv_replay(int16_t current_ca, uint32_t duration_ms) {
+  for (uint32_t t = 0; t < duration_ms; t += TEST_SAMPLE_PERIOD_MS) {
+    soc_process_current(&s_storage, current_ca, TEST_SAMPLE_PERIOD_MS);
+  }
+}
+
+void setup_test(void) {
+  interrupt_init();
+  soft_timer_init();
+  crc32_init();
+  flash_init();
+  flash_erase(SOC_FLASH_PAGE);
+
+  // soft timers and flash were just reset, as they would be on boot
+  memset(&s_storage, 0, sizeof(s_storage));
+  memset(&s_afe_readings, 0, sizeof(s_afe_readings));
+  s_settings = (SocSettings){
+    .capacity_mah = TEST_CAPACITY_MAH,
+    .rest_current_ca = TEST_REST_CURRENT_CA,
+    .rest_time_ms = TEST_REST_TIME_MS,
+    .afe_readings = &s_afe_readings,
+  };
+}
+
+void teardown_test(void) {
+  flash_erase(SOC_FLASH_PAGE);
+}
+
+void test_soc_invalid_args(void) {
+  TEST_ASSERT_NOT_OK(soc_init(NULL, &s_settings));
+  TEST_ASSERT_NOT_OK(soc_init(&s_storage, NULL));
+
+  s_settings.capacity_mah = 0;
+  TEST_ASSERT_NOT_OK(soc_init(&s_storage, &s_settings));
+
+  s_settings.capacity_mah = TEST_CAPACITY_MAH;
+  s_settings.afe_readings = NULL;
+  TEST_ASSERT_NOT_OK(soc_init(&s_storage, &s_settings));
+}
+
+void test_soc_ocv_lookup(void) {
+  TEST_ASSERT_EQUAL(0, soc_ocv_lookup(0));
+  TEST_ASSERT_EQUAL(0, soc_ocv_lookup(30000));
+  TEST_ASSERT_EQUAL(5000, soc_ocv_lookup(TEST_HALF_CELL_DMV));
+  TEST_ASSERT_EQUAL(3500, soc_ocv_lookup(36250));  // interpolated
+  TEST_ASSERT_EQUAL(SOC_MAX, soc_ocv_lookup(42000));
+  TEST_ASSERT_EQUAL(SOC_MAX, soc_ocv_lookup(UINT16_MAX));
+}
+
+// With nothing persisted, the first resting reading with valid cell voltages sets the SOC.
+void test_soc_fresh_start_uses_ocv(void) {
+  TEST_ASSERT_OK(soc_init(&s_storage, &s_settings));
+
+  // the AFE hasn't been read yet, so there's nothing to correct against
+  soc_process_current(&s_storage, 0, TEST_SAMPLE_PERIOD_MS);
+  TEST_ASSERT_EQUAL(SOC_MAX, soc_get_soc(&s_storage));
+
+  prv_set_cell_voltages(TEST_HALF_CELL_DMV);
+  soc_process_current(&s_storage, 0, TEST_SAMPLE_PERIOD_MS);
+  TEST_ASSERT_EQUAL(5000, soc_get_soc(&s_storage));
+  TEST_ASSERT_EQUAL(TEST_CAPACITY_MAH / 2, soc_get_charge_mah(&s_storage));
+}
+
+// Replay a drive trace with sensor noise and compare against a floating point integration.
+void test_soc_replay_trace(void) {
+  prv_set_cell_voltages(TEST_HALF_CELL_DMV);
+  TEST_ASSERT_OK(soc_init(&s_storage, &s_settings));
+  soc_process_current(&s_storage, 0, TEST_SAMPLE_PERIOD_MS);
+  TEST_ASSERT_EQUAL(TEST_CAPACITY_MAH / 2, soc_get_charge_mah(&s_storage));
+
+  const double pack_v = TEST_HALF_CELL_DMV * NUM_TOTAL_CELLS / 10000.0;
+  double expected_mah = TEST_CAPACITY_MAH / 2;
+  double expected_wh = 0;
+  uint32_t sample = 0;
+  for (size_t i = 0; i < SIZEOF_ARRAY(s_drive_trace); i++) {
+    for (uint32_t t = 0; t < s_drive_trace[i].duration_ms; t += TEST_SAMPLE_PERIOD_MS) {
+      // deterministic noise of up to +/-0.37 A
+      int16_t noise_ca = (int16_t)(sample * 7919 % 75) - 37;
+      int16_t current_ca = (int16_t)(s_drive_trace[i].current_ca + noise_ca);
+      soc_process_current(&s_storage, current_ca, TEST_SAMPLE_PERIOD_MS);
+
+      const double amps = current_ca / 100.0;
+      const double hours = TEST_SAMPLE_PERIOD_MS / 3600000.0;
+      expected_mah -= amps * 1000 * hours;
+      expected_wh += pack_v * amps * hours;
+      sample++;
+    }
+  }
+
+  LOG_DEBUG("replayed %d samples: %d mAh, %d Wh\n", (int)sample,
+            (int)soc_get_charge_mah(&s_storage), (int)soc_get_energy_wh(&s_storage));
+  TEST_ASSERT_INT_WITHIN(1, (int32_t)expected_mah, soc_get_charge_mah(&s_storage));
+  TEST_ASSERT_INT_WITHIN(1, (int32_t)expected_wh, soc_get_energy_wh(&s_storage));
+}
+
+// After resting long enough, the SOC snaps to the OCV estimate, once per rest period.
+void test_soc_rest_correction(void) {
+  prv_set_cell_voltages(TEST_HALF_CELL_DMV);
+  TEST_ASSERT_OK(soc_init(&s_storage, &s_settings));
+  soc_process_current(&s_storage, 0, TEST_SAMPLE_PERIOD_MS);
+
+  // 36 A for 6 minutes takes out 3.6 Ah, i.e. 10%
+  prv_replay(3600, 360000);
+  TEST_ASSERT_UINT_WITHIN(1, 4000, soc_get_soc(&s_storage));
+
+  // the cells sag to 30%; nothing happens until we've rested for the full rest time
+  prv_set_cell_voltages(36000);
+  prv_replay(TEST_REST_CURRENT_CA, TEST_REST_TIME_MS - 1000);
+  TEST_ASSERT_UINT_WITHIN(5, 4000, soc_get_soc(&s_storage));
+  prv_replay(-TEST_REST_CURRENT_CA, 2000);
+  TEST_ASSERT_EQUAL(3000, soc_get_soc(&s_storage));
+
+  // staying at rest doesn't re-correct, so coulomb counting continues from the corrected value
+  prv_set_cell_voltages(TEST_HALF_CELL_DMV);
+  prv_replay(0, TEST_REST_TIME_MS);
+  TEST_ASSERT_EQUAL(3000, soc_get_soc(&s_storage));
+}
+
+void test_soc_clamps_at_full(void) {
+  prv_set_cell_voltages(42000);
+  TEST_ASSERT_OK(soc_init(&s_storage, &s_settings));
+  soc_process_current(&s_storage, 0, TEST_SAMPLE_PERIOD_MS);
+  TEST_ASSERT_EQUAL(SOC_MAX, soc_get_soc(&s_storage));
+
+  prv_replay(-5000, 10000);
+  TEST_ASSERT_EQUAL(SOC_MAX, soc_get_soc(&s_storage));
+  TEST_ASSERT_EQUAL(TEST_CAPACITY_MAH, soc_get_charge_mah(&s_storage));
+}
+
+// The persisted state is restored across a reset instead of re-estimating from OCV.
+void test_soc_persists(void) {
+  prv_set_cell_voltages(TEST_HALF_CELL_DMV);
+  TEST_ASSERT_OK(soc_init(&s_storage, &s_settings));
+  soc_process_current(&s_storage, 0, TEST_SAMPLE_PERIOD_MS);
+  prv_replay(3600, 360000);
+  const int32_t charge_mah = soc_get_charge_mah(&s_storage);
+  const int32_t energy_wh = soc_get_energy_wh(&s_storage);
+  TEST_ASSERT_OK(soc_commit(&s_storage));
+  TEST_ASSERT_OK(persist_ctrl_periodic(&s_storage.persist, false));
+
+  // "reset" with cells reading as full - the persisted state wins
+  memset(&s_storage, 0, sizeof(s_storage));
+  prv_set_cell_voltages(42000);
+  TEST_ASSERT_OK(soc_init(&s_storage, &s_settings));
+  soc_process_current(&s_storage, 0, TEST_SAMPLE_PERIOD_MS);
+  TEST_ASSERT_EQUAL(charge_mah, soc_get_charge_mah(&s_storage));
+  TEST_ASSERT_EQUAL(energy_wh, soc_get_energy_wh(&s_storage));
+  TEST_ASSERT_OK(persist_ctrl_periodic(&s_storage.persist, false));
+}
+
+void test_soc_uninitialized(void) {
+  TEST_ASSERT_EQUAL(0, soc_get_soc(&s_storage));
+}
+
+// Initializing again keeps the running persist instance rather than starting a second one.
+void test_soc_reinit_keeps_persist(void) {
+  prv_set_cell_voltages(TEST_HALF_CELL_DMV);
+  TEST_ASSERT_OK(soc_init(&s_storage, &s_settings));
+  soc_process_current(&s_storage, 0, TEST_SAMPLE_PERIOD_MS);
+  prv_replay(3600, 360000);
+  const int32_t charge_mah = soc_get_charge_mah(&s_storage);
+  const SoftTimerId timer_id = s_storage.persist.timer_id;
+  TEST_ASSERT_TRUE(soft_timer_inuse());
+
+  TEST_ASSERT_OK(soc_init(&s_storage, &s_settings));
+  TEST_ASSERT_EQUAL(timer_id, s_storage.persist.timer_id);
+  TEST_ASSERT_INT_WITHIN(TEST_CAPACITY_MAH * SOC_PERSIST_STEP / SOC_MAX, charge_mah,
+                         soc_get_charge_mah(&s_storage));
+
+  // the original instance still commits
+  TEST_ASSERT_OK(soc_commit(&s_storage));
+  TEST_ASSERT_OK(persist_ctrl_periodic(&s_storage.persist, false));
+  TEST_ASSERT_FALSE(soft_timer_inuse());
+}
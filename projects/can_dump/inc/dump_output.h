@@ -0,0 +1,22 @@
+#pragma once
+// Where can_dump writes the CAN frames it sees, as binary CAN trace records (see can_trace.h).
+// On x86, the records go to a trace file named by MIDSUN_CAN_DUMP_FILE (default can_dump.trace),
+// which is indexed when the dump is stopped with SIGINT or SIGTERM.
+// On STM32, each record is COBS encoded and terminated with a 0 byte on stdout (the UART), so a
+// reader such as dump_system.py can resynchronize after a dropped byte. The dump never stops.
+#include <stdbool.h>
+
+#include "can_trace.h"
+#include "status.h"
+
+// Open the output, writing the trace header on x86.
+StatusCode dump_output_init(void);
+
+// Write a record. Timestamps must not decrease.
+StatusCode dump_output_record(const CanTraceRecord *record);
+
+// Whether the dump has been asked to stop.
+bool dump_output_stop_requested(void);
+
+// Finish the trace and close the output.
+StatusCode dump_output_close(void);
@@ -100,7 +100,16 @@ class SocketCanDataSource(CanDataSource):
 class SerialCanDataSource(CanDataSource):
     """
     A CAN datasource that reads from a bound serial port interface.
+
+    Packets are COBS encoded and terminated by a 0 byte. They are either CAN UART packets or CAN
+    trace records (see can_trace.h) from the can_dump project.
     """
+    CAN_UART_PACKET_LEN = 16
+    # timestamp (us), raw ID, DLC, flags, data
+    TRACE_RECORD = struct.Struct('<QIBB2x8s')
+    TRACE_ID_EXTENDED_FLAG = 0x80000000
+    TRACE_ID_EXTENDED_MASK = 0x1FFFFFFF
+
     def __init__(self, masked, device):
         super().__init__(masked)
         self.ser = serial.Serial(device, 115200)
@@ -114,7 +123,15 @@ class SerialCanDataSource(CanDataSource):
                 # print('COBS decode error (len {})'.format(len(encoded_line)))
                 continue
 
-            if len(line) != 16:
+            if len(line) == self.TRACE_RECORD.size:
+                _, raw_id, dlc, _, data = self.TRACE_RECORD.unpack(line)
+                if raw_id & self.TRACE_ID_EXTENDED_FLAG:
+                    can_id = raw_id & self.TRACE_ID_EXTENDED_MASK
+                else:
+                    can_id = raw_id & 0x7FF
+                return can_id, data[:dlc]
+
+            if len(line) != self.CAN_UART_PACKET_LEN:
                 # print('Invalid line (len {})'.format(len(line)))
                 continue
 
@@ -1,7 +1,8 @@
-"""Parses CAN logs created by the system dump tool
+"""Parses CAN logs created by the system dump tool, or binary CAN traces
 """
 import argparse
 import csv
+import struct
 
 from can_message import CanMessage
 
@@ -21,14 +22,60 @@ def parse_data(file_name):
         print(timestamp)
         msg.parse()
 
+# Binary trace layout, see libraries/ms-common/inc/can_trace.h
+TRACE_HEADER = struct.Struct('<IHHII')
+TRACE_RECORD = struct.Struct('<QIBB2x8s')
+TRACE_FOOTER = struct.Struct('<IIQ')
+TRACE_MAGIC = 0x5443534D
+TRACE_FOOTER_MAGIC = 0x4943534D
+TRACE_ID_EXTENDED_FLAG = 0x80000000
+TRACE_FLAG_TX = 0x1
+
+def read_trace(file_name):
+    """Yield (timestamp_us, can_id, extended, data, tx) for every record in a binary trace"""
+    with open(file_name, 'rb') as trace_file:
+        trace = trace_file.read()
+
+    magic, _, record_size, _, _ = TRACE_HEADER.unpack_from(trace)
+    if magic != TRACE_MAGIC or record_size != TRACE_RECORD.size:
+        raise ValueError('{} is not a CAN trace'.format(file_name))
+
+    body_size = len(trace) - TRACE_HEADER.size
+    num_records = body_size // TRACE_RECORD.size
+    if body_size >= TRACE_FOOTER.size:
+        footer_magic, _, footer_records = \
+            TRACE_FOOTER.unpack_from(trace, len(trace) - TRACE_FOOTER.size)
+        if footer_magic == TRACE_FOOTER_MAGIC:
+            num_records = footer_records
+
+    for i in range(num_records):
+        timestamp_us, raw_id, dlc, flags, data = \
+            TRACE_RECORD.unpack_from(trace, TRACE_HEADER.size + i * TRACE_RECORD.size)
+        extended = bool(raw_id & TRACE_ID_EXTENDED_FLAG)
+        can_id = raw_id & (0x1FFFFFFF if extended else 0x7FF)
+        yield timestamp_us, can_id, extended, data[:dlc], bool(flags & TRACE_FLAG_TX)
+
+def parse_trace(file_name):
+    """Read a binary trace and parse it"""
+    for timestamp_us, can_id, _, data, _ in read_trace(file_name):
+        msg = CanMessage(can_id, data)
+
+        print(timestamp_us)
+        msg.parse()
+
 def main():
     """Main entry point"""
     parser = argparse.ArgumentParser(description='Parsing CAN log data')
     parser.add_argument('--file', required=True)
+    parser.add_argument('--trace', action='store_true',
+                        help='the file is a binary trace from can_dump or an x86 CAN tap')
 
     args = parser.parse_args()
 
-    parse_data(args.file)
+    if args.trace:
+        parse_trace(args.file)
+    else:
+        parse_data(args.file)
 
 
 if __name__ == '__main__':
@@ -1,5 +1,9 @@
-#include <inttypes.h>
+#include <string.h>
+
+#include "can_trace.h"
+#include "critical_section.h"
 #include "delay.h"
+#include "dump_output.h"
 #include "generic_can.h"
 #include "generic_can_hw.h"
 #include "gpio.h"
@@ -10,9 +14,21 @@
 
 static GenericCanHw s_can;
 
+// Extends the wrapping soft timer clock so the trace timestamps don't wrap
+static uint32_t s_last_time_us;
+static uint64_t s_timestamp_us;
+
 static void prv_can_rx_callback(const GenericCanMsg *msg, void *context) {
-  printf("ID %" PRIx32 " DLC %" PRIu8 " extended %" PRIu8 "\n", msg->id, (uint8_t)msg->dlc,
-         msg->extended);
+  const uint32_t now_us = soft_timer_get_current_time();
+  s_timestamp_us += (uint32_t)(now_us - s_last_time_us);
+  s_last_time_us = now_us;
+
+  uint8_t data[sizeof(msg->data)];
+  memcpy(data, &msg->data, sizeof(data));
+
+  CanTraceRecord record;
+  can_trace_record_init(&record, s_timestamp_us, msg->id, msg->extended, data, msg->dlc, 0);
+  dump_output_record(&record);
 }
 
 int main(void) {
@@ -27,6 +43,12 @@ int main(void) {
     .loopback = false,
   };
 
+  s_last_time_us = soft_timer_get_current_time();
+  if (!status_ok(dump_output_init())) {
+    LOG_CRITICAL("Failed to open CAN dump output\n");
+    return 1;
+  }
+
   generic_can_hw_init(&s_can, &can_hw_settings, 0);
   generic_can_register_rx((GenericCan *)&s_can, prv_can_rx_callback, 0, 0, true, NULL);
   generic_can_register_rx((GenericCan *)&s_can, prv_can_rx_callback, 0, 0, false, NULL);
@@ -38,14 +60,16 @@ int main(void) {
   GpioAddress led = { .port = GPIO_PORT_A, .pin = 15 };
   gpio_init_pin(&led, &led_settings);
 
-  printf("hello\n");
-
-  while (true) {
+  while (!dump_output_stop_requested()) {
     gpio_toggle_state(&led);
-    printf("still alive\n");
     can_hw_transmit(0x123, false, NULL, 0);
     delay_s(1);
   }
 
+  // Keep the RX callback from appending while the index is written
+  bool disabled = critical_section_start();
+  dump_output_close();
+  critical_section_end(disabled);
+
   return 0;
 }
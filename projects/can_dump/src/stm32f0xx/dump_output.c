@@ -0,0 +1,32 @@
+#include "dump_output.h"
+
+#include <stdio.h>
+
+#include "cobs.h"
+#include "misc.h"
+
+StatusCode dump_output_init(void) {
+  // A serial link can drop bytes, so there's no header to lose - every record is framed instead
+  return STATUS_CODE_OK;
+}
+
+StatusCode dump_output_record(const CanTraceRecord *record) {
+  uint8_t encoded[COBS_MAX_ENCODED_LEN(sizeof(CanTraceRecord)) + 1];
+  size_t encoded_len = SIZEOF_ARRAY(encoded);
+  status_ok_or_return(
+      cobs_encode((const uint8_t *)record, sizeof(*record), encoded, &encoded_len));
+  // Frame the record with a 0
+  encoded[encoded_len++] = 0;
+
+  fwrite(encoded, 1, encoded_len, stdout);
+  fflush(stdout);
+  return STATUS_CODE_OK;
+}
+
+bool dump_output_stop_requested(void) {
+  return false;
+}
+
+StatusCode dump_output_close(void) {
+  return STATUS_CODE_OK;
+}
@@ -0,0 +1,51 @@
+#include "dump_output.h"
+
+#include <signal.h>
+#include <stdlib.h>
+
+#include "log.h"
+
+#define DUMP_OUTPUT_DEFAULT_FILENAME "can_dump.trace"
+#define DUMP_OUTPUT_USER_ENV "MIDSUN_CAN_DUMP_FILE"
+// Enough to index ~16M frames, past which the trace is left for the reader to index
+#define DUMP_OUTPUT_MAX_CHUNKS 65536
+
+static CanTraceWriter s_writer;
+static uint64_t s_chunk_index[DUMP_OUTPUT_MAX_CHUNKS];
+static volatile sig_atomic_t s_stop_requested = 0;
+
+static void prv_request_stop(int signum) {
+  s_stop_requested = 1;
+}
+
+StatusCode dump_output_init(void) {
+  const char *filename = getenv(DUMP_OUTPUT_USER_ENV);
+  if (filename == NULL) {
+    filename = DUMP_OUTPUT_DEFAULT_FILENAME;
+  }
+
+  FILE *fp = fopen(filename, "wb");
+  if (fp == NULL) {
+    return status_msg(STATUS_CODE_INTERNAL_ERROR, "Failed to open dump file");
+  }
+  LOG_DEBUG("Dumping CAN trace to %s\n", filename);
+
+  // The dump normally runs until it's interrupted, so stop cleanly to write the index
+  signal(SIGINT, prv_request_stop);
+  signal(SIGTERM, prv_request_stop);
+  return can_trace_writer_init(&s_writer, fp, s_chunk_index, DUMP_OUTPUT_MAX_CHUNKS);
+}
+
+StatusCode dump_output_record(const CanTraceRecord *record) {
+  return can_trace_writer_append(&s_writer, record);
+}
+
+bool dump_output_stop_requested(void) {
+  return s_stop_requested != 0;
+}
+
+StatusCode dump_output_close(void) {
+  StatusCode status = can_trace_writer_close(&s_writer);
+  fclose(s_writer.stream);
+  return status;
+}
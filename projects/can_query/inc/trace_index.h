@@ -0,0 +1,33 @@
+#pragma once
+// Per-message-ID index over a binary CAN trace (see can_trace.h).
+//
+// Building the index is one pass over the trace, after which every frame of a message ID within
+// a time range is found with a binary search instead of a rescan. Only standard-ID data frames
+// are indexed - ACKs and extended IDs aren't system CAN messages.
+#include <stddef.h>
+#include <stdint.h>
+
+#include "can_msg.h"
+#include "can_trace.h"
+#include "status.h"
+
+typedef struct TraceIndex {
+  const CanTraceReader *reader;
+  // Record numbers of each message ID's frames in time order, grouped by message ID: the frames
+  // of ID i are |records[offsets[i]]| to |records[offsets[i + 1] - 1]|.
+  uint32_t offsets[CAN_MSG_MAX_IDS + 1];
+  uint32_t *records;
+} TraceIndex;
+
+// Index the trace in |reader|, which must stay open for as long as the index is used.
+StatusCode trace_index_build(TraceIndex *index, const CanTraceReader *reader);
+
+void trace_index_free(TraceIndex *index);
+
+// Number of frames of |msg_id| in the whole trace.
+size_t trace_index_count(const TraceIndex *index, CanMessageId msg_id);
+
+// Find the frames of |msg_id| with timestamps in [|start_us|, |end_us|). Returns how many there
+// are, and points |records| at their record numbers.
+size_t trace_index_query(const TraceIndex *index, CanMessageId msg_id, uint64_t start_us,
+                         uint64_t end_us, const uint32_t **records);
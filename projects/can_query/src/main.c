@@ -0,0 +1,101 @@
+// Decodes and filters a binary CAN trace (see can_trace.h) with the generated message table.
+// x86 only.
+//
+// Configured through the environment:
+//   MIDSUN_CAN_QUERY_FILE: the trace to query (required)
+//   MIDSUN_CAN_QUERY_MSG: the message to print, e.g. BATTERY_VT. If not set, prints how many
+//                         frames of each message the trace holds.
+//   MIDSUN_CAN_QUERY_START_US, MIDSUN_CAN_QUERY_END_US: only print frames in this range, in
+//                         microseconds since the start of the trace
+//
+// Frames are printed as CSV: timestamp (us since the start), message, source, then the fields.
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "can_msg_table.h"
+#include "can_trace.h"
+#include "log.h"
+#include "trace_index.h"
+
+static uint64_t prv_getenv_u64(const char *name, uint64_t default_value) {
+  const char *value = getenv(name);
+  return (value == NULL) ? default_value : strtoull(value, NULL, 10);
+}
+
+static void prv_print_summary(const TraceIndex *index) {
+  for (CanMessageId msg_id = 0; msg_id < CAN_MSG_MAX_IDS; msg_id++) {
+    const CanMsgDef *def = can_msg_table_get(msg_id);
+    const size_t count = trace_index_count(index, msg_id);
+    if (count > 0) {
+      printf("%s,%zu\n", (def != NULL) ? def->name : "UNKNOWN", count);
+    }
+  }
+}
+
+static void prv_print_frame(const CanTraceRecord *record, uint64_t first_us,
+                            const CanMsgDef *def) {
+  uint32_t raw_id = 0;
+  bool extended = false;
+  can_trace_record_get_id(record, &raw_id, &extended);
+  CanId id = { .raw = (uint16_t)raw_id };
+  const char *source = can_msg_table_device_name(id.source_id);
+
+  printf("%" PRIu64 ",%s,%s", record->timestamp_us - first_us, def->name,
+         (source != NULL) ? source : "UNKNOWN");
+  for (uint8_t i = 0; i < def->num_fields; i++) {
+    printf(",%s=%" PRIu64, def->fields[i].name,
+           can_msg_table_get_field(&def->fields[i], record->data));
+  }
+  printf("\n");
+}
+
+int main(void) {
+  const char *filename = getenv("MIDSUN_CAN_QUERY_FILE");
+  if (filename == NULL) {
+    LOG_CRITICAL("Set MIDSUN_CAN_QUERY_FILE to the trace to query\n");
+    return 1;
+  }
+
+  CanMessageId msg_id = CAN_MSG_INVALID_ID;
+  const char *msg_name = getenv("MIDSUN_CAN_QUERY_MSG");
+  if (msg_name != NULL) {
+    msg_id = can_msg_table_find(msg_name);
+    if (msg_id == CAN_MSG_INVALID_ID) {
+      LOG_CRITICAL("Unknown message %s\n", msg_name);
+      return 1;
+    }
+  }
+
+  CanTraceReader reader;
+  if (!status_ok(can_trace_reader_open(&reader, filename))) {
+    LOG_CRITICAL("Failed to open trace %s\n", filename);
+    return 1;
+  }
+  TraceIndex index;
+  if (!status_ok(trace_index_build(&index, &reader))) {
+    LOG_CRITICAL("Failed to index trace\n");
+    can_trace_reader_close(&reader);
+    return 1;
+  }
+
+  if (msg_id == CAN_MSG_INVALID_ID) {
+    prv_print_summary(&index);
+  } else {
+    const uint64_t first_us = (reader.num_records > 0) ? reader.records[0].timestamp_us : 0;
+    const uint64_t start_us = first_us + prv_getenv_u64("MIDSUN_CAN_QUERY_START_US", 0);
+    const uint64_t end_offset_us = prv_getenv_u64("MIDSUN_CAN_QUERY_END_US", UINT64_MAX);
+    const uint64_t end_us =
+        (end_offset_us > UINT64_MAX - first_us) ? UINT64_MAX : first_us + end_offset_us;
+
+    const uint32_t *records = NULL;
+    const size_t count = trace_index_query(&index, msg_id, start_us, end_us, &records);
+    for (size_t i = 0; i < count; i++) {
+      prv_print_frame(&reader.records[records[i]], first_us, can_msg_table_get(msg_id));
+    }
+  }
+
+  trace_index_free(&index);
+  can_trace_reader_close(&reader);
+  return 0;
+}
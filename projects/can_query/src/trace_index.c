@@ -0,0 +1,97 @@
+#include "trace_index.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Returns the message ID of a record, or CAN_MSG_INVALID_ID if it isn't indexed
+static CanMessageId prv_msg_id(const CanTraceRecord *record) {
+  uint32_t raw_id = 0;
+  bool extended = false;
+  can_trace_record_get_id(record, &raw_id, &extended);
+  CanId id = { .raw = (uint16_t)raw_id };
+  if (extended || id.type != CAN_MSG_TYPE_DATA) {
+    return CAN_MSG_INVALID_ID;
+  }
+  return id.msg_id;
+}
+
+// Returns the first position in |records| (record numbers) at or after |timestamp_us|
+static size_t prv_lower_bound(const CanTraceReader *reader, const uint32_t *records, size_t len,
+                              uint64_t timestamp_us) {
+  size_t lo = 0;
+  size_t hi = len;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (reader->records[records[mid]].timestamp_us < timestamp_us) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+StatusCode trace_index_build(TraceIndex *index, const CanTraceReader *reader) {
+  if (index == NULL || reader == NULL || reader->num_records > UINT32_MAX) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+  memset(index, 0, sizeof(*index));
+  index->reader = reader;
+
+  // Count the frames of each ID, then turn the counts into where each ID's frames start
+  for (size_t i = 0; i < reader->num_records; i++) {
+    CanMessageId msg_id = prv_msg_id(&reader->records[i]);
+    if (msg_id != CAN_MSG_INVALID_ID) {
+      index->offsets[msg_id + 1]++;
+    }
+  }
+  for (size_t msg_id = 0; msg_id < CAN_MSG_MAX_IDS; msg_id++) {
+    index->offsets[msg_id + 1] += index->offsets[msg_id];
+  }
+
+  const size_t num_indexed = index->offsets[CAN_MSG_MAX_IDS];
+  index->records = malloc((num_indexed > 0 ? num_indexed : 1) * sizeof(uint32_t));
+  if (index->records == NULL) {
+    return status_code(STATUS_CODE_RESOURCE_EXHAUSTED);
+  }
+
+  // Records are in time order, so filling each ID's slots in order keeps them sorted
+  uint32_t next[CAN_MSG_MAX_IDS];
+  memcpy(next, index->offsets, sizeof(next));
+  for (size_t i = 0; i < reader->num_records; i++) {
+    CanMessageId msg_id = prv_msg_id(&reader->records[i]);
+    if (msg_id != CAN_MSG_INVALID_ID) {
+      index->records[next[msg_id]++] = (uint32_t)i;
+    }
+  }
+
+  return STATUS_CODE_OK;
+}
+
+void trace_index_free(TraceIndex *index) {
+  free(index->records);
+  memset(index, 0, sizeof(*index));
+}
+
+size_t trace_index_count(const TraceIndex *index, CanMessageId msg_id) {
+  if (msg_id >= CAN_MSG_MAX_IDS) {
+    return 0;
+  }
+  return index->offsets[msg_id + 1] - index->offsets[msg_id];
+}
+
+size_t trace_index_query(const TraceIndex *index, CanMessageId msg_id, uint64_t start_us,
+                         uint64_t end_us, const uint32_t **records) {
+  *records = index->records;
+  if (msg_id >= CAN_MSG_MAX_IDS || start_us >= end_us) {
+    return 0;
+  }
+
+  const uint32_t *frames = &index->records[index->offsets[msg_id]];
+  const size_t len = trace_index_count(index, msg_id);
+  const size_t first = prv_lower_bound(index->reader, frames, len, start_us);
+  const size_t last = prv_lower_bound(index->reader, frames, len, end_us);
+  *records = &frames[first];
+  return last - first;
+}
@@ -0,0 +1,138 @@
+#include "trace_index.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "can_msg_defs.h"
+#include "can_msg_table.h"
+#include "can_pack.h"
+#include "log.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_TRACE_FILENAME "test_trace_index.trace"
+#define TEST_NUM_FRAMES 3000
+#define TEST_FRAME_PERIOD_US 100
+
+static uint64_t s_chunk_index[TEST_NUM_FRAMES / CAN_TRACE_CHUNK_RECORDS + 1];
+static CanTraceReader s_reader;
+static TraceIndex s_index;
+
+static void prv_append(CanTraceWriter *writer, uint64_t timestamp_us, const CanMessage *msg) {
+  CanId id = {
+    .source_id = msg->source_id,
+    .type = msg->type,
+    .msg_id = msg->msg_id,
+  };
+  CanTraceRecord record;
+  can_trace_record_init(&record, timestamp_us, id.raw, false, msg->data_u8, msg->dlc, 0);
+  TEST_ASSERT_OK(can_trace_writer_append(writer, &record));
+}
+
+// Every third frame is a BATTERY_VT for module (i / 3), the rest are alternating BPS heartbeats
+// and ACKs, with an extended frame thrown in every so often.
+static void prv_write_trace(void) {
+  FILE *fp = fopen(TEST_TRACE_FILENAME, "wb");
+  TEST_ASSERT_NOT_NULL(fp);
+  CanTraceWriter writer;
+  TEST_ASSERT_OK(can_trace_writer_init(&writer, fp, s_chunk_index, SIZEOF_ARRAY(s_chunk_index)));
+
+  for (uint16_t i = 0; i < TEST_NUM_FRAMES; i++) {
+    const uint64_t timestamp_us = (uint64_t)i * TEST_FRAME_PERIOD_US;
+    CanMessage msg = { 0 };
+    if (i % 3 == 0) {
+      CAN_PACK_BATTERY_VT(&msg, i / 3, 40000, 250);
+      prv_append(&writer, timestamp_us, &msg);
+    } else if (i % 100 == 1) {
+      CanTraceRecord record;
+      can_trace_record_init(&record, timestamp_us, SYSTEM_CAN_MESSAGE_BATTERY_VT, true, NULL, 0,
+                            0);
+      TEST_ASSERT_OK(can_trace_writer_append(&writer, &record));
+    } else {
+      CAN_PACK_BPS_HEARTBEAT(&msg, 0);
+      msg.type = (i % 3 == 1) ? CAN_MSG_TYPE_DATA : CAN_MSG_TYPE_ACK;
+      prv_append(&writer, timestamp_us, &msg);
+    }
+  }
+
+  TEST_ASSERT_OK(can_trace_writer_close(&writer));
+  fclose(fp);
+}
+
+void setup_test(void) {
+  prv_write_trace();
+  TEST_ASSERT_OK(can_trace_reader_open(&s_reader, TEST_TRACE_FILENAME));
+  TEST_ASSERT_OK(trace_index_build(&s_index, &s_reader));
+}
+
+void teardown_test(void) {
+  trace_index_free(&s_index);
+  can_trace_reader_close(&s_reader);
+  remove(TEST_TRACE_FILENAME);
+}
+
+void test_trace_index_counts(void) {
+  // the extended frames with the same ID aren't counted
+  TEST_ASSERT_EQUAL(TEST_NUM_FRAMES / 3,
+                    trace_index_count(&s_index, SYSTEM_CAN_MESSAGE_BATTERY_VT));
+
+  // neither are ACKs
+  size_t num_heartbeats = 0;
+  for (uint16_t i = 0; i < TEST_NUM_FRAMES; i++) {
+    num_heartbeats += (i % 3 == 1 && i % 100 != 1);
+  }
+  TEST_ASSERT_EQUAL(num_heartbeats, trace_index_count(&s_index, SYSTEM_CAN_MESSAGE_BPS_HEARTBEAT));
+  TEST_ASSERT_EQUAL(0, trace_index_count(&s_index, SYSTEM_CAN_MESSAGE_BATTERY_SOC));
+  TEST_ASSERT_EQUAL(0, trace_index_count(&s_index, CAN_MSG_INVALID_ID));
+}
+
+void test_trace_index_query_range(void) {
+  const uint32_t *records = NULL;
+
+  // [1000, 2000) us covers frames 10 to 19, of which 12, 15 and 18 are BATTERY_VT
+  size_t count = trace_index_query(&s_index, SYSTEM_CAN_MESSAGE_BATTERY_VT, 1000, 2000, &records);
+  TEST_ASSERT_EQUAL(3, count);
+  for (size_t i = 0; i < count; i++) {
+    const CanTraceRecord *record = &s_reader.records[records[i]];
+    TEST_ASSERT_EQUAL((12 + 3 * i) * TEST_FRAME_PERIOD_US, record->timestamp_us);
+
+    const CanMsgDef *def = can_msg_table_get(SYSTEM_CAN_MESSAGE_BATTERY_VT);
+    TEST_ASSERT_EQUAL(4 + i, can_msg_table_get_field(&def->fields[0], record->data));
+  }
+
+  // the whole trace, and nothing
+  count = trace_index_query(&s_index, SYSTEM_CAN_MESSAGE_BATTERY_VT, 0, UINT64_MAX, &records);
+  TEST_ASSERT_EQUAL(TEST_NUM_FRAMES / 3, count);
+  TEST_ASSERT_EQUAL(0, records[0]);
+  TEST_ASSERT_EQUAL(0, trace_index_query(&s_index, SYSTEM_CAN_MESSAGE_BATTERY_VT, 1201, 1300,
+                                         &records));
+  TEST_ASSERT_EQUAL(0, trace_index_query(&s_index, SYSTEM_CAN_MESSAGE_BATTERY_VT, 2000, 1000,
+                                         &records));
+}
+
+// The generated table decodes what the generated pack macros encode.
+void test_trace_index_msg_table(void) {
+  const CanMessageId msg_id = can_msg_table_find("BATTERY_VT");
+  TEST_ASSERT_EQUAL(SYSTEM_CAN_MESSAGE_BATTERY_VT, msg_id);
+  TEST_ASSERT_EQUAL(CAN_MSG_INVALID_ID, can_msg_table_find("NOT_A_MESSAGE"));
+  TEST_ASSERT_NULL(can_msg_table_get(CAN_MSG_MAX_IDS - 2));
+
+  const CanMsgDef *def = can_msg_table_get(msg_id);
+  TEST_ASSERT_NOT_NULL(def);
+  TEST_ASSERT_EQUAL(SYSTEM_CAN_DEVICE_BMS_CARRIER, def->source);
+  TEST_ASSERT_EQUAL_STRING("BMS_CARRIER", can_msg_table_device_name(def->source));
+  TEST_ASSERT_EQUAL(3, def->num_fields);
+  TEST_ASSERT_EQUAL_STRING("voltage", def->fields[1].name);
+
+  CanMessage msg = { 0 };
+  CAN_PACK_BATTERY_VT(&msg, 7, 41234, 321);
+  TEST_ASSERT_EQUAL(def->dlc, msg.dlc);
+  TEST_ASSERT_EQUAL(7, can_msg_table_get_field(&def->fields[0], msg.data_u8));
+  TEST_ASSERT_EQUAL(41234, can_msg_table_get_field(&def->fields[1], msg.data_u8));
+  TEST_ASSERT_EQUAL(321, can_msg_table_get_field(&def->fields[2], msg.data_u8));
+
+  def = can_msg_table_get(SYSTEM_CAN_MESSAGE_BATTERY_SOC);
+  CAN_PACK_BATTERY_SOC(&msg, 0xDEADBEEF, 12);
+  TEST_ASSERT_EQUAL(0xDEADBEEF, can_msg_table_get_field(&def->fields[0], msg.data_u8));
+  TEST_ASSERT_EQUAL(12, can_msg_table_get_field(&def->fields[1], msg.data_u8));
+}
@@ -0,0 +1,51 @@
+// Replays a binary CAN trace (see can_trace.h) into vcan0, e.g. one recorded by can_dump or by
+// setting MIDSUN_X86_CAN_TRACE_FILE, so a project's RX path can be run against real bus load.
+// x86 only.
+//
+// Configured through the environment:
+//   MIDSUN_CAN_REPLAY_FILE: the trace to replay (required)
+//   MIDSUN_CAN_REPLAY_SPEED: playback speed in percent, 0 for as fast as possible (default 100)
+//   MIDSUN_CAN_REPLAY_INCLUDE_TX: set to 1 to also replay frames the recording node sent itself
+#include <stdlib.h>
+
+#include "can_trace.h"
+#include "log.h"
+
+#define CAN_REPLAY_DEFAULT_SPEED_PERCENT 100
+
+int main(void) {
+  const char *filename = getenv("MIDSUN_CAN_REPLAY_FILE");
+  if (filename == NULL) {
+    LOG_CRITICAL("Set MIDSUN_CAN_REPLAY_FILE to the trace to replay\n");
+    return 1;
+  }
+
+  CanTraceReplaySettings settings = {
+    .speed_percent = CAN_REPLAY_DEFAULT_SPEED_PERCENT,
+    .include_tx = false,
+  };
+  const char *speed = getenv("MIDSUN_CAN_REPLAY_SPEED");
+  if (speed != NULL) {
+    settings.speed_percent = (uint32_t)strtoul(speed, NULL, 10);
+  }
+  const char *include_tx = getenv("MIDSUN_CAN_REPLAY_INCLUDE_TX");
+  settings.include_tx = (include_tx != NULL && include_tx[0] == '1');
+
+  CanTraceReader reader;
+  if (!status_ok(can_trace_reader_open(&reader, filename))) {
+    LOG_CRITICAL("Failed to open trace %s\n", filename);
+    return 1;
+  }
+
+  LOG_DEBUG("Replaying %d frames from %s at %d%%\n", (int)reader.num_records, filename,
+            (int)settings.speed_percent);
+  StatusCode status = can_trace_replay(&reader, &settings);
+  can_trace_reader_close(&reader);
+  if (!status_ok(status)) {
+    LOG_CRITICAL("Replay failed\n");
+    return 1;
+  }
+
+  LOG_DEBUG("Replay done\n");
+  return 0;
+}
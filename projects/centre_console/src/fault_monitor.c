@@ -4,6 +4,7 @@
 #include "can_unpack.h"
 #include "centre_console_events.h"
 #include "centre_console_fault_reason.h"
+#include "flight_recorder.h"
 #include "power_fsm.h"
 #include "status.h"
 #include "watchdog.h"
@@ -15,6 +16,7 @@ static WatchdogStorage s_watchdog_storage = { 0 };
 static void prv_update_centre_console_status(StatusCode status) {
   if (status != STATUS_CODE_OK) {
     FaultReason fault = { .fields = { .area = EE_CONSOLE_FAULT_AREA_BPS_HEARTBEAT, .reason = 0 } };
+    flight_recorder_freeze(fault.raw, (uint32_t)status);
     event_raise_priority(EVENT_PRIORITY_HIGHEST, CENTRE_CONSOLE_POWER_EVENT_FAULT, fault.raw);
   }
 }
@@ -7,6 +7,8 @@
 #include "drive_fsm.h"
 #include "event_queue.h"
 #include "fault_monitor.h"
+#include "flash.h"
+#include "flight_recorder.h"
 #include "gpio.h"
 #include "gpio_it.h"
 #include "interrupt.h"
@@ -62,6 +64,8 @@ int main(void) {
   gpio_it_init();
   soft_timer_init();
   event_queue_init();
+  flash_init();
+  flight_recorder_init();
 
   prv_set_up_can();
 
@@ -90,6 +94,8 @@ int main(void) {
       drive_fsm_process_event(&s_drive_fsm_storage, &e);
       main_event_generator_process_event(&s_main_event_generator, &e);
     }
+    // We keep running after a fault, so save the lead-up to it before power is cut
+    flight_recorder_persist();
     wait();
   }
   return STATUS_CODE_OK;
@@ -0,0 +1,93 @@
+// Prints a flight recorder ring saved after a fault (see flight_recorder.h). x86 only.
+//
+// Configured through the environment:
+//   MIDSUN_FLIGHT_RECORDER_DUMP: a raw dump of the flight recorder's flash page, e.g. from
+//                                OpenOCD's dump_image. If not set, the ring is read from the x86
+//                                flash file in MIDSUN_X86_FLASH_FILE instead.
+//
+// Entries are printed oldest first as CSV: time relative to the fault (us), type, then details.
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "can_msg.h"
+#include "can_msg_table.h"
+#include "flash.h"
+#include "flight_recorder.h"
+#include "log.h"
+
+static const char *s_entry_names[NUM_FLIGHT_RECORDER_ENTRIES] = {
+  [FLIGHT_RECORDER_ENTRY_NONE] = "NONE",     [FLIGHT_RECORDER_ENTRY_EVENT] = "EVENT",
+  [FLIGHT_RECORDER_ENTRY_CAN_RX] = "CAN_RX", [FLIGHT_RECORDER_ENTRY_CAN_TX] = "CAN_TX",
+  [FLIGHT_RECORDER_ENTRY_FAULT] = "FAULT",   [FLIGHT_RECORDER_ENTRY_USER] = "USER",
+};
+
+static StatusCode prv_read_dump(const char *filename, FlightRecorderRing *ring) {
+  uint8_t data[sizeof(FlightRecorderRing)];
+  FILE *fp = fopen(filename, "rb");
+  if (fp == NULL) {
+    return status_msg(STATUS_CODE_UNREACHABLE, "Could not open dump");
+  }
+  size_t len = fread(data, 1, sizeof(data), fp);
+  fclose(fp);
+  return flight_recorder_decode(data, len, ring);
+}
+
+static void prv_print_can(const FlightRecorderEntry *entry) {
+  CanId id = { .raw = entry->value };
+  const CanMsgDef *def = can_msg_table_get(id.msg_id);
+  const char *source = can_msg_table_device_name(id.source_id);
+  printf("%s,%s,%s,dlc=%d", (def != NULL) ? def->name : "UNKNOWN",
+         (source != NULL) ? source : "UNKNOWN", (id.type == CAN_MSG_TYPE_ACK) ? "ack" : "data",
+         entry->arg);
+}
+
+static void prv_print_entry(const FlightRecorderEntry *entry, uint32_t fault_us) {
+  const char *name =
+      (entry->type < NUM_FLIGHT_RECORDER_ENTRIES) ? s_entry_names[entry->type] : "INVALID";
+  // Timestamps wrap, so only the difference is meaningful
+  printf("%d,%s,", (int32_t)(entry->timestamp_us - fault_us), name);
+
+  switch (entry->type) {
+    case FLIGHT_RECORDER_ENTRY_EVENT:
+      printf("id=%d,priority=%d", entry->value, entry->arg);
+      break;
+    case FLIGHT_RECORDER_ENTRY_CAN_RX:
+    case FLIGHT_RECORDER_ENTRY_CAN_TX:
+      prv_print_can(entry);
+      break;
+    default:
+      printf("value=0x%x,arg=0x%x", entry->value, entry->arg);
+      break;
+  }
+  printf("\n");
+}
+
+int main(void) {
+  FlightRecorderRing ring;
+  StatusCode status = STATUS_CODE_OK;
+  const char *filename = getenv("MIDSUN_FLIGHT_RECORDER_DUMP");
+  if (filename != NULL) {
+    status = prv_read_dump(filename, &ring);
+  } else {
+    flash_init();
+    status = flight_recorder_load(&ring);
+  }
+  if (status != STATUS_CODE_OK) {
+    LOG_CRITICAL("No saved flight recorder ring found\n");
+    return 1;
+  }
+
+  const size_t num_entries = flight_recorder_num_entries(&ring);
+  if (num_entries == 0) {
+    return 0;
+  }
+  printf("# fault 0x%x, arg 0x%x, %d entries\n", ring.fault.code, (unsigned)ring.fault.arg,
+         (int)num_entries);
+
+  // The fault is always the newest entry
+  const uint32_t fault_us = flight_recorder_get_entry(&ring, num_entries - 1)->timestamp_us;
+  for (size_t i = 0; i < num_entries; i++) {
+    prv_print_entry(flight_recorder_get_entry(&ring, i), fault_us);
+  }
+  return 0;
+}
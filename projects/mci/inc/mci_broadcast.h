@@ -13,9 +13,17 @@ typedef enum {
   NUM_MOTOR_CONTROLLERS,
 } MotorController;
 
+// Measurements are Q16.16 fixed point, decoded from the WaveSculptor's floats without soft-float
+// math since they're handled on every motor CAN frame
+typedef struct MotorControllerBusMeasurement {
+  int32_t bus_voltage_v;
+  int32_t bus_current_a;
+} MotorControllerBusMeasurement;
+
 typedef struct MotorControllerMeasurements {
-  WaveSculptorBusMeasurement bus_measurements[NUM_MOTOR_CONTROLLERS];
-  float vehicle_velocity[NUM_MOTOR_CONTROLLERS];
+  MotorControllerBusMeasurement bus_measurements[NUM_MOTOR_CONTROLLERS];
+  // cm/s
+  int32_t vehicle_velocity[NUM_MOTOR_CONTROLLERS];
 } MotorControllerMeasurements;
 
 typedef struct MotorControllerBroadcastSettings {
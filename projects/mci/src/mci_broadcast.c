@@ -1,5 +1,8 @@
 #include "mci_broadcast.h"
 
+#include <string.h>
+
+#include "fixed_point.h"
 #include "motor_can.h"
 #include "motor_controller.h"
 #include "soft_timer.h"
@@ -10,31 +13,53 @@
 
 #define M_TO_CM_CONV 100
 
+// Velocities are decoded with extra precision so that scaling to cm/s doesn't lose any
+#define MCI_BROADCAST_VELOCITY_FRAC_BITS 24
+
+// Decodes a float field without any float math. Truncates like a cast.
+static int32_t prv_float_to_fixed(const float *value, uint8_t frac_bits) {
+  uint32_t bits = 0;
+  memcpy(&bits, value, sizeof(bits));
+  return fixed_from_float_bits(bits, frac_bits);
+}
+
+static uint16_t prv_to_uint16(int32_t value) {
+  return (uint16_t)fixed_trunc(value, FIXED_Q16_FRAC_BITS);
+}
+
 static void prv_broadcast_speed(MotorControllerBroadcastStorage *storage) {
-  float *measurements = storage->measurements.vehicle_velocity;
-  CAN_TRANSMIT_MOTOR_VELOCITY((uint16_t)measurements[LEFT_MOTOR_CONTROLLER],
-                              (uint16_t)measurements[RIGHT_MOTOR_CONTROLLER]);
+  int32_t *measurements = storage->measurements.vehicle_velocity;
+  CAN_TRANSMIT_MOTOR_VELOCITY(prv_to_uint16(measurements[LEFT_MOTOR_CONTROLLER]),
+                              prv_to_uint16(measurements[RIGHT_MOTOR_CONTROLLER]));
 }
 
 static void prv_broadcast_bus_measurement(MotorControllerBroadcastStorage *storage) {
-  WaveSculptorBusMeasurement *measurements = storage->measurements.bus_measurements;
-  CAN_TRANSMIT_MOTOR_CONTROLLER_VC((uint16_t)measurements[LEFT_MOTOR_CONTROLLER].bus_voltage_v,
-                                   (uint16_t)measurements[LEFT_MOTOR_CONTROLLER].bus_current_a,
-                                   (uint16_t)measurements[RIGHT_MOTOR_CONTROLLER].bus_voltage_v,
-                                   (uint16_t)measurements[RIGHT_MOTOR_CONTROLLER].bus_current_a);
+  MotorControllerBusMeasurement *left =
+      &storage->measurements.bus_measurements[LEFT_MOTOR_CONTROLLER];
+  MotorControllerBusMeasurement *right =
+      &storage->measurements.bus_measurements[RIGHT_MOTOR_CONTROLLER];
+  CAN_TRANSMIT_MOTOR_CONTROLLER_VC(prv_to_uint16(left->bus_voltage_v),
+                                   prv_to_uint16(left->bus_current_a),
+                                   prv_to_uint16(right->bus_voltage_v),
+                                   prv_to_uint16(right->bus_current_a));
 }
 
 static void prv_handle_speed_rx(const GenericCanMsg *msg, void *context) {
   MotorControllerBroadcastStorage *storage = context;
-  float *measurements = storage->measurements.vehicle_velocity;
+  int32_t *measurements = storage->measurements.vehicle_velocity;
 
   WaveSculptorCanId can_id = { .raw = msg->id };
   WaveSculptorCanData can_data = { .raw = msg->data };
 
   for (size_t motor_id = 0; motor_id < NUM_MOTOR_CONTROLLERS; motor_id++) {
     if (can_id.device_id == storage->ids[motor_id]) {
+      int32_t velocity_ms = prv_float_to_fixed(&can_data.velocity_measurement.vehicle_velocity_ms,
+                                               MCI_BROADCAST_VELOCITY_FRAC_BITS);
+      int32_t velocity_cms =
+          fixed_mul(velocity_ms, fixed_from_int(M_TO_CM_CONV, FIXED_Q16_FRAC_BITS),
+                    MCI_BROADCAST_VELOCITY_FRAC_BITS);
       bool disabled = critical_section_start();
-      measurements[motor_id] = can_data.velocity_measurement.vehicle_velocity_ms * M_TO_CM_CONV;
+      measurements[motor_id] = velocity_cms;
       storage->velocity_rx_bitset |= 1 << motor_id;
       critical_section_end(disabled);
       break;
@@ -44,15 +69,21 @@ static void prv_handle_speed_rx(const GenericCanMsg *msg, void *context) {
 
 static void prv_handle_bus_measurement_rx(const GenericCanMsg *msg, void *context) {
   MotorControllerBroadcastStorage *storage = context;
-  WaveSculptorBusMeasurement *measurements = storage->measurements.bus_measurements;
+  MotorControllerBusMeasurement *measurements = storage->measurements.bus_measurements;
 
   WaveSculptorCanId can_id = { .raw = msg->id };
   WaveSculptorCanData can_data = { .raw = msg->data };
 
   for (size_t motor_id = 0; motor_id < NUM_MOTOR_CONTROLLERS; motor_id++) {
     if (can_id.device_id == storage->ids[motor_id]) {
+      MotorControllerBusMeasurement measurement = {
+        .bus_voltage_v =
+            prv_float_to_fixed(&can_data.bus_measurement.bus_voltage_v, FIXED_Q16_FRAC_BITS),
+        .bus_current_a =
+            prv_float_to_fixed(&can_data.bus_measurement.bus_current_a, FIXED_Q16_FRAC_BITS),
+      };
       bool disabled = critical_section_start();
-      measurements[motor_id] = can_data.bus_measurement;
+      measurements[motor_id] = measurement;
       storage->bus_rx_bitset |= 1 << motor_id;
       critical_section_end(disabled);
     }
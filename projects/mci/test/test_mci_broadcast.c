@@ -60,6 +60,12 @@ typedef struct TestMotorControllerMeasurements {
 
 static TestMotorControllerMeasurements s_test_measurements = { 0 };
 
+// What the WaveSculptors send, as floats
+typedef struct TestWaveSculptorMeasurements {
+  WaveSculptorBusMeasurement bus_measurements[NUM_MOTOR_CONTROLLERS];
+  float vehicle_velocity[NUM_MOTOR_CONTROLLERS];
+} TestWaveSculptorMeasurements;
+
 static MotorCanFrameId s_frame_id_map[] = {
   [LEFT_MOTOR_CONTROLLER * NUM_TEST_MCI_MESSAGES + TEST_MCI_VELOCITY_MESSAGE] =
       MOTOR_CAN_LEFT_VELOCITY_MEASUREMENT_FRAME_ID,
@@ -94,7 +100,7 @@ static StatusCode prv_handle_bus_measurement(const CanMessage *msg, void *contex
 }
 
 static void prv_send_measurements(MotorController controller, TestMciMessage message_type,
-                                  MotorControllerMeasurements *measurements) {
+                                  TestWaveSculptorMeasurements *measurements) {
   WaveSculptorCanData can_data = { 0 };
   if (message_type == TEST_MCI_VELOCITY_MESSAGE) {
     can_data.velocity_measurement.motor_velocity_rpm = 0;
@@ -218,7 +224,7 @@ void teardown_test(void) {
 void test_all_measurements_lb_rv_lv_rb() {
   MotorControllerBroadcastStorage broadcast_storage = { 0 };
   mci_broadcast_init(&broadcast_storage, &s_broadcast_settings);
-  MotorControllerMeasurements expected_measurements = {
+  TestWaveSculptorMeasurements expected_measurements = {
     .bus_measurements =
         {
             [LEFT_MOTOR_CONTROLLER] =
@@ -266,7 +272,7 @@ void test_all_measurements_lb_rb_lv_rv() {
   MotorControllerBroadcastStorage broadcast_storage = { 0 };
   mci_broadcast_init(&broadcast_storage, &s_broadcast_settings);
 
-  MotorControllerMeasurements expected_measurements = {
+  TestWaveSculptorMeasurements expected_measurements = {
     .bus_measurements =
         {
             [LEFT_MOTOR_CONTROLLER] =
@@ -314,7 +320,7 @@ void test_all_measurements_rb_lb_lv_rv() {
   MotorControllerBroadcastStorage broadcast_storage = { 0 };
   mci_broadcast_init(&broadcast_storage, &s_broadcast_settings);
 
-  MotorControllerMeasurements expected_measurements = {
+  TestWaveSculptorMeasurements expected_measurements = {
     .bus_measurements =
         {
             [LEFT_MOTOR_CONTROLLER] =
@@ -364,7 +370,7 @@ void test_no_measurements_rb() {
   MotorControllerBroadcastStorage broadcast_storage = { 0 };
   mci_broadcast_init(&broadcast_storage, &s_broadcast_settings);
 
-  MotorControllerMeasurements expected_measurements = {
+  TestWaveSculptorMeasurements expected_measurements = {
     .bus_measurements =
         {
             [LEFT_MOTOR_CONTROLLER] =
@@ -413,7 +419,7 @@ void test_bus_measurements_rb_lb() {
   MotorControllerBroadcastStorage broadcast_storage = { 0 };
   mci_broadcast_init(&broadcast_storage, &s_broadcast_settings);
 
-  MotorControllerMeasurements expected_measurements = {
+  TestWaveSculptorMeasurements expected_measurements = {
     .bus_measurements =
         {
             [LEFT_MOTOR_CONTROLLER] =
@@ -461,7 +467,7 @@ void test_velocity_measurements_rv_lv() {
   MotorControllerBroadcastStorage broadcast_storage = { 0 };
   mci_broadcast_init(&broadcast_storage, &s_broadcast_settings);
 
-  MotorControllerMeasurements expected_measurements = {
+  TestWaveSculptorMeasurements expected_measurements = {
     .bus_measurements =
         {
             [LEFT_MOTOR_CONTROLLER] =
@@ -507,7 +513,7 @@ void test_no_measurements_rb_lv() {
   MotorControllerBroadcastStorage broadcast_storage = { 0 };
   mci_broadcast_init(&broadcast_storage, &s_broadcast_settings);
 
-  MotorControllerMeasurements expected_measurements = {
+  TestWaveSculptorMeasurements expected_measurements = {
     .bus_measurements =
         {
             [LEFT_MOTOR_CONTROLLER] =
@@ -558,7 +564,7 @@ void test_all_measurements_rv_lv_then_rb_lb() {
   MotorControllerBroadcastStorage broadcast_storage = { 0 };
   mci_broadcast_init(&broadcast_storage, &s_broadcast_settings);
 
-  MotorControllerMeasurements expected_first_measurements = {
+  TestWaveSculptorMeasurements expected_first_measurements = {
     .bus_measurements =
         {
             [LEFT_MOTOR_CONTROLLER] =
@@ -605,7 +611,7 @@ void test_all_measurements_rv_lv_then_rb_lb() {
   s_recieved_bus_measurement = false;
   memset(&s_test_measurements, 0, sizeof(s_test_measurements));
 
-  MotorControllerMeasurements expected_second_measurements = {
+  TestWaveSculptorMeasurements expected_second_measurements = {
     .bus_measurements =
         {
             [LEFT_MOTOR_CONTROLLER] =
@@ -4,5 +4,15 @@
 #include "can_msg_defs.h"
 #include "can_transmit.h"
 #include "can_unpack.h"
+#include "exported_enums.h"
 
+// Any change in either position of at least this much is published, where positions are
+// percentages with EE_PEDAL_VALUE_DENOMINATOR as one
+#define PEDAL_DATA_TX_CHANGE_THRESHOLD (EE_PEDAL_VALUE_DENOMINATOR / 2)
+// Publishes at most this often, so a noisy pedal can't flood the bus
+#define PEDAL_DATA_TX_MIN_PERIOD_MS 10
+// Publishes at least this often, even if nothing changed
+#define PEDAL_DATA_TX_MAX_PERIOD_MS 100
+
+// Publishes positions as the pedals' ADS1015 channels convert. Call after pedal_resources_init().
 StatusCode pedal_data_tx_init();
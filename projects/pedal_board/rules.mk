@@ -10,10 +10,15 @@ $(T)_DEPS := ms-helper ms-common codegen-tooling
 
 ifeq (x86,$(PLATFORM))
 $(T)_EXCLUDE_TESTS := pedal_calib
+else
+# ADS1015 inputs are only injected on x86
+$(T)_EXCLUDE_TESTS := pedal_data_tx_latency
 endif
 
 $(T)_test_brake_data_MOCKS := ads1015_read_raw
 
 $(T)_test_throttle_data_MOCKS := ads1015_read_raw
 
-$(T)_test_pedal_data_tx_MOCKS := ads1015_read_raw
+$(T)_test_pedal_data_tx_MOCKS := ads1015_read_raw can_transmit
+
+$(T)_test_pedal_data_tx_latency_MOCKS := can_transmit
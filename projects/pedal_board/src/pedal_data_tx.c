@@ -1,4 +1,10 @@
 #include "pedal_data_tx.h"
+// Publishes the pedal positions as the ADS1015 converts them instead of on a
+// fixed tick. Each conversion is compared against the last published position,
+// and a large enough change goes out right away. Publishing is limited to once
+// every PEDAL_DATA_TX_MIN_PERIOD_MS: changes within that period go out when it
+// ends. Positions are republished every PEDAL_DATA_TX_MAX_PERIOD_MS regardless.
+#include <stdlib.h>
 #include "ads1015.h"
 #include "brake_data.h"
 #include "can.h"
@@ -13,23 +19,82 @@
 #include "soft_timer.h"
 #include "throttle_data.h"
 
-#define TIMER_TIMEOUT_IN_MILLIS 100
-
+// Last published positions
 int16_t brake_position = INT16_MAX;
 int16_t throttle_position = INT16_MAX;
 
-// pedal callback
-static void prv_pedal_timeout(SoftTimerId timer_id, void *context) {
+static SoftTimerId s_max_period_timer = SOFT_TIMER_INVALID_TIMER;
+static SoftTimerId s_min_period_timer = SOFT_TIMER_INVALID_TIMER;
+static bool s_change_pending = false;
+
+static void prv_transmit(void);
+
+static void prv_max_period_timeout(SoftTimerId timer_id, void *context) {
+  s_max_period_timer = SOFT_TIMER_INVALID_TIMER;
+  prv_transmit();
+}
+
+static void prv_min_period_timeout(SoftTimerId timer_id, void *context) {
+  s_min_period_timer = SOFT_TIMER_INVALID_TIMER;
+  if (s_change_pending) {
+    prv_transmit();
+  }
+}
+
+static void prv_transmit(void) {
   get_brake_data(&brake_position);
   get_throttle_data(&throttle_position);
   // SENDING POSITIONS THROUGH CAN MESSAGES
   CAN_TRANSMIT_PEDAL_OUTPUT((uint32_t)throttle_position, (uint32_t)brake_position);
-  soft_timer_start_millis(TIMER_TIMEOUT_IN_MILLIS, prv_pedal_timeout, context, NULL);
+  s_change_pending = false;
+
+  soft_timer_cancel(s_max_period_timer);
+  soft_timer_cancel(s_min_period_timer);
+  soft_timer_start_millis(PEDAL_DATA_TX_MAX_PERIOD_MS, prv_max_period_timeout, NULL,
+                          &s_max_period_timer);
+  soft_timer_start_millis(PEDAL_DATA_TX_MIN_PERIOD_MS, prv_min_period_timeout, NULL,
+                          &s_min_period_timer);
+}
+
+// Runs after each conversion of either pedal.
+static void prv_conversion_callback(Ads1015Channel channel, void *context) {
+  int16_t position = 0;
+  int16_t published = INT16_MAX;
+  StatusCode status = STATUS_CODE_OK;
+  if (channel == THROTTLE_CHANNEL) {
+    status = get_throttle_data(&position);
+    published = throttle_position;
+  } else {
+    status = get_brake_data(&position);
+    published = brake_position;
+  }
+
+  if (!status_ok(status) || abs(position - published) < PEDAL_DATA_TX_CHANGE_THRESHOLD) {
+    return;
+  }
+
+  if (s_min_period_timer != SOFT_TIMER_INVALID_TIMER) {
+    s_change_pending = true;
+  } else {
+    prv_transmit();
+  }
 }
 
 // main should have a brake fsm, and ads1015storage
 StatusCode pedal_data_tx_init() {
+  // soft_timer_init() doesn't cancel timers
+  soft_timer_cancel(s_max_period_timer);
+  soft_timer_cancel(s_min_period_timer);
+  s_min_period_timer = SOFT_TIMER_INVALID_TIMER;
+  s_change_pending = false;
+  brake_position = INT16_MAX;
+  throttle_position = INT16_MAX;
+
+  Ads1015Storage *storage = get_shared_ads1015_storage();
+  status_ok_or_return(
+      ads1015_configure_channel(storage, THROTTLE_CHANNEL, true, prv_conversion_callback, NULL));
   status_ok_or_return(
-      soft_timer_start_millis(TIMER_TIMEOUT_IN_MILLIS, prv_pedal_timeout, NULL, NULL));
-  return STATUS_CODE_OK;
+      ads1015_configure_channel(storage, BRAKE_CHANNEL, true, prv_conversion_callback, NULL));
+  return soft_timer_start_millis(PEDAL_DATA_TX_MAX_PERIOD_MS, prv_max_period_timeout, NULL,
+                                 &s_max_period_timer);
 }
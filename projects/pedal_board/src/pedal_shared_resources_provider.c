@@ -4,6 +4,9 @@
 #include "pedal_calib.h"
 #include "string.h"
 
+// Rejects single-conversion glitches, then smooths over roughly 4 conversions
+static const Ads1015FilterSettings s_pedal_filter = { .median = true, .iir_shift = 2 };
+
 static Ads1015Storage *s_ads1015_storage;
 static PedalCalibBlob *s_pedal_calib_blob;
 
@@ -19,6 +22,10 @@ StatusCode pedal_resources_init(Ads1015Storage *storage, PedalCalibBlob *calib_b
   LOG_DEBUG("BRAKE UPPER: %d \n", s_pedal_calib_blob->brake_calib.upper_value);
   LOG_DEBUG("BRAKE UPPER: %d \n", s_pedal_calib_blob->brake_calib.lower_value);
 
+  status_ok_or_return(
+      ads1015_configure_filter(s_ads1015_storage, THROTTLE_CHANNEL, &s_pedal_filter));
+  status_ok_or_return(ads1015_configure_filter(s_ads1015_storage, BRAKE_CHANNEL, &s_pedal_filter));
+
   // Throttle Channel, there's 2 but we only use 1 right now
   status_ok_or_return(
       ads1015_configure_channel(s_ads1015_storage, THROTTLE_CHANNEL, true, NULL, NULL));
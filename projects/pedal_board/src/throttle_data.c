@@ -2,6 +2,7 @@
 #include "brake_data.h"
 #include "event_queue.h"
 #include "exported_enums.h"
+#include "fixed_point.h"
 #include "fsm.h"
 #include "log.h"
 #include "pedal_data_tx.h"
@@ -13,15 +14,12 @@ StatusCode get_throttle_data(int16_t *position) {
   // throttle actually uses 2 channels. may configure later
   status_ok_or_return(ads1015_read_raw(get_shared_ads1015_storage(), THROTTLE_CHANNEL, position));
   PedalCalibBlob *calib_blob = get_shared_pedal_calib_blob();
-  int32_t range = calib_blob->throttle_calib.upper_value - calib_blob->throttle_calib.lower_value;
-  int32_t position_upscaled = (int32_t)*position * EE_PEDAL_VALUE_DENOMINATOR;
-  position_upscaled -= calib_blob->throttle_calib.lower_value * EE_PEDAL_VALUE_DENOMINATOR;
-  position_upscaled *= 100;
-  // just to check
-
-  if (range != 0) {
-    position_upscaled /= range;
-    *position = (int16_t)position_upscaled;
+  PedalCalibrationData *calib = &calib_blob->throttle_calib;
+  // Position is a percentage in fixed point with EE_PEDAL_VALUE_DENOMINATOR as one, truncated like
+  // the integer division this used to do
+  if (calib->upper_value != calib->lower_value) {
+    *position = (int16_t)fixed_map_trunc(*position, calib->lower_value, calib->upper_value, 0,
+                                         100 * EE_PEDAL_VALUE_DENOMINATOR);
   }
   return STATUS_CODE_OK;
 }
@@ -85,3 +85,23 @@ void test_brake_data(void) {
   TEST_ASSERT_OK(get_brake_data(&brake_data));
   TEST_ASSERT_EQUAL(brake_data, (int16_t)(changeable_value * EE_PEDAL_VALUE_DENOMINATOR));
 }
+
+// Positions are truncated like the integer division the scaling used to do: (12 - 10) / 300 of the
+// way is 2730.67 / EE_PEDAL_VALUE_DENOMINATOR percent, which must not round up to 2731.
+void test_brake_data_truncates(void) {
+  s_calib_blob.brake_calib.lower_value = 10;
+  s_calib_blob.brake_calib.upper_value = 310;
+
+  int16_t brake_data = INT16_MAX;
+  changeable_value = 12;
+  TEST_ASSERT_OK(get_brake_data(&brake_data));
+  TEST_ASSERT_EQUAL(2730, brake_data);
+  // Below the calibrated range, toward zero rather than down
+  changeable_value = 8;
+  TEST_ASSERT_OK(get_brake_data(&brake_data));
+  TEST_ASSERT_EQUAL(-2730, brake_data);
+
+  s_calib_blob.brake_calib.lower_value = 0;
+  s_calib_blob.brake_calib.upper_value = 100;
+  changeable_value = 0;
+}
@@ -1,26 +1,44 @@
+#include <string.h>
+
 #include "ads1015.h"
 #include "brake_data.h"
 #include "can_transmit.h"
+#include "can_unpack.h"
 #include "delay.h"
 #include "event_queue.h"
 #include "exported_enums.h"
-#include "fsm.h"
 #include "gpio.h"
 #include "gpio_it.h"
 #include "interrupt.h"
 #include "log.h"
-#include "ms_test_helpers.h"
 #include "pedal_data_tx.h"
 #include "pedal_events.h"
 #include "soft_timer.h"
 #include "test_helpers.h"
 #include "throttle_data.h"
 
-int16_t changeable_value = 0;
+// Conversions keep coming, so give them a few periods to be picked up
+#define TEST_PEDAL_DATA_TX_SETTLE_MS 5
+
+static volatile int16_t s_raw[NUM_ADS1015_CHANNELS];
+static volatile uint32_t s_num_tx;
+static volatile uint32_t s_throttle_tx;
+static volatile uint32_t s_brake_tx;
 
 StatusCode TEST_MOCK(ads1015_read_raw)(Ads1015Storage *storage, Ads1015Channel channel,
                                        int16_t *reading) {
-  *reading = changeable_value;
+  *reading = s_raw[channel];
+  return STATUS_CODE_OK;
+}
+
+StatusCode TEST_MOCK(can_transmit)(const CanMessage *msg, const CanAckRequest *ack_request) {
+  TEST_ASSERT_EQUAL(SYSTEM_CAN_MESSAGE_PEDAL_OUTPUT, msg->msg_id);
+  uint32_t throttle = 0;
+  uint32_t brake = 0;
+  CAN_UNPACK_PEDAL_OUTPUT(msg, &throttle, &brake);
+  s_throttle_tx = throttle;
+  s_brake_tx = brake;
+  s_num_tx++;
   return STATUS_CODE_OK;
 }
 
@@ -33,25 +51,8 @@ static PedalCalibBlob s_calib_blob = {
   .brake_calib.lower_value = 0,
 };
 
-static CanStorage s_can_storage = { 0 };
-static CanSettings s_can_settings = {
-  .device_id = 0x1,
-  .bitrate = CAN_HW_BITRATE_500KBPS,
-  .rx_event = PEDAL_CAN_RX,
-  .tx_event = PEDAL_CAN_TX,
-  .fault_event = PEDAL_CAN_FAULT,
-  .tx = { GPIO_PORT_A, 12 },
-  .rx = { GPIO_PORT_A, 11 },
-  .loopback = true,
-};
-
-int counter = 0;
-
-StatusCode prv_test_pedal_data_tx_callback_handler(const CanMessage *msg, void *context,
-                                                   CanAckStatus *ack_reply) {
-  TEST_ASSERT_EQUAL(SYSTEM_CAN_MESSAGE_PEDAL_OUTPUT, msg->msg_id);
-  counter++;
-  return STATUS_CODE_OK;
+static uint32_t prv_position(int16_t raw) {
+  return (uint32_t)(int16_t)(raw * EE_PEDAL_VALUE_DENOMINATOR);
 }
 
 void setup_test(void) {
@@ -61,7 +62,6 @@ void setup_test(void) {
   soft_timer_init();
   event_queue_init();
 
-  can_init(&s_can_storage, &s_can_settings);
   // setup ADC readings
   I2CSettings i2c_settings = {
     .speed = I2C_SPEED_FAST,
@@ -72,8 +72,8 @@ void setup_test(void) {
   GpioAddress ready_pin = { .port = GPIO_PORT_B, .pin = 5 };
   ads1015_init(&s_ads1015_storage, I2C_PORT_2, ADS1015_ADDRESS_GND, &ready_pin);
 
-  can_register_rx_handler(SYSTEM_CAN_MESSAGE_PEDAL_OUTPUT, prv_test_pedal_data_tx_callback_handler,
-                          NULL);
+  memset((void *)s_raw, 0, sizeof(s_raw));
+  s_num_tx = 0;
 
   TEST_ASSERT_OK(pedal_resources_init(&s_ads1015_storage, &s_calib_blob));
   TEST_ASSERT_OK(pedal_data_tx_init());
@@ -81,64 +81,56 @@ void setup_test(void) {
 
 void teardown_test(void) {}
 
-void test_pedal_rx_handler(void) {
-  // should transmit immediately
-
-  MS_TEST_HELPER_CAN_TX_RX(PEDAL_CAN_TX, PEDAL_CAN_RX);
-  int16_t throttle_data = INT16_MAX;
-  int16_t brake_data = INT16_MAX;
-
-  changeable_value = 32;
-  TEST_ASSERT_EQUAL(counter, 1);
-  TEST_ASSERT_OK(get_throttle_data(&throttle_data));
-  TEST_ASSERT_EQUAL(throttle_data, (int16_t)(changeable_value * EE_PEDAL_VALUE_DENOMINATOR));
-  changeable_value = 15;
-  TEST_ASSERT_OK(get_brake_data(&brake_data));
-  TEST_ASSERT_EQUAL(brake_data, (int16_t)(changeable_value * EE_PEDAL_VALUE_DENOMINATOR));
-
-  delay_ms(100);
-  MS_TEST_HELPER_CAN_TX_RX(PEDAL_CAN_TX, PEDAL_CAN_RX);
-  TEST_ASSERT_EQUAL(counter, 2);
-  changeable_value = 2;
-  TEST_ASSERT_OK(get_throttle_data(&throttle_data));
-  TEST_ASSERT_EQUAL(throttle_data, (int16_t)(changeable_value * EE_PEDAL_VALUE_DENOMINATOR));
-  changeable_value = 34;
-  TEST_ASSERT_OK(get_brake_data(&brake_data));
-  TEST_ASSERT_EQUAL(brake_data, (int16_t)(changeable_value * EE_PEDAL_VALUE_DENOMINATOR));
-
-  delay_ms(95);
-  TEST_ASSERT_EQUAL(counter, 2);
-  changeable_value = 0;
-  TEST_ASSERT_OK(get_throttle_data(&throttle_data));
-  TEST_ASSERT_EQUAL(throttle_data, (int16_t)(changeable_value * EE_PEDAL_VALUE_DENOMINATOR));
-  changeable_value = 3;
-  TEST_ASSERT_OK(get_brake_data(&brake_data));
-  TEST_ASSERT_EQUAL(brake_data, (int16_t)(changeable_value * EE_PEDAL_VALUE_DENOMINATOR));
-  delay_ms(5);
-  MS_TEST_HELPER_CAN_TX_RX(PEDAL_CAN_TX, PEDAL_CAN_RX);
-
-  delay_ms(100);
-  MS_TEST_HELPER_CAN_TX_RX(PEDAL_CAN_TX, PEDAL_CAN_RX);
-  delay_ms(100);
-  MS_TEST_HELPER_CAN_TX_RX(PEDAL_CAN_TX, PEDAL_CAN_RX);
-  delay_ms(100);
-  MS_TEST_HELPER_CAN_TX_RX(PEDAL_CAN_TX, PEDAL_CAN_RX);
-  TEST_ASSERT_EQUAL(counter, 6);
-  changeable_value = 33;
-  TEST_ASSERT_OK(get_throttle_data(&throttle_data));
-  TEST_ASSERT_EQUAL(throttle_data, (int16_t)(changeable_value * EE_PEDAL_VALUE_DENOMINATOR));
-  TEST_ASSERT_OK(get_brake_data(&brake_data));
-  TEST_ASSERT_EQUAL(brake_data, (int16_t)(changeable_value * EE_PEDAL_VALUE_DENOMINATOR));
-
-  delay_ms(75);
-  TEST_ASSERT_EQUAL(counter, 6);
-  delay_ms(25);
-  MS_TEST_HELPER_CAN_TX_RX(PEDAL_CAN_TX, PEDAL_CAN_RX);
-  TEST_ASSERT_EQUAL(counter, 7);
-  changeable_value = 23;
-  TEST_ASSERT_OK(get_throttle_data(&throttle_data));
-  TEST_ASSERT_EQUAL(throttle_data, (int16_t)(changeable_value * EE_PEDAL_VALUE_DENOMINATOR));
-  changeable_value = 21;
-  TEST_ASSERT_OK(get_brake_data(&brake_data));
-  TEST_ASSERT_EQUAL(brake_data, (int16_t)(changeable_value * EE_PEDAL_VALUE_DENOMINATOR));
+// The first conversions publish right away, and so does each change after that.
+void test_pedal_data_tx_publish_on_change(void) {
+  delay_ms(TEST_PEDAL_DATA_TX_SETTLE_MS);
+  TEST_ASSERT_EQUAL(1, s_num_tx);
+  TEST_ASSERT_EQUAL(prv_position(0), s_throttle_tx);
+  TEST_ASSERT_EQUAL(prv_position(0), s_brake_tx);
+
+  delay_ms(PEDAL_DATA_TX_MIN_PERIOD_MS);
+  s_raw[THROTTLE_CHANNEL] = 3;
+  delay_ms(TEST_PEDAL_DATA_TX_SETTLE_MS);
+  TEST_ASSERT_EQUAL(2, s_num_tx);
+  TEST_ASSERT_EQUAL(prv_position(3), s_throttle_tx);
+  TEST_ASSERT_EQUAL(prv_position(0), s_brake_tx);
+
+  delay_ms(PEDAL_DATA_TX_MIN_PERIOD_MS);
+  s_raw[BRAKE_CHANNEL] = 7;
+  delay_ms(TEST_PEDAL_DATA_TX_SETTLE_MS);
+  TEST_ASSERT_EQUAL(3, s_num_tx);
+  TEST_ASSERT_EQUAL(prv_position(3), s_throttle_tx);
+  TEST_ASSERT_EQUAL(prv_position(7), s_brake_tx);
+}
+
+// Steady positions are still republished every PEDAL_DATA_TX_MAX_PERIOD_MS.
+void test_pedal_data_tx_max_period(void) {
+  delay_ms(TEST_PEDAL_DATA_TX_SETTLE_MS);
+  TEST_ASSERT_EQUAL(1, s_num_tx);
+
+  delay_ms(PEDAL_DATA_TX_MAX_PERIOD_MS - 2 * TEST_PEDAL_DATA_TX_SETTLE_MS);
+  TEST_ASSERT_EQUAL(1, s_num_tx);
+  delay_ms(2 * TEST_PEDAL_DATA_TX_SETTLE_MS);
+  TEST_ASSERT_EQUAL(2, s_num_tx);
+  delay_ms(PEDAL_DATA_TX_MAX_PERIOD_MS);
+  TEST_ASSERT_EQUAL(3, s_num_tx);
+}
+
+// A pedal that changes on every conversion is limited to PEDAL_DATA_TX_MIN_PERIOD_MS, and its
+// final position still goes out.
+void test_pedal_data_tx_min_period(void) {
+  delay_ms(TEST_PEDAL_DATA_TX_SETTLE_MS);
+  s_num_tx = 0;
+
+  const uint32_t duration_ms = 5 * PEDAL_DATA_TX_MIN_PERIOD_MS;
+  for (uint32_t i = 0; i < duration_ms; i++) {
+    s_raw[THROTTLE_CHANNEL] = (int16_t)(i % 2 == 0 ? 5 : 1);
+    delay_ms(1);
+  }
+  s_raw[THROTTLE_CHANNEL] = 7;
+  delay_ms(PEDAL_DATA_TX_MIN_PERIOD_MS + TEST_PEDAL_DATA_TX_SETTLE_MS);
+
+  TEST_ASSERT_TRUE(s_num_tx <= duration_ms / PEDAL_DATA_TX_MIN_PERIOD_MS + 2);
+  TEST_ASSERT_TRUE(s_num_tx >= duration_ms / PEDAL_DATA_TX_MIN_PERIOD_MS - 1);
+  TEST_ASSERT_EQUAL(prv_position(7), s_throttle_tx);
 }
@@ -0,0 +1,124 @@
+// Measures how long a pedal step takes to reach CAN, from the emulated ADS1015's input through its
+// ready pin, the driver's filtering and pedal_data_tx.
+#include <time.h>
+
+#include "ads1015.h"
+#include "ads1015_inject.h"
+#include "can_transmit.h"
+#include "can_unpack.h"
+#include "delay.h"
+#include "exported_enums.h"
+#include "gpio.h"
+#include "gpio_inject.h"
+#include "gpio_it.h"
+#include "interrupt.h"
+#include "log.h"
+#include "misc.h"
+#include "pedal_data_tx.h"
+#include "soft_timer.h"
+#include "test_helpers.h"
+#include "throttle_data.h"
+
+#define TEST_PEDAL_LATENCY_I2C_PORT I2C_PORT_2
+#define TEST_PEDAL_LATENCY_ADDR ADS1015_ADDRESS_GND
+// 5% throttle with the calibration below
+#define TEST_PEDAL_LATENCY_STEP_RAW 50
+#define TEST_PEDAL_LATENCY_NUM_STEPS 10
+
+static Ads1015Storage s_ads1015_storage = { 0 };
+static GpioAddress s_ready_pin = { .port = GPIO_PORT_B, .pin = 2 };
+
+// Raw readings from 0 to 1000 cover 0% to 100%, so positions up to 8% fit in an int16_t
+static PedalCalibBlob s_calib_blob = {
+  .throttle_calib.upper_value = 1000,
+  .throttle_calib.lower_value = 0,
+  .brake_calib.upper_value = 1000,
+  .brake_calib.lower_value = 0,
+};
+
+static volatile uint32_t s_num_tx;
+static volatile uint32_t s_throttle_tx;
+static volatile uint64_t s_tx_time_ns;
+static volatile uint64_t s_conversion_time_ns;
+
+static uint64_t prv_now_ns(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+StatusCode TEST_MOCK(can_transmit)(const CanMessage *msg, const CanAckRequest *ack_request) {
+  uint32_t brake = 0;
+  uint32_t throttle = 0;
+  CAN_UNPACK_PEDAL_OUTPUT(msg, &throttle, &brake);
+  s_throttle_tx = throttle;
+  s_tx_time_ns = prv_now_ns();
+  // The conversion that caused this message
+  uint64_t conversion_time_ns = 0;
+  gpio_inject_get_edge_time(&s_ready_pin, &conversion_time_ns);
+  s_conversion_time_ns = conversion_time_ns;
+  s_num_tx++;
+  return STATUS_CODE_OK;
+}
+
+void setup_test(void) {
+  gpio_init();
+  interrupt_init();
+  gpio_it_init();
+  soft_timer_init();
+
+  I2CSettings i2c_settings = {
+    .speed = I2C_SPEED_FAST,
+    .scl = { .port = GPIO_PORT_B, .pin = 10 },
+    .sda = { .port = GPIO_PORT_B, .pin = 11 },
+  };
+  i2c_init(TEST_PEDAL_LATENCY_I2C_PORT, &i2c_settings);
+  for (Ads1015Channel channel = 0; channel < NUM_ADS1015_CHANNELS; channel++) {
+    ads1015_inject_set_raw(TEST_PEDAL_LATENCY_I2C_PORT, TEST_PEDAL_LATENCY_ADDR, channel, 0);
+  }
+  TEST_ASSERT_OK(ads1015_init(&s_ads1015_storage, TEST_PEDAL_LATENCY_I2C_PORT,
+                              TEST_PEDAL_LATENCY_ADDR, &s_ready_pin));
+  TEST_ASSERT_OK(pedal_resources_init(&s_ads1015_storage, &s_calib_blob));
+  TEST_ASSERT_OK(pedal_data_tx_init());
+  s_num_tx = 0;
+}
+
+void teardown_test(void) {}
+
+// Each step should be published within the minimum period, well before the maximum period that
+// used to be the only publishing tick.
+void test_pedal_data_tx_latency_step(void) {
+  uint64_t worst_ns = 0;
+  uint64_t worst_conversion_ns = 0;
+  uint64_t total_ns = 0;
+
+  for (int i = 0; i < TEST_PEDAL_LATENCY_NUM_STEPS; i++) {
+    int16_t raw = (i % 2 == 0) ? TEST_PEDAL_LATENCY_STEP_RAW : 0;
+    // Start once the filter has settled on the previous step and nothing is held back by the
+    // minimum period
+    uint32_t num_tx = 0;
+    do {
+      num_tx = s_num_tx;
+      delay_ms(2 * PEDAL_DATA_TX_MIN_PERIOD_MS);
+    } while (num_tx != s_num_tx);
+
+    uint64_t start_ns = prv_now_ns();
+    ads1015_inject_set_raw(TEST_PEDAL_LATENCY_I2C_PORT, TEST_PEDAL_LATENCY_ADDR,
+                           THROTTLE_CHANNEL, raw);
+    while (s_num_tx == num_tx) {
+      TEST_ASSERT_TRUE(prv_now_ns() - start_ns < PEDAL_DATA_TX_MAX_PERIOD_MS * 1000000ull);
+    }
+
+    uint64_t latency_ns = s_tx_time_ns - start_ns;
+    total_ns += latency_ns;
+    worst_ns = MAX(worst_ns, latency_ns);
+    worst_conversion_ns = MAX(worst_conversion_ns, s_tx_time_ns - s_conversion_time_ns);
+  }
+
+  LOG_DEBUG("Step to CAN: %u us average, %u us worst, %u us worst from conversion\n",
+            (unsigned int)(total_ns / TEST_PEDAL_LATENCY_NUM_STEPS / 1000),
+            (unsigned int)(worst_ns / 1000), (unsigned int)(worst_conversion_ns / 1000));
+  TEST_ASSERT_TRUE(worst_ns < PEDAL_DATA_TX_MIN_PERIOD_MS * 1000000ull);
+  // Messages go out from the conversion interrupt itself
+  TEST_ASSERT_TRUE(worst_conversion_ns < worst_ns);
+}
@@ -2,10 +2,19 @@
 
 // Periodically reads current from load switches and exposes global storage.
 // Requires GPIO, interrupts, soft timers, ADC (in ADC_MODE_SINGLE), and I2C to be initalized.
+//
+// Sampling adapts per load switch: a switch whose current is changing is read every
+// |interval_us|, while a steady one backs off, doubling its interval up to the sampling config's
+// |max_interval_us|. A switch carrying a high current is read every |high_current_interval_us|
+// instead. The averages are updated from the latest measurements every |interval_us| however
+// often each switch was read, and the callback runs after each update. Each high current read
+// is also fed to its average right away and runs the callback, so high currents are published
+// at the faster rate.
 
 #include <stdint.h>
 #include "currents.h"
 #include "gpio.h"
+#include "moving_stats.h"
 #include "mux.h"
 #include "pca9539r_gpio_expander.h"
 #include "status.h"
@@ -27,6 +36,9 @@
 #define POWER_DISTRIBUTION_BTS7200_MIN_FAULT_VOLTAGE_MV 3200
 #define POWER_DISTRIBUTION_BTS7200_MAX_FAULT_VOLTAGE_MV 10000
 
+// Each measurement is blended into |averages| with weight 2^-shift to smooth out sense noise.
+#define POWER_DISTRIBUTION_CURRENT_FILTER_SHIFT 1
+
 typedef void (*PowerDistributionCurrentMeasurementCallback)(void *context);
 
 typedef struct {
@@ -62,10 +74,29 @@ typedef struct {
   MuxAddress mux_address;
 } PowerDistributionCurrentHardwareConfig;
 
+typedef struct {
+  // Longest time between reads of a steady load switch. At most |interval_us| (e.g. 0) reads
+  // every switch every interval.
+  uint32_t max_interval_us;
+  // A read of any current on the switch more than this many mA from its previous read means the
+  // switch is changing
+  uint16_t change_threshold_ma;
+  // Switches with any current at or above this many mA are read every |high_current_interval_us|
+  // and published rather than backing off, so faults near the limit are caught quickly. 0
+  // disables this.
+  uint16_t high_current_ma;
+  // Time between reads of a switch carrying a high current. Only used if it's shorter than
+  // |interval_us|, which it should divide evenly.
+  uint32_t high_current_interval_us;
+} PowerDistributionCurrentSamplingConfig;
+
 typedef struct {
   PowerDistributionCurrentHardwareConfig hw_config;
+  // Time between reads of a changing load switch and between updates of the averages
   uint32_t interval_us;
-  // If specified, this callback is called whenever current measurements are updated.
+  PowerDistributionCurrentSamplingConfig sampling;
+  // If specified, this callback is called every |interval_us| once the averages are updated, and
+  // after every read of a high current.
   PowerDistributionCurrentMeasurementCallback callback;
   void *callback_context;
 } PowerDistributionCurrentSettings;
@@ -73,6 +104,13 @@ typedef struct {
 typedef struct {
   // Only the currents specified in the hardware config will be populated.
   uint16_t measurements[NUM_POWER_DISTRIBUTION_CURRENTS];
+  // Filtered measurements, populated for the same currents.
+  uint16_t averages[NUM_POWER_DISTRIBUTION_CURRENTS];
+  // Number of load switch reads so far, for tuning the sampling config
+  uint32_t num_reads;
+  // Number of timer ticks so far; the timer ticks every |high_current_interval_us| if it's used,
+  // otherwise every |interval_us|
+  uint32_t num_ticks;
 } PowerDistributionCurrentStorage;
 
 // Initialize the module with the given settings and set up a soft timer to read currents.
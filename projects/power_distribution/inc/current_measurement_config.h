@@ -1,8 +1,20 @@
 #pragma once
 
-// Standard hardware configurations for current_measurement.
+// Standard hardware and sampling configurations for current_measurement.
 
 #include "current_measurement.h"
 
+// Changing currents are read this often, and the averages are published at this rate
+#define POWER_DISTRIBUTION_CURRENT_INTERVAL_US 500000
+// Steady currents back off to being read this often
+#define POWER_DISTRIBUTION_CURRENT_MAX_INTERVAL_US 1600000
+// Well above the sense noise, well below any load's switching step
+#define POWER_DISTRIBUTION_CURRENT_CHANGE_THRESHOLD_MA 50
+// Switches carrying at least this much current are read this often
+#define POWER_DISTRIBUTION_CURRENT_HIGH_MA 3000
+#define POWER_DISTRIBUTION_CURRENT_HIGH_INTERVAL_US 100000
+
 extern const PowerDistributionCurrentHardwareConfig FRONT_POWER_DISTRIBUTION_CURRENT_HW_CONFIG;
 extern const PowerDistributionCurrentHardwareConfig REAR_POWER_DISTRIBUTION_CURRENT_HW_CONFIG;
+
+extern const PowerDistributionCurrentSamplingConfig POWER_DISTRIBUTION_CURRENT_SAMPLING_CONFIG;
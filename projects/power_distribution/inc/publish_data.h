@@ -2,6 +2,10 @@
 
 // Publishes current measurements over CAN as generated by power_distribution_current_measurement.
 // Requires CAN, GPIO, soft timers, event queue, and interrupts to be initialized.
+//
+// Only currents that moved out of their dead band since they were last published are sent,
+// along with any that haven't been sent for |max_staleness_ms| and any at or above
+// |high_current_ma|, so steady loads stay off the bus.
 
 #include <stdint.h>
 #include "currents.h"
@@ -18,12 +22,21 @@ typedef struct {
   // Currents in this array will be published (in order), others will be ignored.
   PowerDistributionCurrent *currents_to_publish;
   uint16_t num_currents_to_publish;  // length of preceding array
+
+  // Currents within this many mA of their last published value are held back...
+  uint16_t dead_band_ma;
+  // ...until it's this old. 0 publishes every current on every call.
+  uint32_t max_staleness_ms;
+  // Currents at or above this many mA are published on every call regardless, so fault-level
+  // currents aren't held back. 0 disables this.
+  uint16_t high_current_ma;
 } PowerDistributionPublishConfig;
 
 // Initialize the module with the specified config.
 StatusCode power_distribution_publish_data_init(PowerDistributionPublishConfig config);
 
-// Publish the given set of current measurements.
+// Publish the currents from the given set of measurements that changed or went stale.
+// Every current is published on the first call after init.
 // This should be called from a power_distribution_current_measurement callback.
 StatusCode power_distribution_publish_data_publish(
     uint16_t current_measurements[NUM_POWER_DISTRIBUTION_CURRENTS]);
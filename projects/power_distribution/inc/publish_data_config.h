@@ -4,5 +4,10 @@
 
 #include "publish_data.h"
 
+// Half the smallest step we care about, well above the averaged sense noise
+#define POWER_DISTRIBUTION_PUBLISH_DEAD_BAND_MA 25
+// Steady currents are still republished this often so receivers can spot a silent board
+#define POWER_DISTRIBUTION_PUBLISH_MAX_STALENESS_MS 5000
+
 extern const PowerDistributionPublishConfig FRONT_POWER_DISTRIBUTION_PUBLISH_DATA_CONFIG;
 extern const PowerDistributionPublishConfig REAR_POWER_DISTRIBUTION_PUBLISH_DATA_CONFIG;
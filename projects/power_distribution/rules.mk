@@ -6,4 +6,9 @@
 # $(T)_SRC: $(T)_DIR/src{/$(PLATFORM)}/*.{c,s}
 
 # Specify the libraries you want to include
-$(T)_DEPS := ms-common ms-drivers
+$(T)_DEPS := ms-common ms-helper ms-drivers
+
+ifneq (x86,$(PLATFORM))
+# Load switch currents are only simulated on x86
+$(T)_EXCLUDE_TESTS := current_measurement_sampling
+endif
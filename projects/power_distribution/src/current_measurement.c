@@ -1,40 +1,163 @@
 #include "current_measurement.h"
 
 #include <stddef.h>
+#include <stdlib.h>
 #include "bts_7040_7008_current_sense.h"
 #include "bts_7200_current_sense.h"
+#include "misc.h"
+
+// When each load switch is next read, in timer ticks
+typedef struct {
+  uint16_t interval_ticks;
+  uint16_t ticks_left;
+} PowerDistributionCurrentSchedule;
 
 static PowerDistributionCurrentHardwareConfig s_hw_config;
 static PowerDistributionCurrentStorage s_storage = { 0 };
 static Bts7200Storage s_bts7200_storages[MAX_POWER_DISTRIBUTION_BTS7200_CHANNELS];
 static Bts7040Storage s_bts7040_storages[MAX_POWER_DISTRIBUTION_BTS7040_CHANNELS];
+static MovingStatsEwma s_filters[NUM_POWER_DISTRIBUTION_CURRENTS];
+// Whether each current's filter was already fed from a high current read this tick
+static bool s_fed_high[NUM_POWER_DISTRIBUTION_CURRENTS];
+static PowerDistributionCurrentSchedule
+    s_bts7200_schedules[MAX_POWER_DISTRIBUTION_BTS7200_CHANNELS];
+static PowerDistributionCurrentSchedule
+    s_bts7040_schedules[MAX_POWER_DISTRIBUTION_BTS7040_CHANNELS];
 static SoftTimerId s_timer_id;
 
 static uint32_t s_interval_us;
+static PowerDistributionCurrentSamplingConfig s_sampling;
+// The timer ticks at the high current interval if there is one, otherwise every interval
+static uint32_t s_tick_us;
+static uint16_t s_ticks_per_interval;
+static uint16_t s_max_interval_ticks;
 static PowerDistributionCurrentMeasurementCallback s_callback;
 static void *s_callback_context;
 
+static void prv_update_average(PowerDistributionCurrent current) {
+  s_storage.averages[current] =
+      (uint16_t)moving_stats_ewma_push(&s_filters[current], s_storage.measurements[current]);
+}
+
+// Feed a high current read straight to the filter so the callback can publish it this tick
+static void prv_update_high_average(PowerDistributionCurrent current) {
+  prv_update_average(current);
+  s_fed_high[current] = true;
+}
+
+static void prv_update_interval_average(PowerDistributionCurrent current) {
+  if (!s_fed_high[current]) {
+    prv_update_average(current);
+  }
+}
+
+// Feed every current's latest measurement to its filter, so the filters see evenly spaced samples
+// however often each switch is read. Currents already fed from a high read this tick are skipped.
+static void prv_update_averages(void) {
+  for (uint8_t i = 0; i < s_hw_config.num_bts7200_channels; i++) {
+    prv_update_interval_average(s_hw_config.bts7200s[i].current_0);
+    prv_update_interval_average(s_hw_config.bts7200s[i].current_1);
+  }
+  for (uint8_t i = 0; i < s_hw_config.num_bts7040_channels; i++) {
+    prv_update_interval_average(s_hw_config.bts7040s[i].current);
+  }
+}
+
+// Whether a switch is due this round, counting down otherwise
+static bool prv_is_due(PowerDistributionCurrentSchedule *schedule) {
+  if (schedule->ticks_left > 1) {
+    schedule->ticks_left--;
+    return false;
+  }
+  return true;
+}
+
+static bool prv_is_changing(uint16_t previous, uint16_t measurement) {
+  return abs((int)measurement - (int)previous) > s_sampling.change_threshold_ma;
+}
+
+static bool prv_is_high(uint16_t measurement) {
+  return s_sampling.high_current_ma != 0 && measurement >= s_sampling.high_current_ma;
+}
+
+static void prv_reschedule(PowerDistributionCurrentSchedule *schedule, bool high, bool changing) {
+  if (high) {
+    schedule->interval_ticks = 1;
+  } else if (changing) {
+    schedule->interval_ticks = s_ticks_per_interval;
+  } else {
+    uint32_t backed_off = MAX(2u * schedule->interval_ticks, (uint32_t)s_ticks_per_interval);
+    schedule->interval_ticks = (uint16_t)MIN(backed_off, (uint32_t)s_max_interval_ticks);
+  }
+  schedule->ticks_left = schedule->interval_ticks;
+}
+
 static void prv_measure_currents(SoftTimerId timer_id, void *context) {
-  // read from all the BTS7200s
+  bool any_high = false;
+
+  // read from the BTS7200s that are due
   for (uint8_t i = 0; i < s_hw_config.num_bts7200_channels; i++) {
+    if (!prv_is_due(&s_bts7200_schedules[i])) {
+      continue;
+    }
+    PowerDistributionCurrent current_0 = s_hw_config.bts7200s[i].current_0;
+    PowerDistributionCurrent current_1 = s_hw_config.bts7200s[i].current_1;
+    uint16_t previous_0 = s_storage.measurements[current_0];
+    uint16_t previous_1 = s_storage.measurements[current_1];
+
     mux_set(&s_hw_config.mux_address, s_hw_config.bts7200s[i].mux_selection);
-    bts_7200_get_measurement(&s_bts7200_storages[i],
-                             &s_storage.measurements[s_hw_config.bts7200s[i].current_0],
-                             &s_storage.measurements[s_hw_config.bts7200s[i].current_1]);
+    bts_7200_get_measurement(&s_bts7200_storages[i], &s_storage.measurements[current_0],
+                             &s_storage.measurements[current_1]);
+    s_storage.num_reads++;
+
+    uint16_t measurement_0 = s_storage.measurements[current_0];
+    uint16_t measurement_1 = s_storage.measurements[current_1];
+    bool high = prv_is_high(measurement_0) || prv_is_high(measurement_1);
+    bool changing = prv_is_changing(previous_0, measurement_0) ||
+                    prv_is_changing(previous_1, measurement_1);
+    prv_reschedule(&s_bts7200_schedules[i], high, changing);
+    if (high) {
+      prv_update_high_average(current_0);
+      prv_update_high_average(current_1);
+      any_high = true;
+    }
   }
 
-  // read from all the BTS7040s
+  // read from the BTS7040s that are due
   for (uint8_t i = 0; i < s_hw_config.num_bts7040_channels; i++) {
+    if (!prv_is_due(&s_bts7040_schedules[i])) {
+      continue;
+    }
+    PowerDistributionCurrent current = s_hw_config.bts7040s[i].current;
+    uint16_t previous = s_storage.measurements[current];
+
     mux_set(&s_hw_config.mux_address, s_hw_config.bts7040s[i].mux_selection);
-    bts_7040_get_measurement(&s_bts7040_storages[i],
-                             &s_storage.measurements[s_hw_config.bts7040s[i].current]);
+    bts_7040_get_measurement(&s_bts7040_storages[i], &s_storage.measurements[current]);
+    s_storage.num_reads++;
+
+    uint16_t measurement = s_storage.measurements[current];
+    bool high = prv_is_high(measurement);
+    prv_reschedule(&s_bts7040_schedules[i], high, prv_is_changing(previous, measurement));
+    if (high) {
+      prv_update_high_average(current);
+      any_high = true;
+    }
   }
 
-  if (s_callback) {
+  // the callback also runs on any tick with a high current, so it's published from every read
+  bool interval_tick = s_storage.num_ticks % s_ticks_per_interval == 0;
+  if (interval_tick) {
+    prv_update_averages();
+  }
+  if ((interval_tick || any_high) && s_callback) {
     s_callback(s_callback_context);
   }
+  for (uint8_t i = 0; i < NUM_POWER_DISTRIBUTION_CURRENTS; i++) {
+    s_fed_high[i] = false;
+  }
+  s_storage.num_ticks++;
 
-  soft_timer_start(s_interval_us, &prv_measure_currents, NULL, &s_timer_id);
+  soft_timer_start(s_tick_us, &prv_measure_currents, NULL, &s_timer_id);
 }
 
 StatusCode power_distribution_current_measurement_init(PowerDistributionCurrentSettings *settings) {
@@ -45,6 +168,17 @@ StatusCode power_distribution_current_measurement_init(PowerDistributionCurrentS
 
   s_hw_config = settings->hw_config;
   s_interval_us = settings->interval_us;
+  s_sampling = settings->sampling;
+  s_tick_us = s_interval_us;
+  if (s_sampling.high_current_interval_us != 0 &&
+      s_sampling.high_current_interval_us < s_interval_us) {
+    s_tick_us = s_sampling.high_current_interval_us;
+  }
+  uint32_t ticks_per_interval = s_interval_us / MAX(s_tick_us, 1u);
+  s_ticks_per_interval = (uint16_t)MIN(MAX(ticks_per_interval, 1u), (uint32_t)UINT16_MAX);
+  uint32_t max_interval_ticks = s_sampling.max_interval_us / MAX(s_tick_us, 1u);
+  s_max_interval_ticks =
+      (uint16_t)MIN(MAX(max_interval_ticks, (uint32_t)s_ticks_per_interval), (uint32_t)UINT16_MAX);
   s_callback = settings->callback;
   s_callback_context = settings->callback_context;
 
@@ -94,6 +228,23 @@ StatusCode power_distribution_current_measurement_init(PowerDistributionCurrentS
     status_ok_or_return(bts_7040_init(&s_bts7040_storages[i], &bts_7040_settings));
   }
 
+  for (uint8_t i = 0; i < NUM_POWER_DISTRIBUTION_CURRENTS; i++) {
+    status_ok_or_return(
+        moving_stats_ewma_init(&s_filters[i], POWER_DISTRIBUTION_CURRENT_FILTER_SHIFT));
+  }
+
+  // every switch starts at the normal interval and is read right away
+  PowerDistributionCurrentSchedule schedule = { .interval_ticks = s_ticks_per_interval,
+                                                .ticks_left = 0 };
+  s_storage.num_reads = 0;
+  s_storage.num_ticks = 0;
+  for (uint8_t i = 0; i < MAX_POWER_DISTRIBUTION_BTS7200_CHANNELS; i++) {
+    s_bts7200_schedules[i] = schedule;
+  }
+  for (uint8_t i = 0; i < MAX_POWER_DISTRIBUTION_BTS7040_CHANNELS; i++) {
+    s_bts7040_schedules[i] = schedule;
+  }
+
   // measure the currents immediately; the callback doesn't use the timer id it's passed
   prv_measure_currents(SOFT_TIMER_INVALID_TIMER, NULL);
 
@@ -1,7 +1,7 @@
 #include "current_measurement_config.h"
 #include "pin_defs.h"
 
-// Definitions of the hardware configs declared in the header
+// Definitions of the configs declared in the header
 
 #define POWER_DISTRIBUTION_I2C_PORT I2C_PORT_2
 
@@ -242,3 +242,10 @@ const PowerDistributionCurrentHardwareConfig REAR_POWER_DISTRIBUTION_CURRENT_HW_
           .mux_enable_pin = { .port = GPIO_PORT_A, .pin = 2 },  //
       },
 };
+
+const PowerDistributionCurrentSamplingConfig POWER_DISTRIBUTION_CURRENT_SAMPLING_CONFIG = {
+  .max_interval_us = POWER_DISTRIBUTION_CURRENT_MAX_INTERVAL_US,
+  .change_threshold_ma = POWER_DISTRIBUTION_CURRENT_CHANGE_THRESHOLD_MA,
+  .high_current_ma = POWER_DISTRIBUTION_CURRENT_HIGH_MA,
+  .high_current_interval_us = POWER_DISTRIBUTION_CURRENT_HIGH_INTERVAL_US,
+};
@@ -20,9 +20,8 @@
 #include "publish_data_config.h"
 #include "rear_strobe_blinker.h"
 
-#define CURRENT_MEASUREMENT_INTERVAL_US 500000  // 0.5s between current measurements
-#define SIGNAL_BLINK_INTERVAL_US 500000         // 0.5s between blinks of the signal lights
-#define STROBE_BLINK_INTERVAL_US 100000         // 0.1s between blinks of the strobe light
+#define SIGNAL_BLINK_INTERVAL_US 500000  // 0.5s between blinks of the signal lights
+#define STROBE_BLINK_INTERVAL_US 100000  // 0.1s between blinks of the strobe light
 #define NUM_SIGNAL_BLINKS_BETWEEN_SYNCS 10
 
 static CanStorage s_can_storage;
@@ -76,7 +75,7 @@ static void prv_init_can(bool is_front_power_distribution) {
 static void prv_current_measurement_data_ready_callback(void *context) {
   // called when current_measurement has new data: send it to publish_data for publishing
   PowerDistributionCurrentStorage *storage = power_distribution_current_measurement_get_storage();
-  power_distribution_publish_data_publish(storage->measurements);
+  power_distribution_publish_data_publish(storage->averages);
 }
 
 int main(void) {
@@ -110,7 +109,8 @@ int main(void) {
   PowerDistributionCurrentSettings current_measurement_settings = {
     .hw_config = is_front_power_distribution ? FRONT_POWER_DISTRIBUTION_CURRENT_HW_CONFIG
                                              : REAR_POWER_DISTRIBUTION_CURRENT_HW_CONFIG,
-    .interval_us = CURRENT_MEASUREMENT_INTERVAL_US,
+    .interval_us = POWER_DISTRIBUTION_CURRENT_INTERVAL_US,
+    .sampling = POWER_DISTRIBUTION_CURRENT_SAMPLING_CONFIG,
     .callback = &prv_current_measurement_data_ready_callback,
   };
   power_distribution_current_measurement_init(&current_measurement_settings);
@@ -1,7 +1,30 @@
 #include "publish_data.h"
 
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "soft_timer.h"
+
 static PowerDistributionPublishConfig s_config = { 0 };
 
+// What was last sent for each current, and when
+static uint16_t s_published_data[NUM_POWER_DISTRIBUTION_CURRENTS];
+static uint32_t s_published_time_us[NUM_POWER_DISTRIBUTION_CURRENTS];
+static bool s_published[NUM_POWER_DISTRIBUTION_CURRENTS];
+
+static bool prv_should_publish(PowerDistributionCurrent current_id, uint16_t current_data,
+                               uint32_t now_us) {
+  if (!s_published[current_id] || s_config.max_staleness_ms == 0) {
+    return true;
+  }
+  if (s_config.high_current_ma != 0 && current_data >= s_config.high_current_ma) {
+    return true;
+  }
+  uint32_t age_us = now_us - s_published_time_us[current_id];
+  return abs((int)current_data - (int)s_published_data[current_id]) > s_config.dead_band_ma ||
+         age_us >= s_config.max_staleness_ms * 1000;
+}
+
 StatusCode power_distribution_publish_data_init(PowerDistributionPublishConfig config) {
   // check that the transmitter and the currents aren't null
   if (!config.transmitter || !config.currents_to_publish) {
@@ -16,6 +39,7 @@ StatusCode power_distribution_publish_data_init(PowerDistributionPublishConfig c
   }
 
   s_config = config;
+  memset(s_published, 0, sizeof(s_published));
   return STATUS_CODE_OK;
 }
 
@@ -25,10 +49,19 @@ StatusCode power_distribution_publish_data_publish(
     return status_code(STATUS_CODE_UNINITIALIZED);
   }
 
-  // transmit each current from the config
+  // transmit each current from the config that changed or went stale
+  uint32_t now_us = soft_timer_get_current_time();
   for (uint16_t c = 0; c < s_config.num_currents_to_publish; c++) {
     PowerDistributionCurrent current_id = s_config.currents_to_publish[c];
-    status_ok_or_return(s_config.transmitter(current_id, current_measurements[current_id]));
+    uint16_t current_data = current_measurements[current_id];
+    if (!prv_should_publish(current_id, current_data, now_us)) {
+      continue;
+    }
+    status_ok_or_return(s_config.transmitter(current_id, current_data));
+
+    s_published_data[current_id] = current_data;
+    s_published_time_us[current_id] = now_us;
+    s_published[current_id] = true;
   }
 
   return STATUS_CODE_OK;
@@ -1,5 +1,6 @@
 #include "publish_data_config.h"
 #include "can_transmit.h"
+#include "current_measurement_config.h"
 
 static StatusCode prv_publish_front_current_measurement(PowerDistributionCurrent current_id,
                                                         uint16_t current_data) {
@@ -39,6 +40,9 @@ const PowerDistributionPublishConfig FRONT_POWER_DISTRIBUTION_PUBLISH_DATA_CONFI
           FRONT_POWER_DISTRIBUTION_CURRENT_SPARE_2,
       },
   .num_currents_to_publish = 22,
+  .dead_band_ma = POWER_DISTRIBUTION_PUBLISH_DEAD_BAND_MA,
+  .max_staleness_ms = POWER_DISTRIBUTION_PUBLISH_MAX_STALENESS_MS,
+  .high_current_ma = POWER_DISTRIBUTION_CURRENT_HIGH_MA,
 };
 
 const PowerDistributionPublishConfig REAR_POWER_DISTRIBUTION_PUBLISH_DATA_CONFIG = {
@@ -69,4 +73,7 @@ const PowerDistributionPublishConfig REAR_POWER_DISTRIBUTION_PUBLISH_DATA_CONFIG
           REAR_POWER_DISTRIBUTION_CURRENT_SPARE_10,
       },
   .num_currents_to_publish = 22,
+  .dead_band_ma = POWER_DISTRIBUTION_PUBLISH_DEAD_BAND_MA,
+  .max_staleness_ms = POWER_DISTRIBUTION_PUBLISH_MAX_STALENESS_MS,
+  .high_current_ma = POWER_DISTRIBUTION_CURRENT_HIGH_MA,
 };
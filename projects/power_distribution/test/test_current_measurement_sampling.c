@@ -0,0 +1,139 @@
+// Adaptive sampling against the x86 ADC's signal sources, which stand in for the load switches'
+// sense outputs through the mux.
+#include "adc.h"
+#include "adc_source.h"
+#include "current_measurement.h"
+#include "current_measurement_config.h"
+#include "delay.h"
+#include "gpio.h"
+#include "i2c.h"
+#include "interrupt.h"
+#include "log.h"
+#include "soft_timer.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_I2C_PORT I2C_PORT_2
+#define TEST_INTERVAL_US 4000
+#define TEST_HIGH_CURRENT_INTERVAL_US (TEST_INTERVAL_US / 2)
+#define TEST_MAX_INTERVAL_TICKS 8
+#define TEST_NUM_TICKS 40
+
+static int s_times_callback_called = 0;
+static AdcChannel s_sense_channel;
+
+static const PowerDistributionCurrentSamplingConfig s_sampling = {
+  .max_interval_us = TEST_MAX_INTERVAL_TICKS * TEST_INTERVAL_US,
+  .change_threshold_ma = POWER_DISTRIBUTION_CURRENT_CHANGE_THRESHOLD_MA,
+};
+
+static void prv_increment_callback(void *context) {
+  s_times_callback_called++;
+}
+
+static void prv_set_sense_source(AdcSourceType type, uint16_t offset, uint16_t amplitude) {
+  AdcSource source = { .type = type, .offset = offset, .amplitude = amplitude };
+  TEST_ASSERT_OK(adc_source_set(s_sense_channel, &source));
+}
+
+static uint32_t prv_num_switches(void) {
+  return FRONT_POWER_DISTRIBUTION_CURRENT_HW_CONFIG.num_bts7200_channels +
+         FRONT_POWER_DISTRIBUTION_CURRENT_HW_CONFIG.num_bts7040_channels;
+}
+
+static uint32_t prv_num_reads(void) {
+  return power_distribution_current_measurement_get_storage()->num_reads;
+}
+
+static uint32_t prv_num_ticks(void) {
+  return power_distribution_current_measurement_get_storage()->num_ticks;
+}
+
+// Runs for at least TEST_NUM_TICKS timer ticks. The tests compare against the tick count rather
+// than wall time, so they don't depend on the timer keeping up under load.
+static void prv_run(PowerDistributionCurrentSamplingConfig sampling) {
+  PowerDistributionCurrentSettings settings = {
+    .interval_us = TEST_INTERVAL_US,
+    .sampling = sampling,
+    .callback = &prv_increment_callback,
+    .hw_config = FRONT_POWER_DISTRIBUTION_CURRENT_HW_CONFIG,
+  };
+  TEST_ASSERT_OK(power_distribution_current_measurement_init(&settings));
+  while (prv_num_ticks() < TEST_NUM_TICKS) {
+    delay_us(TEST_INTERVAL_US);
+  }
+  TEST_ASSERT_OK(power_distribution_current_measurement_stop());
+}
+
+void setup_test(void) {
+  interrupt_init();
+  soft_timer_init();
+  gpio_init();
+  adc_init(ADC_MODE_SINGLE);
+
+  I2CSettings i2c_settings = {
+    .speed = I2C_SPEED_FAST,
+    .scl = { GPIO_PORT_B, 10 },
+    .sda = { GPIO_PORT_B, 11 },
+  };
+  i2c_init(TEST_I2C_PORT, &i2c_settings);
+
+  GpioAddress sense_pin = FRONT_POWER_DISTRIBUTION_CURRENT_HW_CONFIG.mux_address.mux_output_pin;
+  TEST_ASSERT_OK(adc_get_channel(sense_pin, &s_sense_channel));
+  prv_set_sense_source(ADC_SOURCE_CONSTANT, ADC_SOURCE_DEFAULT_RAW, 0);
+  s_times_callback_called = 0;
+}
+
+void teardown_test(void) {
+  prv_set_sense_source(ADC_SOURCE_CONSTANT, ADC_SOURCE_DEFAULT_RAW, 0);
+}
+
+// Without a sampling config, every switch is read every interval.
+void test_current_measurement_sampling_fixed(void) {
+  PowerDistributionCurrentSamplingConfig fixed = { 0 };
+  prv_run(fixed);
+  LOG_DEBUG("fixed: %d rounds, %d reads\n", s_times_callback_called, (int)prv_num_reads());
+  TEST_ASSERT_EQUAL(prv_num_ticks(), (uint32_t)s_times_callback_called);
+  TEST_ASSERT_EQUAL(prv_num_ticks() * prv_num_switches(), prv_num_reads());
+}
+
+// Steady currents back off to the maximum interval, while the averages are still updated and
+// the callback still runs every interval.
+void test_current_measurement_sampling_steady_backs_off(void) {
+  prv_run(s_sampling);
+  LOG_DEBUG("steady: %d rounds, %d reads\n", s_times_callback_called, (int)prv_num_reads());
+  TEST_ASSERT_EQUAL(prv_num_ticks(), (uint32_t)s_times_callback_called);
+  // 1, 2, 4, then every 8 intervals
+  TEST_ASSERT_TRUE(prv_num_reads() <=
+                   (prv_num_ticks() / TEST_MAX_INTERVAL_TICKS + 4) * prv_num_switches());
+}
+
+// Changing currents keep their switches at the normal interval.
+void test_current_measurement_sampling_changing_stays_at_interval(void) {
+  prv_set_sense_source(ADC_SOURCE_NOISE, ADC_SOURCE_DEFAULT_RAW, 1000);
+  PowerDistributionCurrentSamplingConfig sampling = s_sampling;
+  // the BTS7200s scale the noise down to a few mA
+  sampling.change_threshold_ma = 0;
+  sampling.high_current_interval_us = TEST_HIGH_CURRENT_INTERVAL_US;
+  prv_run(sampling);
+  LOG_DEBUG("changing: %d rounds, %d reads\n", s_times_callback_called, (int)prv_num_reads());
+  // the timer ticks at the high current interval, but without high currents the callback only
+  // runs every other tick
+  uint32_t ticks_per_interval = TEST_INTERVAL_US / TEST_HIGH_CURRENT_INTERVAL_US;
+  uint32_t expected_rounds = (prv_num_ticks() + ticks_per_interval - 1) / ticks_per_interval;
+  TEST_ASSERT_EQUAL(expected_rounds, (uint32_t)s_times_callback_called);
+  uint32_t expected_reads = expected_rounds * prv_num_switches();
+  TEST_ASSERT_UINT_WITHIN(expected_reads / 4, expected_reads, prv_num_reads());
+}
+
+// High currents are read at the high current interval, and the callback runs after every read so
+// they're published at that rate.
+void test_current_measurement_sampling_high_current_speeds_up(void) {
+  PowerDistributionCurrentSamplingConfig sampling = s_sampling;
+  sampling.high_current_ma = 1;
+  sampling.high_current_interval_us = TEST_HIGH_CURRENT_INTERVAL_US;
+  prv_run(sampling);
+  LOG_DEBUG("high: %d rounds, %d reads\n", s_times_callback_called, (int)prv_num_reads());
+  TEST_ASSERT_EQUAL(prv_num_ticks(), (uint32_t)s_times_callback_called);
+  TEST_ASSERT_EQUAL(prv_num_ticks() * prv_num_switches(), prv_num_reads());
+}
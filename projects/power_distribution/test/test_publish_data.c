@@ -1,5 +1,6 @@
 #include "can.h"
 #include "can_msg_defs.h"
+#include "delay.h"
 #include "interrupt.h"
 #include "log.h"
 #include "ms_test_helpers.h"
@@ -140,6 +141,86 @@ void test_power_distribution_publish_data_publish_multiple_currents(void) {
   }
 }
 
+#define TEST_DEAD_BAND_MA 10
+#define TEST_MAX_STALENESS_MS 20
+
+// Test that currents are only republished once they leave the dead band or go stale.
+void test_power_distribution_publish_data_dead_band_and_staleness(void) {
+  PowerDistributionPublishConfig config = {
+    .transmitter = &prv_single_current_callback,
+    .currents_to_publish = (PowerDistributionCurrent[]){ TEST_CURRENT_ID_1 },
+    .num_currents_to_publish = 1,
+    .dead_band_ma = TEST_DEAD_BAND_MA,
+    .max_staleness_ms = TEST_MAX_STALENESS_MS,
+  };
+  TEST_ASSERT_OK(power_distribution_publish_data_init(config));
+  s_times_single_current_callback_called = 0;
+
+  uint16_t test_current_measurements[NUM_POWER_DISTRIBUTION_CURRENTS] = {
+    [TEST_CURRENT_ID_1] = TEST_CURRENT_DATA_1,
+  };
+
+  // the first publish always goes out
+  TEST_ASSERT_OK(power_distribution_publish_data_publish(test_current_measurements));
+  TEST_ASSERT_EQUAL(1, s_times_single_current_callback_called);
+
+  // a change within the dead band is held back
+  test_current_measurements[TEST_CURRENT_ID_1] = TEST_CURRENT_DATA_1 + TEST_DEAD_BAND_MA;
+  TEST_ASSERT_OK(power_distribution_publish_data_publish(test_current_measurements));
+  TEST_ASSERT_EQUAL(1, s_times_single_current_callback_called);
+
+  // leaving the dead band around the last published value publishes
+  test_current_measurements[TEST_CURRENT_ID_1] = TEST_CURRENT_DATA_1 - TEST_DEAD_BAND_MA - 1;
+  TEST_ASSERT_OK(power_distribution_publish_data_publish(test_current_measurements));
+  TEST_ASSERT_EQUAL(2, s_times_single_current_callback_called);
+  TEST_ASSERT_EQUAL(TEST_CURRENT_DATA_1 - TEST_DEAD_BAND_MA - 1, s_single_received_current_data);
+
+  // a steady current is republished once it's stale
+  TEST_ASSERT_OK(power_distribution_publish_data_publish(test_current_measurements));
+  TEST_ASSERT_EQUAL(2, s_times_single_current_callback_called);
+  delay_ms(TEST_MAX_STALENESS_MS);
+  TEST_ASSERT_OK(power_distribution_publish_data_publish(test_current_measurements));
+  TEST_ASSERT_EQUAL(3, s_times_single_current_callback_called);
+
+  // reinitializing publishes everything again
+  TEST_ASSERT_OK(power_distribution_publish_data_init(config));
+  TEST_ASSERT_OK(power_distribution_publish_data_publish(test_current_measurements));
+  TEST_ASSERT_EQUAL(4, s_times_single_current_callback_called);
+}
+
+#define TEST_HIGH_CURRENT_MA 1000
+
+// Test that currents at or above the high current threshold skip the dead band.
+void test_power_distribution_publish_data_high_current_always_published(void) {
+  PowerDistributionPublishConfig config = {
+    .transmitter = &prv_single_current_callback,
+    .currents_to_publish = (PowerDistributionCurrent[]){ TEST_CURRENT_ID_1 },
+    .num_currents_to_publish = 1,
+    .dead_band_ma = TEST_DEAD_BAND_MA,
+    .max_staleness_ms = TEST_MAX_STALENESS_MS,
+    .high_current_ma = TEST_HIGH_CURRENT_MA,
+  };
+  TEST_ASSERT_OK(power_distribution_publish_data_init(config));
+  s_times_single_current_callback_called = 0;
+
+  uint16_t test_current_measurements[NUM_POWER_DISTRIBUTION_CURRENTS] = {
+    [TEST_CURRENT_ID_1] = TEST_HIGH_CURRENT_MA - 1,
+  };
+  TEST_ASSERT_OK(power_distribution_publish_data_publish(test_current_measurements));
+  TEST_ASSERT_EQUAL(1, s_times_single_current_callback_called);
+
+  // just below the threshold, a steady current is held back
+  TEST_ASSERT_OK(power_distribution_publish_data_publish(test_current_measurements));
+  TEST_ASSERT_EQUAL(1, s_times_single_current_callback_called);
+
+  // at the threshold, it goes out every time even within the dead band
+  test_current_measurements[TEST_CURRENT_ID_1] = TEST_HIGH_CURRENT_MA;
+  TEST_ASSERT_OK(power_distribution_publish_data_publish(test_current_measurements));
+  TEST_ASSERT_OK(power_distribution_publish_data_publish(test_current_measurements));
+  TEST_ASSERT_EQUAL(3, s_times_single_current_callback_called);
+  TEST_ASSERT_EQUAL(TEST_HIGH_CURRENT_MA, s_single_received_current_data);
+}
+
 // Test that invalid config gives an error.
 void test_power_distribution_publish_data_invalid_config_errors(void) {
   // null transmitter
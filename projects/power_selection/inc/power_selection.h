@@ -12,6 +12,8 @@
 #define DCDC_OFF 1 << 11
 #define AUX_STATUS 15 << 11
 
+#define AUX_TEMP_DIVIDER_OHMS 33000
+#define AUX_TEMP_FIXED_RESISTANCE_OHMS 10000
 #define temp_to_res(r) 33000.0 / (double)((r) / 1000.0) - 10000
 
 StatusCode aux_dcdc_monitor_init();
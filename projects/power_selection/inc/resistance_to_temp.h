@@ -1,3 +1,10 @@
 #pragma once
+#include <stdint.h>
+
+// Returned by resistance_to_temp_cc() for resistances below the table, i.e. too hot to read
+#define RESISTANCE_TO_TEMP_OUT_OF_RANGE INT32_MAX
+
+// Temperature in centi-celsius for a thermistor resistance in ohms, without any float math
+int32_t resistance_to_temp_cc(int32_t resistance_ohms);
 
 double resistance_to_temp(double resistance);
@@ -1,10 +1,12 @@
 #include "power_selection.h"
+#include <inttypes.h>
 #include "adc.h"
 #include "can.h"
 #include "can_transmit.h"
 #include "can_unpack.h"
 #include "event_queue.h"
 #include "exported_enums.h"
+#include "fixed_point.h"
 #include "gpio.h"
 #include "interrupt.h"
 #include "log.h"
@@ -41,21 +43,30 @@ static uint16_t s_aux_temp = 0;
 // [0] projects/power_selection/src/power_selection.c:42: AUX Temp Resistance Value: 3200.000000
 // [0] projects/power_selection/src/power_selection.c:43: AUX Temp Data in C: 53
 
-void smoke_test(uint16_t s_aux_volt, uint16_t s_aux_temp, double resistance, uint16_t s_aux_tempC) {
+void smoke_test(uint16_t s_aux_volt, uint16_t s_aux_temp, int32_t resistance,
+                uint16_t s_aux_tempC) {
   LOG_DEBUG("AUX Volatge Data: %d\n", s_aux_volt);
   LOG_DEBUG("AUX Temp Voltage Data: %d\n", s_aux_temp);
-  LOG_DEBUG("AUX Temp Resistance Value: %f\n", resistance);
+  LOG_DEBUG("AUX Temp Resistance Value: %" PRId32 "\n", resistance);
   LOG_DEBUG("AUX Temp Data in C: %d\n", s_aux_tempC);
 }
 
+// Integer version of temp_to_res(), so the status check runs without soft-float math
+static int32_t prv_temp_to_res_ohms(uint16_t reading) {
+  // A zero reading saturates, which reads as the coldest temperature
+  return fixed_scale(AUX_TEMP_DIVIDER_OHMS, 1000, reading) - AUX_TEMP_FIXED_RESISTANCE_OHMS;
+}
+
 uint16_t prv_status_checker() {
   adc_read_raw(aux_channels[AUX_ADC_VOLT_CHANNEL], &s_aux_volt);
   adc_read_raw(aux_channels[AUX_ADC_TEMP_CHANNEL], &s_aux_temp);
 
-  double resistance = temp_to_res(s_aux_temp);
+  int32_t resistance = prv_temp_to_res_ohms(s_aux_temp);
 
   uint32_t s_aux_temp_prev = s_aux_temp;
-  s_aux_temp = (uint16_t)resistance_to_temp(resistance);
+  int32_t temp_cc = resistance_to_temp_cc(resistance);
+  s_aux_temp =
+      (temp_cc == RESISTANCE_TO_TEMP_OUT_OF_RANGE) ? UINT16_MAX : (uint16_t)(temp_cc / 100);
 
   // calling the smoke test within this function as per the previous operation of power_selection.c
   smoke_test(s_aux_volt, s_aux_temp_prev, resistance, s_aux_temp);
@@ -1,60 +1,59 @@
+#include "resistance_to_temp.h"
+
 #include <stdint.h>
 
-#define NUM_OF_RESISTANCES 114
+#include "interp_table.h"
 
-typedef enum {
-  RES_TEMP_TABLE_TEMP = 0,
-  RES_TEMP_TABLE_RES,
-  NUM_RES_TEMP_TABLE_INDICES
-} ResTempTableIndex;
+#define NUM_OF_RESISTANCES 114
 
 // from
 // http://2avrmz2nom8p47cc28p2743e-wpengine.netdna-ssl.com/wp-content/uploads/2010/11/Thermistor_10K-2.pdf
-static const double s_resistance_temperature_in_C[NUM_OF_RESISTANCES][NUM_RES_TEMP_TABLE_INDICES] =
-    { { -39.44, 323839 }, { -38.33, 300974 }, { -37.22, 279880 }, { -36.11, 260410 },
-      { -35.00, 242427 }, { -33.89, 225809 }, { -32.78, 210443 }, { -31.67, 196227 },
-      { -30.56, 183068 }, { -29.44, 170775 }, { -28.33, 159488 }, { -27.22, 149024 },
-      { -26.11, 139316 }, { -25.00, 130306 }, { -23.89, 121939 }, { -22.78, 114165 },
-      { -21.67, 106939 }, { -20.56, 100218 }, { -19.44, 93909 },  { -18.33, 88090 },
-      { -17.22, 82670 },  { -16.11, 77620 },  { -15.00, 72911 },  { -13.89, 68518 },
-      { -12.78, 64419 },  { -11.67, 60592 },  { -10.56, 57017 },  { -9.44, 53647 },
-      { -8.33, 50526 },   { -7.22, 47606 },   { -6.11, 44874 },   { -5.00, 42317 },
-      { -3.89, 39921 },   { -2.78, 37676 },   { -1.67, 35573 },   { -0.56, 33599 },
-      { 0.56, 31732 },    { 1.67, 29996 },    { 2.78, 28365 },    { 3.89, 26834 },
-      { 5.00, 25395 },    { 6.11, 24042 },    { 7.22, 22770 },    { 8.33, 21573 },
-      { 9.44, 20446 },    { 10.56, 19376 },   { 11.67, 18378 },   { 12.78, 17437 },
-      { 13.89, 16550 },   { 15.00, 15714 },   { 16.11, 14925 },   { 17.22, 14180 },
-      { 18.33, 13478 },   { 19.44, 12814 },   { 20.56, 12182 },   { 21.67, 11590 },
-      { 22.78, 11030 },   { 23.89, 10501 },   { 25.00, 10000 },   { 26.11, 9526 },
-      { 27.22, 9078 },    { 28.33, 8653 },    { 29.44, 8251 },    { 30.56, 7866 },
-      { 31.67, 7505 },    { 32.78, 7163 },    { 33.89, 6838 },    { 35.00, 6530 },
-      { 36.11, 6238 },    { 37.22, 5960 },    { 38.33, 5697 },    { 39.44, 5447 },
-      { 40.56, 5207 },    { 41.67, 4981 },    { 42.78, 4766 },    { 43.89, 4561 },
-      { 45.00, 4367 },    { 46.11, 4182 },    { 47.22, 4006 },    { 48.33, 3838 },
-      { 49.44, 3679 },    { 50.56, 3525 },    { 51.67, 3380 },    { 52.78, 3242 },
-      { 53.89, 3111 },    { 55.00, 2985 },    { 56.11, 2865 },    { 57.22, 2751 },
-      { 58.33, 2642 },    { 59.44, 2538 },    { 60.56, 2438 },    { 61.67, 2343 },
-      { 62.78, 2252 },    { 63.89, 2165 },    { 65.00, 2082 },    { 66.11, 2003 },
-      { 67.22, 1927 },    { 68.33, 1855 },    { 69.44, 1785 },    { 70.56, 1718 },
-      { 71.67, 1655 },    { 72.78, 1594 },    { 73.89, 1536 },    { 75.00, 1480 },
-      { 76.11, 1427 },    { 77.22, 1375 },    { 78.33, 1326 },    { 79.44, 1279 },
-      { 80.56, 1234 },    { 81.67, 1190 },    { 82.78, 1149 },    { 83.89, 1109 },
-      { 85.00, 1070 },    { 86.11, 1034 } };
+// Resistance in ohms and the matching temperature in centi-celsius
+static const int32_t s_resistance_ohms[NUM_OF_RESISTANCES] = {
+  323839, 300974, 279880, 260410, 242427, 225809, 210443, 196227, 183068, 170775, 159488, 149024,
+  139316, 130306, 121939, 114165, 106939, 100218, 93909, 88090, 82670, 77620, 72911, 68518, 64419,
+  60592, 57017, 53647, 50526, 47606, 44874, 42317, 39921, 37676, 35573, 33599, 31732, 29996,
+  28365, 26834, 25395, 24042, 22770, 21573, 20446, 19376, 18378, 17437, 16550, 15714, 14925,
+  14180, 13478, 12814, 12182, 11590, 11030, 10501, 10000, 9526, 9078, 8653, 8251, 7866, 7505,
+  7163, 6838, 6530, 6238, 5960, 5697, 5447, 5207, 4981, 4766, 4561, 4367, 4182, 4006, 3838, 3679,
+  3525, 3380, 3242, 3111, 2985, 2865, 2751, 2642, 2538, 2438, 2343, 2252, 2165, 2082, 2003, 1927,
+  1855, 1785, 1718, 1655, 1594, 1536, 1480, 1427, 1375, 1326, 1279, 1234, 1190, 1149, 1109, 1070,
+  1034,
+};
 
-double resistance_to_temp(double resistance) {
-  // given resistance, use the table to find the temperature.
-  double temp = UINT16_MAX;
-
-  // checks the highest possible resistance value first
-  // then goes down until it finds the resistance that's lower than it
-  for (int i = 0; i < NUM_OF_RESISTANCES; ++i) {
-    // the higher the resistance, the lower the temperature
-    // so finds the first resistance value that is lower, else returns an impossible resistance
-    if (s_resistance_temperature_in_C[i][RES_TEMP_TABLE_RES] < resistance) {
-      temp = s_resistance_temperature_in_C[i][RES_TEMP_TABLE_TEMP];
-      break;
-    }
+static const int32_t s_temperature_cc[NUM_OF_RESISTANCES] = {
+  -3944, -3833, -3722, -3611, -3500, -3389, -3278, -3167, -3056, -2944, -2833, -2722, -2611,
+  -2500, -2389, -2278, -2167, -2056, -1944, -1833, -1722, -1611, -1500, -1389, -1278, -1167,
+  -1056, -944, -833, -722, -611, -500, -389, -278, -167, -56, 56, 167, 278, 389, 500, 611, 722,
+  833, 944, 1056, 1167, 1278, 1389, 1500, 1611, 1722, 1833, 1944, 2056, 2167, 2278, 2389, 2500,
+  2611, 2722, 2833, 2944, 3056, 3167, 3278, 3389, 3500, 3611, 3722, 3833, 3944, 4056, 4167, 4278,
+  4389, 4500, 4611, 4722, 4833, 4944, 5056, 5167, 5278, 5389, 5500, 5611, 5722, 5833, 5944, 6056,
+  6167, 6278, 6389, 6500, 6611, 6722, 6833, 6944, 7056, 7167, 7278, 7389, 7500, 7611, 7722, 7833,
+  7944, 8056, 8167, 8278, 8389, 8500, 8611,
+};
+
+static const InterpTable s_temperature_table = {
+  .x = s_resistance_ohms,
+  .y = s_temperature_cc,
+  .num_points = NUM_OF_RESISTANCES,
+};
+
+int32_t resistance_to_temp_cc(int32_t resistance_ohms) {
+  // the higher the resistance, the lower the temperature, so anything colder than the table
+  // reads as its coldest temperature and anything hotter as an impossible one
+  if (resistance_ohms >= s_resistance_ohms[0]) {
+    return s_temperature_cc[0];
+  } else if (resistance_ohms <= s_resistance_ohms[NUM_OF_RESISTANCES - 1]) {
+    return RESISTANCE_TO_TEMP_OUT_OF_RANGE;
   }
 
-  return temp;
+  int32_t temp_cc = 0;
+  interp_table_lookup(&s_temperature_table, resistance_ohms, &temp_cc);
+  return temp_cc;
+}
+
+double resistance_to_temp(double resistance) {
+  int32_t temp_cc = resistance_to_temp_cc((resistance >= INT32_MAX) ? INT32_MAX
+                                                                    : (int32_t)resistance);
+  return (temp_cc == RESISTANCE_TO_TEMP_OUT_OF_RANGE) ? UINT16_MAX : temp_cc / 100.0;
 }
@@ -188,3 +188,23 @@ void test_power_selection_rx(void) {
   supposed_to_fail = false;
   CAN_TRANSMIT_POWER_ON_MAIN_SEQUENCE(&ack_req, EE_POWER_MAIN_SEQUENCE_CONFIRM_AUX_STATUS);
 }
+
+// Centi-celsius rounded to the nearest integer, since Unity doesn't have doubles enabled
+static int32_t prv_temp_cc(double resistance) {
+  double temp = resistance_to_temp(resistance) * 100;
+  return (int32_t)(temp + ((temp < 0) ? -0.5 : 0.5));
+}
+
+// Table points convert exactly and readings between them land between their temperatures
+void test_power_selection_resistance_to_temp(void) {
+  TEST_ASSERT_EQUAL(2500, prv_temp_cc(10000));
+  TEST_ASSERT_EQUAL(-56, prv_temp_cc(33599));
+  TEST_ASSERT_EQUAL(8500, prv_temp_cc(1070));
+
+  int32_t temp = prv_temp_cc((10000 + 10501) / 2.0);
+  TEST_ASSERT_TRUE(temp > 2389 && temp < 2500);
+
+  // Colder than the table reads as its coldest temperature, hotter as an impossible one
+  TEST_ASSERT_EQUAL(-3944, prv_temp_cc(400000));
+  TEST_ASSERT_EQUAL(UINT16_MAX, (uint16_t)resistance_to_temp(1000));
+}
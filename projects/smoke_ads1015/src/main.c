@@ -4,6 +4,7 @@
 // Configurable items: wait time, I2C port, channels to be tested and conversion enable
 #include "ads1015.h"
 #include "gpio.h"
+#include "gpio_it.h"
 #include "i2c.h"
 #include "interrupt.h"
 #include "log.h"
@@ -50,6 +51,7 @@ static void prv_read_and_log(SoftTimerId timer_id, void *context) {
 int main(void) {
   gpio_init();
   interrupt_init();
+  gpio_it_init();
   soft_timer_init();
   I2CSettings i2c_settings = {
     .speed = I2C_SPEED_FAST,                    //
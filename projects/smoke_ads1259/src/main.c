@@ -28,13 +28,13 @@ static void prv_rx_error_handler_cb(Ads1259StatusCode code, void *context) {
 }
 
 static void prv_periodic_read(SoftTimerId id, void *context) {
-  double *queue = context;
+  int32_t *queue = context;
   if (s_index < READING_QUEUE_LENGTH) {
     LOG_DEBUG("=========READING # %i========= vref mv: %d\n", s_count++,
-              (int)(EXTERNAL_VREF_V * 1000));
+              EXTERNAL_VREF_UV / 1000);
     ads1259_get_conversion_data(&s_storage);
-    queue[s_index] = s_storage.reading;
-    LOG_DEBUG("%d mV\n", (uint16_t)(s_storage.reading * 1000));
+    queue[s_index] = s_storage.reading_uv;
+    LOG_DEBUG("%d mV\n", (int)(s_storage.reading_uv / 1000));
     s_index++;
     soft_timer_start_millis(CONVERSION_TIME_MS, prv_periodic_read, queue, NULL);
   } else {
@@ -65,7 +65,7 @@ int main() {
   ads1259_init(&s_storage, &settings);
 
   s_index = 0;
-  double reading_queue[READING_QUEUE_LENGTH];
+  int32_t reading_queue[READING_QUEUE_LENGTH];
 
   soft_timer_start_millis(CONVERSION_TIME_MS, prv_periodic_read, reading_queue, NULL);
 
@@ -69,6 +69,10 @@ StatusCode data_store_init(void);
 // Overwrites the value of the data point with |value|.
 StatusCode data_store_set(DataPoint data_point, uint32_t value);
 
+// Marks the data point as not set, e.g. when its source missed a sense cycle deadline, so that
+// consumers don't act on a stale value.
+StatusCode data_store_mark_stale(DataPoint data_point);
+
 // Call this when you're done a session of calling |data_store_set| and you want data consumers
 // to be notified. Raises a DATA_READY_EVENT. Every data point should have been overwritten from
 // its initial garbage when this is called.
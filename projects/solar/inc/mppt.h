@@ -9,6 +9,25 @@
 #include "spi.h"
 #include "status.h"
 
+// Registers read by |mppt_read_all|, used to index |MpptReadings.valid|.
+typedef enum {
+  MPPT_READING_CURRENT = 0,
+  MPPT_READING_VOLTAGE_IN,
+  MPPT_READING_PWM,
+  MPPT_READING_STATUS,
+  NUM_MPPT_READINGS,
+} MpptReading;
+
+// Everything read from one SPV1020 in a single mux session. Units are as in the single reads below.
+typedef struct {
+  uint16_t current;
+  uint16_t vin;
+  uint16_t pwm;
+  uint8_t status;
+  // Bit n is set if reading n (an |MpptReading|) was read successfully.
+  uint8_t valid;
+} MpptReadings;
+
 // needs to initialized first in order to use mppt
 StatusCode mppt_init();
 
@@ -42,3 +61,14 @@ StatusCode mppt_read_pwm(SpiPort port, uint16_t *pwm, Mppt pin);
 // |spv1020_is_overcurrent|, |spv_1020_is_overvoltage|, and |spv1020_is_overtemperature| to check
 // each flag in the status byte.
 StatusCode mppt_read_status(SpiPort port, uint8_t *status, Mppt pin);
+
+// Selects the SPV1020 once, reads current, input voltage, PWM and status, then deselects it.
+// This toggles the mux select pins twice instead of the eight times needed by the single reads.
+// All reads are attempted even if one fails; the first failure is returned and |readings->valid|
+// indicates which readings can be used.
+StatusCode mppt_read_all(SpiPort port, Mppt pin, MpptReadings *readings);
+
+// Reads every SPV1020 from 0 to |mppt_count| - 1 in a single sweep, switching the mux straight from
+// one MPPT to the next and only deselecting at the end. |readings| must have |mppt_count| entries.
+// Returns the first failure, as with |mppt_read_all|.
+StatusCode mppt_read_sweep(SpiPort port, uint8_t mppt_count, MpptReadings *readings);
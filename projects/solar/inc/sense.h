@@ -3,8 +3,19 @@
 // Generic sense module.
 // Requires interrupts, soft timers, and the event queue to be initialized.
 
-// This module operates a "sense cycle": periodically, all registered sense callbacks will be run,
-// then |data_store_done| will be called to notify data consumers that new data is available.
+// This module operates a "sense cycle": periodically, all registered sense sources are started,
+// and once every source has completed (or missed its deadline), |data_store_done| is called to
+// notify data consumers that new data is available.
+
+// There are two kinds of sources:
+//  - Synchronous sources are registered with |sense_register|. Their callback reads data, calls
+//    |data_store_set|, and returns; they're complete as soon as the callback returns.
+//  - Asynchronous sources are registered with |sense_register_async|. Their start callback kicks
+//    off an acquisition and returns immediately; the source calls |sense_source_done| once its data
+//    is in the data store. If it hasn't done so within its deadline, its deadline callback is run
+//    so it can mark its data points stale and the cycle is published without it.
+// All asynchronous sources are started before any synchronous source is run, so the cycle latency
+// is bounded by the slowest asynchronous source rather than the sum of all of them.
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -12,25 +23,60 @@
 
 #define MAX_SENSE_CALLBACKS 32
 
+// Identifies a registered source. Sources are numbered in registration order.
+typedef uint8_t SenseSourceId;
+
 // Callback implementations should read data and call |data_store_set| with each data point.
 // Implementations should avoid blocking - if data isn't ready, log it, possibly raise a fault
 // event, and don't call |data_store_set|.
 typedef void (*SenseCallback)(void *context);
 
+// Start an asynchronous acquisition. Must not block; call |sense_source_done| with |source_id|
+// once the data has been set in the data store.
+typedef void (*SenseStartCallback)(SenseSourceId source_id, void *context);
+
+// Called from an interrupt context when an asynchronous source misses its deadline.
+typedef void (*SenseDeadlineCallback)(SenseSourceId source_id, void *context);
+
 typedef struct {
-  // Waiting period between sense cycles in microseconds.
+  // Waiting period between sense cycles in microseconds, measured from the start of each cycle.
   uint32_t sense_period_us;
 } SenseSettings;
 
+// Timing of the most recently published sense cycle.
+typedef struct {
+  // Time from the start of the cycle until it was published, in microseconds.
+  uint32_t cycle_latency_us;
+  // Time from the start of the cycle until each source completed, indexed by |SenseSourceId|.
+  // Sources that missed their deadline report their deadline.
+  uint32_t source_latency_us[MAX_SENSE_CALLBACKS];
+  // Bit n is set if source n missed its deadline.
+  uint32_t stale_sources;
+  uint8_t num_sources;
+} SenseCycleStats;
+
 // Initialize the module with the given settings.
 StatusCode sense_init(SenseSettings *settings);
 
-// Register a callback to be run on each sense cycle.
+// Register a synchronous callback to be run on each sense cycle.
 // This should only be called by modules implementing the callback (e.g. sense_voltage).
 StatusCode sense_register(SenseCallback callback, void *callback_context);
 
+// Register an asynchronous source with a deadline in microseconds from the start of each cycle.
+// |deadline_callback| may be NULL. |source_id| is set to the source's id if it isn't NULL.
+StatusCode sense_register_async(SenseStartCallback start_callback,
+                                SenseDeadlineCallback deadline_callback, void *callback_context,
+                                uint32_t deadline_us, SenseSourceId *source_id);
+
+// Mark an asynchronous source as complete for the current cycle. Calls outside of a cycle or after
+// the source's deadline are ignored.
+StatusCode sense_source_done(SenseSourceId source_id);
+
 // Start the sense cycle. The first round of sense callbacks will begin immediately.
 void sense_start(void);
 
 // Stop the sense cycle, return whether it was stopped.
 bool sense_stop(void);
+
+// Get the timing of the most recently published sense cycle.
+StatusCode sense_get_cycle_stats(SenseCycleStats *stats);
@@ -9,6 +9,9 @@
 
 #define MAX_SOLAR_MCP3427 16  // the theoretical maximum on a board
 
+// if no conversion arrives within this long after a sense cycle starts, the data point is stale
+#define SENSE_MCP3427_DEADLINE_US 200000
+
 // after this many MCP3427 faults in a row, we raise a fault event
 #define MAX_CONSECUTIVE_MCP3427_FAULTS 3
 
@@ -18,6 +21,9 @@ typedef struct SenseMcp3427AdcConfig {
   DataPoint data_point;
   // The factor to multiply raw MCP3427 ADC values by to get the needed units. Results are rounded.
   float scaling_factor;
+  // Every conversion is blended into an EWMA with weight 2^-filter_shift, and sense cycles report
+  // the EWMA. 0 reports the latest conversion unfiltered.
+  uint8_t filter_shift;
 } SenseMcp3427AdcConfig;
 
 typedef struct SenseMcp3427Settings {
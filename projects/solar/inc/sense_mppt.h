@@ -3,6 +3,7 @@
 // Implementation of sense for reading from the MPPTs. Also checks MPPT statuses for faults.
 // Requires the event queue, GPIO, SPI, mppt, sense, the data store, and the fault handler to be
 // initialized. SPI must be initialized in SPI_MODE_3.
+// All MPPTs are read in a single sweep by one sense callback, see |mppt_read_sweep|.
 
 #include "solar_boards.h"
 #include "spi.h"
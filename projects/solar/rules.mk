@@ -6,14 +6,19 @@
 # $(T)_SRC: $(T)_DIR/src{/$(PLATFORM)}/*.{c,s}
 
 # Specify the libraries you want to include
-$(T)_DEPS := ms-common ms-drivers
+$(T)_DEPS := ms-common ms-helper ms-drivers
 
 $(T)_test_mppt_MOCKS := mux_set
 
+ifneq (x86,$(PLATFORM))
+# Bus traffic is only counted on x86
+$(T)_EXCLUDE_TESTS := mppt_traffic
+endif
+
 $(T)_test_sense_MOCKS := data_store_done
-$(T)_test_sense_mcp3427_MOCKS := sense_register mcp3427_start fault_handler_raise_fault
-$(T)_test_sense_mppt_MOCKS := sense_register mppt_read_current mppt_read_voltage_in mppt_read_pwm \
-	mppt_read_status fault_handler_raise_fault
+$(T)_test_sense_mcp3427_MOCKS := sense_register_async sense_source_done mcp3427_start \
+	fault_handler_raise_fault
+$(T)_test_sense_mppt_MOCKS := sense_register mppt_read_sweep fault_handler_raise_fault
 $(T)_test_sense_temperature_MOCKS := sense_register adc_read_raw
 
 $(T)_test_fault_monitor_MOCKS := fault_handler_raise_fault
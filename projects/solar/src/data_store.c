@@ -22,6 +22,14 @@ StatusCode data_store_set(DataPoint data_point, uint32_t value) {
   return STATUS_CODE_OK;
 }
 
+StatusCode data_store_mark_stale(DataPoint data_point) {
+  if (data_point >= NUM_DATA_POINTS) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+  s_is_set[data_point] = false;
+  return STATUS_CODE_OK;
+}
+
 StatusCode data_store_done(void) {
   // the data ready event has no associated data
   return event_raise_priority(DATA_READY_EVENT_PRIORITY, DATA_READY_EVENT, 0);
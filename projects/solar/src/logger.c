@@ -5,6 +5,7 @@
 #include "data_store.h"
 #include "event_queue.h"
 #include "log.h"
+#include "sense.h"
 #include "solar_boards.h"
 #include "solar_events.h"
 #include "status.h"
@@ -89,6 +90,18 @@ static void prv_log_data(void) {
       }
     }
   }
+
+  SenseCycleStats stats;
+  if (status_ok(sense_get_cycle_stats(&stats))) {
+    uint32_t slowest_us = 0;
+    for (SenseSourceId source = 0; source < stats.num_sources; source++) {
+      slowest_us = MAX(slowest_us, stats.source_latency_us[source]);
+    }
+    LOG_DEBUG("Sense cycle latency: %lu us, slowest source %lu us, stale sources 0x%lx\n",
+              (long unsigned int)stats.cycle_latency_us,  // NOLINT(runtime/int)
+              (long unsigned int)slowest_us,              // NOLINT(runtime/int)
+              (long unsigned int)stats.stale_sources);    // NOLINT(runtime/int)
+  }
 }
 
 StatusCode logger_init(SolarMpptCount mppt_count) {
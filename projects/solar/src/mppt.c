@@ -60,3 +60,55 @@ StatusCode mppt_read_status(SpiPort port, uint8_t *status, Mppt pin) {
   status_ok_or_return(mux_set(&s_mux_address, DISCONNECTED_MUX_OUTPUT));
   return spv1020_code;
 }
+
+// Read every register of the currently selected SPV1020, returning the first failure.
+static StatusCode prv_read_selected(SpiPort port, MpptReadings *readings) {
+  // initializer evaluation order is unspecified, so issue the commands one at a time
+  StatusCode codes[NUM_MPPT_READINGS];
+  codes[MPPT_READING_CURRENT] = spv1020_read_current(port, &readings->current);
+  codes[MPPT_READING_VOLTAGE_IN] = spv1020_read_voltage_in(port, &readings->vin);
+  codes[MPPT_READING_PWM] = spv1020_read_pwm(port, &readings->pwm);
+  codes[MPPT_READING_STATUS] = spv1020_read_status(port, &readings->status);
+
+  StatusCode first_failure = STATUS_CODE_OK;
+  readings->valid = 0;
+  for (MpptReading reading = 0; reading < NUM_MPPT_READINGS; reading++) {
+    if (status_ok(codes[reading])) {
+      readings->valid |= 1 << reading;
+    } else if (status_ok(first_failure)) {
+      first_failure = codes[reading];
+    }
+  }
+  return first_failure;
+}
+
+StatusCode mppt_read_all(SpiPort port, Mppt pin, MpptReadings *readings) {
+  if (readings == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+  status_ok_or_return(mux_set(&s_mux_address, pin));
+  StatusCode spv1020_code = prv_read_selected(port, readings);
+  status_ok_or_return(mux_set(&s_mux_address, DISCONNECTED_MUX_OUTPUT));
+  return spv1020_code;
+}
+
+StatusCode mppt_read_sweep(SpiPort port, uint8_t mppt_count, MpptReadings *readings) {
+  if (readings == NULL || mppt_count > MAX_SOLAR_BOARD_MPPTS) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  StatusCode first_failure = STATUS_CODE_OK;
+  for (Mppt mppt = 0; mppt < mppt_count; mppt++) {
+    StatusCode code = mux_set(&s_mux_address, mppt);
+    if (status_ok(code)) {
+      code = prv_read_selected(port, &readings[mppt]);
+    } else {
+      readings[mppt].valid = 0;
+    }
+    if (!status_ok(code) && status_ok(first_failure)) {
+      first_failure = code;
+    }
+  }
+  status_ok_or_return(mux_set(&s_mux_address, DISCONNECTED_MUX_OUTPUT));
+  return first_failure;
+}
@@ -1,33 +1,146 @@
 #include "sense.h"
 #include <stddef.h>
+#include <string.h>
+#include "critical_section.h"
 #include "data_store.h"
 #include "log.h"
+#include "misc.h"
 #include "soft_timer.h"
 
-static SenseCallback s_callbacks[MAX_SENSE_CALLBACKS];
-static void *s_contexts[MAX_SENSE_CALLBACKS];
+typedef struct SenseSource {
+  SenseCallback callback;  // NULL for asynchronous sources
+  SenseStartCallback start_callback;
+  SenseDeadlineCallback deadline_callback;
+  void *context;
+  uint32_t deadline_us;
+} SenseSource;
+
+static SenseSource s_sources[MAX_SENSE_CALLBACKS];
 static uint8_t s_num_callbacks = 0;
 
 static uint32_t s_period_us;
 
-static SoftTimerId s_timer_id;
+static SoftTimerId s_timer_id = SOFT_TIMER_INVALID_TIMER;
+static SoftTimerId s_deadline_timer_id = SOFT_TIMER_INVALID_TIMER;
+static volatile bool s_running = false;
+
+// State of the cycle in progress: bit n of |s_pending_sources| is set while source n is running.
+static volatile uint32_t s_pending_sources;
+static uint32_t s_cycle_start_us;
+static SenseCycleStats s_cycle;       // being filled in by the cycle in progress
+static SenseCycleStats s_last_cycle;  // last published cycle
+
+static void prv_do_sense_cycle(SoftTimerId timer_id, void *context);
+
+static void prv_start_timer(uint32_t duration_us, SoftTimerCallback callback, SoftTimerId *id) {
+  StatusCode code =
+      soft_timer_start(MAX(duration_us, (uint32_t)SOFT_TIMER_MIN_TIME_US), callback, NULL, id);
+  if (!status_ok(code)) {
+    Status status = status_get();
+    LOG_CRITICAL("Sense cycle timer could not start! Code %d, %s:%s \"%s\"\n", code, status.source,
+                 status.caller, status.message);
+  }
+}
+
+// Must be called with interrupts disabled once no sources are pending.
+static void prv_publish_cycle(void) {
+  const uint32_t elapsed_us = soft_timer_get_current_time() - s_cycle_start_us;
+  s_cycle.cycle_latency_us = elapsed_us;
+  s_cycle.num_sources = s_num_callbacks;
+  s_last_cycle = s_cycle;
+
+  data_store_done();
+
+  // schedule the next cycle relative to the start of this one so slow sources don't drift it
+  uint32_t wait_us = (elapsed_us < s_period_us) ? s_period_us - elapsed_us : 0;
+  prv_start_timer(wait_us, prv_do_sense_cycle, &s_timer_id);
+}
+
+// Arm the deadline timer for the earliest deadline of any pending source.
+static void prv_arm_deadline_timer(void);
+
+static void prv_deadline_timeout(SoftTimerId timer_id, void *context) {
+  const bool disabled = critical_section_start();
+  s_deadline_timer_id = SOFT_TIMER_INVALID_TIMER;
+  if (!s_running || s_pending_sources == 0) {
+    critical_section_end(disabled);
+    return;
+  }
+
+  const uint32_t elapsed_us = soft_timer_get_current_time() - s_cycle_start_us;
+  for (SenseSourceId i = 0; i < s_num_callbacks; i++) {
+    SenseSource *source = &s_sources[i];
+    if ((s_pending_sources & (1u << i)) && elapsed_us >= source->deadline_us) {
+      s_pending_sources &= ~(1u << i);
+      s_cycle.source_latency_us[i] = source->deadline_us;
+      s_cycle.stale_sources |= 1u << i;
+      LOG_WARN("Sense source %d missed its %d us deadline\n", i, (int)source->deadline_us);
+      if (source->deadline_callback != NULL) {
+        source->deadline_callback(i, source->context);
+      }
+    }
+  }
+
+  if (s_pending_sources == 0) {
+    prv_publish_cycle();
+  } else {
+    prv_arm_deadline_timer();
+  }
+  critical_section_end(disabled);
+}
+
+static void prv_arm_deadline_timer(void) {
+  uint32_t earliest_us = UINT32_MAX;
+  for (SenseSourceId i = 0; i < s_num_callbacks; i++) {
+    if (s_pending_sources & (1u << i)) {
+      earliest_us = MIN(earliest_us, s_sources[i].deadline_us);
+    }
+  }
+  const uint32_t elapsed_us = soft_timer_get_current_time() - s_cycle_start_us;
+  uint32_t wait_us = (elapsed_us < earliest_us) ? earliest_us - elapsed_us : 0;
+  prv_start_timer(wait_us, prv_deadline_timeout, &s_deadline_timer_id);
+}
 
 static void prv_do_sense_cycle(SoftTimerId timer_id, void *context) {
-  // call each callback in order
-  for (uint8_t i = 0; i < s_num_callbacks; i++) {
-    SenseCallback callback = s_callbacks[i];
+  const bool disabled = critical_section_start();
+  s_timer_id = SOFT_TIMER_INVALID_TIMER;
+  s_running = true;
+  s_cycle_start_us = soft_timer_get_current_time();
+  memset(&s_cycle, 0, sizeof(s_cycle));
+
+  // kick off every asynchronous source first so they run while we do the synchronous ones
+  uint32_t async_sources = 0;
+  for (SenseSourceId i = 0; i < s_num_callbacks; i++) {
+    if (s_sources[i].start_callback != NULL) {
+      async_sources |= 1u << i;
+    }
+  }
+  s_pending_sources = async_sources;
+  critical_section_end(disabled);
+
+  for (SenseSourceId i = 0; i < s_num_callbacks; i++) {
+    if (async_sources & (1u << i)) {
+      s_sources[i].start_callback(i, s_sources[i].context);
+    }
+  }
+
+  for (SenseSourceId i = 0; i < s_num_callbacks; i++) {
+    SenseCallback callback = s_sources[i].callback;
     if (callback) {
-      callback(s_contexts[i]);
+      callback(s_sources[i].context);
+      s_cycle.source_latency_us[i] = soft_timer_get_current_time() - s_cycle_start_us;
     }
   }
-  data_store_done();
 
-  StatusCode code = soft_timer_start(s_period_us, prv_do_sense_cycle, NULL, &s_timer_id);
-  if (!status_ok(code)) {
-    Status status = status_get();
-    LOG_CRITICAL("Sense cycle could not restart! Code %d, %s:%s \"%s\"\n", code, status.source,
-                 status.caller, status.message);
+  const bool disabled_end = critical_section_start();
+  if (s_running) {
+    if (s_pending_sources == 0) {
+      prv_publish_cycle();
+    } else {
+      prv_arm_deadline_timer();
+    }
   }
+  critical_section_end(disabled_end);
 }
 
 StatusCode sense_init(SenseSettings *settings) {
@@ -36,6 +149,11 @@ StatusCode sense_init(SenseSettings *settings) {
   }
   s_period_us = settings->sense_period_us;
   s_num_callbacks = 0;  // reset callback stack upon reinitialization for ease of testing
+  s_running = false;
+  s_pending_sources = 0;
+  s_timer_id = SOFT_TIMER_INVALID_TIMER;
+  s_deadline_timer_id = SOFT_TIMER_INVALID_TIMER;
+  memset(&s_last_cycle, 0, sizeof(s_last_cycle));
   return STATUS_CODE_OK;
 }
 
@@ -46,18 +164,85 @@ StatusCode sense_register(SenseCallback callback, void *callback_context) {
   if (s_num_callbacks >= MAX_SENSE_CALLBACKS) {
     return STATUS_CODE_RESOURCE_EXHAUSTED;
   }
-  s_callbacks[s_num_callbacks] = callback;
-  s_contexts[s_num_callbacks] = callback_context;
+  s_sources[s_num_callbacks] = (SenseSource){
+    .callback = callback,
+    .context = callback_context,
+  };
   s_num_callbacks++;
   return STATUS_CODE_OK;
 }
 
+StatusCode sense_register_async(SenseStartCallback start_callback,
+                                SenseDeadlineCallback deadline_callback, void *callback_context,
+                                uint32_t deadline_us, SenseSourceId *source_id) {
+  if (start_callback == NULL) {
+    return STATUS_CODE_INVALID_ARGS;
+  }
+  if (s_num_callbacks >= MAX_SENSE_CALLBACKS) {
+    return STATUS_CODE_RESOURCE_EXHAUSTED;
+  }
+  s_sources[s_num_callbacks] = (SenseSource){
+    .start_callback = start_callback,
+    .deadline_callback = deadline_callback,
+    .context = callback_context,
+    .deadline_us = deadline_us,
+  };
+  if (source_id != NULL) {
+    *source_id = s_num_callbacks;
+  }
+  s_num_callbacks++;
+  return STATUS_CODE_OK;
+}
+
+StatusCode sense_source_done(SenseSourceId source_id) {
+  if (source_id >= s_num_callbacks) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+
+  const bool disabled = critical_section_start();
+  if (s_running && (s_pending_sources & (1u << source_id))) {
+    s_pending_sources &= ~(1u << source_id);
+    s_cycle.source_latency_us[source_id] = soft_timer_get_current_time() - s_cycle_start_us;
+    // the synchronous sources are still running if the deadline timer isn't armed yet
+    if (s_pending_sources == 0 && s_deadline_timer_id != SOFT_TIMER_INVALID_TIMER) {
+      soft_timer_cancel(s_deadline_timer_id);
+      s_deadline_timer_id = SOFT_TIMER_INVALID_TIMER;
+      prv_publish_cycle();
+    }
+  }
+  critical_section_end(disabled);
+  return STATUS_CODE_OK;
+}
+
 void sense_start(void) {
   // immediately perform a sense round
   // the timer id and context are never used in |prv_do_sense_cycle|
-  prv_do_sense_cycle(0, NULL);
+  prv_do_sense_cycle(SOFT_TIMER_INVALID_TIMER, NULL);
 }
 
 bool sense_stop(void) {
-  return soft_timer_cancel(s_timer_id);
+  const bool disabled = critical_section_start();
+  const bool was_running = s_running;
+  s_running = false;
+  s_pending_sources = 0;
+  if (s_timer_id != SOFT_TIMER_INVALID_TIMER) {
+    soft_timer_cancel(s_timer_id);
+    s_timer_id = SOFT_TIMER_INVALID_TIMER;
+  }
+  if (s_deadline_timer_id != SOFT_TIMER_INVALID_TIMER) {
+    soft_timer_cancel(s_deadline_timer_id);
+    s_deadline_timer_id = SOFT_TIMER_INVALID_TIMER;
+  }
+  critical_section_end(disabled);
+  return was_running;
+}
+
+StatusCode sense_get_cycle_stats(SenseCycleStats *stats) {
+  if (stats == NULL) {
+    return status_code(STATUS_CODE_INVALID_ARGS);
+  }
+  const bool disabled = critical_section_start();
+  *stats = s_last_cycle;
+  critical_section_end(disabled);
+  return STATUS_CODE_OK;
 }
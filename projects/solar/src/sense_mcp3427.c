@@ -3,15 +3,19 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "critical_section.h"
 #include "data_store.h"
 #include "exported_enums.h"
 #include "fault_handler.h"
 #include "log.h"
 #include "mcp3427_adc.h"
+#include "moving_stats.h"
 #include "sense.h"
 
-// We register one sense callback per MCP3427 to take advantage of the sense loop, and so that the
-// entire MCP3427 sense operation doesn't stop if there is one fault in the sense cycle.
+// We register one asynchronous sense source per MCP3427 to take advantage of the sense loop, and so
+// that the entire MCP3427 sense operation doesn't stop if there is one fault in the sense cycle.
+// Each cycle consumes the first conversion that arrives after the previous cycle started; if none
+// arrives within the deadline, the data point is marked stale for that cycle.
 
 // we only use one channel on the MCP3427
 #define SENSE_MCP3427_CHANNEL MCP3427_CHANNEL_1
@@ -21,20 +25,44 @@ typedef struct SenseMcp3427Data {
   Mcp3427Storage mcp3427_storage;
   DataPoint mcp3427_data_point;
   float scaling_factor;
+  MovingStatsEwma filter;
 
   int16_t value;
-  bool has_value;
+  bool has_value;  // a conversion arrived that hasn't been consumed by a sense cycle
+  bool waiting;    // the current sense cycle is waiting on a conversion
+  SenseSourceId source_id;
   uint8_t consecutive_faults;
 } SenseMcp3427Data;
 
 static SenseMcp3427Data s_mcp3427_data[MAX_SOLAR_MCP3427];
 static uint8_t s_num_mcp3427s;
 
+static void prv_store_value(SenseMcp3427Data *data) {
+  DataPoint data_point = data->mcp3427_data_point;
+  // Multiplying the int16 ADC value by the float scaling factor gives a float which we truncate
+  // and convert to an int32, which we then convert to a uint32 for the data store. Phew!
+  int32_t scaled = (int32_t)(data->scaling_factor * data->value);
+  StatusCode status = data_store_set(data_point, (uint32_t)scaled);
+  if (!status_ok(status)) {
+    LOG_WARN("sense_mcp3427 could not data_store_set with data point %d\n", data_point);
+  }
+  data->has_value = false;
+  data->waiting = false;
+  sense_source_done(data->source_id);
+}
+
 static void prv_mcp3427_callback(int16_t value_ch1, int16_t value_ch2, void *context) {
   SenseMcp3427Data *data = context;
-  data->value = (SENSE_MCP3427_CHANNEL == MCP3427_CHANNEL_1) ? value_ch1 : value_ch2;
-  data->has_value = true;
+  int16_t raw_value = (SENSE_MCP3427_CHANNEL == MCP3427_CHANNEL_1) ? value_ch1 : value_ch2;
   data->consecutive_faults = 0;
+  // the sense cycle starts us from an interrupt on some platforms
+  const bool disabled = critical_section_start();
+  data->value = (int16_t)moving_stats_ewma_push(&data->filter, raw_value);
+  data->has_value = true;
+  if (data->waiting) {
+    prv_store_value(data);
+  }
+  critical_section_end(disabled);
 }
 
 static void prv_mcp3427_fault_callback(void *context) {
@@ -50,20 +78,21 @@ static void prv_mcp3427_fault_callback(void *context) {
   }
 }
 
-static void prv_sense_callback(void *context) {
+static void prv_sense_start_callback(SenseSourceId source_id, void *context) {
   SenseMcp3427Data *data = context;
   if (data->has_value) {
-    DataPoint data_point = data->mcp3427_data_point;
-    // Multiplying the int16 ADC value by the float scaling factor gives a float which we truncate
-    // and convert to an int32, which we then convert to a uint32 for the data store. Phew!
-    int32_t scaled = (int32_t)(data->scaling_factor * data->value);
-    StatusCode status = data_store_set(data_point, (uint32_t)scaled);
-    if (!status_ok(status)) {
-      LOG_WARN("sense_mcp3427 could not data_store_set with data point %d\n", data_point);
-    }
+    prv_store_value(data);
+  } else {
+    data->waiting = true;
   }
 }
 
+static void prv_sense_deadline_callback(SenseSourceId source_id, void *context) {
+  SenseMcp3427Data *data = context;
+  data->waiting = false;
+  data_store_mark_stale(data->mcp3427_data_point);
+}
+
 StatusCode sense_mcp3427_init(SenseMcp3427Settings *settings) {
   if (settings == NULL || settings->num_mcp3427s > MAX_SOLAR_MCP3427) {
     return status_code(STATUS_CODE_INVALID_ARGS);
@@ -74,16 +103,20 @@ StatusCode sense_mcp3427_init(SenseMcp3427Settings *settings) {
   for (uint8_t i = 0; i < s_num_mcp3427s; i++) {
     SenseMcp3427Data *data = &s_mcp3427_data[i];
     data->has_value = false;
+    data->waiting = false;
     data->consecutive_faults = 0;
     data->mcp3427_data_point = settings->mcp3427s[i].data_point;
     data->scaling_factor = settings->mcp3427s[i].scaling_factor;
+    status_ok_or_return(moving_stats_ewma_init(&data->filter, settings->mcp3427s[i].filter_shift));
     status_ok_or_return(
         mcp3427_init(&data->mcp3427_storage, &settings->mcp3427s[i].mcp3427_settings));
     status_ok_or_return(
         mcp3427_register_callback(&data->mcp3427_storage, prv_mcp3427_callback, data));
     status_ok_or_return(
         mcp3427_register_fault_callback(&data->mcp3427_storage, prv_mcp3427_fault_callback, data));
-    status_ok_or_return(sense_register(prv_sense_callback, data));
+    status_ok_or_return(sense_register_async(prv_sense_start_callback,
+                                             prv_sense_deadline_callback, data,
+                                             SENSE_MCP3427_DEADLINE_US, &data->source_id));
   }
 
   return STATUS_CODE_OK;
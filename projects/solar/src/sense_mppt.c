@@ -11,7 +11,7 @@
 #include "status.h"
 
 static SpiPort s_spi_port;
-static Mppt s_indices[MAX_SOLAR_BOARD_MPPTS];
+static uint8_t s_mppt_count;
 static float s_current_scaling_factor;
 static float s_vin_scaling_factor;
 
@@ -34,34 +34,39 @@ static uint32_t prv_scale_raw(uint16_t raw, float scaling_factor) {
 }
 
 static void prv_sense_cycle_callback(void *context) {
-  Mppt mppt = *(Mppt *)context;
+  // read every MPPT in one sweep so the mux is only switched once per MPPT
+  MpptReadings readings[MAX_SOLAR_BOARD_MPPTS] = { 0 };
+  mppt_read_sweep(s_spi_port, s_mppt_count, readings);
 
-  uint16_t current, vin, pwm;
-  uint8_t status;
+  for (Mppt mppt = 0; mppt < s_mppt_count; mppt++) {
+    MpptReadings *reading = &readings[mppt];
 
-  if (status_ok(mppt_read_current(s_spi_port, &current, mppt))) {
-    data_store_set(DATA_POINT_MPPT_CURRENT(mppt), prv_scale_raw(current, s_current_scaling_factor));
-  } else {
-    LOG_WARN("Error reading current from MPPT %d\n", mppt);
-  }
+    if (reading->valid & (1 << MPPT_READING_CURRENT)) {
+      data_store_set(DATA_POINT_MPPT_CURRENT(mppt),
+                     prv_scale_raw(reading->current, s_current_scaling_factor));
+    } else {
+      LOG_WARN("Error reading current from MPPT %d\n", mppt);
+    }
 
-  if (status_ok(mppt_read_voltage_in(s_spi_port, &vin, mppt))) {
-    data_store_set(DATA_POINT_MPPT_VOLTAGE(mppt), prv_scale_raw(vin, s_vin_scaling_factor));
-  } else {
-    LOG_WARN("Error reading voltage from MPPT %d\n", mppt);
-  }
+    if (reading->valid & (1 << MPPT_READING_VOLTAGE_IN)) {
+      data_store_set(DATA_POINT_MPPT_VOLTAGE(mppt),
+                     prv_scale_raw(reading->vin, s_vin_scaling_factor));
+    } else {
+      LOG_WARN("Error reading voltage from MPPT %d\n", mppt);
+    }
 
-  if (status_ok(mppt_read_pwm(s_spi_port, &pwm, mppt))) {
-    data_store_set(DATA_POINT_MPPT_PWM(mppt), pwm);
-  } else {
-    LOG_WARN("Error reading PWM from MPPT %d\n", mppt);
-  }
+    if (reading->valid & (1 << MPPT_READING_PWM)) {
+      data_store_set(DATA_POINT_MPPT_PWM(mppt), reading->pwm);
+    } else {
+      LOG_WARN("Error reading PWM from MPPT %d\n", mppt);
+    }
 
-  if (status_ok(mppt_read_status(s_spi_port, &status, mppt))) {
-    data_store_set(DATA_POINT_CR_BIT(mppt), spv1020_is_cr_bit_set(status));
-    prv_check_status_for_faults(mppt, status);
-  } else {
-    LOG_WARN("Error reading status from MPPT %d\n", mppt);
+    if (reading->valid & (1 << MPPT_READING_STATUS)) {
+      data_store_set(DATA_POINT_CR_BIT(mppt), spv1020_is_cr_bit_set(reading->status));
+      prv_check_status_for_faults(mppt, reading->status);
+    } else {
+      LOG_WARN("Error reading status from MPPT %d\n", mppt);
+    }
   }
 }
 
@@ -74,10 +79,7 @@ StatusCode sense_mppt_init(SenseMpptSettings *settings) {
   s_current_scaling_factor = settings->mppt_current_scaling_factor;
   s_vin_scaling_factor = settings->mppt_vin_scaling_factor;
 
-  for (Mppt mppt = 0; mppt < settings->mppt_count; mppt++) {
-    s_indices[mppt] = mppt;
-    status_ok_or_return(sense_register(prv_sense_cycle_callback, &s_indices[mppt]));
-  }
+  s_mppt_count = settings->mppt_count;
 
-  return STATUS_CODE_OK;
+  return sense_register(prv_sense_cycle_callback, NULL);
 }
@@ -27,6 +27,9 @@
 // (62.5uV/LSB)/(0.264uV/uA) = 236.74uA/LSB
 #define SOLAR_MCP3427_CURRENT_SENSE_SCALING_FACTOR 236.74f
 
+// Current sense conversions are averaged with weight 1/4 each to reject noise between sense cycles.
+#define SOLAR_MCP3427_CURRENT_SENSE_FILTER_SHIFT 2
+
 // Scaling factor to convert SPV1020 current values from SPI to microamps.
 // Must be calibrated.
 #define SOLAR_MPPT_CURRENT_SCALING_FACTOR 1.0f
@@ -149,6 +152,7 @@ static SenseMcp3427Settings s_sense_mcp3427_settings = {
           {
               .data_point = DATA_POINT_CURRENT,
               .scaling_factor = SOLAR_MCP3427_CURRENT_SENSE_SCALING_FACTOR,
+              .filter_shift = SOLAR_MCP3427_CURRENT_SENSE_FILTER_SHIFT,
               .mcp3427_settings =
                   {
                       .port = I2C_PORT_1,
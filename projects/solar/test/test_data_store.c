@@ -34,6 +34,17 @@ void test_data_store_get_is_set_basic(void) {
   TEST_ASSERT_EQUAL(true, is_set);
 }
 
+// Test that marking a data point stale clears its set status.
+void test_data_store_mark_stale(void) {
+  TEST_ASSERT_OK(data_store_init());
+  bool is_set;
+  TEST_ASSERT_OK(data_store_set(VALID_TEST_DATA_POINT, VALID_TEST_VALUE));
+  TEST_ASSERT_OK(data_store_mark_stale(VALID_TEST_DATA_POINT));
+  TEST_ASSERT_OK(data_store_get_is_set(VALID_TEST_DATA_POINT, &is_set));
+  TEST_ASSERT_EQUAL(false, is_set);
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, data_store_mark_stale(NUM_DATA_POINTS));
+}
+
 // Test that every data point works.
 void test_data_store_set_and_get_and_get_is_set_thorough(void) {
   TEST_ASSERT_OK(data_store_init());
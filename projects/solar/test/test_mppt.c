@@ -117,3 +117,47 @@ void test_read_status(void) {
     LOG_WARN("mppt status is nonzero: %x\r\n", status);
   }
 }
+
+// Test that a batched read selects the MPPT once and reads every register.
+void test_read_all(void) {
+  s_times_mux_set_called = 0;
+  MpptReadings readings = { 0 };
+  TEST_ASSERT_NOT_OK(mppt_read_all(TEST_SPI_PORT, (uint8_t)0b1001, &readings));
+  TEST_ASSERT_EQUAL(0, s_times_mux_set_called);
+  TEST_ASSERT_NOT_OK(mppt_read_all(TEST_SPI_PORT, (uint8_t)0b0001, NULL));
+
+  TEST_ASSERT_OK(mppt_read_all(TEST_SPI_PORT, (uint8_t)0b0001, &readings));
+  TEST_ASSERT_EQUAL(2, s_times_mux_set_called);
+  TEST_ASSERT_EQUAL((1 << NUM_MPPT_READINGS) - 1, readings.valid);
+
+  // same ranges as the single reads
+  TEST_ASSERT_BITS_LOW(0b1111110000000000, readings.current);
+  TEST_ASSERT_BITS_LOW(0b1111110000000000, readings.vin);
+  TEST_ASSERT_TRUE(readings.pwm >= 50 && readings.pwm <= 900);
+  TEST_ASSERT_BIT_LOW(7, readings.status);
+}
+
+// Test that a sweep switches the mux once per MPPT and deselects once, rather than twice per
+// register when reading each register individually. See test_mppt_traffic for the bus traffic.
+void test_read_sweep(void) {
+  MpptReadings readings[MAX_SOLAR_BOARD_MPPTS] = { 0 };
+  TEST_ASSERT_NOT_OK(mppt_read_sweep(TEST_SPI_PORT, MAX_SOLAR_BOARD_MPPTS + 1, readings));
+  TEST_ASSERT_NOT_OK(mppt_read_sweep(TEST_SPI_PORT, MAX_SOLAR_BOARD_MPPTS, NULL));
+
+  s_times_mux_set_called = 0;
+  TEST_ASSERT_OK(mppt_read_sweep(TEST_SPI_PORT, MAX_SOLAR_BOARD_MPPTS, readings));
+  TEST_ASSERT_EQUAL(MAX_SOLAR_BOARD_MPPTS + 1, s_times_mux_set_called);
+  for (Mppt mppt = 0; mppt < MAX_SOLAR_BOARD_MPPTS; mppt++) {
+    TEST_ASSERT_EQUAL((1 << NUM_MPPT_READINGS) - 1, readings[mppt].valid);
+  }
+
+  // the same data read one register at a time
+  s_times_mux_set_called = 0;
+  for (Mppt mppt = 0; mppt < MAX_SOLAR_BOARD_MPPTS; mppt++) {
+    TEST_ASSERT_OK(mppt_read_current(TEST_SPI_PORT, &readings[mppt].current, mppt));
+    TEST_ASSERT_OK(mppt_read_voltage_in(TEST_SPI_PORT, &readings[mppt].vin, mppt));
+    TEST_ASSERT_OK(mppt_read_pwm(TEST_SPI_PORT, &readings[mppt].pwm, mppt));
+    TEST_ASSERT_OK(mppt_read_status(TEST_SPI_PORT, &readings[mppt].status, mppt));
+  }
+  TEST_ASSERT_EQUAL(2 * NUM_MPPT_READINGS * MAX_SOLAR_BOARD_MPPTS, s_times_mux_set_called);
+}
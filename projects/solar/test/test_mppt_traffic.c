@@ -0,0 +1,95 @@
+// Measures the bus traffic of MPPT reads through the real mux driver. Output writes and SPI
+// transactions are only counted on x86, so this is excluded on STM32.
+#include "hal_test_helpers.h"
+#include "log.h"
+#include "mppt.h"
+#include "test_helpers.h"
+#include "unity.h"
+
+#define TEST_SPI_PORT SPI_PORT_2
+
+// number of mux select pins written per mux_set
+#define TEST_MUX_BIT_WIDTH 3
+
+static uint32_t s_writes_before;
+static uint32_t s_transactions_before;
+
+static void prv_start_counting(void) {
+  s_writes_before = _test_gpio_get_num_writes();
+  s_transactions_before = _test_spi_get_num_transactions();
+}
+
+static uint32_t prv_writes(void) {
+  return _test_gpio_get_num_writes() - s_writes_before;
+}
+
+static uint32_t prv_transactions(void) {
+  return _test_spi_get_num_transactions() - s_transactions_before;
+}
+
+void setup_test(void) {
+  gpio_init();
+  SpiSettings spi_settings = { .baudrate = 60000,
+                               .mode = SPI_MODE_3,
+                               .mosi = { .port = GPIO_PORT_B, 15 },
+                               .miso = { .port = GPIO_PORT_B, 14 },
+                               .sclk = { .port = GPIO_PORT_B, 13 },
+                               .cs = { .port = GPIO_PORT_B, 12 } };
+  spi_init(TEST_SPI_PORT, &spi_settings);
+  TEST_ASSERT_OK(mppt_init());
+}
+
+void teardown_test(void) {}
+
+// A single read selects and deselects the MPPT around one SPI transaction.
+void test_mppt_traffic_single_read(void) {
+  uint16_t current = 0;
+  prv_start_counting();
+  TEST_ASSERT_OK(mppt_read_current(TEST_SPI_PORT, &current, 0));
+  TEST_ASSERT_EQUAL(2 * TEST_MUX_BIT_WIDTH, prv_writes());
+  TEST_ASSERT_EQUAL(1, prv_transactions());
+
+  // An out of range MPPT fails before anything is written
+  prv_start_counting();
+  TEST_ASSERT_NOT_OK(mppt_read_current(TEST_SPI_PORT, &current, 0b1001));
+  TEST_ASSERT_EQUAL(0, prv_writes());
+  TEST_ASSERT_EQUAL(0, prv_transactions());
+}
+
+// A batched read selects and deselects once, with one SPI transaction per register.
+void test_mppt_traffic_read_all(void) {
+  MpptReadings readings = { 0 };
+  prv_start_counting();
+  TEST_ASSERT_OK(mppt_read_all(TEST_SPI_PORT, 0, &readings));
+  TEST_ASSERT_EQUAL(2 * TEST_MUX_BIT_WIDTH, prv_writes());
+  TEST_ASSERT_EQUAL(NUM_MPPT_READINGS, prv_transactions());
+}
+
+// A sweep switches the mux once per MPPT and deselects once, while reading each register one at a
+// time switches it twice per register. Both issue the same SPV1020 commands.
+void test_mppt_traffic_sweep(void) {
+  MpptReadings readings[MAX_SOLAR_BOARD_MPPTS] = { 0 };
+  prv_start_counting();
+  TEST_ASSERT_OK(mppt_read_sweep(TEST_SPI_PORT, MAX_SOLAR_BOARD_MPPTS, readings));
+  uint32_t sweep_writes = prv_writes();
+  uint32_t sweep_transactions = prv_transactions();
+  TEST_ASSERT_EQUAL((MAX_SOLAR_BOARD_MPPTS + 1) * TEST_MUX_BIT_WIDTH, sweep_writes);
+  TEST_ASSERT_EQUAL(NUM_MPPT_READINGS * MAX_SOLAR_BOARD_MPPTS, sweep_transactions);
+
+  prv_start_counting();
+  for (Mppt mppt = 0; mppt < MAX_SOLAR_BOARD_MPPTS; mppt++) {
+    TEST_ASSERT_OK(mppt_read_current(TEST_SPI_PORT, &readings[mppt].current, mppt));
+    TEST_ASSERT_OK(mppt_read_voltage_in(TEST_SPI_PORT, &readings[mppt].vin, mppt));
+    TEST_ASSERT_OK(mppt_read_pwm(TEST_SPI_PORT, &readings[mppt].pwm, mppt));
+    TEST_ASSERT_OK(mppt_read_status(TEST_SPI_PORT, &readings[mppt].status, mppt));
+  }
+  uint32_t single_writes = prv_writes();
+  uint32_t single_transactions = prv_transactions();
+  TEST_ASSERT_EQUAL(2 * NUM_MPPT_READINGS * MAX_SOLAR_BOARD_MPPTS * TEST_MUX_BIT_WIDTH,
+                    single_writes);
+  TEST_ASSERT_EQUAL(sweep_transactions, single_transactions);
+
+  LOG_DEBUG("MPPT sweep: %d select pin writes, %d SPI transactions (single reads: %d, %d)\n",
+            (int)sweep_writes, (int)sweep_transactions, (int)single_writes,
+            (int)single_transactions);
+}
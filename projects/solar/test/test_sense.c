@@ -37,6 +37,27 @@ static void prv_callback_2(void *context) {
   s_callback_2_context = context;
 }
 
+static uint8_t s_times_start_called = 0;
+static uint8_t s_times_deadline_called = 0;
+static SenseSourceId s_started_source_id = MAX_SENSE_CALLBACKS;
+static SenseSourceId s_deadline_source_id = MAX_SENSE_CALLBACKS;
+
+static void prv_start_callback(SenseSourceId source_id, void *context) {
+  s_times_start_called++;
+  s_started_source_id = source_id;
+}
+
+// completes as soon as it's started, like a source that already has fresh data
+static void prv_start_callback_immediate(SenseSourceId source_id, void *context) {
+  s_times_start_called++;
+  sense_source_done(source_id);
+}
+
+static void prv_deadline_callback(SenseSourceId source_id, void *context) {
+  s_times_deadline_called++;
+  s_deadline_source_id = source_id;
+}
+
 void setup_test(void) {
   event_queue_init();
   interrupt_init();
@@ -46,6 +67,10 @@ void setup_test(void) {
   s_callback_context = NULL;
   s_times_callback_2_called = 0;
   s_callback_2_context = NULL;
+  s_times_start_called = 0;
+  s_times_deadline_called = 0;
+  s_started_source_id = MAX_SENSE_CALLBACKS;
+  s_deadline_source_id = MAX_SENSE_CALLBACKS;
 }
 void teardown_test(void) {}
 
@@ -170,3 +195,124 @@ void test_sense_stop_return_value(void) {
   TEST_ASSERT_EQUAL(true, sense_stop());
   TEST_ASSERT_EQUAL(false, sense_stop());
 }
+
+// Test that an asynchronous source holds the cycle open until it completes.
+void test_sense_async_source_completes(void) {
+  TEST_ASSERT_OK(sense_init(&test_settings));
+
+  uint8_t context;
+  SenseSourceId id;
+  TEST_ASSERT_OK(sense_register(prv_callback, &context));
+  TEST_ASSERT_OK(sense_register_async(prv_start_callback, prv_deadline_callback, &context,
+                                      TEST_SENSE_PERIOD_US / 2, &id));
+  TEST_ASSERT_EQUAL(1, id);
+
+  // both sources are started but the cycle isn't published until the async one is done
+  sense_start();
+  TEST_ASSERT_EQUAL(1, s_times_callback_called);
+  TEST_ASSERT_EQUAL(1, s_times_start_called);
+  TEST_ASSERT_EQUAL(id, s_started_source_id);
+  TEST_ASSERT_EQUAL(0, s_times_data_store_done_called);
+
+  delay_us(TEST_SENSE_PERIOD_US / 10);
+  TEST_ASSERT_EQUAL(0, s_times_data_store_done_called);
+  TEST_ASSERT_OK(sense_source_done(id));
+  TEST_ASSERT_EQUAL(1, s_times_data_store_done_called);
+
+  // completing twice has no effect
+  TEST_ASSERT_OK(sense_source_done(id));
+  TEST_ASSERT_EQUAL(1, s_times_data_store_done_called);
+  TEST_ASSERT_EQUAL(0, s_times_deadline_called);
+
+  SenseCycleStats stats;
+  TEST_ASSERT_OK(sense_get_cycle_stats(&stats));
+  TEST_ASSERT_EQUAL(2, stats.num_sources);
+  TEST_ASSERT_EQUAL(0, stats.stale_sources);
+  TEST_ASSERT_TRUE(stats.source_latency_us[id] >= TEST_SENSE_PERIOD_US / 10);
+  TEST_ASSERT_TRUE(stats.source_latency_us[id] < TEST_SENSE_PERIOD_US / 2);
+  TEST_ASSERT_TRUE(stats.cycle_latency_us >= stats.source_latency_us[id]);
+
+  // the next cycle is scheduled relative to the start of the last one
+  delay_us(TEST_SENSE_PERIOD_US - TEST_SENSE_PERIOD_US / 10 + 1000);
+  TEST_ASSERT_EQUAL(2, s_times_start_called);
+  TEST_ASSERT_EQUAL(1, s_times_data_store_done_called);
+  TEST_ASSERT_OK(sense_source_done(id));
+  TEST_ASSERT_EQUAL(2, s_times_data_store_done_called);
+
+  TEST_ASSERT_EQUAL(true, sense_stop());
+}
+
+// Test that a source completing from its start callback doesn't hold up the cycle.
+void test_sense_async_source_completes_immediately(void) {
+  TEST_ASSERT_OK(sense_init(&test_settings));
+  TEST_ASSERT_OK(sense_register_async(prv_start_callback_immediate, prv_deadline_callback, NULL,
+                                      TEST_SENSE_PERIOD_US / 2, NULL));
+  TEST_ASSERT_OK(sense_register(prv_callback, NULL));
+
+  sense_start();
+  TEST_ASSERT_EQUAL(1, s_times_start_called);
+  TEST_ASSERT_EQUAL(1, s_times_callback_called);
+  TEST_ASSERT_EQUAL(1, s_times_data_store_done_called);
+  TEST_ASSERT_EQUAL(true, sense_stop());
+}
+
+// Test that a source missing its deadline is reported stale and the cycle publishes without it.
+void test_sense_async_source_deadline(void) {
+  TEST_ASSERT_OK(sense_init(&test_settings));
+
+  SenseSourceId slow_id, fast_id;
+  TEST_ASSERT_OK(sense_register_async(prv_start_callback, prv_deadline_callback, NULL,
+                                      TEST_SENSE_PERIOD_US / 5, &slow_id));
+  TEST_ASSERT_OK(sense_register_async(prv_start_callback, NULL, NULL, TEST_SENSE_PERIOD_US / 10,
+                                      &fast_id));
+
+  sense_start();
+  TEST_ASSERT_EQUAL(2, s_times_start_called);
+  TEST_ASSERT_OK(sense_source_done(fast_id));
+  TEST_ASSERT_EQUAL(0, s_times_data_store_done_called);
+
+  // the slow source hasn't timed out yet after the fast one's deadline
+  delay_us(TEST_SENSE_PERIOD_US / 10 + 1000);
+  TEST_ASSERT_EQUAL(0, s_times_deadline_called);
+  TEST_ASSERT_EQUAL(0, s_times_data_store_done_called);
+
+  delay_us(TEST_SENSE_PERIOD_US / 10);
+  TEST_ASSERT_EQUAL(1, s_times_deadline_called);
+  TEST_ASSERT_EQUAL(slow_id, s_deadline_source_id);
+  TEST_ASSERT_EQUAL(1, s_times_data_store_done_called);
+
+  // a late completion is ignored
+  TEST_ASSERT_OK(sense_source_done(slow_id));
+  TEST_ASSERT_EQUAL(1, s_times_data_store_done_called);
+
+  SenseCycleStats stats;
+  TEST_ASSERT_OK(sense_get_cycle_stats(&stats));
+  TEST_ASSERT_EQUAL(1u << slow_id, stats.stale_sources);
+  TEST_ASSERT_EQUAL(TEST_SENSE_PERIOD_US / 5, stats.source_latency_us[slow_id]);
+  TEST_ASSERT_TRUE(stats.cycle_latency_us >= TEST_SENSE_PERIOD_US / 5);
+
+  TEST_ASSERT_EQUAL(true, sense_stop());
+}
+
+// Test that stopping while a cycle waits on a source prevents it from publishing.
+void test_sense_stop_while_waiting(void) {
+  TEST_ASSERT_OK(sense_init(&test_settings));
+  SenseSourceId id;
+  TEST_ASSERT_OK(sense_register_async(prv_start_callback, prv_deadline_callback, NULL,
+                                      TEST_SENSE_PERIOD_US / 5, &id));
+  sense_start();
+  TEST_ASSERT_EQUAL(true, sense_stop());
+  TEST_ASSERT_OK(sense_source_done(id));
+  delay_us(TEST_SENSE_PERIOD_US / 2);
+  TEST_ASSERT_EQUAL(0, s_times_deadline_called);
+  TEST_ASSERT_EQUAL(0, s_times_data_store_done_called);
+}
+
+// Test the argument checking of the asynchronous API.
+void test_sense_async_invalid_args(void) {
+  TEST_ASSERT_OK(sense_init(&test_settings));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS,
+                    sense_register_async(NULL, prv_deadline_callback, NULL, 0, NULL));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, sense_source_done(0));
+  TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, sense_get_cycle_stats(NULL));
+}
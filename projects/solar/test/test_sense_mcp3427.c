@@ -58,6 +58,7 @@ static void prv_get_max_mcp3427s_settings(SenseMcp3427Settings *settings) {
     settings->mcp3427s[i].mcp3427_settings = s_test_mcp3427_settings;
     settings->mcp3427s[i].data_point = prv_get_test_data_point(i);
     settings->mcp3427s[i].scaling_factor = 1.0f;
+    settings->mcp3427s[i].filter_shift = 0;
 
     // Generate a unique port/address pin combo for each MCP3427.
     // There are 2 I2C ports and 8 address pin combos (low & low is the same as float & float).
@@ -72,22 +73,36 @@ static void prv_get_max_mcp3427s_settings(SenseMcp3427Settings *settings) {
   settings->num_mcp3427s = MAX_SOLAR_MCP3427;
 }
 
-// these is updated when |sense_register| is called
-static SenseCallback s_sense_callbacks[MAX_SOLAR_MCP3427];
+// these is updated when |sense_register_async| is called
+static SenseStartCallback s_sense_callbacks[MAX_SOLAR_MCP3427];
+static SenseDeadlineCallback s_sense_deadline_callbacks[MAX_SOLAR_MCP3427];
 static void *s_sense_callback_contexts[MAX_SOLAR_MCP3427];
 static uint8_t s_num_sense_callbacks;
 
-StatusCode TEST_MOCK(sense_register)(SenseCallback callback, void *context) {
-  s_sense_callbacks[s_num_sense_callbacks] = callback;
+StatusCode TEST_MOCK(sense_register_async)(SenseStartCallback start_callback,
+                                           SenseDeadlineCallback deadline_callback, void *context,
+                                           uint32_t deadline_us, SenseSourceId *source_id) {
+  s_sense_callbacks[s_num_sense_callbacks] = start_callback;
+  s_sense_deadline_callbacks[s_num_sense_callbacks] = deadline_callback;
   s_sense_callback_contexts[s_num_sense_callbacks] = context;
 
   // we should never receive a null callback
   TEST_ASSERT_NOT_NULL(s_sense_callbacks[s_num_sense_callbacks]);
+  TEST_ASSERT_NOT_NULL(s_sense_deadline_callbacks[s_num_sense_callbacks]);
 
+  *source_id = s_num_sense_callbacks;
   s_num_sense_callbacks++;
   return STATUS_CODE_OK;
 }
 
+// bit n is set when source n completes
+static uint32_t s_sources_done;
+
+StatusCode TEST_MOCK(sense_source_done)(SenseSourceId source_id) {
+  s_sources_done |= 1u << source_id;
+  return STATUS_CODE_OK;
+}
+
 // these are updated when the mcp3427 mocked functions are called
 static Mcp3427Callback s_mcp3427_callbacks[MAX_SOLAR_MCP3427];
 static void *s_mcp3427_callback_contexts[MAX_SOLAR_MCP3427];
@@ -128,7 +143,7 @@ static void prv_test_value_transform(SenseMcp3427Settings *settings, int16_t in,
                                      uint32_t expected_out, char *msg) {
   for (uint8_t i = 0; i < settings->num_mcp3427s; i++) {
     s_mcp3427_callbacks[i](in, in, s_mcp3427_callback_contexts[i]);
-    s_sense_callbacks[i](s_sense_callback_contexts[i]);
+    s_sense_callbacks[i](i, s_sense_callback_contexts[i]);
   }
   uint32_t actual_out;
   for (uint8_t i = 0; i < settings->num_mcp3427s; i++) {
@@ -145,6 +160,7 @@ void setup_test(void) {
   // The dependencies on I2C and sense are mocked out, so we don't initialize them
 
   s_num_sense_callbacks = 0;
+  s_sources_done = 0;
   s_num_mcp3427_callbacks = 0;
   s_times_mcp3427_start_called = 0;
   s_num_faults_raised = 0;
@@ -181,7 +197,7 @@ void test_sense_mcp3427_normal_cycle_one_mcp3427(void) {
   TEST_ASSERT_EQUAL(false, is_set);
 
   // call the sense cycle callback, make sure |data_store_set| is called
-  s_sense_callbacks[0](s_sense_callback_contexts[0]);
+  s_sense_callbacks[0](0, s_sense_callback_contexts[0]);
   data_store_get_is_set(TEST_DATA_POINT, &is_set);
   TEST_ASSERT_EQUAL(true, is_set);
   data_store_get(TEST_DATA_POINT, &set_value);
@@ -193,7 +209,7 @@ void test_sense_mcp3427_normal_cycle_one_mcp3427(void) {
   // one more cycle, same thing
   s_mcp3427_callbacks[0](TEST_SENSED_CH1_VALUE, TEST_SENSED_CH2_VALUE,
                          s_mcp3427_callback_contexts[0]);
-  s_sense_callbacks[0](s_sense_callback_contexts[0]);
+  s_sense_callbacks[0](0, s_sense_callback_contexts[0]);
   data_store_get(TEST_DATA_POINT, &set_value);
   TEST_ASSERT_EQUAL(TEST_STORED_VALUE, set_value);
 
@@ -232,7 +248,7 @@ void test_sense_mcp3427_normal_cycle_max_mcp3427s(void) {
 
   // call the sense cycle callback, make sure data is set in the data store
   for (uint8_t i = 0; i < MAX_SOLAR_MCP3427; i++) {
-    s_sense_callbacks[i](s_sense_callback_contexts[i]);
+    s_sense_callbacks[i](i, s_sense_callback_contexts[i]);
     data_store_get_is_set(prv_get_test_data_point(i), &is_set);
     TEST_ASSERT_EQUAL(true, is_set);
     data_store_get(prv_get_test_data_point(i), &set_value);
@@ -247,7 +263,7 @@ void test_sense_mcp3427_normal_cycle_max_mcp3427s(void) {
                            s_mcp3427_callback_contexts[i]);
   }
   for (uint8_t i = 0; i < MAX_SOLAR_MCP3427; i++) {
-    s_sense_callbacks[i](s_sense_callback_contexts[i]);
+    s_sense_callbacks[i](i, s_sense_callback_contexts[i]);
     data_store_get(prv_get_test_data_point(i), &set_value);
     TEST_ASSERT_EQUAL(TEST_STORED_VALUE, set_value);
   }
@@ -268,7 +284,7 @@ void test_sense_mcp3427_data_not_ready_max_mcp3427s(void) {
 
   // calling the sense callbacks before the MCP3427 callbacks has no effect
   for (uint8_t i = 0; i < MAX_SOLAR_MCP3427; i++) {
-    s_sense_callbacks[i](s_sense_callback_contexts[i]);
+    s_sense_callbacks[i](i, s_sense_callback_contexts[i]);
     data_store_get_is_set(prv_get_test_data_point(i), &is_set);
     TEST_ASSERT_EQUAL(false, is_set);  // the data store was never set
   }
@@ -277,7 +293,7 @@ void test_sense_mcp3427_data_not_ready_max_mcp3427s(void) {
   s_mcp3427_callbacks[0](TEST_SENSED_CH1_VALUE, TEST_SENSED_CH2_VALUE,
                          s_mcp3427_callback_contexts[0]);
   for (uint8_t i = 0; i < MAX_SOLAR_MCP3427; i++) {
-    s_sense_callbacks[i](s_sense_callback_contexts[i]);
+    s_sense_callbacks[i](i, s_sense_callback_contexts[i]);
     data_store_get_is_set(prv_get_test_data_point(i), &is_set);
     TEST_ASSERT_EQUAL(i == 0, is_set);  // only the first one sets the data store
   }
@@ -286,12 +302,85 @@ void test_sense_mcp3427_data_not_ready_max_mcp3427s(void) {
   for (uint8_t i = 1; i < MAX_SOLAR_MCP3427; i++) {
     s_mcp3427_callbacks[i](TEST_SENSED_CH1_VALUE, TEST_SENSED_CH2_VALUE,
                            s_mcp3427_callback_contexts[i]);
-    s_sense_callbacks[i](s_sense_callback_contexts[i]);
+    s_sense_callbacks[i](i, s_sense_callback_contexts[i]);
     data_store_get_is_set(prv_get_test_data_point(i), &is_set);
     TEST_ASSERT_EQUAL(true, is_set);
   }
 }
 
+// Test that a conversion arriving while a sense cycle waits completes the source immediately.
+void test_sense_mcp3427_completes_waiting_cycle(void) {
+  bool is_set;
+  uint32_t set_value;
+  SenseMcp3427Settings settings;
+  prv_get_max_mcp3427s_settings(&settings);
+  TEST_ASSERT_OK(sense_mcp3427_init(&settings));
+  TEST_ASSERT_OK(sense_mcp3427_start());
+
+  // nothing is ready, so every source waits
+  for (uint8_t i = 0; i < MAX_SOLAR_MCP3427; i++) {
+    s_sense_callbacks[i](i, s_sense_callback_contexts[i]);
+  }
+  TEST_ASSERT_EQUAL(0, s_sources_done);
+
+  // each conversion completes its source as it arrives
+  for (uint8_t i = 0; i < MAX_SOLAR_MCP3427; i++) {
+    s_mcp3427_callbacks[i](TEST_SENSED_CH1_VALUE, TEST_SENSED_CH2_VALUE,
+                           s_mcp3427_callback_contexts[i]);
+    TEST_ASSERT_EQUAL((1u << (i + 1)) - 1, s_sources_done);
+    data_store_get_is_set(prv_get_test_data_point(i), &is_set);
+    TEST_ASSERT_EQUAL(true, is_set);
+    data_store_get(prv_get_test_data_point(i), &set_value);
+    TEST_ASSERT_EQUAL(TEST_STORED_VALUE, set_value);
+  }
+
+  // a conversion is only consumed once: the next cycle waits for a fresh one
+  s_sources_done = 0;
+  s_sense_callbacks[0](0, s_sense_callback_contexts[0]);
+  TEST_ASSERT_EQUAL(0, s_sources_done);
+}
+
+// Test that a missed deadline marks the data point stale and a late conversion is held for the next
+// cycle.
+void test_sense_mcp3427_deadline_marks_stale(void) {
+  bool is_set;
+  SenseMcp3427Settings settings = {
+    .mcp3427s = { {
+        .data_point = TEST_DATA_POINT,
+        .scaling_factor = 1.0f,
+    } },
+    .num_mcp3427s = 1,
+  };
+  settings.mcp3427s[0].mcp3427_settings = s_test_mcp3427_settings;
+  TEST_ASSERT_OK(sense_mcp3427_init(&settings));
+  TEST_ASSERT_OK(sense_mcp3427_start());
+
+  // a first good cycle
+  s_mcp3427_callbacks[0](TEST_SENSED_CH1_VALUE, TEST_SENSED_CH2_VALUE,
+                         s_mcp3427_callback_contexts[0]);
+  s_sense_callbacks[0](0, s_sense_callback_contexts[0]);
+  data_store_get_is_set(TEST_DATA_POINT, &is_set);
+  TEST_ASSERT_EQUAL(true, is_set);
+
+  // the next cycle times out before a conversion arrives
+  s_sources_done = 0;
+  s_sense_callbacks[0](0, s_sense_callback_contexts[0]);
+  s_sense_deadline_callbacks[0](0, s_sense_callback_contexts[0]);
+  data_store_get_is_set(TEST_DATA_POINT, &is_set);
+  TEST_ASSERT_EQUAL(false, is_set);
+
+  // the late conversion doesn't complete the timed-out cycle but is used by the next one
+  s_mcp3427_callbacks[0](TEST_SENSED_CH1_VALUE, TEST_SENSED_CH2_VALUE,
+                         s_mcp3427_callback_contexts[0]);
+  TEST_ASSERT_EQUAL(0, s_sources_done);
+  data_store_get_is_set(TEST_DATA_POINT, &is_set);
+  TEST_ASSERT_EQUAL(false, is_set);
+  s_sense_callbacks[0](0, s_sense_callback_contexts[0]);
+  TEST_ASSERT_EQUAL(1, s_sources_done);
+  data_store_get_is_set(TEST_DATA_POINT, &is_set);
+  TEST_ASSERT_EQUAL(true, is_set);
+}
+
 // Test that a fault event is raised when an MCP3427 faults too much.
 void test_sense_mcp3427_fault(void) {
   SenseMcp3427Settings settings;
@@ -392,6 +481,32 @@ void test_sense_mcp3427_scaling_factor(void) {
   prv_test_value_transform(&settings, -1025, 0xFFFFFF00, "-1025->0xFFFFFF00 (factor 0.25) failed.");
 }
 
+// Test that a nonzero filter shift reports the EWMA of every conversion, not just the latest.
+void test_sense_mcp3427_filter(void) {
+  uint32_t set_value = 0;
+  SenseMcp3427Settings settings = {
+    .mcp3427s = { {
+        .data_point = TEST_DATA_POINT,
+        .scaling_factor = 1.0f,
+        .filter_shift = 2,
+    } },
+    .num_mcp3427s = 1,
+  };
+  settings.mcp3427s[0].mcp3427_settings = s_test_mcp3427_settings;
+  TEST_ASSERT_OK(sense_mcp3427_init(&settings));
+  TEST_ASSERT_OK(sense_mcp3427_start());
+
+  // the first conversion seeds the filter
+  prv_test_value_transform(&settings, 100, 100, "Filter seeding failed");
+
+  // conversions between cycles are all blended in: 100 -> 200 -> 225
+  s_mcp3427_callbacks[0](500, 500, s_mcp3427_callback_contexts[0]);
+  s_mcp3427_callbacks[0](300, 300, s_mcp3427_callback_contexts[0]);
+  s_sense_callbacks[0](0, s_sense_callback_contexts[0]);
+  data_store_get(TEST_DATA_POINT, &set_value);
+  TEST_ASSERT_EQUAL(225, set_value);
+}
+
 // Test that initializing with NULL settings fails gracefully.
 void test_sense_mcp3427_init_null(void) {
   TEST_ASSERT_EQUAL(STATUS_CODE_INVALID_ARGS, sense_mcp3427_init(NULL));
@@ -45,33 +45,24 @@ static uint16_t s_mppt_voltage_ret;
 static uint16_t s_mppt_pwm_ret;
 static uint8_t s_mppt_status_ret;
 
-static uint8_t s_mppt_current_pin;
-static uint8_t s_mppt_voltage_pin;
-static uint8_t s_mppt_pwm_pin;
-static uint8_t s_mppt_status_pin;
-
-StatusCode TEST_MOCK(mppt_read_current)(SpiPort port, uint16_t *current, uint8_t pin) {
-  *current = s_mppt_current_ret;
-  s_mppt_current_pin = pin;
-  return STATUS_CODE_OK;
-}
-
-StatusCode TEST_MOCK(mppt_read_voltage_in)(SpiPort port, uint16_t *voltage, uint8_t pin) {
-  *voltage = s_mppt_voltage_ret;
-  s_mppt_voltage_pin = pin;
-  return STATUS_CODE_OK;
-}
-
-StatusCode TEST_MOCK(mppt_read_pwm)(SpiPort port, uint16_t *pwm, uint8_t pin) {
-  *pwm = s_mppt_pwm_ret;
-  s_mppt_pwm_pin = pin;
-  return STATUS_CODE_OK;
-}
-
-StatusCode TEST_MOCK(mppt_read_status)(SpiPort port, uint16_t *status, uint8_t pin) {
-  *status = s_mppt_status_ret;
-  s_mppt_status_pin = pin;
-  return STATUS_CODE_OK;
+// bit n is set to make reading n (an |MpptReading|) fail
+static uint8_t s_mppt_failed_readings;
+static uint8_t s_times_sweep_called;
+static uint8_t s_sweep_mppt_count;
+
+StatusCode TEST_MOCK(mppt_read_sweep)(SpiPort port, uint8_t mppt_count, MpptReadings *readings) {
+  for (Mppt mppt = 0; mppt < mppt_count; mppt++) {
+    readings[mppt] = (MpptReadings){
+      .current = s_mppt_current_ret,
+      .vin = s_mppt_voltage_ret,
+      .pwm = s_mppt_pwm_ret,
+      .status = s_mppt_status_ret,
+      .valid = ((1 << NUM_MPPT_READINGS) - 1) & ~s_mppt_failed_readings,
+    };
+  }
+  s_times_sweep_called++;
+  s_sweep_mppt_count = mppt_count;
+  return (s_mppt_failed_readings != 0) ? STATUS_CODE_INTERNAL_ERROR : STATUS_CODE_OK;
 }
 
 static uint8_t s_num_faults_raised;
@@ -104,10 +95,9 @@ void setup_test(void) {
   s_mppt_voltage_ret = TEST_VOLTAGE;
   s_mppt_pwm_ret = TEST_PWM;
   s_mppt_status_ret = DEFAULT_STATUS;
-  s_mppt_current_pin = INVALID_MPPT;
-  s_mppt_voltage_pin = INVALID_MPPT;
-  s_mppt_pwm_pin = INVALID_MPPT;
-  s_mppt_status_pin = INVALID_MPPT;
+  s_mppt_failed_readings = 0;
+  s_times_sweep_called = 0;
+  s_sweep_mppt_count = 0;
 
   s_num_faults_raised = 0;
 }
@@ -156,11 +146,9 @@ void test_single_mppt_cycle_sets_values(void) {
   data_store_get(DATA_POINT_CR_BIT(0), &set_value);
   TEST_ASSERT_EQUAL(TEST_CR_BIT, set_value);
 
-  // the pins used should match with the MPPT
-  TEST_ASSERT_EQUAL(0, s_mppt_current_pin);
-  TEST_ASSERT_EQUAL(0, s_mppt_voltage_pin);
-  TEST_ASSERT_EQUAL(0, s_mppt_pwm_pin);
-  TEST_ASSERT_EQUAL(0, s_mppt_status_pin);
+  // the MPPT was read in a single sweep
+  TEST_ASSERT_EQUAL(1, s_times_sweep_called);
+  TEST_ASSERT_EQUAL(1, s_sweep_mppt_count);
 
   // the default status is OK, so no errors should have been thrown
   MS_TEST_HELPER_ASSERT_NO_EVENT_RAISED();
@@ -193,6 +181,11 @@ void test_max_mppt_cycle_sets_values(void) {
   // trigger the sense cycle, everything should then be set to the correct values
   prv_trigger_sense_cycle();
 
+  // all MPPTs are read in one sweep from a single sense callback
+  TEST_ASSERT_EQUAL(1, s_num_sense_callbacks);
+  TEST_ASSERT_EQUAL(1, s_times_sweep_called);
+  TEST_ASSERT_EQUAL(MAX_SOLAR_BOARD_MPPTS, s_sweep_mppt_count);
+
   for (Mppt mppt = 0; mppt < MAX_SOLAR_BOARD_MPPTS; mppt++) {
     data_store_get_is_set(DATA_POINT_MPPT_CURRENT(mppt), &is_set);
     TEST_ASSERT_EQUAL(true, is_set);
@@ -321,6 +314,34 @@ void test_status_faults(void) {
   TEST_ASSERT_EQUAL(MAX_SOLAR_BOARD_MPPTS, num_ovc_events);
 }
 
+// Test that readings which failed are not set while the rest of the sweep still is.
+void test_failed_readings_not_set(void) {
+  bool is_set;
+  SenseMpptSettings settings = {
+    .mppt_count = MAX_SOLAR_BOARD_MPPTS,
+    .spi_port = TEST_SPI_PORT,
+    .mppt_current_scaling_factor = 1.0f,
+    .mppt_vin_scaling_factor = 1.0f,
+  };
+  TEST_ASSERT_OK(sense_mppt_init(&settings));
+
+  s_mppt_failed_readings = (1 << MPPT_READING_VOLTAGE_IN) | (1 << MPPT_READING_STATUS);
+  s_mppt_status_ret = SPV1020_OVV_MASK;  // would fault if the status were used
+  prv_trigger_sense_cycle();
+
+  for (Mppt mppt = 0; mppt < MAX_SOLAR_BOARD_MPPTS; mppt++) {
+    data_store_get_is_set(DATA_POINT_MPPT_CURRENT(mppt), &is_set);
+    TEST_ASSERT_EQUAL(true, is_set);
+    data_store_get_is_set(DATA_POINT_MPPT_VOLTAGE(mppt), &is_set);
+    TEST_ASSERT_EQUAL(false, is_set);
+    data_store_get_is_set(DATA_POINT_MPPT_PWM(mppt), &is_set);
+    TEST_ASSERT_EQUAL(true, is_set);
+    data_store_get_is_set(DATA_POINT_CR_BIT(mppt), &is_set);
+    TEST_ASSERT_EQUAL(false, is_set);
+  }
+  TEST_ASSERT_EQUAL(0, s_num_faults_raised);
+}
+
 // Test that the current and vin scaling factors are respected.
 void test_scaling_factor(void) {
   SenseMpptSettings settings = {